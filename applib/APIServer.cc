@@ -56,6 +56,7 @@
 #include "bundling/Bundle.h"
 #include "bundling/BundleEvent.h"
 #include "bundling/BundleDaemon.h"
+#include "bundling/BundleDaemonStorage.h"
 #include "bundling/BundleProtocol.h"
 #include "bundling/BundleProtocolVersion7.h"
 #include "bundling/BundleStatusReport.h"
@@ -1461,6 +1462,9 @@ APIClient::handle_recv()
 
     BundleRef bref("APIClient::handle_recv");
 
+    // must be declared after bref so it is released before the bundle
+    BundlePayload::ReadView payload_view;
+
     // Pull the front bundle off the bundle_list and also move it to either
     // the app unacked or acked list, depending on whether the app is
     // actively acking or not.
@@ -1568,9 +1572,17 @@ APIClient::handle_recv()
         // the app wants the payload in memory
         payload.buf.buf_len = payload_len;
         if (payload_len != 0) {
-            buf.reserve(payload_len);
-            payload.buf.buf_val =
-                (char*)b->payload().read_data(0, payload_len, buf.buf());
+            // hand the app a borrowed view of the payload if possible
+            // rather than copying it out into a scratch buffer first
+            if (BundleDaemonStorage::params_.payload_read_views_ &&
+                b->payload().get_read_view(0, payload_len, &payload_view))
+            {
+                payload.buf.buf_val = (char*)payload_view.buf();
+            } else {
+                buf.reserve(payload_len);
+                payload.buf.buf_val =
+                    (char*)b->payload().read_data(0, payload_len, buf.buf());
+            }
         } else {
             payload.buf.buf_val = 0;
         }
@@ -2066,6 +2078,9 @@ APIClient::handle_peek()
     }
 
     BundleRef bref("APIClient::handle_recv");
+
+    // must be declared after bref so it is released before the bundle
+    BundlePayload::ReadView payload_view;
     bref = api_reg->bundle_list()->pop_front();
     Bundle* b = bref.object();
     ASSERT(b != nullptr);
@@ -2110,9 +2125,17 @@ APIClient::handle_peek()
         // the app wants the payload in memory
         payload.buf.buf_len = payload_len;
         if (payload_len != 0) {
-            buf.reserve(payload_len);
-            payload.buf.buf_val =
-                (char*)b->payload().read_data(0, payload_len, buf.buf());
+            // hand the app a borrowed view of the payload if possible
+            // rather than copying it out into a scratch buffer first
+            if (BundleDaemonStorage::params_.payload_read_views_ &&
+                b->payload().get_read_view(0, payload_len, &payload_view))
+            {
+                payload.buf.buf_val = (char*)payload_view.buf();
+            } else {
+                buf.reserve(payload_len);
+                payload.buf.buf_val =
+                    (char*)b->payload().read_data(0, payload_len, buf.buf());
+            }
         } else {
             payload.buf.buf_val = 0;
         }
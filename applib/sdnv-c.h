@@ -43,6 +43,15 @@ extern int sdnv_encode(uint64_t val, unsigned char* bp, size_t len);
  */
 extern int sdnv_decode(const unsigned char* bp, size_t len, uint64_t* val);
 
+/**
+ * Convert count consecutive SDNVs pointed to by bp into unsigned
+ * 64-bit integers.
+ *
+ * @return The total number of bytes of bp consumed, or -1 on error.
+ */
+extern int sdnv_decode_n(const unsigned char* bp, size_t len,
+                         uint64_t* vals, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
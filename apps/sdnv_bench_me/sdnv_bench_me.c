@@ -0,0 +1,372 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Round-trip checks and a microbenchmark for the SDNV codec.
+ *
+ * Every value below 2^exhaustive_bits (2^24 by default) is encoded,
+ * decoded and compared with a bytewise reference decoder. So is every
+ * value on either side of each seven-bit boundary up to 2^64 and a run
+ * of random values of every length. Every truncation of those encodings
+ * must fail to decode, and so must 10 byte encodings that overflow 64
+ * bits. Then the encode, decode and decode_n throughput is measured
+ * over buffers of packed SDNVs.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "sdnv-c.h"
+
+#define NUM_VALUES 4096
+
+int      exhaustive_bits = 24;
+int      bench_rounds    = 2000;
+int      failures        = 0;
+
+#define FAIL(fmt, args...)                              \
+    do {                                                \
+        fprintf(stderr, "FAILED: " fmt "\n", ## args);  \
+        if (++failures > 20) exit(1);                   \
+    } while (0)
+
+//----------------------------------------------------------------------
+static int
+ref_decode(const unsigned char* bp, size_t len, uint64_t* val)
+{
+    size_t i;
+    *val = 0;
+    for (i = 0; i < len && i < 10; ++i) {
+        *val = (*val << 7) | (bp[i] & 0x7f);
+        if ((bp[i] & 0x80) == 0) {
+            if (i == 9 && bp[0] != 0x81) {
+                return -1;
+            }
+            return (int)i + 1;
+        }
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------
+static int
+ref_encoding_len(uint64_t val)
+{
+    int n = 1;
+    while (val >>= 7) {
+        ++n;
+    }
+    return n;
+}
+
+//----------------------------------------------------------------------
+static uint64_t
+rand64(void)
+{
+    return ((uint64_t)random() << 62) ^ ((uint64_t)random() << 31) ^
+           (uint64_t)random();
+}
+
+//----------------------------------------------------------------------
+static void
+check_value(uint64_t val, int check_truncations)
+{
+    // the encoding is followed by junk so that decoders which read
+    // past the end of the SDNV would notice
+    unsigned char buf[32];
+    uint64_t decoded = 0;
+    int len, i;
+
+    memset(buf, 0xff, sizeof(buf));
+
+    len = sdnv_encode(val, buf, sizeof(buf));
+    if (len != ref_encoding_len(val) || (size_t)len != sdnv_encoding_len(val)) {
+        FAIL("encode %llu: len %d expected %d",
+             (unsigned long long)val, len, ref_encoding_len(val));
+        return;
+    }
+
+    if (ref_decode(buf, len, &decoded) != len || decoded != val) {
+        FAIL("encode %llu: reference decodes %llu",
+             (unsigned long long)val, (unsigned long long)decoded);
+        return;
+    }
+
+    if (sdnv_decode(buf, len, &decoded) != len || decoded != val) {
+        FAIL("decode %llu: got %llu", (unsigned long long)val,
+             (unsigned long long)decoded);
+    }
+
+    if (sdnv_decode(buf, sizeof(buf), &decoded) != len || decoded != val) {
+        FAIL("decode %llu from long buffer: got %llu",
+             (unsigned long long)val, (unsigned long long)decoded);
+    }
+
+    if (sdnv_encode(val, buf, len - 1) != -1) {
+        FAIL("encode %llu into %d bytes succeeded",
+             (unsigned long long)val, len - 1);
+    }
+
+    if (check_truncations) {
+        for (i = 0; i < len; ++i) {
+            if (sdnv_decode(buf, i, &decoded) != -1) {
+                FAIL("decode %llu truncated to %d bytes succeeded",
+                     (unsigned long long)val, i);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+static void
+check_round_trips(void)
+{
+    uint64_t val, limit = 1ULL << exhaustive_bits;
+    int shift, i;
+
+    for (val = 0; val < limit; ++val) {
+        check_value(val, (val & 0xfff) == 0);
+    }
+
+    for (shift = 0; shift < 64; ++shift) {
+        uint64_t bit = 1ULL << shift;
+        check_value(bit, 1);
+        check_value(bit - 1, 1);
+        check_value(bit + 1, 1);
+        check_value(~0ULL >> shift, 1);
+    }
+
+    for (i = 0; i < 1000000; ++i) {
+        check_value(rand64() >> (random() % 64), (i % 64) == 0);
+    }
+
+    printf("round trips:   %llu exhaustive values ok\n",
+           (unsigned long long)limit);
+}
+
+//----------------------------------------------------------------------
+static void
+check_malformed(void)
+{
+    unsigned char buf[16];
+    uint64_t val;
+    int first;
+
+    // ten byte encodings only have room for bit 63 in the first byte
+    for (first = 0x80; first <= 0xff; ++first) {
+        memset(buf, 0x80, sizeof(buf));
+        buf[0] = first;
+        buf[9] = 0x01;
+        int expected = (first == 0x81) ? 10 : -1;
+        if (sdnv_decode(buf, sizeof(buf), &val) != expected) {
+            FAIL("ten byte sdnv with first byte 0x%02x", first);
+        }
+    }
+
+    // so do eleven byte encodings, even leading zeros
+    memset(buf, 0x80, sizeof(buf));
+    buf[10] = 0x01;
+    if (sdnv_decode(buf, sizeof(buf), &val) != -1) {
+        FAIL("eleven byte sdnv decoded");
+    }
+
+    // and a run of continuation bytes never ends
+    memset(buf, 0x80, sizeof(buf));
+    if (sdnv_decode(buf, sizeof(buf), &val) != -1) {
+        FAIL("unterminated sdnv decoded");
+    }
+
+    printf("malformed:     ok\n");
+}
+
+//----------------------------------------------------------------------
+static size_t
+fill_values(uint64_t* vals, unsigned char* buf, size_t buflen, int max_bits)
+{
+    size_t off = 0;
+    int i;
+
+    for (i = 0; i < NUM_VALUES; ++i) {
+        vals[i] = rand64() >> (64 - 1 - (random() % max_bits));
+        off += sdnv_encode(vals[i], buf + off, buflen - off);
+    }
+    return off;
+}
+
+//----------------------------------------------------------------------
+static void
+check_decode_n(void)
+{
+    static uint64_t vals[NUM_VALUES], decoded[NUM_VALUES];
+    static unsigned char buf[NUM_VALUES * 10];
+    size_t len = fill_values(vals, buf, sizeof(buf), 64);
+    size_t off = 0;
+    int i;
+
+    if (sdnv_decode_n(buf, len, decoded, NUM_VALUES) != (int)len ||
+        memcmp(vals, decoded, sizeof(vals)) != 0)
+    {
+        FAIL("decode_n of %d values", NUM_VALUES);
+    }
+
+    if (sdnv_decode_n(buf, len - 1, decoded, NUM_VALUES) != -1) {
+        FAIL("decode_n of truncated buffer succeeded");
+    }
+
+    // and in runs of a few fields, the way header parsers use it
+    for (i = 0; i + 5 <= NUM_VALUES; i += 5) {
+        int ret = sdnv_decode_n(buf + off, len - off, decoded, 5);
+        if (ret <= 0 || memcmp(&vals[i], decoded, 5 * sizeof(uint64_t)) != 0) {
+            FAIL("decode_n of five values at %d", i);
+            break;
+        }
+        off += ret;
+    }
+
+    printf("decode_n:      ok\n");
+}
+
+//----------------------------------------------------------------------
+static double
+now(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+//----------------------------------------------------------------------
+static void
+report(const char* what, int max_bits, double start, size_t ops)
+{
+    double elapsed = now() - start;
+    printf("%-10s <= %2d bits: %7.2f ns/value %8.1f Mvalues/s\n",
+           what, max_bits, elapsed * 1e9 / ops, ops / elapsed / 1e6);
+}
+
+//----------------------------------------------------------------------
+static void
+bench(int max_bits)
+{
+    static uint64_t vals[NUM_VALUES], decoded[NUM_VALUES];
+    static unsigned char buf[NUM_VALUES * 10];
+    size_t len = fill_values(vals, buf, sizeof(buf), max_bits);
+    size_t ops = (size_t)bench_rounds * NUM_VALUES;
+    uint64_t sum = 0;
+    double start;
+    int r, i;
+
+    start = now();
+    for (r = 0; r < bench_rounds; ++r) {
+        size_t off = 0;
+        for (i = 0; i < NUM_VALUES; ++i) {
+            off += sdnv_encode(vals[i], buf + off, sizeof(buf) - off);
+        }
+        sum += off;
+    }
+    report("encode", max_bits, start, ops);
+
+    start = now();
+    for (r = 0; r < bench_rounds; ++r) {
+        size_t off = 0;
+        for (i = 0; i < NUM_VALUES; ++i) {
+            off += sdnv_decode(buf + off, len - off, &decoded[i]);
+        }
+        sum += decoded[r % NUM_VALUES];
+    }
+    report("decode", max_bits, start, ops);
+
+    start = now();
+    for (r = 0; r < bench_rounds; ++r) {
+        size_t off = 0;
+        for (i = 0; i < NUM_VALUES; i += 8) {
+            off += sdnv_decode_n(buf + off, len - off, &decoded[i], 8);
+        }
+        sum += decoded[r % NUM_VALUES];
+    }
+    report("decode_n", max_bits, start, ops);
+
+    start = now();
+    for (r = 0; r < bench_rounds; ++r) {
+        size_t off = 0;
+        for (i = 0; i < NUM_VALUES; ++i) {
+            off += ref_decode(buf + off, len - off, &decoded[i]);
+        }
+        sum += decoded[r % NUM_VALUES];
+    }
+    report("bytewise", max_bits, start, ops);
+
+    if (sum == 0) {
+        printf("\n"); // keep the loops from being optimized away
+    }
+}
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "e:r:")) != -1) {
+        switch (opt) {
+        case 'e':
+            exhaustive_bits = atoi(optarg);
+            break;
+        case 'r':
+            bench_rounds = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-e exhaustive_bits] [-r bench_rounds]\n"
+                    " -e   check every value below 2^bits (default 24)\n"
+                    " -r   passes over the benchmark buffers, 0 to skip\n",
+                    argv[0]);
+            exit(1);
+        }
+    }
+
+    if (exhaustive_bits < 0 || exhaustive_bits > 40) {
+        fprintf(stderr, "exhaustive_bits must be between 0 and 40\n");
+        exit(1);
+    }
+
+    srandom(1);
+
+    check_round_trips();
+    check_malformed();
+    check_decode_n();
+
+    if (failures != 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        exit(1);
+    }
+
+    if (bench_rounds > 0) {
+        bench(7);
+        bench(14);
+        bench(32);
+        bench(64);
+    }
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Benchmark of the scheduling overhead of driving many CLConnections
+ * from a thread each versus from the shared CLEventLoops.
+ *
+ * Pairs of connections are set up over socketpairs and bounce a small
+ * message back and forth, so nearly all of the work is waking up the
+ * right connection. Each run reports the message rate along with the
+ * cpu time, context switches and threads used.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/util/Getopt.h>
+#include <third_party/oasys/util/Time.h>
+
+#include "bundling/BundleDaemon.h"
+#include "conv_layers/CLConnection.h"
+#include "conv_layers/CLEventLoop.h"
+
+using namespace dtn;
+
+namespace {
+
+u_int  num_pairs = 500;
+u_int  num_loops = 2;
+u_int  msg_len   = 64;
+double duration  = 5.0;
+
+//----------------------------------------------------------------------
+class EchoParams : public ConnectionConvergenceLayer::LinkParams {
+public:
+    EchoParams() : LinkParams(true)
+    {
+        sendbuf_len_ = 4096;
+        recvbuf_len_ = 4096;
+    }
+};
+
+//----------------------------------------------------------------------
+/**
+ * Connection that sends back every message it receives. The active
+ * side sends the first one.
+ */
+class EchoConnection : public CLConnection {
+public:
+    EchoConnection(LinkParams* params, int fd, bool active)
+        : CLConnection("EchoConnection", "/dtnme_cl_loop_bench/conn",
+                       nullptr, params, active),
+          fd_(fd),
+          messages_(0)
+    {
+    }
+
+    virtual ~EchoConnection()
+    {
+        // the stop request is left over if the peer closed first
+        CLMsg msg;
+        while (cmdqueue_.try_pop(&msg)) {}
+
+        disconnect();
+    }
+
+    void stop()
+    {
+        cmdqueue_.push_back(CLMsg(CLMSG_BREAK_CONTACT));
+    }
+
+    uint64_t messages() const { return messages_; }
+
+protected:
+    virtual void connect() override { queue_message(); }
+    virtual void accept() override {}
+    virtual void disconnect() override
+    {
+        if (fd_ != -1) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    virtual void initialize_pollfds() override
+    {
+        pollfds_[0].fd     = fd_;
+        pollfds_[0].events = POLLIN;
+        num_pollfds_       = 1;
+        poll_timeout_      = 1000;
+    }
+
+    virtual void handle_bundles_queued() override {}
+    virtual void handle_cancel_bundle(Bundle* b) override { (void)b; }
+    virtual void handle_poll_timeout() override {}
+
+    virtual bool send_pending_data() override
+    {
+        if (sendbuf_.fullbytes() != 0) {
+            ssize_t cc = ::write(fd_, sendbuf_.start(), sendbuf_.fullbytes());
+            if (cc > 0) {
+                sendbuf_.consume(cc);
+            } else if (errno != EAGAIN) {
+                break_contact(ContactEvent::BROKEN);
+                return false;
+            }
+        }
+
+        if (sendbuf_.fullbytes() != 0) {
+            pollfds_[0].events |= POLLOUT;
+        } else {
+            pollfds_[0].events &= ~POLLOUT;
+        }
+        return false;
+    }
+
+    virtual void handle_poll_activity() override
+    {
+        short revents = pollfds_[0].revents;
+
+        if (revents & POLLIN) {
+            recvbuf_.reserve(msg_len);
+            ssize_t cc = ::read(fd_, recvbuf_.end(), recvbuf_.tailbytes());
+            if (cc <= 0) {
+                if (cc == 0 || errno != EAGAIN) {
+                    break_contact(ContactEvent::BROKEN);
+                }
+                return;
+            }
+            recvbuf_.fill(cc);
+
+            while (recvbuf_.fullbytes() >= msg_len) {
+                recvbuf_.consume(msg_len);
+                ++messages_;
+                queue_message();
+            }
+        } else if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            break_contact(ContactEvent::BROKEN);
+        }
+    }
+
+    void queue_message()
+    {
+        sendbuf_.reserve(msg_len);
+        memset(sendbuf_.end(), 'm', msg_len);
+        sendbuf_.fill(msg_len);
+    }
+
+    int                   fd_;
+    std::atomic<uint64_t> messages_;
+};
+
+//----------------------------------------------------------------------
+int
+num_threads()
+{
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f == nullptr) {
+        return -1;
+    }
+
+    char line[256];
+    int threads = -1;
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        if (sscanf(line, "Threads: %d", &threads) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return threads;
+}
+
+//----------------------------------------------------------------------
+void
+run(const char* name, u_int loops)
+{
+    BundleDaemon::params_.cl_event_loops_ = loops;
+
+    EchoParams params;
+    std::vector<EchoConnection*> conns;
+
+    for (u_int i = 0; i < num_pairs; ++i) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            perror("socketpair");
+            exit(1);
+        }
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+        conns.push_back(new EchoConnection(&params, fds[0], true));
+        conns.push_back(new EchoConnection(&params, fds[1], false));
+    }
+
+    // let the connections start up before measuring
+    for (EchoConnection* conn : conns) {
+        conn->start_connection();
+    }
+    usleep(500000);
+
+    struct rusage ru_start, ru_end;
+    uint64_t msgs_start = 0, msgs_end = 0;
+
+    for (EchoConnection* conn : conns) {
+        msgs_start += conn->messages();
+    }
+    getrusage(RUSAGE_SELF, &ru_start);
+    oasys::Time start;
+    start.get_time();
+
+    usleep((useconds_t)(duration * 1000000));
+
+    for (EchoConnection* conn : conns) {
+        msgs_end += conn->messages();
+    }
+    getrusage(RUSAGE_SELF, &ru_end);
+    double elapsed = start.elapsed_us() / 1e6;
+    int threads = num_threads();
+
+    for (EchoConnection* conn : conns) {
+        conn->stop();
+    }
+    for (EchoConnection* conn : conns) {
+        while (!conn->is_stopped()) {
+            usleep(1000);
+        }
+        delete conn;
+    }
+
+    double cpu = (ru_end.ru_utime.tv_sec - ru_start.ru_utime.tv_sec) +
+                 (ru_end.ru_stime.tv_sec - ru_start.ru_stime.tv_sec) +
+                 (ru_end.ru_utime.tv_usec - ru_start.ru_utime.tv_usec) / 1e6 +
+                 (ru_end.ru_stime.tv_usec - ru_start.ru_stime.tv_usec) / 1e6;
+    long csw = (ru_end.ru_nvcsw - ru_start.ru_nvcsw) +
+               (ru_end.ru_nivcsw - ru_start.ru_nivcsw);
+    double msgs = msgs_end - msgs_start;
+
+    printf("%-18s %5d threads %10.0f msgs/s %8.2f us cpu/msg %8.3f csw/msg %7.2f cpus\n",
+           name, threads, msgs / elapsed, cpu * 1e6 / msgs, csw / msgs,
+           cpu / elapsed);
+    fflush(stdout);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    oasys::Getopt opts;
+
+    opts.addopt(new oasys::UIntOpt('n', "pairs", &num_pairs, "<n>",
+                                   "connection pairs (default 500)"));
+    opts.addopt(new oasys::UIntOpt('l', "loops", &num_loops, "<n>",
+                                   "event loop threads (default 2)"));
+    opts.addopt(new oasys::UIntOpt('s', "size", &msg_len, "<bytes>",
+                                   "message length (default 64)"));
+    opts.addopt(new oasys::DoubleOpt('d', "duration", &duration, "<secs>",
+                                     "seconds to measure each run (default 5)"));
+
+    int remainder = opts.getopt(argv[0], argc, argv);
+    if (remainder != argc || num_pairs == 0 || num_loops == 0 ||
+        msg_len == 0 || msg_len > 4096 || duration <= 0)
+    {
+        opts.usage(argv[0]);
+        exit(1);
+    }
+
+    // each connection uses a socket and two notifier pipes
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    oasys::Log::init(oasys::LOG_WARN);
+
+    printf("%u connection pairs, %u byte messages\n", num_pairs, msg_len);
+    fflush(stdout);
+
+    run("thread per conn", 0);
+
+    char name[32];
+    snprintf(name, sizeof(name), "%u event loop%s", num_loops,
+             (num_loops == 1) ? "" : "s");
+    run(name, num_loops);
+
+    return 0;
+}
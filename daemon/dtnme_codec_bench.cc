@@ -0,0 +1,553 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Microbenchmark for the bundle codecs, independent of sockets and
+ * storage.
+ *
+ * A bundle of the requested shape is generated locally and encoded. The
+ * extension blocks are then spliced in after the primary block, so the
+ * encoding looks like a bundle received from a peer. That encoding is
+ * timed through each stage a forwarding node runs on a bundle:
+ *
+ *   consume       BundleProtocol::consume() of the whole encoding into a
+ *                 new bundle, in chunks of the given size
+ *   prepare       BundleProtocol::prepare_blocks() and generate_blocks()
+ *                 for the received bundle, then delete_blocks()
+ *   produce       BundleProtocol::produce() of the whole bundle
+ *   total_length  BundleProtocol::total_length()
+ *
+ * Every stage runs first on one thread and then on the requested number
+ * of threads, each with its own copy of the bundle. Payloads are kept in
+ * memory so that only the codec is measured.
+ *
+ * With --chunk-sweep only the consume stage is run, on one thread, with
+ * the encoding handed over in 64 B, 1 KB, 16 KB and 64 KB chunks, which
+ * shows the cost of a block being split across convergence layer reads
+ * (e.g. -s 100000 -S for a 100 KB payload).
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/io/FileUtils.h>
+#include <third_party/oasys/storage/DurableStore.h>
+#include <third_party/oasys/util/CRC16.h>
+#include <third_party/oasys/util/CRC32C.h>
+#include <third_party/oasys/util/Getopt.h>
+#include <third_party/oasys/util/Time.h>
+
+#include "bundling/Bundle.h"
+#include "bundling/BundleDaemon.h"
+#include "bundling/BundleProtocol.h"
+#include "bundling/SDNV.h"
+#include "contacts/ContactPlanner.h"
+#include "contacts/Link.h"
+#include "naming/SchemeTable.h"
+#include "storage/BundleStore.h"
+#include "storage/DTNStorageConfig.h"
+#include "storage/GlobalStore.h"
+
+using namespace dtn;
+
+namespace {
+
+int       bp_version     = BundleProtocol::BP_VERSION_7;
+u_int64_t payload_len    = 1000;
+u_int     ext_blocks     = 0;
+u_int     ext_block_type = 192;
+u_int64_t ext_block_len  = 32;
+u_int     crc_type       = 2;
+u_int     imc_dests      = 0;
+u_int64_t chunk_len      = 0;
+u_int     num_threads    = 0;
+double    duration       = 1.0;
+bool      no_cache       = false;
+bool      chunk_sweep    = false;
+
+//----------------------------------------------------------------------
+void
+cbor_head(std::string* out, u_char major, u_int64_t val)
+{
+    major <<= 5;
+    if (val < 24) {
+        out->push_back(major | val);
+        return;
+    }
+
+    int len = (val <= 0xff) ? 1 : (val <= 0xffff) ? 2 : (val <= 0xffffffff) ? 4 : 8;
+    out->push_back(major | ((len == 1) ? 24 : (len == 2) ? 25 : (len == 4) ? 26 : 27));
+    for (int i = len - 1; i >= 0; --i) {
+        out->push_back((u_char)(val >> (i * 8)));
+    }
+}
+
+//----------------------------------------------------------------------
+void
+sdnv(std::string* out, u_int64_t val)
+{
+    u_char buf[16];
+    int len = SDNV::encode(val, buf, sizeof(buf));
+    out->append((const char*)buf, len);
+}
+
+//----------------------------------------------------------------------
+/**
+ * Encode an opaque extension block with the given block number.
+ */
+std::string
+encode_ext_block(u_int64_t block_number)
+{
+    std::string data(ext_block_len, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (char)(block_number + i);
+    }
+
+    std::string block;
+
+    if (bp_version == BundleProtocol::BP_VERSION_6) {
+        block.push_back((char)ext_block_type);
+        sdnv(&block, 0); // block processing flags
+        sdnv(&block, data.size());
+        block.append(data);
+        return block;
+    }
+
+    size_t crc_len = (crc_type == 1) ? 2 : (crc_type == 2) ? 4 : 0;
+
+    cbor_head(&block, 4, (crc_len == 0) ? 5 : 6);
+    cbor_head(&block, 0, ext_block_type);
+    cbor_head(&block, 0, block_number);
+    cbor_head(&block, 0, 0); // block processing flags
+    cbor_head(&block, 0, crc_type);
+    cbor_head(&block, 2, data.size());
+    block.append(data);
+
+    if (crc_len != 0) {
+        // the crc covers the block with the crc field zeroed
+        cbor_head(&block, 2, crc_len);
+        block.append(crc_len, '\0');
+
+        u_char* crcp = (u_char*)&block[block.size() - crc_len];
+        if (crc_type == 1) {
+            u_int16_t crc = htons(oasys::CRC16::extend(0, (const u_char*)block.data(), block.size()));
+            memcpy(crcp, &crc, sizeof(crc));
+        } else {
+            u_int32_t crc = htonl(oasys::CRC32C::extend(0, (const u_char*)block.data(), block.size()));
+            memcpy(crcp, &crc, sizeof(crc));
+        }
+    }
+
+    return block;
+}
+
+//----------------------------------------------------------------------
+/**
+ * Build a bundle of the configured shape and return its encoding with
+ * the extension blocks added.
+ */
+std::string
+encode_bundle()
+{
+    Bundle* bundle = new Bundle(bp_version, BundlePayload::MEMORY);
+
+    bundle->set_source(BD_MAKE_EID("ipn:1.2"));
+    bundle->mutable_replyto() = BD_MAKE_EID("ipn:1.2");
+    bundle->set_creation_ts(1000, 7);
+    bundle->set_expiration_secs(3600);
+    // a primary block without a CRC is only valid with a BIB, so it
+    // keeps the default CRC32C if the extension blocks have none
+    if (crc_type != 0) {
+        bundle->set_primary_block_crc_type(crc_type);
+    }
+
+    if (imc_dests != 0) {
+        bundle->mutable_dest() = BD_MAKE_EID("imc:10.4");
+        for (u_int i = 0; i < imc_dests; ++i) {
+            bundle->add_imc_orig_dest_node(100 + i);
+            bundle->add_imc_dest_node(100 + i);
+        }
+    } else {
+        bundle->mutable_dest() = BD_MAKE_EID("ipn:3.4");
+    }
+
+    std::string data(payload_len, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (char)(i * 7);
+    }
+    bundle->mutable_payload()->set_data(data);
+
+    LinkRef link("dtnme_codec_bench");
+    SPtr_BlockInfoVec blocks = BundleProtocol::prepare_blocks(bundle, link);
+    if (blocks == nullptr) {
+        fprintf(stderr, "error preparing the blocks of the bundle\n");
+        exit(1);
+    }
+
+    size_t total = BundleProtocol::generate_blocks(bundle, blocks.get(), link);
+
+    std::string wire(total, '\0');
+    bool last = false;
+    if (BundleProtocol::produce(bundle, blocks.get(), (u_char*)&wire[0],
+                                0, total, &last) != total || !last)
+    {
+        fprintf(stderr, "error producing the bundle\n");
+        exit(1);
+    }
+
+    // the extension blocks go after the primary block, which follows
+    // the start of the indefinite length array in BPv7
+    size_t offset = blocks->front()->contents().len();
+    if (bp_version == BundleProtocol::BP_VERSION_7) {
+        ++offset;
+    }
+
+    std::string ext;
+    for (u_int i = 0; i < ext_blocks; ++i) {
+        ext.append(encode_ext_block(100 + i));
+    }
+    wire.insert(offset, ext);
+
+    BundleProtocol::delete_blocks(bundle, link);
+    delete bundle;
+
+    return wire;
+}
+
+//----------------------------------------------------------------------
+/**
+ * Decode the encoding into the bundle as a convergence layer would,
+ * handing over chunk_len bytes at a time (plus whatever was left
+ * unconsumed by the previous call).
+ */
+bool
+consume_bundle(Bundle* bundle, const std::string& wire)
+{
+    size_t chunk = (chunk_len == 0) ? wire.size() : chunk_len;
+    size_t offset = 0;
+    size_t pending = 0;
+    bool last = false;
+
+    while (!last && offset < wire.size()) {
+        size_t len = std::min(chunk + pending, wire.size() - offset);
+        ssize_t cc = BundleProtocol::consume(bundle, (u_char*)&wire[offset], len, &last);
+        if (cc < 0) {
+            return false;
+        }
+        offset += cc;
+        pending = len - cc;
+    }
+
+    return last && offset == wire.size();
+}
+
+//----------------------------------------------------------------------
+/**
+ * Per thread state for running the stages.
+ */
+class Worker {
+public:
+    Worker(const std::string& wire)
+        : wire_(wire),
+          link_("dtnme_codec_bench"),
+          bundle_(new Bundle(bp_version, BundlePayload::MEMORY)),
+          ops_(0)
+    {
+        BundleProtocol::status_report_reason_t reception_reason, deletion_reason;
+
+        if (!consume_bundle(bundle_, wire_) ||
+            !BundleProtocol::validate(bundle_, &reception_reason, &deletion_reason))
+        {
+            fprintf(stderr, "error consuming the bundle\n");
+            exit(1);
+        }
+
+        if (bundle_->recv_blocks()->size() < 2 + ext_blocks ||
+            bundle_->payload().length() != payload_len)
+        {
+            fprintf(stderr, "bundle consumed with %zu blocks and a %zu byte payload\n",
+                    bundle_->recv_blocks()->size(), bundle_->payload().length());
+            exit(1);
+        }
+
+        out_.resize(wire_.size() * 2);
+    }
+
+    ~Worker()
+    {
+        BundleProtocol::delete_blocks(bundle_, link_);
+        delete bundle_;
+    }
+
+    void consume()
+    {
+        Bundle* bundle = new Bundle(bp_version, BundlePayload::MEMORY);
+        if (!consume_bundle(bundle, wire_)) {
+            fprintf(stderr, "error consuming the bundle\n");
+            exit(1);
+        }
+        delete bundle;
+    }
+
+    void prepare()
+    {
+        SPtr_BlockInfoVec blocks = BundleProtocol::prepare_blocks(bundle_, link_);
+        ASSERT(blocks != nullptr);
+        BundleProtocol::generate_blocks(bundle_, blocks.get(), link_);
+        BundleProtocol::delete_blocks(bundle_, link_);
+    }
+
+    void produce()
+    {
+        bool last = false;
+        BundleProtocol::produce(bundle_, blocks_.get(), (u_char*)&out_[0],
+                                0, total_, &last);
+        ASSERT(last);
+    }
+
+    void total_length()
+    {
+        total_ = BundleProtocol::total_length(bundle_, blocks_.get());
+    }
+
+    /// Set up the outbound blocks for produce() and total_length()
+    void generate()
+    {
+        blocks_ = BundleProtocol::prepare_blocks(bundle_, link_);
+        ASSERT(blocks_ != nullptr);
+        total_ = BundleProtocol::generate_blocks(bundle_, blocks_.get(), link_);
+        ASSERT(total_ <= out_.size());
+    }
+
+    const std::string& wire_;
+    LinkRef            link_;
+    Bundle*            bundle_;
+    SPtr_BlockInfoVec  blocks_;
+    size_t             total_ = 0;
+    std::string        out_;
+    size_t             ops_;
+};
+
+typedef void (Worker::*stage_func_t)();
+
+//----------------------------------------------------------------------
+/**
+ * Run the stage for the configured duration on each of the workers at
+ * once and print the combined rate.
+ */
+void
+run_stage(const char* name, stage_func_t func, std::vector<Worker*>& workers,
+          size_t bytes)
+{
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    u_int64_t usecs = (u_int64_t)(duration * 1000000);
+
+    for (Worker* worker : workers) {
+        worker->ops_ = 0;
+        threads.emplace_back([worker, func, usecs, &go]() {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+
+            oasys::Time start;
+            start.get_time();
+            do {
+                (worker->*func)();
+                ++worker->ops_;
+            } while (start.elapsed_us() < usecs);
+        });
+    }
+
+    oasys::Time start;
+    start.get_time();
+    go = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double elapsed = start.elapsed_us() / 1e6;
+
+    size_t ops = 0;
+    for (Worker* worker : workers) {
+        ops += worker->ops_;
+    }
+
+    printf("%-12s %3zu thread%s %12.0f bundles/s %10.1f MB/s %10.3f us/bundle\n",
+           name, workers.size(), (workers.size() == 1) ? " " : "s",
+           ops / elapsed, ops * bytes / elapsed / 1e6,
+           elapsed * 1e6 * workers.size() / ops);
+    fflush(stdout);
+}
+
+//----------------------------------------------------------------------
+void
+run_stages(const std::string& wire, size_t count)
+{
+    std::vector<Worker*> workers;
+    for (size_t i = 0; i < count; ++i) {
+        workers.push_back(new Worker(wire));
+    }
+
+    run_stage("consume", &Worker::consume, workers, wire.size());
+    run_stage("prepare", &Worker::prepare, workers, wire.size());
+
+    for (Worker* worker : workers) {
+        worker->generate();
+    }
+
+    run_stage("produce", &Worker::produce, workers, wire.size());
+    run_stage("total_length", &Worker::total_length, workers, wire.size());
+
+    for (Worker* worker : workers) {
+        delete worker;
+    }
+}
+
+//----------------------------------------------------------------------
+void
+run_chunk_sweep(const std::string& wire)
+{
+    size_t chunks[]      = { 64, 1024, 16 * 1024, 64 * 1024 };
+    const char* names[]  = { "consume/64", "consume/1K", "consume/16K", "consume/64K" };
+
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+        chunk_len = chunks[i];
+
+        std::vector<Worker*> workers(1, new Worker(wire));
+        run_stage(names[i], &Worker::consume, workers, wire.size());
+        delete workers[0];
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    oasys::Getopt opts;
+
+    opts.addopt(new oasys::IntOpt('v', "version", &bp_version, "<6|7>",
+                                  "bundle protocol version (default 7)"));
+    opts.addopt(new oasys::SizeOpt('s', "payload", &payload_len, "<size>",
+                                   "payload length (default 1000)"));
+    opts.addopt(new oasys::UIntOpt('x', "ext-blocks", &ext_blocks, "<n>",
+                                   "number of extension blocks (default 0)"));
+    opts.addopt(new oasys::UIntOpt('T', "ext-type", &ext_block_type, "<type>",
+                                   "extension block type (default 192)"));
+    opts.addopt(new oasys::SizeOpt('e', "ext-len", &ext_block_len, "<size>",
+                                   "extension block data length (default 32)"));
+    opts.addopt(new oasys::UIntOpt('c', "crc", &crc_type, "<0|1|2>",
+                                   "BPv7 CRC type of the blocks (default 2)"));
+    opts.addopt(new oasys::UIntOpt('m', "imc-dests", &imc_dests, "<n>",
+                                   "send to an IMC group with n BPv7 destination nodes (default 0)"));
+    opts.addopt(new oasys::SizeOpt('k', "chunk", &chunk_len, "<size>",
+                                   "bytes handed to each consume call (default the whole bundle)"));
+    opts.addopt(new oasys::UIntOpt('t', "threads", &num_threads, "<n>",
+                                   "threads for the parallel runs (default one per cpu)"));
+    opts.addopt(new oasys::DoubleOpt('d', "duration", &duration, "<secs>",
+                                     "seconds to run each stage (default 1)"));
+    opts.addopt(new oasys::BoolOpt('C', "no-cache", &no_cache,
+                                   "disable the block encoding cache"));
+    opts.addopt(new oasys::BoolOpt('S', "chunk-sweep", &chunk_sweep,
+                                   "only time consume, in 64 B to 64 KB chunks"));
+
+    int remainder = opts.getopt(argv[0], argc, argv);
+    if (remainder != argc ||
+        (bp_version != BundleProtocol::BP_VERSION_6 &&
+         bp_version != BundleProtocol::BP_VERSION_7) ||
+        crc_type > 2 || duration <= 0)
+    {
+        opts.usage(argv[0]);
+        exit(1);
+    }
+
+    if (bp_version == BundleProtocol::BP_VERSION_6 && imc_dests != 0) {
+        fprintf(stderr, "IMC destinations are only supported with BPv7\n");
+        exit(1);
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+
+    oasys::Log::init(oasys::LOG_WARN);
+
+    // the daemon needs a bundle store to hand out bundle ids, so give
+    // it a throwaway in-memory one
+    char tmpdir[] = "/tmp/dtnme_codec_bench.XXXXXX";
+    if (mkdtemp(tmpdir) == nullptr) {
+        perror("mkdtemp");
+        exit(1);
+    }
+
+    DTNStorageConfig cfg("storage", "memorydb", "dtn", tmpdir);
+    cfg.init_        = true;
+    cfg.payload_dir_ = std::string(tmpdir) + "/bundles";
+
+    oasys::DurableStore* store = new oasys::DurableStore("/dtn/storage");
+    if (store->create_store(cfg) != 0) {
+        fprintf(stderr, "error creating the bundle store\n");
+        exit(1);
+    }
+
+    ContactPlanner::init();
+    SchemeTable::create();
+    BundleDaemon::init();
+    if (GlobalStore::init(cfg, store) != 0 || BundleStore::init(cfg, store) != 0) {
+        fprintf(stderr, "error initializing the bundle store\n");
+        exit(1);
+    }
+
+    if (no_cache) {
+        BundleDaemon::params_.block_encoding_cache_size_ = 0;
+    }
+
+    std::string wire = encode_bundle();
+
+    printf("BPv%d bundle: %" PRIu64 " byte payload, %u extension blocks of type %u "
+           "with %" PRIu64 " bytes, CRC type %u, %u IMC destinations -- %zu bytes\n",
+           bp_version, payload_len, ext_blocks, ext_block_type, ext_block_len,
+           (bp_version == BundleProtocol::BP_VERSION_7) ? crc_type : 0,
+           imc_dests, wire.size());
+    fflush(stdout);
+
+    if (chunk_sweep) {
+        run_chunk_sweep(wire);
+    } else {
+        run_stages(wire, 1);
+        if (num_threads > 1) {
+            run_stages(wire, num_threads);
+        }
+    }
+
+    oasys::FileUtils::rm_all_from_dir(tmpdir, true);
+    rmdir(tmpdir);
+
+    return 0;
+}
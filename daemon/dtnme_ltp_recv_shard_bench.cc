@@ -0,0 +1,615 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Benchmark of the LTPUDP receive path with the interface's recv_shards
+ * option, run through the real LTPUDPConvergenceLayer and LTPEngine.
+ *
+ * For each shard count from 1 up to the maximum an LTPEngine is set up
+ * with that many RecvDataProcessors and a node for one remote engine,
+ * then an ltpudp interface is added with the same recv_shards so that
+ * its Receivers bind that many SO_REUSEPORT sockets on one port. The
+ * node's session dispatch and RecvSegProcessors, the report segments
+ * and the report acks are all the daemon's own code.
+ *
+ * The remote engine is played by sender threads, each with its own
+ * socket so the kernel spreads them across the receiving sockets. Each
+ * keeps a window of red sessions open, sends every session as a burst
+ * of data segments ending in a checkpoint, and answers the report
+ * segment the node sends back with a report ack, which closes the
+ * session on both sides. A session counts once its report claims all
+ * of its data. The node's link is a stub that hands those report
+ * segments straight to the sender threads instead of queueing them
+ * for an LTPUDPConvergenceLayer sender.
+ *
+ * The session payload is not a bundle so bundle extraction gives up on
+ * it at the first byte, which leaves the cost of the extraction out of
+ * the rates. Each run reports the aggregate rate sessions completed at
+ * and the cpu time used per segment, and the node logs its statistics
+ * as it is shut down at the end of the run.
+ *
+ * The senders compete with the receivers for the cpus so the scaling
+ * seen depends on having more cores than threads.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <atomic>
+#include <errno.h>
+#include <inttypes.h>
+#include <map>
+#include <memory>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/io/FileUtils.h>
+#include <third_party/oasys/storage/DurableStore.h>
+#include <third_party/oasys/thread/Timer.h>
+#include <third_party/oasys/util/Getopt.h>
+#include <third_party/oasys/util/Time.h>
+
+#include "bundling/BundleDaemon.h"
+#include "bundling/SDNV.h"
+#include "contacts/ContactPlanner.h"
+#include "contacts/InterfaceTable.h"
+#include "conv_layers/LTPUDPConvergenceLayer.h"
+#include "ltp/LTPCLSenderIF.h"
+#include "ltp/LTPEngine.h"
+#include "naming/SchemeTable.h"
+#include "storage/BundleStore.h"
+#include "storage/DTNStorageConfig.h"
+#include "storage/GlobalStore.h"
+
+using namespace dtn;
+
+namespace {
+
+const uint64_t LOCAL_ENGINE_ID  = 1;
+const uint64_t REMOTE_ENGINE_ID = 22;
+
+// LTP segment types (the control flags of the first byte)
+const u_char LTP_DS_RED     = 0x00;
+const u_char LTP_DS_RED_EOB = 0x03;
+const u_char LTP_RS         = 0x08;
+const u_char LTP_RAS        = 0x09;
+
+u_int     seg_len      = 1400;
+u_int     session_segs = 8;
+u_int     num_senders  = 4;
+u_int     window       = 4;
+u_int     max_shards   = 8;
+u_int     recvbuf      = 8 * 1024 * 1024;
+double    duration     = 3.0;
+double    timeout      = 0.5;
+u_int16_t port         = 14560;
+
+std::atomic<bool> stop(false);
+
+//----------------------------------------------------------------------
+void
+sdnv(std::string* out, u_int64_t val)
+{
+    u_char buf[16];
+    int len = SDNV::encode(val, buf, sizeof(buf));
+    out->append((const char*)buf, len);
+}
+
+//----------------------------------------------------------------------
+/**
+ * Encode the header shared by every segment type, with no extensions.
+ */
+std::string
+segment_header(u_char type, u_int64_t session_id)
+{
+    std::string seg;
+    seg.push_back(type);
+    sdnv(&seg, REMOTE_ENGINE_ID);
+    sdnv(&seg, session_id);
+    seg.push_back(0);
+    return seg;
+}
+
+//----------------------------------------------------------------------
+/**
+ * Decode the header of a segment, returning the offset of the first
+ * field after it or 0 if it is not one of ours.
+ */
+size_t
+parse_header(const u_char* bp, size_t len, u_char* type, u_int64_t* session_id)
+{
+    u_int64_t engine_id;
+    size_t offset = 1;
+    int cc;
+
+    if (len < 4 || (bp[0] & 0xf0) != 0) {
+        return 0;
+    }
+    *type = bp[0];
+
+    if ((cc = SDNV::decode(bp + offset, len - offset, &engine_id)) <= 0) {
+        return 0;
+    }
+    offset += cc;
+
+    if ((cc = SDNV::decode(bp + offset, len - offset, session_id)) <= 0) {
+        return 0;
+    }
+    offset += cc;
+
+    if (engine_id != REMOTE_ENGINE_ID || offset >= len || bp[offset] != 0) {
+        return 0;
+    }
+    return offset + 1;
+}
+
+//----------------------------------------------------------------------
+/**
+ * The sender thread, and so the socket, a session belongs to.
+ */
+u_int
+session_sender(u_int64_t session_id)
+{
+    return (session_id >> 32) & 0xff;
+}
+
+//----------------------------------------------------------------------
+struct sockaddr_in
+loopback_addr(u_int16_t addr_port)
+{
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port        = htons(addr_port);
+    return sa;
+}
+
+//----------------------------------------------------------------------
+/**
+ * The node's link to the remote engine. Report segments and the other
+ * admin segments go straight to the socket of the sender thread the
+ * session belongs to. The rest of the settings are the ltpudp link
+ * defaults.
+ */
+class BenchLink : public LTPCLSenderIF {
+public:
+    BenchLink(int fd) : fd_(fd) {}
+
+    uint64_t           Remote_Engine_ID() override { return REMOTE_ENGINE_ID; }
+    void               Set_Ready_For_Bundles(bool) override {}
+
+    void Send_Admin_Seg_Highest_Priority(std::string* send_data, SPtr_LTPTimer timer, bool) override
+    {
+        u_char type;
+        u_int64_t session_id;
+        const u_char* bp = (const u_char*)send_data->data();
+
+        if (parse_header(bp, send_data->size(), &type, &session_id) != 0) {
+            struct sockaddr_in sa = loopback_addr(port + 1 + session_sender(session_id));
+            ::sendto(fd_, bp, send_data->size(), 0, (struct sockaddr*)&sa, sizeof(sa));
+        }
+
+        // started once sent, as the ltpudp sender does
+        if (timer != nullptr) {
+            timer->start();
+        }
+
+        delete send_data;
+    }
+
+    void               Send_DataSeg_Higher_Priority(SPtr_LTPDataSegment, SPtr_LTPTimer) override {}
+    void               Send_DataSeg_Low_Priority(SPtr_LTPDataSegment, SPtr_LTPTimer) override {}
+    uint32_t           Retran_Intvl() override { return params_.retran_intvl_; }
+    uint32_t           Retran_Retries() override { return params_.retran_retries_; }
+    uint32_t           Inactivity_Intvl() override { return params_.inactivity_intvl_; }
+    void               Add_To_Inflight(const BundleRef&) override {}
+    void               Del_From_Queue(const BundleRef&) override {}
+    size_t             Get_Bundles_Queued_Count() override { return 0; }
+    size_t             Get_Bundles_InFlight_Count() override { return 0; }
+    bool               Del_From_InFlight_Queue(const BundleRef&) override { return false; }
+    void               Delete_Xmit_Blocks(const BundleRef&) override {}
+    uint32_t           Max_Sessions() override { return params_.max_sessions_; }
+    uint32_t           Agg_Time() override { return params_.agg_time_; }
+    uint64_t           Agg_Size() override { return params_.agg_size_; }
+    uint32_t           Seg_Size() override { return params_.seg_size_; }
+    bool               CCSDS_Compatible() override { return params_.ccsds_compatible_; }
+    size_t             Ltp_Queued_Bytes_Quota() override { return params_.ltp_queued_bytes_quota_; }
+    size_t             Bytes_Per_CheckPoint() override { return params_.bytes_per_checkpoint_; }
+    bool               Use_Files_Xmit() override { return params_.use_files_xmit_; }
+    bool               Use_Files_Recv() override { return params_.use_files_recv_; }
+    bool               Keep_Aborted_Files() override { return params_.keep_aborted_files_; }
+    bool               Use_DiskIO_Kludge() override { return params_.use_diskio_kludge_; }
+    int32_t            Recv_Test() override { return params_.recv_test_; }
+    std::string&       Dir_Path() override { return params_.dir_path_; }
+
+    void               PostTransmitProcessing(BundleRef&, bool, uint64_t, bool) override {}
+    SPtr_BlockInfoVec  GetBlockInfoVec(Bundle*) override { return nullptr; }
+    bool               Dump_Sessions() override { return params_.dump_sessions_; }
+    bool               Dump_Segs() override { return params_.dump_segs_; }
+    bool               Hex_Dump() override { return params_.hexdump_; }
+    bool               AOS() override { return params_.comm_aos_; }
+    uint32_t           Inbound_Cipher_Suite() override { return params_.inbound_cipher_suite_; }
+    uint32_t           Inbound_Cipher_Key_Id() override { return params_.inbound_cipher_key_id_; }
+    std::string&       Inbound_Cipher_Engine() override { return params_.inbound_cipher_engine_; }
+    uint32_t           Outbound_Cipher_Suite() override { return params_.outbound_cipher_suite_; }
+    uint32_t           Outbound_Cipher_Key_Id() override { return params_.outbound_cipher_key_id_; }
+    std::string&       Outbound_Cipher_Engine() override { return params_.outbound_cipher_engine_; }
+
+private:
+    int fd_;
+    LTPUDPConvergenceLayer::Params params_;
+};
+
+//----------------------------------------------------------------------
+/**
+ * Lets the bench install an LTPEngine of its own for each run, which
+ * the daemon otherwise only creates when it starts running.
+ */
+class BenchDaemon : public BundleDaemon {
+public:
+    static BenchDaemon* init()
+    {
+        BenchDaemon* daemon = new BenchDaemon();
+        instance_ = daemon;
+        daemon->do_init();
+        return daemon;
+    }
+
+    void set_ltp_engine(SPtr_LTPEngine engine) { ltp_engine_ = engine; }
+};
+
+//----------------------------------------------------------------------
+/**
+ * One socket of the remote engine, keeping a window of sessions open.
+ */
+class Sender {
+public:
+    Sender(u_int index, u_int run)
+        : next_session_(((u_int64_t)run << 40) | ((u_int64_t)index << 32))
+    {
+        fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+        int one = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        struct sockaddr_in sa = loopback_addr(port + 1 + index);
+        if (::bind(fd_, (struct sockaddr*)&sa, sizeof(sa)) != 0) {
+            perror("bind");
+            exit(1);
+        }
+
+        payload_.assign(seg_len, '\0');
+    }
+
+    ~Sender() { ::close(fd_); }
+
+    void run()
+    {
+        u_char buf[2048];
+
+        while (! stop) {
+            while (outstanding_.size() < window) {
+                send_session();
+            }
+
+            struct pollfd pfd = { fd_, POLLIN, 0 };
+            ::poll(&pfd, 1, 10);
+
+            ssize_t cc;
+            while ((cc = ::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+                handle_report(buf, cc);
+            }
+
+            expire_sessions();
+        }
+    }
+
+    u_int64_t sessions_done_ = 0;
+    u_int64_t sessions_lost_ = 0;
+
+private:
+    //----------------------------------------------------------------------
+    void send_session()
+    {
+        u_int64_t session_id = ++next_session_;
+
+        std::vector<std::string> segs(session_segs);
+        std::vector<struct iovec> iovs(session_segs);
+        std::vector<struct mmsghdr> msgs(session_segs);
+        struct sockaddr_in sa = loopback_addr(port);
+
+        for (u_int i = 0; i < session_segs; ++i) {
+            bool last = (i == session_segs - 1);
+
+            segs[i] = segment_header(last ? LTP_DS_RED_EOB : LTP_DS_RED, session_id);
+            sdnv(&segs[i], 1);                  // client service id
+            sdnv(&segs[i], i * seg_len);        // offset
+            sdnv(&segs[i], seg_len);            // length
+            if (last) {
+                sdnv(&segs[i], 1);              // checkpoint serial number
+                sdnv(&segs[i], 0);              // report serial number
+            }
+            segs[i].append(payload_);
+
+            iovs[i].iov_base = (void*)segs[i].data();
+            iovs[i].iov_len  = segs[i].size();
+
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name    = &sa;
+            msgs[i].msg_hdr.msg_namelen = sizeof(sa);
+            msgs[i].msg_hdr.msg_iov     = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+        }
+
+        u_int sent = 0;
+        while (sent < session_segs) {
+            int cc = ::sendmmsg(fd_, msgs.data() + sent, session_segs - sent, 0);
+            if (cc < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("sendmmsg");
+                exit(1);
+            }
+            sent += cc;
+        }
+
+        oasys::Time now;
+        now.get_time();
+        outstanding_[session_id] = now;
+    }
+
+    //----------------------------------------------------------------------
+    void handle_report(const u_char* bp, size_t len)
+    {
+        u_char type;
+        u_int64_t session_id;
+        size_t offset = parse_header(bp, len, &type, &session_id);
+
+        if (offset == 0 || type != LTP_RS) {
+            return;
+        }
+
+        // report serial, checkpoint serial, upper bound, lower bound,
+        // claim count and then the first claim's offset and length
+        u_int64_t fields[7];
+        if (SDNV::decode_n(bp + offset, len - offset, fields, 7) <= 0) {
+            return;
+        }
+
+        // acked even if it is no longer ours so the node can close it
+        std::string ras = segment_header(LTP_RAS, session_id);
+        sdnv(&ras, fields[0]);
+
+        struct sockaddr_in sa = loopback_addr(port);
+        ::sendto(fd_, ras.data(), ras.size(), 0, (struct sockaddr*)&sa, sizeof(sa));
+
+        std::map<u_int64_t, oasys::Time>::iterator iter = outstanding_.find(session_id);
+        if (iter == outstanding_.end()) {
+            return;
+        }
+        outstanding_.erase(iter);
+
+        u_int64_t total = (u_int64_t)seg_len * session_segs;
+        if (fields[2] == total && fields[3] == 0 && fields[4] == 1 &&
+            fields[5] == 0 && fields[6] == total)
+        {
+            ++sessions_done_;
+        } else {
+            ++sessions_lost_;
+        }
+    }
+
+    //----------------------------------------------------------------------
+    void expire_sessions()
+    {
+        std::map<u_int64_t, oasys::Time>::iterator iter = outstanding_.begin();
+        while (iter != outstanding_.end()) {
+            if (iter->second.elapsed_ms() > timeout * 1000) {
+                ++sessions_lost_;
+                iter = outstanding_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    int fd_;
+    u_int64_t next_session_;
+    std::string payload_;
+    std::map<u_int64_t, oasys::Time> outstanding_;
+};
+
+//----------------------------------------------------------------------
+double
+cpu_secs()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+//----------------------------------------------------------------------
+void
+run_shards(BenchDaemon* daemon, LTPUDPConvergenceLayer* cl, int link_fd, u_int shards)
+{
+    SPtr_LTPEngine engine = std::make_shared<LTPEngine>(LOCAL_ENGINE_ID);
+    daemon->set_ltp_engine(engine);
+
+    // the node sizes its session dispatch by the engine's shards
+    engine->set_recv_shards(shards);
+    engine->register_engine(std::make_shared<BenchLink>(link_fd));
+
+    std::string local_port  = "local_port=" + std::to_string(port);
+    std::string recv_shards = "recv_shards=" + std::to_string(shards);
+    std::string recv_buf    = "recvbuf=" + std::to_string(recvbuf);
+    const char* argv[] = { "local_addr=127.0.0.1", local_port.c_str(),
+                           recv_shards.c_str(), recv_buf.c_str() };
+
+    if (! InterfaceTable::instance()->add("ltp0", cl, "ltpudp", 4, argv)) {
+        fprintf(stderr, "error adding the ltpudp interface\n");
+        exit(1);
+    }
+
+    // let the receivers and the engine's processors get going
+    usleep(500000);
+
+    std::vector<Sender*> senders;
+    for (u_int i = 0; i < num_senders; ++i) {
+        senders.push_back(new Sender(i, shards));
+    }
+
+    stop = false;
+    double cpu_start = cpu_secs();
+    oasys::Time start;
+    start.get_time();
+
+    std::vector<std::thread> threads;
+    for (Sender* sender : senders) {
+        threads.emplace_back(&Sender::run, sender);
+    }
+
+    usleep(duration * 1e6);
+    stop = true;
+    double elapsed = start.elapsed_us() / 1e6;
+    double cpu = cpu_secs() - cpu_start;
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    u_int64_t done = 0;
+    u_int64_t lost = 0;
+    for (Sender* sender : senders) {
+        done += sender->sessions_done_;
+        lost += sender->sessions_lost_;
+        delete sender;
+    }
+
+    u_int64_t segs = done * session_segs;
+    printf("%u shard%s %12.0f segments/s %10.0f sessions/s %10.1f MB/s "
+           "%8.2f us cpu/segment %8" PRIu64 " sessions lost\n",
+           shards, (shards == 1) ? " " : "s",
+           segs / elapsed, done / elapsed, segs * (double)seg_len / elapsed / 1e6,
+           (segs == 0) ? 0.0 : cpu * 1e6 / segs, lost);
+    fflush(stdout);
+
+    InterfaceTable::instance()->del("ltp0");
+    engine->shutdown();
+    daemon->set_ltp_engine(nullptr);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    oasys::Getopt opts;
+
+    opts.addopt(new oasys::UIntOpt('s', "size", &seg_len, "<bytes>",
+                                   "data segment payload length (default 1400)"));
+    opts.addopt(new oasys::UIntOpt('n', "segments", &session_segs, "<n>",
+                                   "data segments per session (default 8)"));
+    opts.addopt(new oasys::UIntOpt('t', "senders", &num_senders, "<n>",
+                                   "sender threads, each with its own socket (default 4)"));
+    opts.addopt(new oasys::UIntOpt('w', "window", &window, "<n>",
+                                   "sessions each sender keeps open (default 4)"));
+    opts.addopt(new oasys::UIntOpt('k', "shards", &max_shards, "<n>",
+                                   "largest number of receive shards to run with (default 8)"));
+    opts.addopt(new oasys::UIntOpt('b', "recvbuf", &recvbuf, "<bytes>",
+                                   "receive buffer of each receiving socket (default 8 MB)"));
+    opts.addopt(new oasys::DoubleOpt('d', "duration", &duration, "<secs>",
+                                     "seconds to run each shard count (default 3)"));
+    opts.addopt(new oasys::DoubleOpt('T', "timeout", &timeout, "<secs>",
+                                     "seconds before a session with no report is lost (default 0.5)"));
+    opts.addopt(new oasys::UInt16Opt('p', "port", &port, "<port>",
+                                     "port to receive on, the senders use the ones above it (default 14560)"));
+
+    int remainder = opts.getopt(argv[0], argc, argv);
+    if (remainder != argc || seg_len == 0 || seg_len > 60000 || session_segs == 0 ||
+        num_senders == 0 || num_senders > 255 || window == 0 || max_shards == 0 ||
+        max_shards > LTPEngine::MAX_RECV_SHARDS || duration <= 0 || timeout <= 0)
+    {
+        opts.usage(argv[0]);
+        exit(1);
+    }
+
+    // bundle extraction rejecting the payloads logs an error per session
+    oasys::Log::init(oasys::LOG_CRIT);
+
+    // the node reserves payload space for each session, so the daemon
+    // needs a bundle store even though no bundles come out
+    char tmpdir[] = "/tmp/dtnme_ltp_recv_shard_bench.XXXXXX";
+    if (mkdtemp(tmpdir) == nullptr) {
+        perror("mkdtemp");
+        exit(1);
+    }
+
+    DTNStorageConfig cfg("storage", "memorydb", "dtn", tmpdir);
+    cfg.init_        = true;
+    cfg.payload_dir_ = std::string(tmpdir) + "/bundles";
+
+    oasys::DurableStore* store = new oasys::DurableStore("/dtn/storage");
+    if (store->create_store(cfg) != 0) {
+        fprintf(stderr, "error creating the bundle store\n");
+        exit(1);
+    }
+
+    ContactPlanner::init();
+    SchemeTable::create();
+    BenchDaemon* daemon = BenchDaemon::init();
+    if (GlobalStore::init(cfg, store) != 0 || BundleStore::init(cfg, store) != 0) {
+        fprintf(stderr, "error initializing the bundle store\n");
+        exit(1);
+    }
+
+    oasys::SharedTimerThread::init();
+    InterfaceTable::init();
+    InterfaceTable::instance()->activate_interfaces();
+
+    LTPUDPConvergenceLayer* cl = new LTPUDPConvergenceLayer();
+    int link_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+    printf("%u senders with %u sessions each of %u segments of %u bytes\n",
+           num_senders, window, session_segs, seg_len);
+    fflush(stdout);
+
+    for (u_int shards = 1; shards <= max_shards; ++shards) {
+        run_shards(daemon, cl, link_fd, shards);
+    }
+
+    ::close(link_fd);
+
+    oasys::FileUtils::rm_all_from_dir(tmpdir, true);
+    rmdir(tmpdir);
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Benchmark of the pacing done by oasys::RateLimitedSocket as the
+ * LTPUDP convergence layer uses it: a sender blocks in sendto() until
+ * the token bucket lets each datagram go.
+ *
+ * Datagrams go to a loopback socket that is never read (the kernel
+ * drops what doesn't fit), so the only work is the pacing and the
+ * send itself. Each run reports the rate achieved against the target,
+ * the cpu used by the sending thread, the 99th percentile gap between
+ * datagrams against the ideal gap, and the burstiness: the most bytes
+ * the sender ever got ahead of a perfectly smooth schedule.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <algorithm>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/io/RateLimitedSocket.h>
+#include <third_party/oasys/io/UDPClient.h>
+#include <third_party/oasys/util/Getopt.h>
+
+namespace {
+
+u_int     msg_len    = 1400;
+double    duration   = 5.0;
+u_int16_t port       = 14557;
+bool      leaky      = false;
+
+//----------------------------------------------------------------------
+uint64_t
+clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+//----------------------------------------------------------------------
+void
+run(double mbps)
+{
+    // the sink is never read so it just needs to exist
+    oasys::UDPClient sink("/dtnme_pacing_bench/sink");
+    sink.set_logfd(false);
+    if (sink.bind(htonl(INADDR_LOOPBACK), port) != 0) {
+        fprintf(stderr, "error binding to port %u\n", port);
+        exit(1);
+    }
+
+    oasys::UDPClient socket("/dtnme_pacing_bench/sender");
+    socket.set_logfd(false);
+    socket.init_socket();
+
+    uint64_t rate = (uint64_t)(mbps * 1000000);
+    oasys::RateLimitedSocket rate_socket("/dtnme_pacing_bench/rate", rate, 0,
+                                         leaky ? oasys::RateLimitedSocket::LEAKY :
+                                                 oasys::RateLimitedSocket::STANDARD,
+                                         &socket);
+
+    // start from an empty bucket so the initial burst doesn't count
+    rate_socket.bucket()->empty();
+
+    std::vector<char> payload(msg_len, 'p');
+    std::vector<uint64_t> departures;
+    departures.reserve((size_t)(duration * rate / (msg_len * 8)) + 1000);
+
+    uint64_t cpu_start = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    uint64_t start     = clock_ns(CLOCK_MONOTONIC);
+    uint64_t end       = start + (uint64_t)(duration * 1e9);
+    uint64_t now       = start;
+
+    while (now < end) {
+        rate_socket.sendto(payload.data(), msg_len, 0, htonl(INADDR_LOOPBACK), port,
+                           true);  // block until data can be sent
+        now = clock_ns(CLOCK_MONOTONIC);
+        departures.push_back(now);
+    }
+
+    double elapsed = (now - start) / 1e9;
+    double cpu     = (clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start) / 1e9;
+    double sent    = (double)departures.size() * msg_len * 8;
+
+    std::vector<uint64_t> gaps;
+    gaps.reserve(departures.size());
+    for (size_t i = 1; i < departures.size(); ++i) {
+        gaps.push_back(departures[i] - departures[i - 1]);
+    }
+    std::sort(gaps.begin(), gaps.end());
+    double p99_gap = gaps.empty() ? 0 : gaps[(gaps.size() * 99) / 100] / 1e3;
+    double ideal   = msg_len * 8 / (double)rate * 1e6;
+
+    // furthest ahead of sending at exactly the rate from the start
+    double max_lead = 0;
+    for (size_t i = 0; i < departures.size(); ++i) {
+        double lead = (i + 1) * (double)msg_len - (departures[i] - start) * rate / 8e9;
+        max_lead = std::max(max_lead, lead);
+    }
+
+    printf("%7.0f Mbit/s target %10.3f Mbit/s sent (%+6.2f%%) %6.1f%% cpu "
+           "%9.1f us p99 gap (ideal %8.1f) %8.0f bytes max burst\n",
+           mbps, sent / elapsed / 1e6, (sent / elapsed - rate) * 100 / rate,
+           cpu * 100 / elapsed, p99_gap, ideal, max_lead);
+    fflush(stdout);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    oasys::Getopt opts;
+
+    opts.addopt(new oasys::UIntOpt('s', "size", &msg_len, "<bytes>",
+                                   "datagram length (default 1400)"));
+    opts.addopt(new oasys::DoubleOpt('d', "duration", &duration, "<secs>",
+                                     "seconds to measure each rate (default 5)"));
+    opts.addopt(new oasys::UInt16Opt('p', "port", &port, "<port>",
+                                     "loopback port to use (default 14557)"));
+    opts.addopt(new oasys::BoolOpt('l', "leaky", &leaky,
+                                   "use the leaky bucket (default standard)"));
+
+    int remainder = opts.getopt(argv[0], argc, argv);
+    if (msg_len == 0 || msg_len > 65507 || duration <= 0) {
+        opts.usage(argv[0]);
+        exit(1);
+    }
+
+    oasys::Log::init(oasys::LOG_WARN);
+
+    printf("%u byte datagrams, %s bucket\n", msg_len, leaky ? "leaky" : "standard");
+    fflush(stdout);
+
+    // rates in Mbit/s, 1, 100 and 1000 unless given
+    std::vector<double> rates;
+    for (int i = remainder; i < argc; ++i) {
+        rates.push_back(atof(argv[i]));
+    }
+    if (rates.empty()) {
+        rates = { 1, 100, 1000 };
+    }
+
+    for (double mbps : rates) {
+        if (mbps <= 0) {
+            opts.usage(argv[0]);
+            exit(1);
+        }
+        run(mbps);
+    }
+
+    return 0;
+}
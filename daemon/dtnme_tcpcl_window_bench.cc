@@ -0,0 +1,213 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Benchmark of TCPCLv4 goodput over a long delay path with a fixed
+ * inflight window and fixed segments versus the TransferWindow used
+ * by the connections.
+ *
+ * The path is emulated in process on a simulated clock: segments are
+ * serialized onto a bottleneck of the given rate behind a socket
+ * buffer's worth of queueing, arrive half a round trip later, and the
+ * receiver acks all of a bundle's segments once its last segment is
+ * in, as TCPConvergenceLayer does. The sender follows the same rules
+ * as Connection4 for starting bundles and sizing segments.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <algorithm>
+#include <inttypes.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <third_party/oasys/util/Getopt.h>
+
+#include "conv_layers/TransferWindow.h"
+
+using namespace dtn;
+
+namespace {
+
+double   rtt_ms           = 100;
+double   rate_mbps        = 1000;
+double   duration         = 30;
+u_int    max_inflight     = 100;
+uint64_t segment_length   = 10000000;
+uint64_t max_inflight_bytes = 256000000;
+u_int    sockbuf_len      = 4000000;
+
+/// An XFER_ACK on its way back to the sender
+struct Ack {
+    uint64_t transfer_id_;
+    uint64_t acked_len_;
+    uint64_t newly_acked_;
+    uint64_t bundle_len_;   ///< non zero for the final ack of a bundle
+};
+
+//----------------------------------------------------------------------
+void
+run(const char* name, uint64_t bundle_len, bool adaptive)
+{
+    const double rate  = rate_mbps * 1e6 / 8;    // bytes per second
+    const double delay = rtt_ms / 2000;          // one way, seconds
+
+    TransferWindow window;
+    std::multimap<double, Ack> acks;
+
+    double   now        = 0;
+    double   link_free  = 0;       // when the bottleneck goes idle
+    uint64_t next_id    = 0;
+    bool     sending    = false;   // in the middle of a bundle
+    uint64_t sent       = 0;       // bytes of it sent so far
+    size_t   inflight   = 0;
+
+    std::vector<std::pair<uint64_t, uint64_t>> segs; // end offset, len of the current bundle
+
+    uint64_t delivered = 0, num_segments = 0, segment_bytes = 0;
+    double   inflight_sum = 0;
+    uint64_t inflight_samples = 0;
+
+    auto us = [](double t) { return (uint64_t)(t * 1e6) + 1; };
+
+    while (now < duration) {
+        // deliver the acks that are due
+        while (!acks.empty() && acks.begin()->first <= now) {
+            const Ack& ack = acks.begin()->second;
+            window.segment_acked(ack.transfer_id_, ack.acked_len_,
+                                 ack.newly_acked_, us(now));
+            if (ack.bundle_len_ != 0) {
+                delivered += ack.bundle_len_;
+                --inflight;
+            }
+            acks.erase(acks.begin());
+        }
+
+        // send while there is room in the socket buffer
+        bool blocked = false;
+        while (true) {
+            if (!sending) {
+                bool open = adaptive ?
+                            window.open(inflight, max_inflight, max_inflight_bytes) :
+                            (inflight < max_inflight);
+                if (!open) {
+                    break;
+                }
+                sending = true;
+                sent    = 0;
+                segs.clear();
+                ++next_id;
+                ++inflight;
+            }
+
+            if ((link_free - now) * rate > sockbuf_len) {
+                blocked = true;
+                break;
+            }
+
+            uint64_t max_len = adaptive ? window.segment_length(segment_length) :
+                                          segment_length;
+            uint64_t len  = std::min(max_len, bundle_len - sent);
+            bool     last = (sent + len == bundle_len);
+            uint64_t wire = len + 18;
+            if (sent == 0) {
+                wire += last ? 4 : 4 + 13;
+            }
+
+            link_free = std::max(now, link_free) + wire / rate;
+            window.segment_sent(next_id, sent + len, len, us(now));
+            sent += len;
+            segs.push_back(std::make_pair(sent, len));
+            ++num_segments;
+            segment_bytes += len;
+
+            if (last) {
+                // the receiver acks each segment once it has the bundle
+                double ack_time = link_free + 2 * delay;
+                for (size_t i = 0; i < segs.size(); ++i) {
+                    Ack ack;
+                    ack.transfer_id_ = next_id;
+                    ack.acked_len_   = segs[i].first;
+                    ack.newly_acked_ = segs[i].second;
+                    ack.bundle_len_  = (i == segs.size() - 1) ? bundle_len : 0;
+                    acks.insert(std::make_pair(ack_time, ack));
+                }
+                sending = false;
+            }
+        }
+
+        inflight_sum += inflight;
+        ++inflight_samples;
+
+        // on to the next ack or the socket buffer draining
+        double next = acks.empty() ? duration : acks.begin()->first;
+        if (blocked) {
+            next = std::min(next, link_free - sockbuf_len / rate);
+        }
+        now = std::max(next, now + 1e-6);
+    }
+
+    printf("%-10s %-9s %10.1f Mbit/s %10.0f bundles/s %10.0f avg inflight %12.0f avg segment\n",
+           name, adaptive ? "adaptive" : "fixed",
+           delivered * 8 / now / 1e6, (delivered / (double)bundle_len) / now,
+           inflight_sum / inflight_samples,
+           (double)segment_bytes / std::max(num_segments, (uint64_t)1));
+    fflush(stdout);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    oasys::Getopt opts;
+
+    opts.addopt(new oasys::DoubleOpt('r', "rtt", &rtt_ms, "<ms>",
+                                     "round trip time (default 100)"));
+    opts.addopt(new oasys::DoubleOpt('b', "rate", &rate_mbps, "<Mbit/s>",
+                                     "bottleneck rate (default 1000)"));
+    opts.addopt(new oasys::DoubleOpt('d', "duration", &duration, "<secs>",
+                                     "simulated seconds per run (default 30)"));
+    opts.addopt(new oasys::UIntOpt('i', "max_inflight_bundles", &max_inflight, "<n>",
+                                   "max_inflight_bundles link param (default 100)"));
+    opts.addopt(new oasys::UInt64Opt('s', "segment_length", &segment_length, "<bytes>",
+                                     "segment_length link param (default 10000000)"));
+
+    int remainder = opts.getopt(argv[0], argc, argv);
+    if (remainder != argc || rtt_ms <= 0 || rate_mbps <= 0 || duration <= 0 ||
+        max_inflight == 0 || segment_length == 0)
+    {
+        opts.usage(argv[0]);
+        exit(1);
+    }
+
+    printf("%.0f ms rtt, %.0f Mbit/s path, max_inflight_bundles %u, segment_length %" PRIu64 "\n",
+           rtt_ms, rate_mbps, max_inflight, segment_length);
+    fflush(stdout);
+
+    run("1 KB", 1000, false);
+    run("1 KB", 1000, true);
+    run("100 MB", 100000000, false);
+    run("100 MB", 100000000, true);
+
+    return 0;
+}
@@ -0,0 +1,332 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+/*
+ * Benchmark of the UDP convergence layer's socket I/O at small bundle
+ * sizes: one sendmsg()/recvfrom() per datagram as the CL used to do
+ * versus the sendmmsg()/recvmmsg() batches it does now.
+ *
+ * A receiver thread set up like UDPConvergenceLayer::Receiver (an
+ * oasys UDPClient with a notifier, so every call polls first) drains a
+ * loopback socket while the main thread sends to it as fast as it can
+ * the way UDPConvergenceLayer::Sender does. Each run reports the
+ * datagrams sent and received per second and the cpu time per
+ * datagram received.
+ *
+ * A last run sends the batch as UDP GSO super-packets and receives
+ * with UDP_GRO as LTPUDPConvergenceLayer does for its segment bursts,
+ * counting each segment as a datagram. Pick a size like an LTP
+ * segment's (-s 1400) for that one to be meaningful.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <vector>
+
+#include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/io/UDPClient.h>
+#include <third_party/oasys/thread/Notifier.h>
+#include <third_party/oasys/thread/Thread.h>
+#include <third_party/oasys/util/Getopt.h>
+#include <third_party/oasys/util/Time.h>
+
+#ifndef UDP_SEGMENT
+#  define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#  define UDP_GRO 104
+#endif
+
+namespace {
+
+u_int     batch      = 32;
+u_int     msg_len    = 100;
+double    duration   = 5.0;
+u_int16_t port       = 14556;
+
+//----------------------------------------------------------------------
+/**
+ * Receiving side, draining the socket in batches of the given size
+ * (1 for a recvfrom() per datagram), optionally with UDP_GRO.
+ */
+class Receiver : public oasys::UDPClient,
+                 public oasys::Thread
+{
+public:
+    Receiver(u_int batch, bool gro)
+        : IOHandlerBase(new oasys::Notifier("/dtnme_udp_batch_bench/rcvr")),
+          UDPClient("/dtnme_udp_batch_bench/rcvr"),
+          Thread("Receiver"),
+          batch_(batch),
+          gro_(gro),
+          received_(0)
+    {
+        logfd_ = false;
+        params_.recv_bufsize_ = 8 * 1024 * 1024;
+    }
+
+    uint64_t received() const { return received_; }
+
+protected:
+    void run() override
+    {
+        std::unique_ptr<u_char[]> bufs(new u_char[batch_ * MAX_UDP_PACKET]);
+        std::vector<struct iovec> iovs(batch_);
+        std::vector<struct mmsghdr> msgs(batch_);
+
+        size_t cmsg_space = CMSG_SPACE(sizeof(int));
+        std::vector<char> cmsgs(batch_ * cmsg_space);
+
+        if (gro_) {
+            int one = 1;
+            if (::setsockopt(fd_, SOL_UDP, UDP_GRO, &one, sizeof(one)) != 0) {
+                fprintf(stderr, "error enabling UDP_GRO: %s\n", strerror(errno));
+                exit(1);
+            }
+        }
+
+        for (u_int i = 0; i < batch_; ++i) {
+            iovs[i].iov_base = bufs.get() + (i * MAX_UDP_PACKET);
+            iovs[i].iov_len  = MAX_UDP_PACKET;
+
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov    = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        in_addr_t addr;
+        u_int16_t port;
+
+        while (!should_stop()) {
+            int ret;
+            if (batch_ == 1) {
+                ret = recvfrom((char*)bufs.get(), MAX_UDP_PACKET, 0, &addr, &port);
+            } else {
+                if (gro_) {
+                    for (u_int i = 0; i < batch_; ++i) {
+                        msgs[i].msg_hdr.msg_control    = &cmsgs[i * cmsg_space];
+                        msgs[i].msg_hdr.msg_controllen = cmsg_space;
+                    }
+                }
+                ret = recvmmsg(msgs.data(), batch_, MSG_WAITFORONE);
+            }
+
+            if (ret <= 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            if (!gro_) {
+                received_ += (batch_ == 1) ? 1 : ret;
+                continue;
+            }
+
+            // a coalesced datagram says the size of the segments in it
+            for (int i = 0; i < ret; ++i) {
+                size_t len    = msgs[i].msg_len;
+                size_t seglen = len;
+                struct msghdr* msg = &msgs[i].msg_hdr;
+                for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg != nullptr;
+                     cmsg = CMSG_NXTHDR(msg, cmsg))
+                {
+                    if ((cmsg->cmsg_level == SOL_UDP) && (cmsg->cmsg_type == UDP_GRO)) {
+                        int gso_size;
+                        memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                        seglen = gso_size;
+                    }
+                }
+                received_ += (len + seglen - 1) / std::max(seglen, (size_t)1);
+            }
+        }
+    }
+
+    u_int                 batch_;
+    bool                  gro_;
+    std::atomic<uint64_t> received_;
+};
+
+//----------------------------------------------------------------------
+double
+cpu_seconds()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+//----------------------------------------------------------------------
+void
+run(u_int batch, bool gso = false)
+{
+    Receiver* receiver = new Receiver(batch, gso);
+    if (receiver->bind(htonl(INADDR_LOOPBACK), port) != 0) {
+        fprintf(stderr, "error binding to port %u\n", port);
+        exit(1);
+    }
+    receiver->start();
+
+    oasys::UDPClient socket("/dtnme_udp_batch_bench/sender");
+    socket.set_logfd(false);
+    socket.init_socket();
+
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port        = htons(port);
+
+    std::vector<u_char> payload(msg_len, 'b');
+    std::vector<struct iovec> iovs(batch);
+    std::vector<struct mmsghdr> msgs(batch);
+
+    // one super-packet of as many segments as fit in a datagram
+    u_int gso_segs = std::min(batch, 65507 / msg_len);
+    char gso_cmsg[CMSG_SPACE(sizeof(uint16_t))];
+    memset(gso_cmsg, 0, sizeof(gso_cmsg));
+
+    for (u_int i = 0; i < batch; ++i) {
+        iovs[i].iov_base = payload.data();
+        iovs[i].iov_len  = msg_len;
+
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name    = &sa;
+        msgs[i].msg_hdr.msg_namelen = sizeof(sa);
+        msgs[i].msg_hdr.msg_iov     = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+
+    if (gso) {
+        msgs[0].msg_hdr.msg_iovlen     = gso_segs;
+        msgs[0].msg_hdr.msg_control    = gso_cmsg;
+        msgs[0].msg_hdr.msg_controllen = sizeof(gso_cmsg);
+
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[0].msg_hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type  = UDP_SEGMENT;
+        cmsg->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+        uint16_t gso_size = msg_len;
+        memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+    }
+
+    uint64_t sent = 0;
+    uint64_t rcvd_start = receiver->received();
+    double   cpu_start  = cpu_seconds();
+    oasys::Time start;
+    start.get_time();
+
+    while (start.elapsed_ms() < duration * 1000) {
+        // check the clock every so often rather than every send
+        for (u_int n = 0; n < 1000; n += batch) {
+            int cc;
+            if (gso) {
+                cc = socket.sendmsg(&msgs[0].msg_hdr, 0);
+                cc = (cc == (int)(gso_segs * msg_len)) ? gso_segs : -1;
+            } else if (batch == 1) {
+                cc = socket.sendmsg(&msgs[0].msg_hdr, 0);
+                cc = (cc == (int)msg_len) ? 1 : -1;
+            } else {
+                cc = socket.sendmmsg(msgs.data(), batch, 0);
+            }
+
+            if (cc < 0) {
+                if (errno == ENOBUFS || errno == EAGAIN) {
+                    continue;
+                }
+                fprintf(stderr, "error sending: %s\n", strerror(errno));
+                exit(1);
+            }
+            sent += cc;
+        }
+    }
+
+    double   elapsed = start.elapsed_us() / 1e6;
+    uint64_t rcvd    = receiver->received() - rcvd_start;
+    double   cpu     = cpu_seconds() - cpu_start;
+
+    receiver->set_should_stop();
+    receiver->interrupt_from_io();
+    while (!receiver->is_stopped()) {
+        oasys::Thread::yield();
+    }
+    delete receiver;
+
+    char name[32];
+    if (gso) {
+        snprintf(name, sizeof(name), "gso of %u", gso_segs);
+    } else if (batch == 1) {
+        snprintf(name, sizeof(name), "per datagram");
+    } else {
+        snprintf(name, sizeof(name), "batch of %u", batch);
+    }
+
+    printf("%-14s %10.0f sent/s %10.0f received/s %8.2f us cpu/received\n",
+           name, sent / elapsed, rcvd / elapsed, cpu * 1e6 / std::max(rcvd, (uint64_t)1));
+    fflush(stdout);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    oasys::Getopt opts;
+
+    opts.addopt(new oasys::UIntOpt('b', "batch", &batch, "<n>",
+                                   "datagrams per batched call (default 32)"));
+    opts.addopt(new oasys::UIntOpt('s', "size", &msg_len, "<bytes>",
+                                   "datagram length (default 100)"));
+    opts.addopt(new oasys::DoubleOpt('d', "duration", &duration, "<secs>",
+                                     "seconds to measure each run (default 5)"));
+    opts.addopt(new oasys::UInt16Opt('p', "port", &port, "<port>",
+                                     "loopback port to use (default 14556)"));
+
+    int remainder = opts.getopt(argv[0], argc, argv);
+    if (remainder != argc || batch < 2 || batch > 1024 ||
+        msg_len == 0 || msg_len > 65507 || duration <= 0)
+    {
+        opts.usage(argv[0]);
+        exit(1);
+    }
+
+    oasys::Log::init(oasys::LOG_WARN);
+
+    printf("%u byte datagrams over loopback\n", msg_len);
+    fflush(stdout);
+
+    run(1);
+    run(batch);
+    run(batch, true);
+
+    return 0;
+}
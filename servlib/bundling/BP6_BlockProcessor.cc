@@ -134,8 +134,7 @@ BP6_BlockProcessor::consume_preamble(BlockInfoVec* recv_blocks,
     //
     // We assert that the whole incoming buffer was consumed.
     u_int64_t eid_ref_count = 0LLU;
-    u_int64_t scheme_offset;
-    u_int64_t ssp_offset;
+    u_int64_t offsets[2]; // scheme and ssp
     
     ASSERT(block->eid_list().empty());
     EndpointIDVector eid_list;
@@ -154,19 +153,9 @@ BP6_BlockProcessor::consume_preamble(BlockInfoVec* recv_blocks,
             
         for ( u_int32_t i = 0; i < eid_ref_count; ++i ) {
             // Now we try decoding the sdnv pair with the offsets
-            sdnv_len = SDNV::decode(contents->buf() + buf_offset,
-                                    contents->len() - buf_offset,
-                                    &scheme_offset);
-            if (sdnv_len == -1) {
-                if (tocopy != len) return -1;
-
-                return len;
-            }
-            buf_offset += sdnv_len;
-                    
-            sdnv_len = SDNV::decode(contents->buf() + buf_offset,
-                                    contents->len() - buf_offset,
-                                    &ssp_offset);
+            sdnv_len = SDNV::decode_n(contents->buf() + buf_offset,
+                                      contents->len() - buf_offset,
+                                      offsets, 2);
             if (sdnv_len == -1) {
                 if (tocopy != len) return -1;
                 return len;
@@ -174,7 +163,7 @@ BP6_BlockProcessor::consume_preamble(BlockInfoVec* recv_blocks,
             buf_offset += sdnv_len;
                 
             SPtr_EID sptr_eid;
-            dict->extract_eid(sptr_eid, scheme_offset, ssp_offset);
+            dict->extract_eid(sptr_eid, offsets[0], offsets[1]);
             eid_list.push_back(sptr_eid);
         }
     }
@@ -38,6 +38,8 @@
 
 #include "BP6_PayloadBlockProcessor.h"
 #include "Bundle.h"
+#include "BundleDaemonStorage.h"
+#include "BundleIOVec.h"
 #include "BundleProtocol.h"
 #include "PayloadBlockProcessorHelper.h"
 
@@ -121,6 +123,10 @@ BP6_PayloadBlockProcessor::consume(Bundle*    bundle,
         tocopy = len;
     }
 
+    if (rcvd == 0) {
+        bundle->mutable_payload()->preallocate(block->data_length());
+    }
+
     bundle->mutable_payload()->set_length(rcvd + tocopy);
     bundle->mutable_payload()->write_data(buf, rcvd, tocopy);
 
@@ -212,17 +218,25 @@ BP6_PayloadBlockProcessor::produce(const Bundle*    bundle,
 {
     PayloadBlockProcessorHelper* helper = nullptr;
 
-    // check to see if a working buffer would improve disk I/O performance
+    // check to see if a read view or a working buffer would improve disk I/O performance
     if ((offset == 0) && (block->locals() == nullptr)) {
         if (bundle->payload().length() > len) {
-            size_t alloc_len = bundle->payload().length();
-            if (alloc_len > 10000000) {
-                alloc_len = 10000000;
+            helper = new PayloadBlockProcessorHelper(0);
+
+            // prefer borrowing the payload bytes directly from the file
+            // mapping (or memory buffer) over reading them into the work buffer
+            if (!BundleDaemonStorage::params_.payload_read_views_ ||
+                !bundle->payload().get_read_view(0, bundle->payload().length(), &helper->view_))
+            {
+                size_t alloc_len = bundle->payload().length();
+                if (alloc_len > 10000000) {
+                    alloc_len = 10000000;
+                }
+
+                helper->work_buf_.set_size(alloc_len);
             }
 
-            helper = new PayloadBlockProcessorHelper(alloc_len);
-
-            // save a reference to the working buffer on the blocks so we can
+            // save a reference to the helper on the blocks so we can
             // keep using it each time this method is called
             (const_cast<BlockInfo*>(block))->set_locals(helper);
         }
@@ -247,7 +261,15 @@ BP6_PayloadBlockProcessor::produce(const Bundle*    bundle,
 
     size_t tocopy = std::min(len, bundle->payload().length() - payload_offset);
 
-    if (helper != nullptr) {
+    if ((helper != nullptr) && helper->view_.valid()) {
+        // copy straight out of the borrowed view
+        memcpy(buf, helper->view_.buf() + payload_offset, tocopy);
+
+        if ((payload_offset + tocopy) == bundle->payload().length()) {
+            // finished with the payload so the helper and its view can be released
+            (const_cast<BlockInfo*>(block))->set_locals(nullptr);
+        }
+    } else if (helper != nullptr) {
         // already have enough data in the work buf?
         if (helper->work_buf_.fullbytes() >= tocopy) {
             //copy the requested amount of data
@@ -304,6 +326,59 @@ BP6_PayloadBlockProcessor::produce(const Bundle*    bundle,
     return;
 }
 
+//----------------------------------------------------------------------
+void
+BP6_PayloadBlockProcessor::produce_iov(const Bundle*    bundle,
+                                       const BlockInfo* block,
+                                       size_t           offset,
+                                       size_t           len,
+                                       BundleIOVec*     iov)
+{
+    // the preamble comes straight out of the contents buffer
+    if (offset < block->data_offset()) {
+        size_t tocopy = std::min(len, block->data_offset() - offset);
+        iov->append(block->contents().buf() + offset, tocopy);
+        offset += tocopy;
+        len    -= tocopy;
+    }
+
+    if (len == 0)
+        return;
+
+    size_t payload_offset = offset - block->data_offset();
+
+    // set up a view of the whole payload the first time through and
+    // keep it on the block for the following calls as produce() does
+    PayloadBlockProcessorHelper* helper = nullptr;
+    if (block->locals() != nullptr) {
+        helper = dynamic_cast<PayloadBlockProcessorHelper*>(block->locals());  // could be nullptr
+    } else if (BundleDaemonStorage::params_.payload_read_views_) {
+        helper = new PayloadBlockProcessorHelper(0);
+        if (bundle->payload().get_read_view(0, bundle->payload().length(), &helper->view_)) {
+            (const_cast<BlockInfo*>(block))->set_locals(helper);
+        } else {
+            delete helper;
+            helper = nullptr;
+        }
+    }
+
+    if ((helper == nullptr) || !helper->view_.valid()) {
+        // no view so copy the range into a buffer owned by the list
+        produce(bundle, block, iov->append_copy(len), offset, len);
+        return;
+    }
+
+    // the list keeps its own reference to the helper so the view stays
+    // mapped (and its file open) after the block lets go of it below
+    int fd = iov->use_files() ? helper->view_.file_fd() : -1;
+    iov->append_file(helper->view_.buf() + payload_offset, len,
+                     fd, payload_offset, helper);
+
+    if ((payload_offset + len) == bundle->payload().length()) {
+        (const_cast<BlockInfo*>(block))->set_locals(nullptr);
+    }
+}
+
 //----------------------------------------------------------------------
 void
 BP6_PayloadBlockProcessor::process(process_func*    func,
@@ -53,6 +53,12 @@ public:
                  size_t           offset,
                  size_t           len) override;
 
+    void produce_iov(const Bundle*    bundle,
+                     const BlockInfo* block,
+                     size_t           offset,
+                     size_t           len,
+                     BundleIOVec*     iov) override;
+
     void process(process_func*    func,
                  const Bundle*    bundle,
                  const BlockInfo* caller_block,
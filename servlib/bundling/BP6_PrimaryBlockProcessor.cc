@@ -378,6 +378,7 @@ BP6_PrimaryBlockProcessor::consume(Bundle*    bundle,
     static const char* log = "/dtn/bundle/protocol";
     ssize_t consumed = 0;
     PrimaryBlock primary;
+    u_int64_t fields[12];
     
     ASSERT(! block->complete());
     
@@ -449,19 +450,27 @@ BP6_PrimaryBlockProcessor::consume(Bundle*    bundle,
     // field advertised.
     ASSERT(len == block->data_length());
     
-    // Read the various SDNVs up to the start of the dictionary.
-    PBP_READ_SDNV(&primary.dest_scheme_offset);
-    PBP_READ_SDNV(&primary.dest_ssp_offset);
-    PBP_READ_SDNV(&primary.source_scheme_offset);
-    PBP_READ_SDNV(&primary.source_ssp_offset);
-    PBP_READ_SDNV(&primary.replyto_scheme_offset);
-    PBP_READ_SDNV(&primary.replyto_ssp_offset);
-    PBP_READ_SDNV(&primary.custodian_scheme_offset);
-    PBP_READ_SDNV(&primary.custodian_ssp_offset);
-    PBP_READ_SDNV(&primary.creation_time);
-    PBP_READ_SDNV(&primary.creation_sequence);
-    PBP_READ_SDNV(&primary.lifetime);
-    PBP_READ_SDNV(&primary.dictionary_length);
+    // Read the twelve SDNVs up to the start of the dictionary in one pass.
+    {
+        int sdnv_len = SDNV::decode_n(buf, len, fields, 12);
+        if (sdnv_len < 0)
+            goto tooshort;
+        buf += sdnv_len;
+        len -= sdnv_len;
+    }
+
+    primary.dest_scheme_offset      = fields[0];
+    primary.dest_ssp_offset         = fields[1];
+    primary.source_scheme_offset    = fields[2];
+    primary.source_ssp_offset       = fields[3];
+    primary.replyto_scheme_offset   = fields[4];
+    primary.replyto_ssp_offset      = fields[5];
+    primary.custodian_scheme_offset = fields[6];
+    primary.custodian_ssp_offset    = fields[7];
+    primary.creation_time           = fields[8];
+    primary.creation_sequence       = fields[9];
+    primary.lifetime                = fields[10];
+    primary.dictionary_length       = fields[11];
     
 //    bundle->set_creation_ts(BundleTimestamp(primary.creation_time,
 //                                            primary.creation_sequence));
@@ -36,7 +36,11 @@
 #  include <dtn-config.h>
 #endif
 
+#include <algorithm>
+
 #include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/util/CRC16.h>
+#include <third_party/oasys/util/CRC32C.h>
 
 #include "BP7_BlockProcessor.h"
 #include "BlockInfo.h"
@@ -126,6 +130,70 @@ BP7_BlockProcessor::consume(Bundle*    bundle,
     return BP_FAIL;
 }
 
+//----------------------------------------------------------------------
+ssize_t
+BP7_BlockProcessor::accumulate_cbor(BlockInfo* block,
+                                    u_char*    buf,
+                                    size_t     len,
+                                    bool*      have_all)
+{
+    CborItemScanner* scanner = block->scanner();
+
+    size_t consumed = 0;
+    CborItemScanner::status_t status = scanner->scan(buf, len, &consumed);
+    if (status == CborItemScanner::SCAN_ERROR)
+    {
+        log_err_p(log_path(), "BP7 decode error: %s - malformed CBOR after %" PRIu64 " bytes",
+                  block_name(), scanner->scanned());
+        return BP_FAIL;
+    }
+
+    // grow the contents by doubling rather than by the size of each read
+    BlockInfo::DataBuffer* contents = block->writable_contents();
+    size_t need = contents->len() + consumed;
+    if (need > contents->buf_len()) {
+        contents->reserve(std::max(need, contents->buf_len() * 2));
+    }
+    memcpy(contents->end(), buf, consumed);
+    contents->set_len(need);
+
+    *have_all = (status != CborItemScanner::SCAN_NEED_MORE);
+    return consumed;
+}
+
+//----------------------------------------------------------------------
+ssize_t
+BP7_BlockProcessor::consume_canonical_block(Bundle*    bundle,
+                                            BlockInfo* block,
+                                            u_char*    buf,
+                                            size_t     len)
+{
+    ASSERT(! block->complete());
+
+    bool have_all = false;
+    ssize_t consumed = accumulate_cbor(block, buf, len, &have_all);
+    if (consumed < 0 || !have_all)
+    {
+        return consumed;
+    }
+
+    // decode the block now that all of it is in the contents
+    BlockInfo::DataBuffer* contents = block->writable_contents();
+    int64_t block_len = decode_canonical_block(block, (uint8_t*) contents->buf(), contents->len());
+
+    if (block_len != (int64_t) contents->len())
+    {
+        log_err_p(log_path(), "BP7 decode error: %s - error decoding block of %zu bytes (status = %" PRIi64 ")",
+                  block_name(), contents->len(), block_len);
+        return BP_FAIL;
+    }
+
+    block->set_complete(true);
+    bundle->set_highest_rcvd_block_number(block->block_number());
+
+    return consumed;
+}
+
 //----------------------------------------------------------------------
 bool
 BP7_BlockProcessor::validate(const Bundle*           bundle,
@@ -327,110 +395,17 @@ BP7_BlockProcessor::init_block(BlockInfo*    block,
 uint16_t
 BP7_BlockProcessor::crc16(const unsigned char* data, size_t size, uint16_t crc_in)
 {
-    // CRC_16/ISO-HDLC checksum
-    #define CRC16_ISO_HDLC_POLYNOMIAL 0x8408
-
-    // first call should use crc = 0; subsequent calls use previously returned crc
-    uint16_t crc = ~crc_in;
-
-    while (size--) 
-    { 
-        crc ^= *data++; 
-        for (unsigned k = 0; k < 8; k++)
-        {
-            crc = crc & 0x0001 ? (crc >> 1) ^ CRC16_ISO_HDLC_POLYNOMIAL : crc >> 1; 
-        }
-    }
-    
-    return ~crc;   // XOR with 0xffff
-}
-
-
-/***********************************************************************************************************/
-/* CRC32C implementation adapted from Mark Adler's source code published at:                               */
-/*                                                                                                         */
-/* https://stackoverflow.com/questions/17645167/implementing-sse-4-2s-crc32c-in-software/17646775#17646775 */
-/*                                                                                                         */
-/***********************************************************************************************************/
-
-/* CRC-32C (iSCSI) polynomial in reversed bit order. */
-#define POLY 0x82f63b78
-
-/* Table for a quadword-at-a-time software crc. */
-//static pthread_once_t crc32c_once_sw = PTHREAD_ONCE_INIT;
-uint32_t BP7_BlockProcessor::crc32c_table[8][256];
-bool BP7_BlockProcessor::crc_initialized_ = false;
-
-//----------------------------------------------------------------------
-/* Construct table for software CRC-32C calculation. */
-void
-BP7_BlockProcessor::crc32c_init_sw(void)
-{
-    uint32_t n, crc, k;
-
-    for (n = 0; n < 256; n++) {
-        crc = n;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc32c_table[0][n] = crc;
-    }
-    for (n = 0; n < 256; n++) {
-        crc = crc32c_table[0][n];
-        for (k = 1; k < 8; k++) {
-            crc = crc32c_table[0][crc & 0xff] ^ (crc >> 8);
-            crc32c_table[k][n] = crc;
-        }
-    }
+    // CRC-16/X.25 (ISO-HDLC); first call should use crc_in = 0 and
+    // subsequent calls the previously returned crc
+    return oasys::CRC16::extend(crc_in, data, size);
 }
 
-
 //----------------------------------------------------------------------
-/* Table-driven software version as a fall-back.  This is about 15 times slower
-   than using the hardware instructions.  This assumes little-endian integers,
-   as is the case on Intel processors that the assembler code here is for. */
 uint32_t
-BP7_BlockProcessor::crc32c_sw(uint32_t crci, const unsigned char* buf, size_t len)
+BP7_BlockProcessor::crc32c(uint32_t crci, const unsigned char* buf, size_t len)
 {
-    const unsigned char *next = buf;
-    size_t crc;
-    size_t next_qword;
-
-    //pthread_once(&crc32c_once_sw, crc32c_init_sw);
-    if ( !crc_initialized_ ) {
-        crc32c_init_sw();
-        crc_initialized_ = true;
-    }
-
-    crc = crci ^ 0xffffffff;
-    while (len && ((uintptr_t)next & 7) != 0) {
-        crc = crc32c_table[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
-        len--;
-    }
-    while (len >= 8) {
-        memcpy(&next_qword, next, 8);
-        crc ^= next_qword;
-        crc = crc32c_table[7][crc & 0xff] ^
-              crc32c_table[6][(crc >> 8) & 0xff] ^
-              crc32c_table[5][(crc >> 16) & 0xff] ^
-              crc32c_table[4][(crc >> 24) & 0xff] ^
-              crc32c_table[3][(crc >> 32) & 0xff] ^
-              crc32c_table[2][(crc >> 40) & 0xff] ^
-              crc32c_table[1][(crc >> 48) & 0xff] ^
-              crc32c_table[0][crc >> 56];
-        next += 8;
-        len -= 8;
-    }
-    while (len) {
-        crc = crc32c_table[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
-        len--;
-    }
-    return (uint32_t)crc ^ 0xffffffff;
+    // uses the SSE4.2 or ARMv8 crc32c instructions when available
+    return oasys::CRC32C::extend(crci, buf, len);
 }
 
 
@@ -636,7 +611,7 @@ BP7_BlockProcessor::encode_crc(CborEncoder& blockArrayEncoder, uint32_t crc_type
                     // calculate the CRC on the CBOR data
                     size_t block_cbor_length = dummyEncoder.data.ptr - block_first_cbor_byte;
                     uint32_t crc = 0;
-                    crc = crc32c_sw(crc, block_first_cbor_byte, block_cbor_length);
+                    crc = crc32c(crc, block_first_cbor_byte, block_cbor_length);
 
 
                     // convert CRC to network byte order
@@ -1484,7 +1459,7 @@ BP7_BlockProcessor::decode_crc_and_validate(CborValue& cvElement, size_t crc_typ
         memset((void*) crc_first_cbor_data_byte, 0, 4);
 
         uint32_t calc_crc = 0;
-        calc_crc = crc32c_sw(calc_crc, block_first_cbor_byte, block_cbor_length);
+        calc_crc = crc32c(calc_crc, block_first_cbor_byte, block_cbor_length);
 
         validated = (calc_crc == crc);
 
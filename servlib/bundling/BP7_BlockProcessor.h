@@ -301,17 +301,11 @@ protected:
                            u_int64_t     data_length) override;
 
 
-    /***********************************************************************************************************/
-    /* CRC32C implementation adapted from Mark Adler's source code published at:                               */
-    /*                                                                                                         */
-    /* https://stackoverflow.com/questions/17645167/implementing-sse-4-2s-crc32c-in-software/17646775#17646775 */
-    /*                                                                                                         */
-    /***********************************************************************************************************/
-    static uint32_t crc32c_table[8][256];
-    static bool crc_initialized_;
-    static void crc32c_init_sw(void);
-
-    virtual uint32_t crc32c_sw(uint32_t crci, const unsigned char* buf, size_t len);
+    /**
+     * CRC calculations for the BPv7 CRC types 1 and 2 which extend a
+     * previously returned crc (start with 0).
+     */
+    virtual uint32_t crc32c(uint32_t crci, const unsigned char* buf, size_t len);
     virtual uint16_t crc16(const unsigned char* data, size_t size, uint16_t crc_in=0);
 
 
@@ -350,6 +344,26 @@ protected:
      */
     virtual int64_t decode_canonical_block(BlockInfo* block, uint8_t*  buf, size_t buflen);
 
+    /**
+     * Append the bytes of a block that arrive in buf to its contents,
+     * scanning the CBOR with the block's CborItemScanner so that a
+     * block split across many reads is neither copied to a temporary
+     * buffer nor reparsed from the start on each one.
+     *
+     * @return the number of bytes that belong to the block or BP_FAIL,
+     *         with have_all set once the contents hold all of the block
+     *         (or the header up to the string the scanner stopped at)
+     */
+    virtual ssize_t accumulate_cbor(BlockInfo* block, u_char* buf, size_t len,
+                                    bool* have_all);
+
+    /**
+     * Consume routine for canonical blocks which decodes the block with
+     * decode_canonical_block() once all of its bytes have arrived.
+     */
+    virtual ssize_t consume_canonical_block(Bundle* bundle, BlockInfo* block,
+                                            u_char* buf, size_t len);
+
     //----------------------------------------------------------------------
     // this is a wrapper around cbor_value_get_string_length() which provide an
     // error indication if there is not enough data available to extract the length!
@@ -87,99 +87,7 @@ BP7_IMCDestinationsBlockProcessor::consume(Bundle*    bundle,
                                    u_char*    buf,
                                    size_t     len)
 {
-    (void) bundle;
-
-    ssize_t consumed = 0;
-
-    ASSERT(! block->complete());
-
-    int64_t block_len;
-    size_t prev_consumed = block->contents().len();
-
-    if (prev_consumed == 0)
-    {
-        // try to decode the block from the received data
-        block_len = decode_canonical_block(block, (uint8_t*) buf, len);
-
-        if (block_len == BP_FAIL)
-        {
-            // protocol error - abort
-            consumed = BP_FAIL;
-        }
-        else if (block_len == BP7_UNEXPECTED_EOF)
-        {
-            // not enough data received yet
-            // - store this chunk in the block contents and wait for more
-            BlockInfo::DataBuffer* contents = block->writable_contents();
-            contents->reserve(contents->len() + len);
-            memcpy(contents->end(), buf, len);
-            contents->set_len(contents->len() + len);
-            consumed = len;
-        }
-        else
-        {
-            // got the entire block in this first chunk of data
-            BlockInfo::DataBuffer* contents = block->writable_contents();
-            contents->reserve(block_len);
-            memcpy(contents->end(), buf, block_len);
-            contents->set_len(block_len);
-
-            block->set_complete(true);
-            bundle->set_highest_rcvd_block_number(block->block_number());
-
-            consumed = block_len;
-        }
-    }
-    else
-    {
-        // combine the previous data with the new data and 
-        // try again to decode the block
-
-        // instead of adding all of the new data to the contents
-        // using a temp buffer and then only adding the needed
-        // bybtes to the contents
-
-        BlockInfo::DataBuffer* contents = block->writable_contents();
-
-        size_t combined_size = prev_consumed + len;
-        u_char* temp_buf = (u_char*) malloc(combined_size);
-
-        memcpy(temp_buf, contents->buf(), prev_consumed);
-        memcpy(temp_buf + prev_consumed, buf, len);
-
-        // try to decode the block 
-        block_len = decode_canonical_block(block, (uint8_t*) temp_buf, combined_size);
-
-        free(temp_buf);
-
-        if (block_len == BP_FAIL)
-        {
-            // protocol error - abort
-            consumed = BP_FAIL;
-        }
-        else if (block_len == BP7_UNEXPECTED_EOF)
-        {
-            // not enogh data received yet
-            // - store this chunk in the block contents and wait for more
-            contents->reserve(contents->len() + len);
-            memcpy(contents->end(), buf, len);
-            contents->set_len(contents->len() + len);
-            consumed = len;
-        }
-        else
-        {
-            // we now have the entire block
-            contents->reserve(block_len);
-            memcpy(contents->end(), buf, block_len - prev_consumed);
-            contents->set_len(block_len);
-
-            block->set_complete(true);
-            bundle->set_highest_rcvd_block_number(block->block_number());
-
-            consumed = block_len - prev_consumed;
-        }
-
-    }
+    ssize_t consumed = consume_canonical_block(bundle, block, buf, len);
 
     if (block->complete())
     {
@@ -38,6 +38,8 @@
 
 #include "BP7_PayloadBlockProcessor.h"
 #include "Bundle.h"
+#include "BundleDaemonStorage.h"
+#include "BundleIOVec.h"
 #include "BundleProtocol.h"
 #include "BundleProtocolVersion7.h"
 #include "PayloadBlockProcessorHelper.h"
@@ -209,149 +211,50 @@ BP7_PayloadBlockProcessor::consume(Bundle*    bundle,
 
     if (block->data_offset() == 0)
     {
-        size_t prev_consumed = block->contents().len();
-
-        if (prev_consumed == 0)
+        if (block->contents().len() == 0)
         {
-
-            //log_always_p(log_path(), "BP7_PayloadBlockProcessor::consume - first CBOR charater: %02x", buf[0]);
-
-            // try to decode the header info from the received data
-            block_hdr_len = decode_payload_header(block, (uint8_t*) buf, len, payload_len);
-
-            if (block_hdr_len == BP_FAIL)
-            {
-                // protocol error - abort
-                return BP_FAIL;
-            }
-            else if (block_hdr_len == BP7_UNEXPECTED_EOF)
-            {
-                // not enogh data received yet
-                // - store this chunk in the block contents and wait for more
-                BlockInfo::DataBuffer* contents = block->writable_contents();
-                contents->reserve(contents->len() + len);
-                memcpy(contents->end(), buf, len);
-                contents->set_len(contents->len() + len);
-                consumed = len;
-
-                //dzdebug
-                //log_always_p(log_path(), "BP7_Payload.consume (Bundle %s) - not enough data (len = %zu) - buf: %2.2x contents: %2.2x",
-                //                         bundle->gbofid_str().c_str(), len, buf[0], block->contents().buf()[0]);
-            }
-            else
-            {
-                // got the entire header info in this first chunk of data
-                BlockInfo::DataBuffer* contents = block->writable_contents();
-                contents->reserve(block_hdr_len);
-                memcpy(contents->end(), buf, block_hdr_len);
-                contents->set_len(block_hdr_len);
-
-                block->set_data_offset(block_hdr_len);
-                block->set_data_length(payload_len);
-
-                block->set_crc_offset(block_hdr_len + payload_len);
-                switch (block->crc_type()) {
-                    case 0: block->set_crc_length(0);
-                       break;
-                    case 1: block->set_crc_length(3); // CRC16 = 2 bytes + 1 CBOR header byte
-                       break;
-                    case 2: block->set_crc_length(5); // CRC32c = 4 bytes + 1 CBOR header byte
-                       break;
-                }
-
-                // Payload block is always last block of bundle 
-                // so we will let it consume the extra CBOR break character that must follow it
-                block->set_bpv7_EOB_offset(block_hdr_len + payload_len + block->crc_length());
-
-                consumed = block_hdr_len;
-
-
-                //oasys::HexDumpBuffer hex;
-                //hex.append(contents->buf(), contents->len());
-
-                //log_always_p(log_path(), "consume - processed %zu bytes of header",
-                //                         consumed);
-                //log_multiline(log_path(), oasys::LOG_ALWAYS, hex.hexify().c_str());
-            }
+            // stop scanning at the payload data so that it can be
+            // written straight to the payload
+            block->scanner()->set_stop_at_string(true);
         }
-        else
-        {
-            // combine the previous data with the new data and 
-            // try again to decode the header info
-
-            // instead of adding all of the new data to the contents
-            // using a temp buffer and then only adding the needed
-            // bybtes to the contents
 
-            size_t combined_size = prev_consumed + len;
-            u_char* temp_buf = (u_char*) malloc(combined_size);
-
-            memcpy(temp_buf, block->contents().buf(), prev_consumed);
-            memcpy(temp_buf + prev_consumed, buf, len);
-
-                //dzdebug
-                //log_always_p(log_path(), "BP7_Payload.consume (resuming Bundle %s) - (prev_len = %zu) - temp_buf: %2.2x contents: %2.2x",
-                //                         bundle->gbofid_str().c_str(), prev_consumed, temp_buf[0], block->contents().buf()[0]);
-
-            // try to decode the block 
-            block_hdr_len = decode_payload_header(block, (uint8_t*) temp_buf, combined_size, payload_len);
+        bool have_header = false;
+        consumed = accumulate_cbor(block, buf, len, &have_header);
+        if (consumed < 0)
+        {
+            // protocol error - abort
+            return BP_FAIL;
+        }
 
-            free(temp_buf);
+        if (have_header)
+        {
+            // decode the header now that all of it is in the contents
+            BlockInfo::DataBuffer* contents = block->writable_contents();
+            block_hdr_len = decode_payload_header(block, (uint8_t*) contents->buf(), contents->len(), payload_len);
 
-            if (block_hdr_len == BP_FAIL)
+            if (block_hdr_len != (int64_t) contents->len())
             {
-                //dzdebug
-                //log_always_p(log_path(), "BP7_Payload.consume (Bundle %s) - (prev_len = %zu) - first byte = %2.2x",
-                //                         bundle->gbofid_str().c_str(), prev_consumed, temp_buf[0]);
-                // protocol error - abort
+                log_err_p(log_path(), "BP7 decode error: %s - error decoding header of %zu bytes (status = %" PRIi64 ")",
+                          block_name(), contents->len(), block_hdr_len);
                 return BP_FAIL;
             }
-            else if (block_hdr_len == BP7_UNEXPECTED_EOF)
-            {
-                // not enogh data received yet
-                // - store this chunk in the block contents and wait for more
-                BlockInfo::DataBuffer* contents = block->writable_contents();
-                contents->reserve(contents->len() + len);
-                memcpy(contents->end(), buf, len);
-                contents->set_len(contents->len() + len);
-                consumed = len;
-            }
-            else
-            {
-                // we now have the entire header info
-                BlockInfo::DataBuffer* contents = block->writable_contents();
-                contents->reserve(block_hdr_len);
-                memcpy(contents->end(), buf, block_hdr_len - prev_consumed);
-                contents->set_len(block_hdr_len);
-
-                block->set_data_offset(block_hdr_len);
-                block->set_data_length(payload_len);
-
-                block->set_crc_offset(block_hdr_len + payload_len);
-                switch (block->crc_type()) {
-                    case 0: block->set_crc_length(0);
-                       break;
-                    case 1: block->set_crc_length(3); // CRC16 = 2 bytes + 1 CBOR header byte
-                       break;
-                    case 2: block->set_crc_length(5); // CRC32c = 4 bytes + 1 CBOR header byte
-                       break;
-                }
-
-                // Payload block is always last block of bundle 
-                // so we will let it consume the extra CBOR break character that must follow it
-                block->set_bpv7_EOB_offset(block_hdr_len + payload_len + block->crc_length());
-
-                consumed = block_hdr_len - prev_consumed;
-
 
-
-                //oasys::HexDumpBuffer hex;
-                //hex.append(contents->buf(), contents->len());
-
-                //log_always_p(log_path(), "consume - processed %zu bytes of header",
-                //                         consumed);
-                //log_multiline(log_path(), oasys::LOG_ALWAYS, hex.hexify().c_str());
+            block->set_data_offset(block_hdr_len);
+            block->set_data_length(payload_len);
+
+            block->set_crc_offset(block_hdr_len + payload_len);
+            switch (block->crc_type()) {
+                case 0: block->set_crc_length(0);
+                   break;
+                case 1: block->set_crc_length(3); // CRC16 = 2 bytes + 1 CBOR header byte
+                   break;
+                case 2: block->set_crc_length(5); // CRC32c = 4 bytes + 1 CBOR header byte
+                   break;
             }
+
+            // Payload block is always last block of bundle 
+            // so we will let it consume the extra CBOR break character that must follow it
+            block->set_bpv7_EOB_offset(block_hdr_len + payload_len + block->crc_length());
         }
 
         buf += consumed;
@@ -409,6 +312,10 @@ BP7_PayloadBlockProcessor::consume(Bundle*    bundle,
             tocopy = len;
         }
 
+        if (payload_bytes_rcvd == 0) {
+            bundle->mutable_payload()->preallocate(block->data_length());
+        }
+
         bundle->mutable_payload()->set_length(payload_bytes_rcvd + tocopy);
         bundle->mutable_payload()->write_data(buf, payload_bytes_rcvd, tocopy);
 
@@ -756,17 +663,25 @@ BP7_PayloadBlockProcessor::produce(const Bundle*    bundle,
 {
     PayloadBlockProcessorHelper* helper = nullptr;
 
-    // check to see if a working buffer would improve disk I/O performance
+    // check to see if a read view or a working buffer would improve disk I/O performance
     if ((offset == 0) && (block->locals() == nullptr)) {
         if (bundle->payload().length() > len) {
-            size_t alloc_len = bundle->payload().length();
-            if (alloc_len > 10000000) {
-                alloc_len = 10000000;
-            }
+            helper = new PayloadBlockProcessorHelper(0);
 
-            helper = new PayloadBlockProcessorHelper(alloc_len);
+            // prefer borrowing the payload bytes directly from the file
+            // mapping (or memory buffer) over reading them into the work buffer
+            if (!BundleDaemonStorage::params_.payload_read_views_ ||
+                !bundle->payload().get_read_view(0, bundle->payload().length(), &helper->view_))
+            {
+                size_t alloc_len = bundle->payload().length();
+                if (alloc_len > 10000000) {
+                    alloc_len = 10000000;
+                }
 
-            // save a reference to the working buffer on the blocks so we can
+                helper->work_buf_.set_size(alloc_len);
+            }
+
+            // save a reference to the helper on the blocks so we can
             // keep using it each time this method is called
             (const_cast<BlockInfo*>(block))->set_locals(helper);
         }
@@ -791,7 +706,15 @@ BP7_PayloadBlockProcessor::produce(const Bundle*    bundle,
 
     size_t tocopy = std::min(len, bundle->payload().length() - payload_offset);
 
-    if (helper != nullptr) {
+    if ((helper != nullptr) && helper->view_.valid()) {
+        // copy straight out of the borrowed view
+        memcpy(buf, helper->view_.buf() + payload_offset, tocopy);
+
+        if ((payload_offset + tocopy) == bundle->payload().length()) {
+            // finished with the payload so the helper and its view can be released
+            (const_cast<BlockInfo*>(block))->set_locals(nullptr);
+        }
+    } else if (helper != nullptr) {
         // already have enough data in the work buf?
         if (helper->work_buf_.fullbytes() >= tocopy) {
             //copy the requested amount of data
@@ -848,6 +771,59 @@ BP7_PayloadBlockProcessor::produce(const Bundle*    bundle,
     return;
 }
 
+//----------------------------------------------------------------------
+void
+BP7_PayloadBlockProcessor::produce_iov(const Bundle*    bundle,
+                                       const BlockInfo* block,
+                                       size_t           offset,
+                                       size_t           len,
+                                       BundleIOVec*     iov)
+{
+    // the preamble comes straight out of the contents buffer
+    if (offset < block->data_offset()) {
+        size_t tocopy = std::min(len, block->data_offset() - offset);
+        iov->append(block->contents().buf() + offset, tocopy);
+        offset += tocopy;
+        len    -= tocopy;
+    }
+
+    if (len == 0)
+        return;
+
+    size_t payload_offset = offset - block->data_offset();
+
+    // set up a view of the whole payload the first time through and
+    // keep it on the block for the following calls as produce() does
+    PayloadBlockProcessorHelper* helper = nullptr;
+    if (block->locals() != nullptr) {
+        helper = dynamic_cast<PayloadBlockProcessorHelper*>(block->locals());  // could be nullptr
+    } else if (BundleDaemonStorage::params_.payload_read_views_) {
+        helper = new PayloadBlockProcessorHelper(0);
+        if (bundle->payload().get_read_view(0, bundle->payload().length(), &helper->view_)) {
+            (const_cast<BlockInfo*>(block))->set_locals(helper);
+        } else {
+            delete helper;
+            helper = nullptr;
+        }
+    }
+
+    if ((helper == nullptr) || !helper->view_.valid()) {
+        // no view so copy the range into a buffer owned by the list
+        produce(bundle, block, iov->append_copy(len), offset, len);
+        return;
+    }
+
+    // the list keeps its own reference to the helper so the view stays
+    // mapped (and its file open) after the block lets go of it below
+    int fd = iov->use_files() ? helper->view_.file_fd() : -1;
+    iov->append_file(helper->view_.buf() + payload_offset, len,
+                     fd, payload_offset, helper);
+
+    if ((payload_offset + len) == bundle->payload().length()) {
+        (const_cast<BlockInfo*>(block))->set_locals(nullptr);
+    }
+}
+
 //----------------------------------------------------------------------
 void
 BP7_PayloadBlockProcessor::process(process_func*    func,
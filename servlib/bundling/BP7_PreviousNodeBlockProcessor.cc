@@ -88,116 +88,7 @@ BP7_PreviousNodeBlockProcessor::consume(Bundle*    bundle,
                                    u_char*    buf,
                                    size_t     len)
 {
-    (void) bundle;
-
-    ssize_t consumed = 0;
-
-            //log_always_p(log_path(), "consume - first CBOR charater: %02x", buf[0]);
-
-    ASSERT(! block->complete());
-
-    int64_t block_len;
-    size_t prev_consumed = block->contents().len();
-
-    if (prev_consumed == 0)
-    {
-        // try to decode the block from the received data
-        block_len = decode_canonical_block(block, (uint8_t*) buf, len);
-
-        if (block_len == BP_FAIL)
-        {
-            // protocol error - abort
-            consumed = BP_FAIL;
-        }
-        else if (block_len == BP7_UNEXPECTED_EOF)
-        {
-            // not enogh data received yet
-            // - store this chunk in the block contents and wait for more
-            BlockInfo::DataBuffer* contents = block->writable_contents();
-            contents->reserve(contents->len() + len);
-            memcpy(contents->end(), buf, len);
-            contents->set_len(contents->len() + len);
-            consumed = len;
-        }
-        else
-        {
-            // got the entire block in this first chunk of data
-            BlockInfo::DataBuffer* contents = block->writable_contents();
-            contents->reserve(block_len);
-            memcpy(contents->end(), buf, block_len);
-            contents->set_len(block_len);
-
-            block->set_complete(true);
-            bundle->set_highest_rcvd_block_number(block->block_number());
-
-            consumed = block_len;
-
-            //oasys::HexDumpBuffer hex;
-            //hex.append(block->contents().buf(), block->contents().len());
-
-            //log_always_p(log_path(), "consumed %zu CBOR bytes:",
-            //                         block->contents().len());
-            ////log_multiline(log_path(), oasys::LOG_ALWAYS, hex.hexify().c_str());
-
-        }
-    }
-    else
-    {
-        // combine the previous data with the new data and 
-        // try again to decode the block
-
-        // instead of adding all of the new data to the contents
-        // using a temp buffer and then only adding the needed
-        // bybtes to the contents
-
-        BlockInfo::DataBuffer* contents = block->writable_contents();
-
-        size_t combined_size = prev_consumed + len;
-        u_char* temp_buf = (u_char*) malloc(combined_size);
-
-        memcpy(temp_buf, contents->buf(), prev_consumed);
-        memcpy(temp_buf + prev_consumed, buf, len);
-
-        // try to decode the block 
-        block_len = decode_canonical_block(block, (uint8_t*) temp_buf, combined_size);
-
-        free(temp_buf);
-
-        if (block_len == BP_FAIL)
-        {
-            // protocol error - abort
-            consumed = BP_FAIL;
-        }
-        else if (block_len == BP7_UNEXPECTED_EOF)
-        {
-            // not enogh data received yet
-            // - store this chunk in the block contents and wait for more
-            contents->reserve(contents->len() + len);
-            memcpy(contents->end(), buf, len);
-            contents->set_len(contents->len() + len);
-            consumed = len;
-        }
-        else
-        {
-            // we now have the entire block
-            contents->reserve(block_len);
-            memcpy(contents->end(), buf, block_len - prev_consumed);
-            contents->set_len(block_len);
-
-            block->set_complete(true);
-            bundle->set_highest_rcvd_block_number(block->block_number());
-
-            consumed = block_len - prev_consumed;
-
-            //oasys::HexDumpBuffer hex;
-            //hex.append(contents->buf(), block_len);
-
-            //log_always_p(log_path(), "consume - processed %zu bytes - block complete = %s",
-            //                         consumed, block->complete()?"true":"false");
-            //log_multiline(log_path(), oasys::LOG_ALWAYS, hex.hexify().c_str());
-        }
-
-    }
+    ssize_t consumed = consume_canonical_block(bundle, block, buf, len);
 
     if (block->complete())
     {
@@ -214,10 +105,6 @@ BP7_PreviousNodeBlockProcessor::consume(Bundle*    bundle,
         }
     }
 
-
-            //log_always_p(log_path(), "BP7_UnknwonBlockProcessor::consume - processed %zu bytes - block complete = %s",
-            //                         consumed, block->complete()?"true":"false");
-
     return consumed;
 }
 
@@ -82,6 +82,8 @@ public:
                           BlockInfoVec* xmit_blocks,
                           BlockInfo*    block);
 
+    bool cache_encoding() const override { return true; }
+
     /// @}
 
 protected:
@@ -0,0 +1,224 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <string.h>
+
+#include "BlockEncodingCache.h"
+#include "BlockProcessor.h"
+#include "Bundle.h"
+#include "BundleDaemon.h"
+
+namespace oasys {
+    template <> dtn::BlockEncodingCache* oasys::Singleton<dtn::BlockEncodingCache>::instance_ = nullptr;
+}
+
+namespace dtn {
+
+//----------------------------------------------------------------------
+BlockEncodingCache::Entry::Entry(const Bundle* bundle)
+    : footprint_(sizeof(Entry)),
+      payload_length_(bundle->payload().length()),
+      is_fragment_(bundle->is_fragment()),
+      frag_offset_(bundle->frag_offset()),
+      orig_length_(bundle->orig_length()),
+      expiration_millis_(bundle->expiration_millis()),
+      primary_block_crc_type_(bundle->primary_block_crc_type())
+{
+}
+
+//----------------------------------------------------------------------
+bool
+BlockEncodingCache::Entry::matches(const Bundle* bundle) const
+{
+    return (payload_length_         == bundle->payload().length() &&
+            is_fragment_            == bundle->is_fragment() &&
+            frag_offset_            == bundle->frag_offset() &&
+            orig_length_            == bundle->orig_length() &&
+            expiration_millis_      == bundle->expiration_millis() &&
+            primary_block_crc_type_ == bundle->primary_block_crc_type());
+}
+
+//----------------------------------------------------------------------
+bool
+BlockEncodingCache::Entry::apply(BlockInfo* block) const
+{
+    u_int16_t owner_type = block->owner()->block_type();
+
+    for (const Block& cached : blocks_) {
+        if (cached.owner_type_ != owner_type ||
+            cached.block_number_ != block->block_number()) {
+            continue;
+        }
+
+        BlockInfo::DataBuffer* contents = block->writable_contents();
+        contents->clear();
+        contents->reserve(cached.contents_.size());
+        memcpy(contents->buf(), cached.contents_.data(), cached.contents_.size());
+        contents->set_len(cached.contents_.size());
+
+        block->set_flag(cached.block_flags_);
+        block->set_data_offset(cached.data_offset_);
+        block->set_data_length(cached.data_length_);
+        block->set_crc_type(cached.crc_type_);
+        block->set_crc_length(cached.crc_length_);
+        block->set_crc_offset(cached.crc_offset_);
+        return true;
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------
+void
+BlockEncodingCache::Entry::add(const BlockInfo* block)
+{
+    blocks_.emplace_back();
+    Block& cached = blocks_.back();
+
+    cached.owner_type_   = block->owner()->block_type();
+    cached.block_number_ = block->block_number();
+    cached.block_flags_  = block->block_flags();
+    cached.data_offset_  = block->data_offset();
+    cached.data_length_  = block->data_length();
+    cached.crc_type_     = block->crc_type();
+    cached.crc_length_   = block->crc_length();
+    cached.crc_offset_   = block->crc_offset();
+    cached.contents_.assign(block->contents().buf(),
+                            block->contents().buf() + block->contents().len());
+
+    footprint_ += sizeof(Block) + cached.contents_.capacity();
+}
+
+//----------------------------------------------------------------------
+bool
+BlockEncodingCache::SizeHelper::over_limit(const bundleid_t& key, const SPtr_Entry& val)
+{
+    (void)key;
+    return bytes_ + val->footprint() > BundleDaemon::params_.block_encoding_cache_size_;
+}
+
+//----------------------------------------------------------------------
+void
+BlockEncodingCache::SizeHelper::put(const bundleid_t& key, const SPtr_Entry& val)
+{
+    (void)key;
+    bytes_ += val->footprint();
+    ++entries_;
+}
+
+//----------------------------------------------------------------------
+void
+BlockEncodingCache::SizeHelper::cleanup(const bundleid_t& key, const SPtr_Entry& val)
+{
+    (void)key;
+    ASSERT(bytes_ >= val->footprint());
+    bytes_ -= val->footprint();
+    --entries_;
+}
+
+//----------------------------------------------------------------------
+BlockEncodingCache::BlockEncodingCache()
+    : Logger("BlockEncodingCache", "/dtn/bundle/encoding_cache"),
+      cache_(logpath_, SizeHelper(), true /* reorder on get() */),
+      hits_(0),
+      misses_(0),
+      stale_(0)
+{
+}
+
+//----------------------------------------------------------------------
+bool
+BlockEncodingCache::enabled() const
+{
+    return BundleDaemon::params_.block_encoding_cache_size_ != 0;
+}
+
+//----------------------------------------------------------------------
+BlockEncodingCache::SPtr_Entry
+BlockEncodingCache::lookup(const Bundle* bundle)
+{
+    SPtr_Entry entry;
+    if (! cache_.get(bundle->bundleid(), &entry)) {
+        ++misses_;
+        return nullptr;
+    }
+
+    if (! entry->matches(bundle)) {
+        // the bundle changed since it was cached
+        ++stale_;
+        cache_.evict(bundle->bundleid());
+        return nullptr;
+    }
+
+    ++hits_;
+    return entry;
+}
+
+//----------------------------------------------------------------------
+void
+BlockEncodingCache::store(const Bundle* bundle, const BlockInfoVec* blocks)
+{
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>(bundle);
+
+    for (BlockInfoVec::const_iterator iter = blocks->begin();
+         iter != blocks->end();
+         ++iter)
+    {
+        if ((*iter)->owner()->cache_encoding()) {
+            entry->add(iter->get());
+        }
+    }
+
+    if (entry->num_blocks() == 0 ||
+        entry->footprint() > BundleDaemon::params_.block_encoding_cache_size_) {
+        return;
+    }
+
+    cache_.evict(bundle->bundleid());
+
+    Cache::Handle handle;
+    if (cache_.put_and_pin(bundle->bundleid(), entry, &handle)) {
+        // only pinned while being inserted so it can be evicted
+        handle.unpin();
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BlockEncodingCache::evict(const Bundle* bundle)
+{
+    cache_.evict(bundle->bundleid());
+}
+
+//----------------------------------------------------------------------
+void
+BlockEncodingCache::get_stats(oasys::StringBuffer* buf)
+{
+    SizeHelper* helper = cache_.get_helper();
+
+    buf->appendf("Block Encodings    : %zu bundles  %zu bytes (max: %zu) -- "
+                 "%zu hits  %zu misses  %zu stale\n",
+                 helper->entries(), helper->bytes(),
+                 BundleDaemon::params_.block_encoding_cache_size_,
+                 hits_.load(), misses_.load(), stale_.load());
+}
+
+} // namespace dtn
@@ -0,0 +1,169 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _BLOCK_ENCODING_CACHE_H_
+#define _BLOCK_ENCODING_CACHE_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <third_party/oasys/util/Cache.h>
+#include <third_party/oasys/util/Singleton.h>
+#include <third_party/oasys/util/StringBuffer.h>
+
+#include "BlockInfo.h"
+
+namespace dtn {
+
+class Bundle;
+
+/**
+ * Encodings of the outbound blocks of a bundle that come out the same
+ * on every link and every transmission (the BPv7 primary block and the
+ * payload block header), kept so that sending a bundle again -- on
+ * another link, to several IMC destinations or after a contact drops --
+ * only has to generate the per-transmission blocks such as the previous
+ * node, hop count and bundle age blocks.
+ *
+ * Entries are keyed by bundle id and hold the fields of the bundle that
+ * went into the encodings so an entry left over from before a bundle was
+ * changed (e.g. reactively fragmented) is not used. The cache holds at
+ * most BundleDaemon::params_.block_encoding_cache_size_ bytes, evicting
+ * the least recently used bundles, and entries are dropped when their
+ * bundle is freed.
+ */
+class BlockEncodingCache : public oasys::Singleton<BlockEncodingCache>,
+                           public oasys::Logger {
+public:
+    /**
+     * The reusable blocks of one bundle.
+     */
+    class Entry {
+    public:
+        /// Snapshot the bundle fields that the cached blocks depend on
+        Entry(const Bundle* bundle);
+
+        /// Whether the bundle still matches the snapshot
+        bool matches(const Bundle* bundle) const;
+
+        /// Copy the block's contents and fields out of the cache
+        /// @return false if there is no encoding for the block
+        bool apply(BlockInfo* block) const;
+
+        /// Add a copy of a generated block
+        void add(const BlockInfo* block);
+
+        /// Bytes of memory charged to the cache for the entry
+        size_t footprint() const { return footprint_; }
+
+        /// Number of cached blocks
+        size_t num_blocks() const { return blocks_.size(); }
+
+    protected:
+        struct Block {
+            u_int16_t            owner_type_;
+            uint64_t             block_number_;
+            uint64_t             block_flags_;
+            size_t               data_offset_;
+            size_t               data_length_;
+            uint64_t             crc_type_;
+            size_t               crc_length_;
+            size_t               crc_offset_;
+            std::vector<u_char>  contents_;
+        };
+
+        std::vector<Block> blocks_;
+        size_t             footprint_;
+
+        /// @{ Bundle fields that go into the cached encodings and can
+        /// change over the life of the bundle
+        size_t             payload_length_;
+        bool               is_fragment_;
+        size_t             frag_offset_;
+        size_t             orig_length_;
+        uint64_t           expiration_millis_;
+        uint64_t           primary_block_crc_type_;
+        /// @}
+    };
+
+    typedef std::shared_ptr<const Entry> SPtr_Entry;
+
+    /// Whether the cache has been given any memory
+    bool enabled() const;
+
+    /**
+     * Find the cached blocks for the bundle.
+     *
+     * @return the entry or null if there is none or it's out of date
+     */
+    SPtr_Entry lookup(const Bundle* bundle);
+
+    /**
+     * Replace the bundle's entry with copies of the blocks in the list
+     * whose owners allow their encodings to be cached.
+     */
+    void store(const Bundle* bundle, const BlockInfoVec* blocks);
+
+    /**
+     * Drop the bundle's entry.
+     */
+    void evict(const Bundle* bundle);
+
+    /**
+     * Write out the usage statistics.
+     */
+    void get_stats(oasys::StringBuffer* buf);
+
+protected:
+    friend class oasys::Singleton<BlockEncodingCache>;
+
+    BlockEncodingCache();
+
+    /**
+     * Cache helper that accounts for the bytes held by the entries
+     * against the configured limit.
+     */
+    class SizeHelper {
+    public:
+        SizeHelper() : bytes_(0), entries_(0) {}
+
+        bool over_limit(const bundleid_t& key, const SPtr_Entry& val);
+        void put(const bundleid_t& key, const SPtr_Entry& val);
+        void cleanup(const bundleid_t& key, const SPtr_Entry& val);
+
+        size_t bytes()   const { return bytes_; }
+        size_t entries() const { return entries_; }
+
+    protected:
+        size_t bytes_;
+        size_t entries_;
+    };
+
+    typedef oasys::Cache<bundleid_t, SPtr_Entry, SizeHelper> Cache;
+    Cache cache_;
+
+    /// @{ Statistics
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::atomic<size_t> stale_;
+    /// @}
+};
+
+} // namespace dtn
+
+#endif /* _BLOCK_ENCODING_CACHE_H_ */
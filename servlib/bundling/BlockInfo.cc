@@ -71,7 +71,8 @@ BlockInfo::BlockInfo(BlockProcessor* owner)
       crc_bytes_received_(0),
       crc_checked_(false),
       crc_validated_(false),
-      bpv7_EOB_offset_(0)
+      bpv7_EOB_offset_(0),
+      scanner_()
 {
     eid_list_.clear();
     memset(crc_cbor_bytes_, 0, sizeof(crc_cbor_bytes_));
@@ -98,7 +99,8 @@ BlockInfo::BlockInfo(BlockProcessor* owner, const SPtr_BlockInfo source)
       crc_bytes_received_(0),
       crc_checked_(false),
       crc_validated_(false),
-      bpv7_EOB_offset_(0)
+      bpv7_EOB_offset_(0),
+      scanner_()
 {
     eid_list_.clear();
     memset(crc_cbor_bytes_, 0, sizeof(crc_cbor_bytes_));
@@ -125,7 +127,8 @@ BlockInfo::BlockInfo(oasys::Builder& builder)
       crc_bytes_received_(0),
       crc_checked_(false),
       crc_validated_(false),
-      bpv7_EOB_offset_(0)
+      bpv7_EOB_offset_(0),
+      scanner_()
 {
     (void)builder;
 
@@ -153,7 +156,8 @@ BlockInfo::BlockInfo(const BlockInfo &bi)
       crc_bytes_received_(bi.crc_bytes_received_),
       crc_checked_(bi.crc_checked_),
       crc_validated_(bi.crc_validated_),
-      bpv7_EOB_offset_(bi.bpv7_EOB_offset_)
+      bpv7_EOB_offset_(bi.bpv7_EOB_offset_),
+      scanner_(bi.scanner_)
 {
     memcpy(crc_cbor_bytes_, bi.crc_cbor_bytes_, sizeof(crc_cbor_bytes_));
 }
@@ -180,7 +184,8 @@ BlockInfo::BlockInfo(const SPtr_BlockInfo& bi)
       crc_bytes_received_(bi->crc_bytes_received_),
       crc_checked_(bi->crc_checked_),
       crc_validated_(bi->crc_validated_),
-      bpv7_EOB_offset_(bi->bpv7_EOB_offset_)
+      bpv7_EOB_offset_(bi->bpv7_EOB_offset_),
+      scanner_(bi->scanner_)
 {
     memcpy(crc_cbor_bytes_, bi->crc_cbor_bytes_, sizeof(crc_cbor_bytes_));
 }
@@ -219,6 +224,7 @@ BlockInfo& BlockInfo::operator=(const BlockInfo& other)
     crc_checked_ = other.crc_checked_;
     crc_validated_ = other.crc_validated_;
     bpv7_EOB_offset_ = other.bpv7_EOB_offset_;
+    scanner_ = other.scanner_;
     memcpy(crc_cbor_bytes_, other.crc_cbor_bytes_, sizeof(crc_cbor_bytes_));
 
     return *this;
@@ -257,6 +263,7 @@ BlockInfo& BlockInfo::operator=(BlockInfo&& other) noexcept
         crc_checked_ = other.crc_checked_;
         crc_validated_ = other.crc_validated_;
         bpv7_EOB_offset_ = other.bpv7_EOB_offset_;
+        scanner_ = other.scanner_;
         memcpy(crc_cbor_bytes_, other.crc_cbor_bytes_, sizeof(crc_cbor_bytes_));
     }
     return *this;
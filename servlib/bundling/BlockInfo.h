@@ -43,6 +43,7 @@
 #include <third_party/oasys/util/ScratchBuffer.h>
 
 #include "BP_Local.h"
+#include "CborItemScanner.h"
 #include "Dictionary.h"
 #include "contacts/Link.h"
 #include <string>
@@ -159,6 +160,7 @@ public:
     void        set_crc_checked(bool b)      { crc_checked_ = b; }
     void        set_crc_validated(bool b)    { crc_validated_ = b; }
     void        set_bpv7_EOB_offset(size_t t)     { bpv7_EOB_offset_ = t; }
+    CborItemScanner* scanner()               { return &scanner_; }
     /// @}
 
     /// @{ These accessors need special case processing since the
@@ -198,6 +200,7 @@ protected:
                                           ///  indicating End of Bundle [CBOR array] (BPv7)
                                           ///  - used by BP7_PayloadBLockProcessor since it
                                           ///    is always the last block of a bundle
+    CborItemScanner  scanner_;            ///< Receive state of the block's CBOR (BPv7)
 };
 
 
@@ -40,6 +40,7 @@
 
 #include "BlockProcessor.h"
 #include "Bundle.h"
+#include "BundleIOVec.h"
 
 namespace dtn {
 
@@ -59,6 +60,20 @@ BlockProcessor::~BlockProcessor()
 {
 }
 
+//----------------------------------------------------------------------
+void
+BlockProcessor::produce_iov(const Bundle*    bundle,
+                            const BlockInfo* block,
+                            size_t           offset,
+                            size_t           len,
+                            BundleIOVec*     iov)
+{
+    (void)bundle;
+
+    ASSERT(block->contents().len() >= offset + len);
+    iov->append(block->contents().buf() + offset, len);
+}
+
 int
 BlockProcessor::format(oasys::StringBuffer* buf, BlockInfo *b)
 {
@@ -44,6 +44,7 @@
 namespace dtn {
 
 class Bundle;
+class BundleIOVec;
 class Link;
 class OpaqueContext;
 
@@ -245,6 +246,28 @@ public:
                          size_t           offset,
                          size_t           len)  = 0;
 
+    /**
+     * Variant of produce() that adds the specified range of the block
+     * to the segment list instead of copying it out.
+     *
+     * The base class implementation points the segment into the
+     * contents buffer. The payload block processors override it to
+     * point into a read view of the payload.
+     */
+    virtual void produce_iov(const Bundle*    bundle,
+                             const BlockInfo* block,
+                             size_t           offset,
+                             size_t           len,
+                             BundleIOVec*     iov);
+
+    /**
+     * Whether the block generated for a bundle comes out the same on
+     * every link and every transmission, in which case its encoding is
+     * kept in the BlockEncodingCache and reused instead of calling
+     * generate() again. The base class returns false.
+     */
+    virtual bool cache_encoding() const { return false; }
+
     /**
      * General hook to set up a block with the given contents. Used
      * for creating generic extension blocks coming from the API.
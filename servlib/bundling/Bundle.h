@@ -352,6 +352,7 @@ public:
     SPtr_EID&   mutable_custodian()    { return sptr_custodian_; }
     SPtr_EID&   mutable_prevhop()      { return sptr_prevhop_; }
     void set_bp_version(int32_t v)    { bp_version_ = v; }
+    void set_primary_block_crc_type(size_t t) { primary_block_crc_type_ = t; }
     void set_is_admin(bool t)          { is_admin_ = t; }
     void set_do_not_fragment(bool t)   { do_not_fragment_ = t; }
     void set_custody_requested(bool t) { custody_requested_ = t && is_bpv6(); }
@@ -46,6 +46,7 @@
 #include <third_party/oasys/tclcmd/TclCommand.h>
 #include <third_party/oasys/util/Time.h>
 
+#include "BlockEncodingCache.h"
 #include "Bundle.h"
 #include "BundleActions.h"
 #include "BundleEvent.h"
@@ -62,10 +63,14 @@
 #include "CustodySignal.h"
 #include "ExpirationTimer.h"
 #include "FragmentManager.h"
+#include "PayloadMemoryManager.h"
+#include "PayloadScrubber.h"
+#include "PayloadWriter.h"
 #include "contacts/Link.h"
 #include "contacts/Contact.h"
 #include "contacts/ContactManager.h"
 #include "contacts/InterfaceTable.h"
+#include "conv_layers/CLEventLoop.h"
 #include "conv_layers/ConvergenceLayer.h"
 #include "ltp/LTPEngine.h"
 #include "naming/IPNScheme.h"
@@ -278,6 +283,13 @@ BundleDaemon::post_at_head(SPtr_BundleEvent& sptr_event)
     instance_->post_event(sptr_event, false);  // at_back = false
 }
 
+//----------------------------------------------------------------------
+void
+BundleDaemon::post_batch(std::vector<SPtr_BundleEvent>& events)
+{
+    instance_->post_events(events);
+}
+
 //----------------------------------------------------------------------
 bool
 BundleDaemon::post_and_wait(SPtr_BundleEvent& sptr_event,
@@ -347,6 +359,32 @@ BundleDaemon::post_event(SPtr_BundleEvent& sptr_event, bool at_back)
     }
 }
 
+//----------------------------------------------------------------------
+void
+BundleDaemon::post_events(std::vector<SPtr_BundleEvent>& events)
+{
+    if (final_cleanup_) {
+        return;
+    }
+
+    // received bundles are by far the common case, so those go to the
+    // input thread in one push and anything else is posted singly
+    std::vector<SPtr_BundleEvent> input_events;
+    input_events.reserve(events.size());
+
+    for (SPtr_BundleEvent& sptr_event : events) {
+        if (sptr_event->event_processor_ == EVENT_PROCESSOR_INPUT) {
+            input_events.push_back(sptr_event);
+        } else {
+            post_event(sptr_event, true);
+        }
+    }
+
+    if (!input_events.empty()) {
+        daemon_input_->post_events(input_events);
+    }
+}
+
 //----------------------------------------------------------------------
 void
 BundleDaemon::get_routing_state(oasys::StringBuffer* buf)
@@ -447,6 +485,8 @@ BundleDaemon::get_daemon_stats(oasys::StringBuffer* buf)
     daemon_storage_->get_daemon_stats(buf);
     daemon_cleanup_->get_daemon_stats(buf);
 
+    BlockEncodingCache::instance()->get_stats(buf);
+    CLEventLoopPool::instance()->get_stats(buf);
 }
 
 
@@ -2619,6 +2659,18 @@ BundleDaemon::handle_shutdown_request(SPtr_BundleEvent& sptr_event)
     daemon_storage_->commit_all_updates();
     log_always("finished storage close out");
 
+    if (PayloadMemoryManager::initialized()) {
+        PayloadMemoryManager::instance()->shutdown();
+    }
+
+    if (PayloadWriter::initialized()) {
+        PayloadWriter::instance()->shutdown();
+    }
+
+    if (PayloadScrubber::initialized()) {
+        PayloadScrubber::instance()->shutdown();
+    }
+
     // signal to the main loop to bail
     set_should_stop();
 
@@ -3276,6 +3328,8 @@ BundleDaemon::handle_bundle_free(SPtr_BundleEvent& sptr_event)
     bundle_restaging_daemon_->bundle_deleted(bundle);
 #endif // BARD_ENABLED
 
+    BlockEncodingCache::instance()->evict(bundle);
+
     delete bundle;
 
     ++stats_.deleted_bundles_;
@@ -3484,6 +3538,9 @@ BundleDaemon::load_bundles()
 
     size_t num_bundles_loaded = 0;
 
+    BundleDaemonStorage::reload_check_t reload_check =
+        BundleDaemonStorage::params_.payload_reload_check_;
+
     int iter_status = iter->begin();
 
     while ((iter_status == oasys::DS_OK) && iter->more()) {
@@ -3515,8 +3572,23 @@ BundleDaemon::load_bundles()
             continue;
         }
 
+        // likewise for a payload file that was truncated or corrupted
+        if ((reload_check != BundleDaemonStorage::RELOAD_CHECK_NONE) &&
+            !bundle->mutable_payload()->validate(reload_check == BundleDaemonStorage::RELOAD_CHECK_FULL)) {
+            log_err("payload for *%p failed validation on reload",
+                    bundle);
+            doa_bundles.push_back(bundle);
+
+            iter_status = iter->next();
+            continue;
+        }
+
         ++num_bundles_loaded;
 
+        if (PayloadScrubber::initialized()) {
+            PayloadScrubber::instance()->post(bundle);
+        }
+
         // reset the flags indicating it is in the datastore
         bundle->set_in_datastore(true);
         bundle->set_queued_for_datastore(true);
@@ -3566,7 +3638,7 @@ BundleDaemon::load_bundles()
         delete doa_bundles[i];
     }
 
-    log_always("Loaded %zu bundles from storage; %zu bundles had errors reading the payload file and were deleted",
+    log_always("Loaded %zu bundles from storage; %zu bundles had errors reading or validating the payload file and were deleted",
                num_bundles_loaded, num_doa);
 
     return true;
@@ -3679,6 +3751,11 @@ BundleDaemon::run()
 
     load_registrations();
     load_previous_links();
+
+    if (BundleDaemonStorage::params_.payload_reload_check_ == BundleDaemonStorage::RELOAD_CHECK_SCRUB) {
+        PayloadScrubber::init();
+    }
+
     if (!load_bundles()) {
         // abort - load_bundles already output a crit message
         exit(1);
@@ -3687,6 +3764,19 @@ BundleDaemon::run()
 
     daemon_storage_->start();
 
+    // hybrid payloads fall back to disk when there is no manager
+    if (BundleDaemonStorage::params_.payload_location_ == BundlePayload::HYBRID) {
+        PayloadMemoryManager::init();
+        PayloadMemoryManager::instance()->start();
+    }
+
+    PayloadWriter::init();
+    PayloadWriter::instance()->start();
+
+    if (PayloadScrubber::initialized()) {
+        PayloadScrubber::instance()->start();
+    }
+
     load_pendingacs();
     daemon_acs_->start();
 
@@ -211,6 +211,13 @@ public:
      * daemon thread.
      */
     static void post_at_head(SPtr_BundleEvent& sptr_event);
+
+    /**
+     * Queues a batch of events at the tail of their queues, taking
+     * each queue's lock and waking its thread once for the batch
+     * rather than once per event.
+     */
+    static void post_batch(std::vector<SPtr_BundleEvent>& events);
     
     /**
      * Post the given event and wait for it to be processed by the
@@ -225,6 +232,7 @@ public:
     * the simulator to use a modified event queue.
     */
     virtual void post_event(SPtr_BundleEvent& ptr_vent, bool at_back = true);
+    virtual void post_events(std::vector<SPtr_BundleEvent>& events);
 
     /**
      * Returns the current bundle router.
@@ -393,6 +401,12 @@ public:
         /// API max size for a payload delivered by mmemory
         size_t api_deliver_max_memory_size_ = 1000000;
 
+        /// Bytes of memory for reusable outbound block encodings (0 = disabled)
+        size_t block_encoding_cache_size_ = 16000000;
+
+        /// Threads driving the connection oriented CL connections (0 = a thread per connection)
+        u_int cl_event_loops_ = 0;
+
         /// allow specification of the local LTP Engine ID (otherwise pull from local IPN EID)
         uint64_t ltp_engine_id_ = 0;
 
@@ -97,6 +97,19 @@ BundleDaemonInput::post_event(SPtr_BundleEvent& sptr_event, bool at_back)
     me_eventq_.push(sptr_event, at_back);
 }
 
+//----------------------------------------------------------------------
+void
+BundleDaemonInput::post_events(std::vector<SPtr_BundleEvent>& events)
+{
+    oasys::Time now;
+    now.get_time();
+
+    for (SPtr_BundleEvent& sptr_event : events) {
+        sptr_event->posted_time_ = now;
+    }
+    me_eventq_.push_back_all(events);
+}
+
 //----------------------------------------------------------------------
 void
 BundleDaemonInput::get_daemon_stats(oasys::StringBuffer* buf)
@@ -124,6 +124,12 @@ protected:
      */
     virtual void post_event(SPtr_BundleEvent& sptr_event, bool at_back = true);
 
+    /**
+     * Queue a batch of events at the back of the queue with a single
+     * lock and wakeup.
+     */
+    virtual void post_events(std::vector<SPtr_BundleEvent>& events);
+
 protected:
     /**
      * Generate delivery events for newly-loaded bundles.
@@ -30,12 +30,14 @@
 #include "BundleDaemonStorage.h"
 #include "SDNV.h"
 #include "storage/BundleStore.h"
-#include "storage/GlobalStore.h"
 #include "storage/RegistrationStore.h"
 #include "storage/LinkStore.h"
 #include "storage/PendingAcsStore.h"
 
 #include "ExpirationTimer.h"
+#include "PayloadMemoryManager.h"
+#include "PayloadScrubber.h"
+#include "PayloadWriter.h"
 
 
 // enable or disable debug level logging in this file
@@ -51,7 +53,19 @@ BundleDaemonStorage::Params::Params()
       db_log_auto_removal_(false),
       db_storage_enabled_(true),
       db_force_sync_to_disk_(true),
-      payload_location_(BundlePayload::DISK)
+      payload_location_(BundlePayload::DISK),
+      payload_mem_budget_(256000000),
+      payload_mem_high_water_pct_(90),
+      payload_mem_low_water_pct_(75),
+      payload_mem_max_age_(60),
+      payload_write_behind_(true),
+      payload_write_chunk_(1048576),
+      payload_write_behind_limit_(67108864),
+      payload_preallocate_(true),
+      payload_read_views_(true),
+      payload_checksums_(true),
+      payload_reload_check_(RELOAD_CHECK_SIZE),
+      payload_scrub_rate_(10000000)
 {}
 
 BundleDaemonStorage::Params BundleDaemonStorage::params_;
@@ -186,6 +200,18 @@ BundleDaemonStorage::get_stats(oasys::StringBuffer* buf)
                  stats_.pacs_deleted_,
                  stats_.pacs_delupdates_,
                  stats_.pacs_reloaded_);
+
+    if (PayloadMemoryManager::initialized()) {
+        PayloadMemoryManager::instance()->get_stats(buf);
+    }
+
+    if (PayloadWriter::initialized()) {
+        PayloadWriter::instance()->get_stats(buf);
+    }
+
+    if (PayloadScrubber::initialized()) {
+        PayloadScrubber::instance()->get_stats(buf);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -546,8 +572,6 @@ BundleDaemonStorage::update_database_registrations()
                 store->begin_transaction();
             }
 
-            GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_registrations");
-
             if ( rs->del(regid)) {
                 ++stats_.regs_deleted_;
                 --stats_.regs_in_db_;
@@ -556,8 +580,6 @@ BundleDaemonStorage::update_database_registrations()
                         regid);
             }
 
-            GlobalStore::instance()->unlock_db_access();
-
             // remove this registration from the add_update list if it is there
             result = add_update_registrations_->erase(regid);
             if (1 == result) {
@@ -589,8 +611,6 @@ BundleDaemonStorage::update_database_registrations()
             apireg->lock()->lock("BundleDaemonStorage::update_database_registrations");
             apireg->set_in_storage_queue(false);
 
-            GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_registrations");
-
             if (apireg->in_datastore()) {
                 if (! rs->update(apireg)) {
                     log_crit("error updating registration %d in data store!!",
@@ -607,8 +627,6 @@ BundleDaemonStorage::update_database_registrations()
 	            ++stats_.regs_in_db_;
             }
 
-            GlobalStore::instance()->unlock_db_access();
-
             apireg->lock()->unlock();
         }
 
@@ -672,7 +690,6 @@ BundleDaemonStorage::update_database_bundles()
         }
 
         if (in_db) {
-            GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_bundles - delete");
             if (bstore->del(bundleid, durable_size)) {
                 ++stats_.bundles_deleted_;
                 --stats_.bundles_in_db_;
@@ -680,8 +697,6 @@ BundleDaemonStorage::update_database_bundles()
                 log_warn("error removing bundle %" PRIbid " from data store",
                          bundleid);
             }
-
-            GlobalStore::instance()->unlock_db_access();
         } else {
             // release the memory that was reserved
             BundleStore::instance()->release_payload_space(durable_size);
@@ -718,7 +733,7 @@ BundleDaemonStorage::update_database_bundles()
 
                         bundle->lock()->unlock();
 
-                        GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_bundles - update");
+                        bstore->lock_db_access("BundleDaemonStorage::update_database_bundles - update");
                         bundle->lock()->lock("BundleDaemonStorage::update_database_bundles #2");
                         bundle->set_in_storage_queue(false);
 
@@ -727,7 +742,7 @@ BundleDaemonStorage::update_database_bundles()
                                      bundle->durable_key());
                         }
 
-                        GlobalStore::instance()->unlock_db_access();
+                        bstore->unlock_db_access();
 
                         ++stats_.bundles_updated_;
                     } else {
@@ -750,9 +765,12 @@ BundleDaemonStorage::update_database_bundles()
                                 log_warn("Sync payload took %u ms", sync_payload_timer_.elapsed_ms());
                             }
 #endif
+                        } else if (bundle->payload().is_hybrid()) {
+                            // a payload still held in memory would not survive a restart
+                            bundle->mutable_payload()->spill_to_disk();
                         }
 
-                        GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_bundles - add");
+                        bstore->lock_db_access("BundleDaemonStorage::update_database_bundles - add");
 
                         //get lock after have db access
                         bundle->lock()->lock("BundleDaemonStorage::update_database_bundles #3");
@@ -764,7 +782,7 @@ BundleDaemonStorage::update_database_bundles()
                                      bundle->durable_key());
                         }
 
-                        GlobalStore::instance()->unlock_db_access();
+                        bstore->unlock_db_access();
 
                         bundle->set_in_datastore(true);
 
@@ -789,6 +807,10 @@ BundleDaemonStorage::update_database_bundles()
     }
     add_update_bundles_->clear();
 
+    // sync the directory entries of the new payload files once for the
+    // whole batch, before the bundles referring to them are committed
+    bstore->sync_payload_dirs(params_.db_force_sync_to_disk_);
+
     if (!first_trans) {
         store->end_transaction();
     }
@@ -825,8 +847,6 @@ BundleDaemonStorage::update_database_links()
             store->begin_transaction();
         }
 
-        GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_links");
-
         if (ls->del(key)) {
             ++stats_.links_deleted_;
             --stats_.links_in_db_;
@@ -835,8 +855,6 @@ BundleDaemonStorage::update_database_links()
                     key.c_str());
         }
 
-        GlobalStore::instance()->unlock_db_access();
-
         // remove this registration from the add_update list if it is there
         result = add_update_links_->erase(key);
         if (1 == result) {
@@ -862,8 +880,6 @@ BundleDaemonStorage::update_database_links()
 
         link->lock()->lock("BundleDaemonStorage::update_database_links");
 
-        GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_links");
-
         if (link->in_datastore()) {
             if (! ls->update(link)) {
                 log_crit("error updating link %s in data store!!",
@@ -880,8 +896,6 @@ BundleDaemonStorage::update_database_links()
 	    ++stats_.links_in_db_;
         }
 
-        GlobalStore::instance()->unlock_db_access();
-
         link->lock()->unlock();
 
         // remove this entry from the list
@@ -930,8 +944,6 @@ BundleDaemonStorage::update_database_pendingacs()
 
         pacs->lock().lock("BundleDaemonStorage::update_database_pendingacs (delete)");
 
-        GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_pendingacs");
-
         if (pastore->del(pacs->durable_key())) {
             ++stats_.pacs_deleted_;
             --stats_.pacs_in_db_;
@@ -940,8 +952,6 @@ BundleDaemonStorage::update_database_pendingacs()
                     pacs->durable_key().c_str());
         }
 
-        GlobalStore::instance()->unlock_db_access();
-
         // remove this entry from the add_update list if it is there
         result = add_update_pendingacs_->erase(pacs->durable_key());
         if (1 == result) {
@@ -970,8 +980,6 @@ BundleDaemonStorage::update_database_pendingacs()
 
         pacs->lock().lock("BundleDaemonStorage::update_database_pendingacs");
 
-        GlobalStore::instance()->lock_db_access("BundleDaemonStorage::update_database_pendingacs");
-
         if (pacs->in_datastore()) {
             if (! pastore->update(pacs)) {
                 log_crit("error updating Pending ACS %s in data store!!",
@@ -988,8 +996,6 @@ BundleDaemonStorage::update_database_pendingacs()
 	    ++stats_.pacs_in_db_;
         }
 
-        GlobalStore::instance()->unlock_db_access();
-
         pacs->lock().unlock();
 
         // remove this entry from the list
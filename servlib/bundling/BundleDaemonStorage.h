@@ -155,6 +155,16 @@ public:
      */
     void commit_all_updates();
 
+    /**
+     * How payloads are checked when bundles are reloaded at startup
+     */
+    typedef enum {
+        RELOAD_CHECK_NONE = 0,   ///< only check that the payload file exists
+        RELOAD_CHECK_SIZE,       ///< check the payload file size
+        RELOAD_CHECK_FULL,       ///< check the size and CRC before loading
+        RELOAD_CHECK_SCRUB,      ///< check the size and then the CRC in the background
+    } reload_check_t;
+
     /**
      * General daemon parameters
      */
@@ -174,8 +184,44 @@ public:
         /// whether to force payloads to sync to disk
         bool db_force_sync_to_disk_;
 
-        /// where bundle payloads should be stored (MEMORY, DISK or NODAT)
+        /// where bundle payloads should be stored (MEMORY, DISK, NODATA or HYBRID)
         BundlePayload::location_t payload_location_;
+
+        /// max bytes of HYBRID payloads to hold in memory
+        u_int64_t payload_mem_budget_;
+
+        /// percent of the budget at which payloads start to be spilled to disk
+        u_int32_t payload_mem_high_water_pct_;
+
+        /// percent of the budget at which spilling stops
+        u_int32_t payload_mem_low_water_pct_;
+
+        /// seconds without access before a payload is spilled (0 = never)
+        u_int32_t payload_mem_max_age_;
+
+        /// whether received payload data is buffered and written by the PayloadWriter
+        bool payload_write_behind_;
+
+        /// size of the aligned chunks written by the PayloadWriter
+        u_int32_t payload_write_chunk_;
+
+        /// max chunk memory buffered for the PayloadWriter across all payloads (0 = no limit)
+        u_int32_t payload_write_behind_limit_;
+
+        /// whether to preallocate payload files when the length is known
+        bool payload_preallocate_;
+
+        /// whether to produce outgoing payloads from mmap'ed read views
+        bool payload_read_views_;
+
+        /// whether to compute a CRC32C of payloads as they are written
+        bool payload_checksums_;
+
+        /// how payloads are checked when bundles are reloaded
+        reload_check_t payload_reload_check_;
+
+        /// max bytes per second read by the PayloadScrubber
+        u_int64_t payload_scrub_rate_;
     };
 
     static Params params_;
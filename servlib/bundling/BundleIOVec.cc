@@ -0,0 +1,171 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <string.h>
+
+#include <third_party/oasys/debug/DebugUtils.h>
+
+#include "BundleIOVec.h"
+
+namespace dtn {
+
+//----------------------------------------------------------------------
+BundleIOVec::BundleIOVec()
+    : pos_(0),
+      length_(0),
+      use_files_(false)
+{
+}
+
+//----------------------------------------------------------------------
+BundleIOVec::~BundleIOVec()
+{
+    clear();
+}
+
+//----------------------------------------------------------------------
+void
+BundleIOVec::clear()
+{
+    iov_.clear();
+    files_.clear();
+    pos_    = 0;
+    length_ = 0;
+
+    holders_.clear();
+    copies_.clear();
+}
+
+//----------------------------------------------------------------------
+void
+BundleIOVec::append(const u_char* buf, size_t len, BP_Local* holder)
+{
+    append_file(buf, len, -1, 0, holder);
+}
+
+//----------------------------------------------------------------------
+void
+BundleIOVec::append_file(const u_char* buf, size_t len, int fd,
+                         off_t file_offset, BP_Local* holder)
+{
+    if (len == 0) {
+        return;
+    }
+
+    if (holder != nullptr) {
+        if (holders_.empty() || holders_.back().object() != holder) {
+            holders_.push_back(BP_LocalRef(holder, "BundleIOVec"));
+        }
+    }
+
+    length_ += len;
+
+    if (iov_.size() > pos_) {
+        struct iovec& last = iov_.back();
+        FileSeg& last_file = files_.back();
+        if (((const u_char*)last.iov_base + last.iov_len == buf) &&
+            (last_file.fd_ == fd) &&
+            ((fd == -1) ||
+             (last_file.offset_ + (off_t)last.iov_len == file_offset)))
+        {
+            last.iov_len += len;
+            return;
+        }
+    }
+
+    struct iovec seg;
+    seg.iov_base = const_cast<u_char*>(buf);
+    seg.iov_len  = len;
+    iov_.push_back(seg);
+
+    FileSeg file_seg;
+    file_seg.fd_     = fd;
+    file_seg.offset_ = file_offset;
+    files_.push_back(file_seg);
+}
+
+//----------------------------------------------------------------------
+u_char*
+BundleIOVec::append_copy(size_t len)
+{
+    copies_.emplace_back(new u_char[len]);
+    u_char* buf = copies_.back().get();
+    append(buf, len);
+    return buf;
+}
+
+//----------------------------------------------------------------------
+void
+BundleIOVec::consume(size_t len)
+{
+    ASSERT(len <= length_);
+    length_ -= len;
+
+    while (len != 0) {
+        struct iovec& seg = iov_[pos_];
+        if (len < seg.iov_len) {
+            seg.iov_base = (u_char*)seg.iov_base + len;
+            seg.iov_len -= len;
+            files_[pos_].offset_ += len;
+            break;
+        }
+
+        len -= seg.iov_len;
+        ++pos_;
+    }
+
+    if (length_ == 0) {
+        clear();
+    }
+}
+
+//----------------------------------------------------------------------
+int
+BundleIOVec::iovcnt_before_file() const
+{
+    size_t i = pos_;
+    while ((i < files_.size()) && (files_[i].fd_ == -1)) {
+        ++i;
+    }
+    return i - pos_;
+}
+
+//----------------------------------------------------------------------
+int
+BundleIOVec::file_fd(int i, off_t* file_offset) const
+{
+    ASSERT(i < iovcnt());
+    const FileSeg& file_seg = files_[pos_ + i];
+    *file_offset = file_seg.offset_;
+    return file_seg.fd_;
+}
+
+//----------------------------------------------------------------------
+void
+BundleIOVec::copy_out(u_char* buf) const
+{
+    for (size_t i = pos_; i < iov_.size(); ++i) {
+        memcpy(buf, iov_[i].iov_base, iov_[i].iov_len);
+        buf += iov_[i].iov_len;
+    }
+}
+
+} // namespace dtn
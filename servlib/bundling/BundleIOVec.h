@@ -0,0 +1,140 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _BUNDLE_IOVEC_H_
+#define _BUNDLE_IOVEC_H_
+
+#include <memory>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+
+#include "BP_Local.h"
+
+namespace dtn {
+
+/**
+ * List of the segments of formatted bundle data filled in by
+ * BundleProtocol::produce_iov(). Each segment points at bytes that are
+ * already formatted somewhere else -- the contents buffer of a block,
+ * a read view of the payload, or a small buffer owned by the list for
+ * bytes that had to be copied -- so that a convergence layer can hand
+ * them to writev() or sendmsg() without first copying them into its
+ * own send buffer.
+ *
+ * The list holds a reference on the block processor locals that own a
+ * payload view so the mapped bytes stay valid until they have been
+ * consumed or the list is cleared, even if the block list itself is
+ * released first.
+ *
+ * If the convergence layer can send straight from a file (see
+ * set_use_files()), payload bytes that live in the payload file are
+ * also tagged with the file descriptor and offset so they can go out
+ * with sendfile() instead of being read through the mapping.
+ */
+class BundleIOVec {
+public:
+    BundleIOVec();
+    ~BundleIOVec();
+
+    /**
+     * Drop all of the segments along with the references and copy
+     * buffers that back them.
+     */
+    void clear();
+
+    /**
+     * Add len bytes at buf as the next segment. If holder is set, a
+     * reference to it is kept until the list is cleared. The range is
+     * merged into the previous segment if it directly follows it.
+     */
+    void append(const u_char* buf, size_t len, BP_Local* holder = nullptr);
+
+    /**
+     * Add len bytes at buf that are also found at file_offset in the
+     * file open on fd. The fd must stay open until the list is cleared
+     * (normally by being owned by the holder).
+     */
+    void append_file(const u_char* buf, size_t len, int fd, off_t file_offset,
+                     BP_Local* holder);
+
+    /**
+     * Add a len byte buffer owned by the list as the next segment and
+     * return it to be filled in.
+     */
+    u_char* append_copy(size_t len);
+
+    /**
+     * Drop the first len bytes of the list after they were written.
+     */
+    void consume(size_t len);
+
+    /// @{ Accessors for the segments that remain to be written
+    const struct iovec* iov()    const { return iov_.data() + pos_; }
+    int                 iovcnt() const { return iov_.size() - pos_; }
+    size_t              length() const { return length_; }
+    bool                empty()  const { return length_ == 0; }
+    /// @}
+
+    /// @{ Whether the producer should tag payload file segments
+    void set_use_files(bool use_files) { use_files_ = use_files; }
+    bool use_files() const { return use_files_; }
+    /// @}
+
+    /**
+     * The number of segments ahead of the first one that is tagged
+     * with a file (all of them if there is none).
+     */
+    int iovcnt_before_file() const;
+
+    /**
+     * The file descriptor of the i'th remaining segment or -1 if the
+     * segment is not tagged with a file. The file offset of the first
+     * byte of the segment is returned in file_offset.
+     */
+    int file_fd(int i, off_t* file_offset) const;
+
+    /**
+     * Copy the remaining bytes out to buf (which must hold length()
+     * bytes), mostly for the convergence layers that have to fall
+     * back to a contiguous buffer.
+     */
+    void copy_out(u_char* buf) const;
+
+protected:
+    /// Not copyable since the segments point into the copy buffers
+    BundleIOVec(const BundleIOVec&);
+    BundleIOVec& operator=(const BundleIOVec&);
+
+    /// File backing of a segment
+    struct FileSeg {
+        int   fd_;      ///< -1 if the segment is only in memory
+        off_t offset_;  ///< file offset of the first byte
+    };
+
+    std::vector<struct iovec>              iov_;     ///< the segments
+    std::vector<FileSeg>                   files_;   ///< file backing of each segment
+    size_t                                 pos_;     ///< index of the first unwritten segment
+    size_t                                 length_;  ///< unwritten bytes
+    std::vector<BP_LocalRef>               holders_; ///< owners of the viewed bytes
+    std::vector<std::unique_ptr<u_char[]>> copies_;  ///< buffers for copied bytes
+    bool                                   use_files_; ///< tag payload file segments
+};
+
+} // namespace dtn
+
+#endif /* _BUNDLE_IOVEC_H_ */
@@ -38,9 +38,16 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#ifdef __linux__
+#include <sys/xattr.h>
+#endif
+#include <unistd.h>
 #include <third_party/oasys/debug/DebugUtils.h>
 #include <third_party/oasys/io/FileUtils.h>
 #include <third_party/oasys/thread/SpinLock.h>
@@ -50,11 +57,25 @@
 #include "BundleDaemon.h"
 #include "BundleDaemonStorage.h"
 #include "BundlePayload.h"
+#include "PayloadMemoryManager.h"
+#include "PayloadWriter.h"
 #include "storage/BundleStore.h"
 
 
 #define FILEMODE_ALL (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)
 
+// max chunks queued to the PayloadWriter per payload before writes
+// are done directly by the caller
+#define MAX_QUEUED_WRITE_CHUNKS 16
+
+// max out of order ranges tracked for the incremental CRC
+#define MAX_CRC_EXTENTS 64
+
+// extended attribute of the payload file holding the payload length
+// and CRC32C; keeping it out of the bundle record leaves the
+// serialized schema (and the datastore digest) unchanged
+#define PAYLOAD_CRC_XATTR "user.dtnme.crc32c"
+
 
 namespace dtn {
 
@@ -93,6 +114,18 @@ BundlePayload::init(bundleid_t bundleid, location_t location)
 
     logpathf("/dtn/bundle/payload/%" PRIbid, bundleid);
 
+    if (location_ == HYBRID) {
+        if (PayloadMemoryManager::initialized()) {
+            // start out in memory and let the PayloadMemoryManager
+            // spill the payload to disk as needed
+            location_ = MEMORY;
+            hybrid_ = true;
+            PayloadMemoryManager::instance()->add_payload(this);
+        } else {
+            location_ = DISK;
+        }
+    }
+
     // nothing to do if there's no backing file
     if (location_ == MEMORY || location_ == NODATA) {
         return;
@@ -101,32 +134,48 @@ BundlePayload::init(bundleid_t bundleid, location_t location)
     //dz debug
     oasys::ScopeLock l(lock_, "BundlePayload::init");
 
-    // initialize the file handle for the backing store, but
-    // immediately close it
-    BundleStore* bs = BundleStore::instance();
-
     // XXX/demmer the simulator can't really deal with files, so this
     // is a hacky way to handle bundles that get created with a DISK
     // location in the simulator... a better fix would have this class
     // use oasys::FileBackedObjectStore and then have an in-memory
     // abstraction of the store that we use in the simulator, akin
     // to the memorydb version of the DurableStore
-    if (bs->payload_dir() == "NO_PAYLOAD_FILES") {
+    if (BundleStore::instance()->payload_dir() == "NO_PAYLOAD_FILES") {
         location_ = MEMORY;
         return;
     }
 
+    if (!create_payload_file()) {
+        return;
+    }
+
+    if (length_ > 0) {
+        // XXX/dz this will probably never be invoked
+        sync_payload();
+    }
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::create_payload_file()
+{
+    ASSERT(lock_->is_locked_by_me());
+    ASSERT(location_ == DISK);
+
+    // initialize the file handle for the backing store, but
+    // immediately close it
+    BundleStore* bs = BundleStore::instance();
 
     //XXX/dz too many files in a directory causes major delay when creating files
     oasys::StringBuffer sb_dirpath("%s/%" PRIbid,
-                             bs->payload_dir().c_str(), (bundleid / 10000));
+                             bs->payload_dir().c_str(), (bundleid_ / 10000));
 
     dir_path_ = sb_dirpath.c_str();
 
 
     // create the path into the subdirectory
     oasys::StringBuffer path("%s/bundle_%" PRIbid ".dat",
-                             dir_path_.c_str(), bundleid);
+                             dir_path_.c_str(), bundleid_);
 
     file_.logpathf("%s/file", logpath_);
 
@@ -137,10 +186,13 @@ BundlePayload::init(bundleid_t bundleid, location_t location)
     int err = 0;
     int open_errno = 0;
     int ctr = 0;
+    bool new_dir = false;
     while (++ctr < 4) {
         //create the subdirectory if it does not exist
         dir_lock_.lock(__func__);
-        mkdir(dir_path_.c_str(), 0777 ); 
+        if (mkdir(dir_path_.c_str(), 0777) == 0) {
+            new_dir = true;
+        }
 
         err = 0;
         open_errno = 0;
@@ -171,7 +223,7 @@ BundlePayload::init(bundleid_t bundleid, location_t location)
     {
         log_crit("aborting after error creating payload file %s: %s",
                  path.c_str(), strerror(errno));
-        return;
+        return false;
     }
 
     int fd = bs->payload_fdcache()->put_and_pin(file_.path(), file_.fd());
@@ -179,23 +231,34 @@ BundlePayload::init(bundleid_t bundleid, location_t location)
         PANIC("duplicate entry in open fd cache");
     }
 
-    if (length_ > 0) {
-        // XXX/dz this will probably never be invoked
-        sync_payload();
-    }
-
     unpin_file();
+
+    // the new directory entries are synced along with the next batch
+    // of bundles added to the database
+    bs->payload_file_created(dir_path_, new_dir);
+
+    return true;
 }
 
 //----------------------------------------------------------------------
 void
 BundlePayload::sync_payload()
 {
+    if (hybrid_ && (location_ == MEMORY)) {
+        // the payload has to be on disk to be durable
+        spill_to_disk();
+    }
+
     if (location_ == MEMORY || location_ == NODATA) {
         return;
     }
 
     oasys::ScopeLock scoplok(lock_, "BundlePayload::sync_payload");
+
+    // if the PayloadWriter already synced the completed payload then
+    // modified_ will have been cleared when this returns
+    flush_write_behind();
+
     if (modified_) {
 
         pin_file();
@@ -205,6 +268,8 @@ BundlePayload::sync_payload()
 
         syncing_file_ = true;
 
+        store_crc(file_.fd());
+
         scoplok.unlock();
 
         fsync(file_.fd());
@@ -262,12 +327,35 @@ BundlePayload::init_from_store(bundleid_t bundleid)
     if (fd != file_.fd()) {
         PANIC("duplicate entry in open fd cache");
     }
+
+    load_crc(fd);
+
     unpin_file();
 }
 
 //----------------------------------------------------------------------
 BundlePayload::~BundlePayload()
 {
+    if (hybrid_) {
+        PayloadMemoryManager::instance()->del_payload(this);
+
+        // wait for a spill that may be in progress
+        lock_->lock("BundlePayload::~BundlePayload");
+        lock_->unlock();
+    }
+
+    if (PayloadWriter::initialized()) {
+        PayloadWriter::instance()->cancel(this);
+    }
+
+    // the data has no place to go at this point
+    ASSERT(wb_direct_ == nullptr);
+    free_chunk(wb_cur_);
+    while (!wb_queued_.empty()) {
+        free_chunk(wb_queued_.front());
+        wb_queued_.pop_front();
+    }
+
     delete_payload_file();
 
     delete lock_;
@@ -317,6 +405,8 @@ BundlePayload::release_file(std::string& filename)
 
     oasys::ScopeLock scoplok(lock_, __func__);
 
+    flush_write_behind();
+
     // prevent the BDStorage from trying to sync to disk if possible
     modified_ = false;
 
@@ -368,6 +458,9 @@ BundlePayload::serialize(oasys::SerializeAction* a)
     if (a->action_code() == oasys::Serialize::UNMARSHAL) {
         length_ = u64_len;
         base_offset_ = u64_offset;
+
+        // the CRC is picked up from the payload file by init_from_store()
+        invalidate_crc();
     }
     
 }
@@ -377,8 +470,28 @@ void
 BundlePayload::set_length(size_t length)
 {
     oasys::ScopeLock l(lock_, "BundlePayload::set_length");
+
+    if (length < crc_len_) {
+        invalidate_crc();
+    }
+
+    if (hybrid_ && (location_ == MEMORY) && (length > mem_reserved_)) {
+        PayloadMemoryManager* pmm = PayloadMemoryManager::instance();
+        size_t amount = length - mem_reserved_;
+
+        // a payload that no longer fits in the budget goes to disk
+        // and if that can't be done right now it stays in memory
+        // over budget
+        if (!pmm->reserve(this, amount) && !internal_spill()) {
+            pmm->reserve(this, amount, true);
+        }
+    }
+
     length_ = length;
     if (location_ == MEMORY) {
+        // growing the buffer could move it out from under a read view
+        ASSERT((num_read_views_ == 0) || (length <= data_.buf_len()));
+
         data_.reserve(length);
         data_.set_len(length);
     }
@@ -455,6 +568,20 @@ BundlePayload::truncate(size_t length)
     oasys::ScopeLock l(lock_, "BundlePayload::truncate");
     
     ASSERT(length <= length_);
+
+    if (length < crc_len_) {
+        invalidate_crc();
+    } else if (!crc_extents_.empty()) {
+        // out of order ranges past the new end are no longer needed
+        std::map<size_t, CRCExtent>::iterator iter = crc_extents_.lower_bound(length);
+        if ((iter != crc_extents_.begin()) &&
+            (std::prev(iter)->first + std::prev(iter)->second.len_ > length)) {
+            invalidate_crc();
+        } else {
+            crc_extents_.erase(iter, crc_extents_.end());
+        }
+    }
+
     length_     = length;
     cur_offset_ = length; // XXX/demmer is this right?
     
@@ -463,17 +590,39 @@ BundlePayload::truncate(size_t length)
         data_.set_len(length);
         break;
     case DISK:
-        pin_file();
-        file_.truncate(length);
-        unpin_file();
+        flush_write_behind();
         modified_ = true;
+
+        // a read view maps the file and touching a mapped page past the
+        // end of the file raises SIGBUS, so the file keeps its length
+        // until the last view is released
+        if (num_read_views_ > 0) {
+            log_debug("deferring truncate to %zu with %d read views outstanding",
+                      length, num_read_views_);
+            truncate_pending_ = true;
+            break;
+        }
+        truncate_file();
         break;
     case NODATA:
     case DEFAULT:
+    case HYBRID:
         NOTREACHED;
     }
 }
 
+//----------------------------------------------------------------------
+void
+BundlePayload::truncate_file()
+{
+    ASSERT(lock_->is_locked_by_me());
+
+    pin_file();
+    file_.truncate(length_);
+    unpin_file();
+    truncate_pending_ = false;
+}
+
 //----------------------------------------------------------------------
 void
 BundlePayload::copy_file(oasys::FileIOClient* dst) const
@@ -484,6 +633,7 @@ BundlePayload::copy_file(oasys::FileIOClient* dst) const
 
     //dzdebug ASSERT(location_ == DISK);
     if (location_ == DISK) {
+        const_cast<BundlePayload*>(this)->flush_write_behind();
         pin_file();
         file_.lseek(0, SEEK_SET);
         file_.copy_contents(dst, length());
@@ -518,8 +668,18 @@ bool
 BundlePayload::replace_with_file(const char* path)
 {
     oasys::ScopeLock l(lock_, "BundlePayload::replace_with_file");
+
+    if (hybrid_ && (location_ == MEMORY)) {
+        // the payload is replaced by a file so it has to be on disk
+        internal_spill();
+    }
     
     ASSERT(location_ == DISK);
+    flush_write_behind();
+
+    // the new contents never pass through here
+    invalidate_crc();
+
     std::string payload_path = file_.path();
 
     // first flush the old fd from the cache and unlink the file
@@ -602,6 +762,10 @@ BundlePayload::internal_write(const u_char* bp, size_t offset, size_t len)
         memcpy(data_.buf() + offset, bp, len);
         break;
     case DISK:
+        // anything still buffered has to go out first to keep the
+        // writes in order
+        flush_write_behind();
+
         // check if we need to seek
         if (cur_offset_ != offset) {
             file_.lseek(offset, SEEK_SET);
@@ -621,10 +785,12 @@ BundlePayload::internal_write(const u_char* bp, size_t offset, size_t len)
             cur_offset_ += len;
         }
 
+        ++wb_seq_;
         modified_ = true;
         break;
     case NODATA:
     case DEFAULT:
+    case HYBRID:
         NOTREACHED;
     }
 }
@@ -656,12 +822,124 @@ BundlePayload::append_data(const u_char* bp, size_t len)
 
     size_t old_length = length_;
     set_length(length_ + len);
+
+    update_crc(bp, old_length, len);
+
+    if (buffer_write(bp, old_length, len)) {
+        return;
+    }
     
     pin_file();
     internal_write(bp, old_length, len);
     unpin_file();
 }
 
+//----------------------------------------------------------------------
+u_char*
+BundlePayload::direct_append_buf(size_t len, size_t* avail)
+{
+    oasys::ScopeLock l(lock_, "BundlePayload::direct_append_buf");
+
+    ASSERT(wb_direct_ == nullptr);
+    *avail = 0;
+
+    if (len == 0) {
+        return nullptr;
+    }
+
+    switch (location_) {
+    case MEMORY:
+    {
+        // growing a hybrid payload may need to spill it to disk
+        if (hybrid_ || (num_read_views_ != 0)) {
+            return nullptr;
+        }
+
+        // grow the buffer to the full expected length up front
+        data_.reserve(std::max(length_ + len, expected_len_));
+        *avail = len;
+        return data_.buf() + length_;
+    }
+
+    case DISK:
+    {
+        size_t chunk_size = BundleDaemonStorage::params_.payload_write_chunk_;
+
+        if ((chunk_size == 0) || !BundleDaemonStorage::params_.payload_write_behind_ ||
+            !PayloadWriter::initialized() || !PayloadWriter::instance()->accepting() ||
+            (wb_queued_.size() >= MAX_QUEUED_WRITE_CHUNKS)) {
+            return nullptr;
+        }
+
+        // the data goes on the end of the current chunk or starts a
+        // new one. the chunk is taken out of wb_cur_ until the data
+        // is in so a flush can't hand it to the PayloadWriter
+        if (wb_cur_ != nullptr) {
+            if (length_ != (wb_cur_->offset_ + wb_cur_->buf_.len())) {
+                return nullptr;
+            }
+            wb_direct_ = wb_cur_;
+            wb_cur_ = nullptr;
+        } else {
+            wb_direct_ = alloc_chunk(length_, chunk_size);
+            if (wb_direct_ == nullptr) {
+                return nullptr;
+            }
+        }
+
+        *avail = std::min(len, wb_direct_->buf_.nfree());
+        return wb_direct_->buf_.buf() + wb_direct_->buf_.len();
+    }
+
+    case NODATA:
+    case DEFAULT:
+    case HYBRID:
+        break;
+    }
+
+    return nullptr;
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::direct_append_done(size_t len)
+{
+    oasys::ScopeLock l(lock_, "BundlePayload::direct_append_done");
+
+    size_t offset = length_;
+
+    if (location_ == MEMORY) {
+        ASSERT(data_.buf_len() >= (offset + len));
+        set_length(offset + len);
+        update_crc(data_.buf() + offset, offset, len);
+        return;
+    }
+
+    ASSERT(wb_direct_ != nullptr);
+    PendingWrite* chunk = wb_direct_;
+    wb_direct_ = nullptr;
+
+    if (len != 0) {
+        ASSERT(len <= chunk->buf_.nfree());
+        set_length(offset + len);
+        update_crc(chunk->buf_.buf() + chunk->buf_.len(), offset, len);
+        chunk->buf_.incr_len(len);
+
+        ++wb_seq_;
+        modified_ = true;
+    }
+
+    if (chunk->buf_.len() == 0) {
+        free_chunk(chunk);
+    } else if ((chunk->buf_.nfree() == 0) ||
+               ((expected_len_ != 0) && (length_ >= expected_len_))) {
+        wb_queued_.push_back(chunk);
+        PayloadWriter::instance()->post(this);
+    } else {
+        wb_cur_ = chunk;
+    }
+}
+
 //----------------------------------------------------------------------
 void
 BundlePayload::write_data(const u_char* bp, size_t offset, size_t len)
@@ -669,6 +947,13 @@ BundlePayload::write_data(const u_char* bp, size_t offset, size_t len)
     oasys::ScopeLock l(lock_, "BundlePayload::write_data");
     
     ASSERT(length_ >= (len + offset));
+
+    update_crc(bp, offset, len);
+
+    if (buffer_write(bp, offset, len)) {
+        return;
+    }
+
     pin_file();
     internal_write(bp, offset, len);
     unpin_file();
@@ -698,6 +983,8 @@ BundlePayload::write_data(const BundlePayload& src, size_t src_offset,
     oasys::ScratchBuffer<u_char*, 1024> buf(len);
     const u_char* bp = src.read_data(src_offset, len, buf.buf());
 
+    update_crc(bp, dst_offset, len);
+
     pin_file();
     internal_write(bp, dst_offset, len);
     unpin_file();
@@ -718,9 +1005,14 @@ BundlePayload::read_data(size_t offset, size_t len, u_char* buf)
     switch(location_) {
     case MEMORY:
         memcpy(buf, data_.buf() + offset, len);
+
+        if (hybrid_) {
+            PayloadMemoryManager::instance()->touch(this, offset, len);
+        }
         break;
 
     case DISK:
+        flush_write_behind();
         pin_file();
         
         // check if we need to seek first
@@ -736,11 +1028,727 @@ BundlePayload::read_data(size_t offset, size_t len, u_char* buf)
 
     case NODATA:
     case DEFAULT:
+    case HYBRID:
         NOTREACHED;
     }
 
     return buf;
 }
 
+//----------------------------------------------------------------------
+bool
+BundlePayload::get_read_view(size_t offset, size_t len, ReadView* view) const
+{
+    ASSERT(view != nullptr);
+    view->release();
+
+    if (len == 0) {
+        return false;
+    }
+
+    oasys::ScopeLock l(lock_, "BundlePayload::get_read_view");
+
+    ASSERTF(length_ >= (offset + len),
+            "length=%zu offset=%zu len=%zu",
+            length_, offset, len);
+
+    switch(location_) {
+    case MEMORY:
+        view->buf_ = data_.buf() + offset;
+
+        if (hybrid_) {
+            PayloadMemoryManager::instance()->touch(const_cast<BundlePayload*>(this), offset, len);
+        }
+        break;
+
+    case DISK:
+    {
+        const_cast<BundlePayload*>(this)->flush_write_behind();
+
+        if (!pin_file()) {
+            return false;
+        }
+
+        // mmap offsets must be page aligned so map from the start of
+        // the page and point the view at the requested byte
+        static const size_t page_size = sysconf(_SC_PAGESIZE);
+        size_t map_offset = offset - (offset % page_size);
+        size_t map_len    = len + (offset - map_offset);
+
+        oasys::MmapFile* mmap = new oasys::MmapFile(logpath_);
+        u_char* ptr = (u_char*) mmap->map_fd(file_.fd(), PROT_READ, MAP_SHARED,
+                                             map_len, map_offset);
+
+        // the mapping holds its own reference to the file so the fd
+        // can go back to the cache right away
+        unpin_file();
+
+        if (ptr == nullptr) {
+            delete mmap;
+            return false;
+        }
+
+        madvise(ptr, map_len, MADV_SEQUENTIAL);
+
+        view->mmap_ = mmap;
+        view->buf_  = ptr + (offset - map_offset);
+        break;
+    }
+
+    case NODATA:
+    case DEFAULT:
+    case HYBRID:
+        return false;
+    }
+
+    view->payload_ = this;
+    view->offset_  = offset;
+    view->len_     = len;
+
+    ++num_read_views_;
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::preallocate(size_t len)
+{
+    oasys::ScopeLock l(lock_, "BundlePayload::preallocate");
+
+    expected_len_ = len;
+
+    if ((location_ != DISK) || (len <= length_) ||
+        !BundleDaemonStorage::params_.payload_preallocate_) {
+        return;
+    }
+
+#ifdef __linux__
+    if (pin_file()) {
+        // keep the file size so that it still reflects what has been
+        // written if the bundle does not arrive in full
+        if ((fallocate(file_.fd(), FALLOC_FL_KEEP_SIZE, 0, len) != 0) &&
+            (errno != EOPNOTSUPP)) {
+            log_warn("error preallocating %zu bytes for payload file %s: %s",
+                     len, file_.path(), strerror(errno));
+        }
+        unpin_file();
+    }
+#endif
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::update_crc(const u_char* bp, size_t offset, size_t len)
+{
+    ASSERT(lock_->is_locked_by_me());
+
+    if (!crc_valid_ || (len == 0)) {
+        return;
+    }
+
+    if (!BundleDaemonStorage::params_.payload_checksums_) {
+        invalidate_crc();
+        return;
+    }
+
+    std::map<size_t, CRCExtent>::iterator next;
+
+    if (offset == crc_len_) {
+        crc_ = oasys::CRC32C::extend(crc_, bp, len);
+        crc_len_ += len;
+
+        next = crc_extents_.begin();
+        if ((next != crc_extents_.end()) && (next->first < crc_len_)) {
+            // overlaps data that was written out of order
+            invalidate_crc();
+            return;
+        }
+    } else if (offset < crc_len_) {
+        // data that has already been covered is being rewritten
+        invalidate_crc();
+        return;
+    } else {
+        // written ahead of the covered range so keep the CRC of this
+        // range by itself until the gap is filled in
+        next = crc_extents_.lower_bound(offset);
+        if ((next != crc_extents_.end()) && (next->first < (offset + len))) {
+            invalidate_crc();
+            return;
+        }
+
+        std::map<size_t, CRCExtent>::iterator prev = next;
+        if ((next != crc_extents_.begin()) &&
+            ((--prev)->first + prev->second.len_ >= offset)) {
+            if (prev->first + prev->second.len_ > offset) {
+                invalidate_crc();
+                return;
+            }
+
+            // extends the previous range
+            prev->second.crc_ = oasys::CRC32C::extend(prev->second.crc_, bp, len);
+            prev->second.len_ += len;
+        } else {
+            if (crc_extents_.size() >= MAX_CRC_EXTENTS) {
+                invalidate_crc();
+                return;
+            }
+
+            CRCExtent extent;
+            extent.len_ = len;
+            extent.crc_ = oasys::CRC32C::extend(0, bp, len);
+            prev = crc_extents_.insert(next, std::make_pair(offset, extent));
+        }
+
+        // join the following range if the gap to it was just closed
+        if ((next != crc_extents_.end()) &&
+            (prev->first + prev->second.len_ == next->first)) {
+            prev->second.crc_ = oasys::CRC32C::combine(prev->second.crc_, next->second.crc_,
+                                                       next->second.len_);
+            prev->second.len_ += next->second.len_;
+            crc_extents_.erase(next);
+        }
+        return;
+    }
+
+    // fold in any ranges that now pick up where the covered range ends
+    while (!crc_extents_.empty() && (crc_extents_.begin()->first == crc_len_)) {
+        next = crc_extents_.begin();
+        crc_ = oasys::CRC32C::combine(crc_, next->second.crc_, next->second.len_);
+        crc_len_ += next->second.len_;
+        crc_extents_.erase(next);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::invalidate_crc()
+{
+    crc_valid_ = false;
+    crc_ = 0;
+    crc_len_ = 0;
+    crc_extents_.clear();
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::store_crc(int fd)
+{
+    ASSERT(lock_->is_locked_by_me());
+
+#ifdef __linux__
+    if (!BundleDaemonStorage::params_.payload_checksums_) {
+        return;
+    }
+
+    if (!crc_valid()) {
+        // drop a CRC that no longer matches the rewritten file
+        fremovexattr(fd, PAYLOAD_CRC_XATTR);
+        return;
+    }
+
+    u_char buf[sizeof(u_int64_t) + sizeof(u_int32_t)];
+    u_int64_t len = length_;
+    memcpy(buf, &len, sizeof(len));
+    memcpy(buf + sizeof(len), &crc_, sizeof(crc_));
+
+    if (fsetxattr(fd, PAYLOAD_CRC_XATTR, buf, sizeof(buf), 0) != 0) {
+        log_debug("unable to store the CRC32C of payload file %s: %s",
+                  file_.path(), strerror(errno));
+    }
+#else
+    (void) fd;
+#endif
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::load_crc(int fd)
+{
+    ASSERT(lock_->is_locked_by_me());
+
+    invalidate_crc();
+
+#ifdef __linux__
+    u_char buf[sizeof(u_int64_t) + sizeof(u_int32_t)];
+
+    if (fgetxattr(fd, PAYLOAD_CRC_XATTR, buf, sizeof(buf)) != (ssize_t) sizeof(buf)) {
+        // stored without checksums or on a filesystem without
+        // extended attributes so only the size can be checked
+        return;
+    }
+
+    u_int64_t len;
+    memcpy(&len, buf, sizeof(len));
+
+    if (len != length_) {
+        log_debug("ignoring CRC32C of payload file %s stored for %" PRIu64 " bytes",
+                  file_.path(), len);
+        return;
+    }
+
+    memcpy(&crc_, buf + sizeof(len), sizeof(crc_));
+    crc_len_ = length_;
+    crc_valid_ = true;
+#else
+    (void) fd;
+#endif
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::get_crc(u_int32_t* crc, size_t* len) const
+{
+    oasys::ScopeLock l(lock_, "BundlePayload::get_crc");
+
+    if (!crc_valid()) {
+        return false;
+    }
+
+    *crc = crc_;
+    *len = length_;
+    return true;
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::validate(bool check_crc)
+{
+    oasys::ScopeLock l(lock_, "BundlePayload::validate");
+
+    if (location_ != DISK) {
+        return (location_ == MEMORY);
+    }
+
+    flush_write_behind();
+
+    if (!pin_file()) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(file_.fd(), &st) != 0) {
+        log_err("validate: error checking payload file %s: %s",
+                file_.path(), strerror(errno));
+        unpin_file();
+        return false;
+    }
+
+    if ((size_t) st.st_size != length_) {
+        log_err("validate: payload file %s is %zu bytes but the payload is %zu bytes",
+                file_.path(), (size_t) st.st_size, length_);
+        unpin_file();
+        return false;
+    }
+
+    bool result = true;
+
+    if (check_crc && crc_valid()) {
+        oasys::ScratchBuffer<u_char*> buf(64 * 1024);
+        u_int32_t crc = 0;
+        size_t offset = 0;
+
+        while (offset < length_) {
+            size_t toread = std::min(length_ - offset, buf.buf_len());
+            ssize_t cc = ::pread(file_.fd(), buf.buf(), toread, offset);
+            if (cc <= 0) {
+                log_err("validate: error reading payload file %s: %s",
+                        file_.path(), strerror(errno));
+                result = false;
+                break;
+            }
+
+            crc = oasys::CRC32C::extend(crc, buf.buf(), cc);
+            offset += cc;
+        }
+
+        if (result && (crc != crc_)) {
+            log_err("validate: payload file %s CRC32C is 0x%08x but expected 0x%08x",
+                    file_.path(), crc, crc_);
+            result = false;
+        }
+    }
+
+    unpin_file();
+
+    return result;
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::buffer_write(const u_char* bp, size_t offset, size_t len)
+{
+    ASSERT(lock_->is_locked_by_me());
+
+    size_t chunk_size = BundleDaemonStorage::params_.payload_write_chunk_;
+
+    if ((location_ != DISK) || (chunk_size == 0) ||
+        !BundleDaemonStorage::params_.payload_write_behind_ ||
+        !PayloadWriter::initialized() || !PayloadWriter::instance()->accepting()) {
+        return false;
+    }
+
+    if (wb_queued_.size() >= MAX_QUEUED_WRITE_CHUNKS) {
+        // the disk is not keeping up so let the caller write
+        // everything out directly
+        return false;
+    }
+
+    bool post = false;
+
+    // a write that does not pick up where the current chunk leaves
+    // off starts a new one
+    if ((wb_cur_ != nullptr) && (offset != (wb_cur_->offset_ + wb_cur_->buf_.len()))) {
+        wb_queued_.push_back(wb_cur_);
+        wb_cur_ = nullptr;
+        post = true;
+    }
+
+    while (len > 0) {
+        if (wb_cur_ == nullptr) {
+            wb_cur_ = alloc_chunk(offset, chunk_size);
+            if (wb_cur_ == nullptr) {
+                // over the PayloadWriter limit so the caller writes it
+                // directly; that flushes whatever was buffered first
+                return false;
+            }
+        }
+
+        size_t tocopy = std::min(len, wb_cur_->buf_.nfree());
+        memcpy(wb_cur_->buf_.buf() + wb_cur_->buf_.len(), bp, tocopy);
+        wb_cur_->buf_.incr_len(tocopy);
+
+        bp     += tocopy;
+        offset += tocopy;
+        len    -= tocopy;
+
+        if ((wb_cur_->buf_.nfree() == 0) ||
+            ((expected_len_ != 0) && (offset >= expected_len_))) {
+            wb_queued_.push_back(wb_cur_);
+            wb_cur_ = nullptr;
+            post = true;
+        }
+    }
+
+    ++wb_seq_;
+    modified_ = true;
+
+    if (post) {
+        PayloadWriter::instance()->post(this);
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+BundlePayload::PendingWrite*
+BundlePayload::alloc_chunk(size_t offset, size_t chunk_size)
+{
+    // end each chunk on a chunk size boundary so the file is written
+    // in large aligned pieces
+    size_t len = chunk_size - (offset % chunk_size);
+
+    if (!PayloadWriter::instance()->reserve_buffer(len)) {
+        return nullptr;
+    }
+
+    PendingWrite* chunk = new PendingWrite();
+    chunk->offset_   = offset;
+    chunk->reserved_ = len;
+    chunk->buf_.reserve(len);
+    return chunk;
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::free_chunk(PendingWrite* chunk)
+{
+    if (chunk == nullptr) {
+        return;
+    }
+
+    PayloadWriter::instance()->release_buffer(chunk->reserved_);
+    delete chunk;
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::write_chunk(int fd, const PendingWrite* chunk)
+{
+    const u_char* bp  = chunk->buf_.buf();
+    size_t offset     = chunk->offset_;
+    size_t len        = chunk->buf_.len();
+
+    while (len > 0) {
+        ssize_t cc = ::pwrite(fd, bp, len, offset);
+        if (cc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            log_err("%s: error writing %zu bytes at offset %zu to file(fd: %d): %s",
+                    __func__, len, offset, fd, strerror(errno));
+            return false;
+        }
+
+        bp     += cc;
+        offset += cc;
+        len    -= cc;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::flush_write_behind()
+{
+    ASSERT(lock_->is_locked_by_me());
+
+    if (wb_cur_ != nullptr) {
+        wb_queued_.push_back(wb_cur_);
+        wb_cur_ = nullptr;
+    }
+
+    // the PayloadWriter does not need the lock to finish the chunk
+    // it is working on
+    if (PayloadWriter::initialized()) {
+        PayloadWriter::instance()->wait_for_write(this);
+    }
+
+    if (wb_queued_.empty()) {
+        return;
+    }
+
+    if (!pin_file()) {
+        log_err("unable to write %zu buffered chunks to payload file %s",
+                wb_queued_.size(), file_.path());
+    }
+
+    while (!wb_queued_.empty()) {
+        PendingWrite* chunk = wb_queued_.front();
+        wb_queued_.pop_front();
+
+        if (file_.is_open()) {
+            write_chunk(file_.fd(), chunk);
+        }
+        free_chunk(chunk);
+    }
+
+    unpin_file();
+}
+
+//----------------------------------------------------------------------
+size_t
+BundlePayload::write_queued_chunks(size_t* num_chunks, bool* error)
+{
+    size_t bytes = 0;
+
+    *num_chunks = 0;
+    *error = false;
+
+    lock_->lock("BundlePayload::write_queued_chunks");
+
+    while (!wb_queued_.empty()) {
+        PendingWrite* chunk = wb_queued_.front();
+        wb_queued_.pop_front();
+
+        if ((location_ != DISK) || !pin_file()) {
+            *error = true;
+            free_chunk(chunk);
+            continue;
+        }
+
+        // write without holding the lock so that the receiving thread
+        // can keep filling in the next chunk
+        int fd = file_.fd();
+        PayloadWriter::instance()->set_write_in_progress(this, true);
+        lock_->unlock();
+
+        if (!write_chunk(fd, chunk)) {
+            *error = true;
+        }
+
+        bytes += chunk->buf_.len();
+        ++(*num_chunks);
+        free_chunk(chunk);
+
+        unpin_file();
+        PayloadWriter::instance()->set_write_in_progress(this, false);
+
+        lock_->lock("BundlePayload::write_queued_chunks");
+    }
+
+    lock_->unlock();
+
+    return bytes;
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::sync_if_complete()
+{
+    lock_->lock("BundlePayload::sync_if_complete");
+
+    if ((location_ != DISK) || !modified_ || (expected_len_ == 0) ||
+        (length_ < expected_len_) || (wb_cur_ != nullptr) || !wb_queued_.empty() ||
+        !pin_file()) {
+        lock_->unlock();
+        return false;
+    }
+
+    int fd = file_.fd();
+    u_int64_t seq = wb_seq_;
+
+    store_crc(fd);
+
+    // the sync does not hold off flush_write_behind() so a reader
+    // taking the lock never waits on the disk; anything written in
+    // the meantime bumps wb_seq_ and leaves the file marked modified
+    syncing_file_ = true;
+    lock_->unlock();
+
+    fsync(fd);
+    unpin_file();
+
+    syncing_file_ = false;
+
+    lock_->lock("BundlePayload::sync_if_complete");
+
+    // only clear the flag if nothing was written during the sync
+    if (seq == wb_seq_) {
+        modified_ = false;
+    }
+    lock_->unlock();
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::spill_to_disk()
+{
+    oasys::ScopeLock l(lock_, "BundlePayload::spill_to_disk");
+
+    if (location_ == DISK) {
+        return true;
+    }
+
+    return internal_spill();
+}
+
+//----------------------------------------------------------------------
+bool
+BundlePayload::internal_spill()
+{
+    ASSERT(lock_->is_locked_by_me());
+
+    // only hybrid payloads still tracked by the manager move; one
+    // that is no longer tracked is in the middle of being deleted
+    if (!hybrid_ || !mem_tracked_ || (location_ != MEMORY)) {
+        return false;
+    }
+
+    // a read view points directly into the memory buffer
+    if (num_read_views_ > 0) {
+        log_debug("not spilling payload to disk with %d read views outstanding",
+                  num_read_views_);
+        return false;
+    }
+
+    if (BundleStore::instance()->payload_dir() == "NO_PAYLOAD_FILES") {
+        return false;
+    }
+
+    location_ = DISK;
+    if (!create_payload_file()) {
+        location_ = MEMORY;
+        return false;
+    }
+
+    cur_offset_ = 0;
+
+    if (length_ > 0) {
+        pin_file();
+        internal_write(data_.buf(), 0, length_);
+        unpin_file();
+    }
+
+    log_debug("spilled %zu byte payload to disk", length_);
+
+    data_.free_buf();
+
+    PayloadMemoryManager::instance()->payload_spilled(this);
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+BundlePayload::ReadView::ReadView()
+    : payload_(nullptr),
+      buf_(nullptr),
+      offset_(0),
+      len_(0),
+      mmap_(nullptr),
+      fd_(-1)
+{
+}
+
+//----------------------------------------------------------------------
+BundlePayload::ReadView::~ReadView()
+{
+    release();
+}
+
+//----------------------------------------------------------------------
+int
+BundlePayload::ReadView::file_fd()
+{
+    if ((fd_ != -1) || (mmap_ == nullptr)) {
+        return fd_;
+    }
+
+    oasys::ScopeLock l(payload_->lock_, "BundlePayload::ReadView::file_fd");
+
+    if (payload_->pin_file()) {
+        fd_ = dup(payload_->file_.fd());
+        payload_->unpin_file();
+    }
+
+    return fd_;
+}
+
+//----------------------------------------------------------------------
+void
+BundlePayload::ReadView::release()
+{
+    if (mmap_ != nullptr) {
+        delete mmap_;  // unmaps the range
+        mmap_ = nullptr;
+    }
+
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    if (payload_ != nullptr) {
+        oasys::ScopeLock l(payload_->lock_, "BundlePayload::ReadView::release");
+        ASSERT(payload_->num_read_views_ > 0);
+        --payload_->num_read_views_;
+
+        if ((payload_->num_read_views_ == 0) && payload_->truncate_pending_ &&
+            (payload_->location_ == DISK))
+        {
+            const_cast<BundlePayload*>(payload_)->truncate_file();
+        }
+        payload_ = nullptr;
+    }
+
+    buf_    = nullptr;
+    offset_ = 0;
+    len_    = 0;
+}
+
 
 } // namespace dtn
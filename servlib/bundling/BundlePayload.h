@@ -35,10 +35,18 @@
 #ifndef _BUNDLE_PAYLOAD_H_
 #define _BUNDLE_PAYLOAD_H_
 
+#include <atomic>
+#include <deque>
+#include <list>
+#include <map>
 #include <string>
 #include <third_party/oasys/serialize/Serialize.h>
 #include <third_party/oasys/debug/DebugUtils.h>
 #include <third_party/oasys/io/FileIOClient.h>
+#include <third_party/oasys/io/MmapFile.h>
+#include <third_party/oasys/util/CRC32C.h>
+#include <third_party/oasys/util/ScratchBuffer.h>
+#include <third_party/oasys/util/Time.h>
 
 namespace dtn {
 
@@ -68,6 +76,7 @@ public:
         MEMORY = 1,	 /// in memory only (TempBundle)
         DISK   = 2,	 /// on disk
         NODATA = 3,	 /// no data storage at all (used for simulator)
+        HYBRID = 4,	 /// in memory within the PayloadMemoryManager budget, else on disk
     } location_t;
     
     /**
@@ -81,15 +90,37 @@ public:
     void init_from_store(bundleid_t bundleid);
   
     /**
-     * Sync the payload file to disk (if location = DISK)
+     * Sync the payload file to disk (if location = DISK). A hybrid
+     * payload still held in memory is first spilled to disk.
      */
     void sync_payload();
+
+    /**
+     * Move a hybrid payload that is held in memory out to its
+     * payload file.
+     *
+     * @return true if the payload is now on disk
+     */
+    bool spill_to_disk();
+
+    /**
+     * Whether the payload was created with the HYBRID location.
+     */
+    bool is_hybrid() const { return hybrid_; }
   
     /**
      * Set the payload length in preparation for filling in with data.
      */
     void set_length(size_t len);
 
+    /**
+     * Hint that the payload is going to be filled in to a total of
+     * len bytes. Space is preallocated for the payload file and the
+     * last buffered chunk is handed to the PayloadWriter as soon as
+     * it has been written.
+     */
+    void preallocate(size_t len);
+
     /**
      * Truncate the payload. Used for reactive fragmentation.
      */
@@ -104,6 +135,39 @@ public:
      * The payload location.
      */
     location_t location() const { return location_; }
+
+    /**
+     * Whether crc() covers the entire payload. The CRC is given up on
+     * if data is rewritten or arrives too far out of order to track.
+     */
+    bool crc_valid() const
+    {
+        return crc_valid_ && (crc_len_ == length_) && crc_extents_.empty();
+    }
+
+    /**
+     * The CRC32C of the payload data, computed as it was written.
+     */
+    u_int32_t crc() const { return crc_; }
+
+    /**
+     * Take the CRC and the length it covers together under the payload
+     * lock, for a reader that checks the data while it may still be
+     * written to.
+     *
+     * @return false (leaving crc and len alone) if the CRC does not
+     * cover the whole payload
+     */
+    bool get_crc(u_int32_t* crc, size_t* len) const;
+
+    /**
+     * Check that the payload file holds length() bytes and, if
+     * check_crc is set and the CRC is valid, that the data matches
+     * the CRC.
+     *
+     * @return true if the payload checks out
+     */
+    bool validate(bool check_crc);
     
     /**
      * Set the payload data and length.
@@ -121,6 +185,26 @@ public:
      */
     void append_data(const u_char* bp, size_t len);
 
+    /**
+     * Get a buffer for receiving up to len bytes of data to be added to
+     * the end of the payload, so a convergence layer can read them
+     * from its socket directly instead of reading into its own buffer
+     * and calling append_data(). The buffer is the in-memory payload
+     * or the next write behind chunk of a DISK payload. Every call
+     * must be followed by direct_append_done().
+     *
+     * @return the buffer, with the number of bytes it takes (which may
+     * be less than len) in *avail, or nullptr if append_data() has to
+     * be used
+     */
+    u_char* direct_append_buf(size_t len, size_t* avail);
+
+    /**
+     * Add the first len bytes (possibly none) of the buffer returned
+     * by direct_append_buf() to the payload.
+     */
+    void direct_append_done(size_t len);
+
     /**
      * Write a chunk of payload data at the specified offset. The
      * length must have been previously set to at least offset + len.
@@ -190,6 +274,70 @@ public:
             read_data(offset, len, buf);
     }
 
+    /**
+     * A pinned, read-only view of a range of the payload data. For
+     * DISK payloads the range is mmap'ed from the payload file and for
+     * MEMORY payloads it points directly into the in-memory buffer so
+     * the bytes can be consumed without first copying them out. The
+     * payload must not be resized while a view is held. A truncate
+     * shortens it right away but leaves the file length alone until
+     * the last view is released.
+     */
+    class ReadView {
+    public:
+        ReadView();
+        ~ReadView();
+
+        /**
+         * Unmap the range (if needed) and unpin the payload.
+         */
+        void release();
+
+        /// @{ Accessors
+        bool          valid()  const { return buf_ != nullptr; }
+        const u_char* buf()    const { return buf_; }
+        size_t        offset() const { return offset_; }
+        size_t        len()    const { return len_; }
+        /// @}
+
+        /**
+         * A descriptor for the payload file that stays open as long
+         * as the view, for handing the range to sendfile(). The first
+         * call dups the descriptor out of the payload fd cache.
+         *
+         * @return the fd or -1 if the payload is not on disk
+         */
+        int file_fd();
+
+    protected:
+        friend class BundlePayload;
+
+        /// Views are not copyable
+        ReadView(const ReadView&);
+        ReadView& operator=(const ReadView&);
+
+        const BundlePayload* payload_; ///< the pinned payload
+        const u_char*        buf_;     ///< pointer to the first byte of the range
+        size_t               offset_;  ///< payload offset of the first byte
+        size_t               len_;     ///< length of the range
+        oasys::MmapFile*     mmap_;    ///< mapping of the file (DISK only)
+        int                  fd_;      ///< dup of the file descriptor (DISK only)
+    };
+
+    /**
+     * Set up a borrowed view of len bytes of the payload starting at
+     * offset instead of copying them out with read_data().
+     *
+     * @return true if the view was established, false if the caller
+     * should fall back to read_data()
+     */
+    bool get_read_view(size_t offset, size_t len, ReadView* view) const;
+
+    /**
+     * The number of read views currently outstanding.
+     */
+    int num_read_views() const { return num_read_views_; }
+
     /**
      * Release the database payload file to be handed off to an app. 
      * Moves the file up to the main bundle storage path and 
@@ -213,6 +361,41 @@ public:
     static bool test_no_remove_;    ///< test: don't rm payload files
 
 protected:
+    friend class PayloadMemoryManager;
+    friend class PayloadWriter;
+
+    /**
+     * A chunk of payload data waiting to be written to the file.
+     */
+    struct PendingWrite {
+        size_t offset_;                      ///< payload offset of the chunk
+        size_t reserved_;                    ///< bytes charged to the PayloadWriter limit
+        oasys::ScratchBuffer<u_char*> buf_;  ///< the chunk data
+    };
+
+    /**
+     * A range of payload data that was written ahead of the range
+     * covered by crc_ and the CRC32C of just that range.
+     */
+    struct CRCExtent {
+        size_t len_;
+        u_int32_t crc_;
+    };
+
+    void update_crc(const u_char* bp, size_t offset, size_t len);
+    void invalidate_crc();
+    void store_crc(int fd);
+    void load_crc(int fd);
+    void truncate_file();
+    bool buffer_write(const u_char* bp, size_t offset, size_t len);
+    bool write_chunk(int fd, const PendingWrite* chunk);
+    PendingWrite* alloc_chunk(size_t offset, size_t chunk_size);
+    void free_chunk(PendingWrite* chunk);
+    void flush_write_behind();
+    size_t write_queued_chunks(size_t* num_chunks, bool* error);
+    bool sync_if_complete();
+    bool create_payload_file();
+    bool internal_spill();
     bool pin_file() const;
     void unpin_file() const;
     void internal_write(const u_char* bp, size_t offset, size_t len);
@@ -230,7 +413,39 @@ protected:
 
     bundleid_t bundleid_;
 
-    bool syncing_file_ = false;  ///< flag indicating whether a file sync is in progress
+    /// Whether a file sync is in progress; set under lock_ but cleared
+    /// by the syncing thread without it, since release_file() waits
+    /// for it while holding lock_
+    std::atomic<bool> syncing_file_{false};
+
+    mutable int num_read_views_ = 0; ///< number of outstanding ReadViews
+    bool truncate_pending_ = false;  ///< file truncate waiting on the read views
+
+    /// @{ Incremental CRC32C of the payload data
+    u_int32_t crc_ = 0;                 ///< CRC32C of the first crc_len_ bytes
+    size_t crc_len_ = 0;                ///< length of the range covered by crc_
+    bool crc_valid_ = true;             ///< false once the CRC can't be tracked
+    std::map<size_t, CRCExtent> crc_extents_; ///< out of order ranges by offset
+    /// @}
+
+    /// @{ Write behind state, chunks are written by the PayloadWriter
+    PendingWrite* wb_cur_ = nullptr;        ///< chunk being filled in
+    PendingWrite* wb_direct_ = nullptr;     ///< chunk lent out by direct_append_buf()
+    std::deque<PendingWrite*> wb_queued_;   ///< chunks handed to the PayloadWriter
+    bool wb_in_progress_ = false;           ///< PayloadWriter is writing a chunk unlocked (protected by its wait lock)
+    bool wb_posted_ = false;                ///< in the PayloadWriter queue (protected by its lock)
+    u_int64_t wb_seq_ = 0;                  ///< count of writes to the file
+    size_t expected_len_ = 0;               ///< total length given to preallocate()
+    /// @}
+
+    /// @{ Hybrid payload state, managed by the PayloadMemoryManager
+    bool hybrid_ = false;               ///< created with the HYBRID location
+    bool mem_tracked_ = false;          ///< in the PayloadMemoryManager list
+    size_t mem_reserved_ = 0;           ///< bytes reserved from the budget
+    size_t mem_next_offset_ = SIZE_MAX; ///< where a read continuing the last access would start
+    oasys::Time mem_last_access_;       ///< time of the last access
+    std::list<BundlePayload*>::iterator mem_lru_iter_; ///< position in the list
+    /// @}
 
     static oasys::SpinLock dir_lock_;	///< coordinate attempts to create/remove directories
 };
@@ -165,6 +165,22 @@ BundleProtocol::produce(const Bundle* bundle, const BlockInfoVec* blocks,
         return BundleProtocolVersion7::produce(bundle, blocks, data, offset, len, last);
     } 
 }
+
+//----------------------------------------------------------------------
+size_t
+BundleProtocol::produce_iov(const Bundle* bundle, const BlockInfoVec* blocks,
+                            size_t offset, size_t len, BundleIOVec* iov,
+                            bool* last)
+{
+    if (bundle->is_bpv6())
+    {
+        return BundleProtocolVersion6::produce_iov(bundle, blocks, offset, len, iov, last);
+    }
+    else
+    {
+        return BundleProtocolVersion7::produce_iov(bundle, blocks, offset, len, iov, last);
+    } 
+}
     
 //----------------------------------------------------------------------
 ssize_t
@@ -201,6 +217,47 @@ BundleProtocol::consume(Bundle* bundle,
     } 
 }
 
+//----------------------------------------------------------------------
+size_t
+BundleProtocol::direct_payload_len(Bundle* bundle)
+{
+    if (bundle->is_bpv_unknown()) {
+        return 0;
+    }
+
+    SPtr_BlockInfoVec sptr_recv_blocks = bundle->mutable_recv_blocks();
+    if (sptr_recv_blocks->empty()) {
+        return 0;
+    }
+
+    // the payload block has to be the one being received and its
+    // header has to have been parsed
+    SPtr_BlockInfo info = sptr_recv_blocks->back();
+    int payload_type = bundle->is_bpv6() ? (int) BundleProtocolVersion6::PAYLOAD_BLOCK :
+                                           (int) BundleProtocolVersion7::PAYLOAD_BLOCK;
+    if ((info->owner()->block_type() != payload_type) ||
+        info->complete() || (info->data_offset() == 0))
+    {
+        return 0;
+    }
+
+    BundlePayload* payload = bundle->mutable_payload();
+    if (payload->location() == BundlePayload::NODATA) {
+        return 0;
+    }
+
+    size_t rcvd = payload->length();
+    if ((rcvd + 1) >= info->data_length()) {
+        return 0;
+    }
+
+    if (rcvd == 0) {
+        payload->preallocate(info->data_length());
+    }
+
+    return info->data_length() - rcvd - 1;
+}
+
 //----------------------------------------------------------------------
 bool
 BundleProtocol::validate(Bundle* bundle,
@@ -43,6 +43,7 @@ namespace dtn {
 
 class BlockProcessor;
 class Bundle;
+class BundleIOVec;
 struct BundleTimestamp;
 class EndpointID;
 
@@ -105,6 +106,18 @@ public:
      */
     static size_t produce(const Bundle* bundle, const BlockInfoVec* blocks,
                           u_char* data, size_t offset, size_t len, bool* last);
+
+    /**
+     * Variant of produce() that fills in a list of pointers to the
+     * formatted block contents and payload instead of copying them
+     * out, for convergence layers that send with writev or sendmsg.
+     *
+     * @return the length of the chunk added to iov (up to the supplied
+     * length) and sets *last to true if the bundle is complete.
+     */
+    static size_t produce_iov(const Bundle* bundle, const BlockInfoVec* blocks,
+                              size_t offset, size_t len, BundleIOVec* iov,
+                              bool* last);
     
     /**
      * Parse the supplied chunk of arriving data and append it to the
@@ -121,6 +134,19 @@ public:
      */
     static ssize_t consume(Bundle* bundle, u_char* data, size_t len, bool* last);
 
+    /**
+     * The number of payload data bytes that come next in a bundle being
+     * consumed, which a convergence layer may read straight into the
+     * payload (see BundlePayload::direct_append_buf()) instead of
+     * passing them to consume(). The last byte of the payload is never
+     * included so that consume() still completes the payload block.
+     * Like consume(), this preallocates the payload before the first
+     * bytes of it arrive.
+     *
+     * @return the number of bytes or 0 if consume() has to be used
+     */
+    static size_t direct_payload_len(Bundle* bundle);
+
     /**
      * Bundle Protocol Versions
      */
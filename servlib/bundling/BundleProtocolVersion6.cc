@@ -51,6 +51,7 @@
 #include "BP6_PrimaryBlockProcessor.h"
 #include "BP6_UnknownBlockProcessor.h"
 #include "Bundle.h"
+#include "BundleIOVec.h"
 #include "BundleDaemon.h"
 #include "BundleProtocolVersion6.h"
 #include "BundleTimestamp.h"
@@ -497,6 +498,65 @@ BundleProtocolVersion6::produce(const Bundle* bundle, const BlockInfoVec* blocks
     return origlen - len;
 }
     
+//----------------------------------------------------------------------
+size_t
+BundleProtocolVersion6::produce_iov(const Bundle* bundle, const BlockInfoVec* blocks,
+                                    size_t offset, size_t len, BundleIOVec* iov,
+                                    bool* last)
+{
+    size_t origlen = len;
+    *last = false;
+
+    if (len == 0)
+        return 0;
+    
+    // advance past any blocks that are skipped by the given offset
+    ASSERT(!blocks->empty());
+    BlockInfoVec::const_iterator iter = blocks->begin();
+    SPtr_BlockInfo blkptr = *iter;
+    while (offset >= blkptr->full_length()) {
+        offset -= blkptr->full_length();
+        iter++;
+        ASSERT(iter != blocks->end());
+
+        blkptr = *iter;
+    }
+    
+    // add the segments for each block in turn, exactly as produce()
+    // copies them out
+    while (1) {
+        size_t remainder = blkptr->full_length() - offset;
+        size_t toadd     = std::min(len, remainder);
+        blkptr->owner()->produce_iov(bundle, blkptr.get(), offset, toadd, iov);
+        
+        len    -= toadd;
+        offset = 0;
+
+        if (len == 0) {
+            if ((toadd == remainder) && (blkptr->last_block()))
+            {
+                ASSERT(iter + 1 == blocks->end());
+                *last = true;
+            }
+            
+            break;
+        }
+
+        ASSERT(toadd == remainder);
+        if (blkptr->last_block()) {
+            ASSERT(iter + 1 == blocks->end());
+            *last = true;
+            break;
+        }
+        
+        ++iter;
+        ASSERT(iter != blocks->end());
+        blkptr = *iter;
+    }
+    
+    return origlen - len;
+}
+    
 //----------------------------------------------------------------------
 ssize_t
 BundleProtocolVersion6::consume(Bundle* bundle,
@@ -45,6 +45,7 @@ namespace dtn {
 
 class BlockProcessor;
 class Bundle;
+class BundleIOVec;
 struct BundleTimestamp;
 
 /**
@@ -120,6 +121,18 @@ public:
      */
     static size_t produce(const Bundle* bundle, const BlockInfoVec* blocks,
                           u_char* data, size_t offset, size_t len, bool* last);
+
+    /**
+     * Variant of produce() that fills in a list of pointers to the
+     * formatted block contents and payload instead of copying them
+     * out, for convergence layers that send with writev or sendmsg.
+     *
+     * @return the length of the chunk added to iov (up to the supplied
+     * length) and sets *last to true if the bundle is complete.
+     */
+    static size_t produce_iov(const Bundle* bundle, const BlockInfoVec* blocks,
+                              size_t offset, size_t len, BundleIOVec* iov,
+                              bool* last);
     
     /**
      * Parse the supplied chunk of arriving data and append it to the
@@ -42,10 +42,12 @@
 #include <third_party/oasys/debug/DebugUtils.h>
 #include <third_party/oasys/util/StringUtils.h>
 
+#include "BlockEncodingCache.h"
 #include "BlockInfo.h"
 #include "BlockProcessor.h"
 #include "Bundle.h"
 #include "BundleDaemon.h"
+#include "BundleIOVec.h"
 #include "BundleProtocolVersion7.h"
 #include "BundleTimestamp.h"
 #include "BP7_BundleAgeBlockProcessor.h"
@@ -285,6 +287,15 @@ BundleProtocolVersion7::generate_blocks(Bundle*        bundle,
     ASSERT(blocks->size() >= 2);
     ASSERT(blocks->front()->type() == PRIMARY_BLOCK);
 
+    // if the bundle has been sent before, the blocks that are the same
+    // for every transmission can be copied from the encoding cache
+    BlockEncodingCache* cache = BlockEncodingCache::instance();
+    BlockEncodingCache::SPtr_Entry cached;
+    bool all_cached = true;
+    if (cache->enabled()) {
+        cached = cache->lookup(bundle);
+    }
+
     // now we make another pass through the list and call generate on
     // each block processor
 
@@ -295,6 +306,13 @@ BundleProtocolVersion7::generate_blocks(Bundle*        bundle,
     {
         SPtr_BlockInfo blkptr = *iter;
 
+        if (blkptr->owner()->cache_encoding()) {
+            if (cached && cached->apply(blkptr.get())) {
+                continue;
+            }
+            all_cached = false;
+        }
+
         bool last = (iter == last_block);
         if(BP_FAIL == blkptr->owner()->generate(bundle, blocks, blkptr.get(), link, last)) {
             log_err_p(LOG, "BundleProtocolVersion7::generate_blocks had %d->generate() return BP_FAIL", blkptr->owner()->block_type());
@@ -337,6 +355,10 @@ BundleProtocolVersion7::generate_blocks(Bundle*        bundle,
         total_len += blkptr->full_length();
     }
 
+    if (!all_cached && cache->enabled()) {
+        cache->store(bundle, blocks);
+    }
+
     //log_debug_p(LOG, "BundleProtocolVersion7::generate_blocks: end");
     
     return total_len;
@@ -507,50 +529,136 @@ BundleProtocolVersion7::produce(const Bundle* bundle, const BlockInfoVec* blocks
 }
     
 //----------------------------------------------------------------------
-int
-BundleProtocolVersion7::peek_into_cbor_for_block_type(u_char* buf, size_t buflen, uint8_t& block_type)
+size_t
+BundleProtocolVersion7::produce_iov(const Bundle* bundle, const BlockInfoVec* blocks,
+                                    size_t offset, size_t len, BundleIOVec* iov,
+                                    bool* last)
 {
-    CborError err;
-    CborParser parser;
-    CborValue cvBlockArray;
-    CborValue cvBlockElements;
-
-    #define CHECK_ERR_RETURN \
-        if ((err == CborErrorAdvancePastEOF) || (err == CborErrorUnexpectedEOF)) \
-        { \
-            return BP7_UNEXPECTED_EOF; \
-        } \
-        else if (err != CborNoError) \
-        { \
-            log_err_p(LOG, "BP7::peek_into_cbor_for_block_type - cbor error"); \
-            return BP_FAIL; \
-        }
+    // the bytes that open and close the bundle's indefinite length array
+    static const u_char cbor_array_start = 0x9f;
+    static const u_char cbor_break       = BP7_CBOR_BREAK_CHAR;
 
-    err = cbor_parser_init(buf, buflen, 0, &parser, &cvBlockArray);
-    CHECK_ERR_RETURN
+    size_t origlen = len;
+    *last = false;
 
-    if (!cbor_value_is_container(&cvBlockArray)) {
-        log_err_p(LOG, "BP7::peek_into_cbor_for_block_type - error: not a container");
+    if (len == 0)
+        return 0;
+    
+    ASSERT(!blocks->empty());
 
-        return BP_FAIL;
+    if (offset == 0) {
+        iov->append(&cbor_array_start, 1);
+        --len;
+    } else {
+        --offset;  // skip first CBOR byte
     }
 
-    err = cbor_value_enter_container(&cvBlockArray, &cvBlockElements);
-    CHECK_ERR_RETURN
+    // advance past any blocks that are skipped by the given offset
+    BlockInfoVec::const_iterator iter = blocks->begin();
+    SPtr_BlockInfo blkptr = *iter;
 
-    if (!cbor_value_is_unsigned_integer(&cvBlockElements)) {
-        log_err_p(LOG, "BP7::peek_into_cbor_for_block_type - error: block type field not an unsigned integer");
+    while (iter != blocks->end()) {
+        blkptr = *iter;
+        if (blkptr) {
+            if (offset >= blkptr->full_length()) {
+                offset -= blkptr->full_length();
+                iter++;
+            } else {
+                break;
+            }
+        } else {
+            log_crit_p("/bp7", "BP7::%s - null block pointer - abort", __func__);
+        }
+    }
+    
+    if (iter == blocks->end())
+    {
+        // only the CBOR break byte closing the bundle is left
+        iov->append(&cbor_break, 1);
+        *last = true;
+        return 1;
+    }
 
-        return BP_FAIL;
+    // add the segments for each block in turn, exactly as produce()
+    // copies them out
+    while (1) {
+        size_t remainder = blkptr->full_length() - offset;
+        size_t toadd     = std::min(len, remainder);
+        blkptr->owner()->produce_iov(bundle, blkptr.get(), offset, toadd, iov);
+        
+        len    -= toadd;
+        offset = 0;
+
+        if (len == 0) {
+            break;
+        }
+
+        ASSERT(toadd == remainder);
+        if (blkptr->type() == PAYLOAD_BLOCK) {
+            break;
+        }
+        
+        ++iter;
+        ASSERT(iter != blocks->end());
+        blkptr = *iter;
     }
 
-    uint64_t ui64_type = 0;
-    err = cbor_value_get_uint64(&cvBlockElements, &ui64_type);
-    CHECK_ERR_RETURN
+    if (len > 0) {
+        iov->append(&cbor_break, 1);
+        len -= 1;
+        *last = true;
+    }
+    
+    return origlen - len;
+}
+    
+//----------------------------------------------------------------------
+int
+BundleProtocolVersion7::peek_into_cbor_for_block_type(u_char* buf, size_t buflen, uint8_t& block_type)
+{
+    // A block is a CBOR array whose first item is the unsigned integer
+    // block type. Only the two headers are needed so they are decoded
+    // directly rather than setting up a CBOR parser for every block.
+    size_t pos = 0;
 
-    block_type = (ui64_type & 0xff);
+    for (int item = 0; item < 2; ++item)
+    {
+        if (pos == buflen) {
+            return BP7_UNEXPECTED_EOF;
+        }
+
+        uint8_t major = buf[pos] >> 5;
+        uint8_t info  = buf[pos] & 0x1f;
+        ++pos;
 
-    #undef CHECK_ERR_RETURN
+        if (item == 0 && major != 4 && major != 5) {
+            log_err_p(LOG, "BP7::peek_into_cbor_for_block_type - error: not a container");
+            return BP_FAIL;
+        }
+        if (item == 1 && major != 0) {
+            log_err_p(LOG, "BP7::peek_into_cbor_for_block_type - error: block type field not an unsigned integer");
+            return BP_FAIL;
+        }
+
+        uint64_t value = info;
+        if (info >= 24 && info <= 27) {
+            size_t num_bytes = 1 << (info - 24);
+            if (buflen - pos < num_bytes) {
+                return BP7_UNEXPECTED_EOF;
+            }
+            value = 0;
+            for (size_t i = 0; i < num_bytes; ++i) {
+                value = (value << 8) | buf[pos++];
+            }
+        } else if (info > 27 && (item == 1 || info != 31)) {
+            log_err_p(LOG, "BP7::peek_into_cbor_for_block_type - cbor error");
+            return BP_FAIL;
+        }
+
+        if (item == 1) {
+            block_type = (value & 0xff);
+        }
+    }
 
     return BP_SUCCESS;
 }
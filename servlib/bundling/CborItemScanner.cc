@@ -0,0 +1,217 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <string.h>
+
+#include "CborItemScanner.h"
+
+namespace dtn {
+
+//----------------------------------------------------------------------
+void
+CborItemScanner::reset()
+{
+    depth_          = 0;
+    head_len_       = 0;
+    head_need_      = 0;
+    skip_           = 0;
+    scanned_        = 0;
+    string_length_  = 0;
+    stop_at_string_ = false;
+    done_           = false;
+}
+
+//----------------------------------------------------------------------
+void
+CborItemScanner::item_done()
+{
+    while (depth_ > 0) {
+        u_int64_t* remaining = &remaining_[depth_ - 1];
+        if (*remaining == INDEFINITE) {
+            return;
+        }
+        if (--(*remaining) != 0) {
+            return;
+        }
+
+        // the container is complete, which completes an item of the
+        // container it is in
+        --depth_;
+    }
+
+    done_ = true;
+}
+
+//----------------------------------------------------------------------
+bool
+CborItemScanner::push(u_int64_t items)
+{
+    if (items == 0) {
+        item_done();
+        return true;
+    }
+
+    if (depth_ == MAX_DEPTH) {
+        return false;
+    }
+
+    remaining_[depth_++] = items;
+    return true;
+}
+
+//----------------------------------------------------------------------
+CborItemScanner::status_t
+CborItemScanner::scan(const u_char* buf, size_t len, size_t* consumed)
+{
+    size_t pos = 0;
+    status_t status = SCAN_NEED_MORE;
+
+    while (!done_ && pos < len) {
+        // skip over string contents
+        if (skip_ != 0) {
+            size_t n = len - pos;
+            if (skip_ < n) {
+                n = skip_;
+            }
+            pos   += n;
+            skip_ -= n;
+            if (skip_ == 0) {
+                item_done();
+            }
+            continue;
+        }
+
+        // accumulate the item header
+        if (head_len_ == 0) {
+            head_[0]  = buf[pos++];
+            head_len_ = 1;
+
+            u_int8_t info = head_[0] & 0x1f;
+            if (info < 24 || info == 31) {
+                head_need_ = 1;
+            } else if (info <= 27) {
+                head_need_ = 1 + (1 << (info - 24));
+            } else {
+                status = SCAN_ERROR;
+                break;
+            }
+        }
+
+        if (head_len_ < head_need_) {
+            size_t n = head_need_ - head_len_;
+            if (len - pos < n) {
+                n = len - pos;
+            }
+            memcpy(head_ + head_len_, buf + pos, n);
+            head_len_ += n;
+            pos       += n;
+            if (head_len_ < head_need_) {
+                break;
+            }
+        }
+
+        // the header is complete
+        u_int8_t major = head_[0] >> 5;
+        u_int8_t info  = head_[0] & 0x1f;
+        bool indefinite = (info == 31);
+        u_int64_t value = info;
+        if (head_need_ > 1) {
+            value = 0;
+            for (int i = 1; i < head_need_; ++i) {
+                value = (value << 8) | head_[i];
+            }
+        }
+        head_len_ = 0;
+
+        switch (major) {
+        case 0: // unsigned integer
+        case 1: // negative integer
+            if (indefinite) {
+                status = SCAN_ERROR;
+            } else {
+                item_done();
+            }
+            break;
+
+        case 2: // byte string
+        case 3: // text string
+            if (indefinite) {
+                // the chunks follow as definite strings until a break
+                if (!push(INDEFINITE)) {
+                    status = SCAN_ERROR;
+                }
+            } else if (stop_at_string_ && major == 2 && depth_ == 1) {
+                string_length_ = value;
+                status = SCAN_STRING_HEADER;
+            } else if (value == 0) {
+                item_done();
+            } else {
+                skip_ = value;
+            }
+            break;
+
+        case 4: // array
+            if (!push(indefinite ? INDEFINITE : value)) {
+                status = SCAN_ERROR;
+            }
+            break;
+
+        case 5: // map
+            if (!indefinite && value > (INDEFINITE - 1) / 2) {
+                status = SCAN_ERROR;
+            } else if (!push(indefinite ? INDEFINITE : value * 2)) {
+                status = SCAN_ERROR;
+            }
+            break;
+
+        case 6: // tag, applies to the item that follows
+            if (indefinite) {
+                status = SCAN_ERROR;
+            }
+            break;
+
+        case 7: // simple values, floats and break
+            if (!indefinite) {
+                item_done();
+            } else if (depth_ == 0 || remaining_[depth_ - 1] != INDEFINITE) {
+                status = SCAN_ERROR;
+            } else {
+                --depth_;
+                item_done();
+            }
+            break;
+        }
+
+        if (status != SCAN_NEED_MORE) {
+            break;
+        }
+    }
+
+    if (status == SCAN_NEED_MORE && done_) {
+        status = SCAN_COMPLETE;
+    }
+
+    scanned_ += pos;
+    *consumed = pos;
+    return status;
+}
+
+} // namespace dtn
@@ -0,0 +1,103 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _CBOR_ITEM_SCANNER_H_
+#define _CBOR_ITEM_SCANNER_H_
+
+#include <sys/types.h>
+#include <third_party/oasys/compat/inttypes.h>
+
+namespace dtn {
+
+/**
+ * Resumable scanner that finds the end of a CBOR data item as its
+ * bytes arrive in chunks of any size. Each byte of the item headers
+ * is looked at once and the contents of strings are skipped without
+ * being looked at, so a block split across many convergence layer
+ * reads is neither copied to a temporary buffer nor reparsed from the
+ * start on every read.
+ *
+ * The scanner only checks the CBOR framing; the item is decoded once
+ * all of its bytes are available.
+ */
+class CborItemScanner {
+public:
+    /// Results of scan()
+    typedef enum {
+        SCAN_ERROR = -1,        ///< malformed CBOR
+        SCAN_NEED_MORE = 0,     ///< all bytes consumed, item incomplete
+        SCAN_COMPLETE = 1,      ///< the item is complete
+        SCAN_STRING_HEADER = 2, ///< stopped after a byte string header
+    } status_t;
+
+    CborItemScanner() { reset(); }
+
+    /**
+     * Start on a new item.
+     */
+    void reset();
+
+    /**
+     * Have scan() stop after the header of the first byte string
+     * directly inside a top level array or map, leaving the contents
+     * of the string to the caller (the BPv7 payload data).
+     */
+    void set_stop_at_string(bool stop) { stop_at_string_ = stop; }
+
+    /**
+     * Scan up to len bytes of the item.
+     *
+     * @param consumed set to the number of bytes that are part of
+     *        the item, which is less than len only if the item is
+     *        complete or the scan stopped at a string header
+     */
+    status_t scan(const u_char* buf, size_t len, size_t* consumed);
+
+    /// Total bytes of the item scanned so far
+    u_int64_t scanned() const { return scanned_; }
+
+    /// Length of the byte string scan() stopped at
+    u_int64_t string_length() const { return string_length_; }
+
+protected:
+    /// Maximum nesting of arrays, maps and indefinite strings
+    static const int MAX_DEPTH = 16;
+
+    /// Count of remaining items used for indefinite length containers
+    static const u_int64_t INDEFINITE = (u_int64_t)-1;
+
+    /// Account for a complete item, closing finished containers
+    void item_done();
+
+    /// Open a container with the given number of items
+    bool push(u_int64_t items);
+
+    u_int64_t remaining_[MAX_DEPTH]; ///< items left in each open container
+    int       depth_;                ///< number of open containers
+    u_char    head_[9];              ///< header bytes of the current item
+    u_int8_t  head_len_;             ///< header bytes received
+    u_int8_t  head_need_;            ///< header bytes needed
+    u_int64_t skip_;                 ///< string bytes left to skip
+    u_int64_t scanned_;              ///< bytes of the item scanned
+    u_int64_t string_length_;        ///< length of the stopped at string
+    bool      stop_at_string_;       ///< stop at the first string header
+    bool      done_;                 ///< the item is complete
+};
+
+} // namespace dtn
+
+#endif /* _CBOR_ITEM_SCANNER_H_ */
@@ -8,6 +8,7 @@
 #include <cbor.h>
 
 #include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/util/CRC32C.h>
 
 #include "CborUtil.h"
 
@@ -116,7 +117,7 @@ CborUtil::encode_crc(CborEncoder& blockArrayEncoder, uint32_t crc_type,
                     // calculate the CRC on the CBOR data
                     size_t block_cbor_length = dummyEncoder.data.ptr - block_first_cbor_byte;
                     uint32_t crc = 0;
-                    crc = crc32c_sw(crc, block_first_cbor_byte, block_cbor_length);
+                    crc = crc32c(crc, block_first_cbor_byte, block_cbor_length);
 
 
                     // convert CRC to network byte order
@@ -666,7 +667,7 @@ CborUtil::decode_crc_and_validate(CborValue& cvElement, uint64_t crc_type,
         memset((void*) crc_first_cbor_data_byte, 0, 4);
 
         uint32_t calc_crc = 0;
-        calc_crc = crc32c_sw(calc_crc, block_first_cbor_byte, block_cbor_length);
+        calc_crc = crc32c(calc_crc, block_first_cbor_byte, block_cbor_length);
 
         validated = (calc_crc == crc);
     }
@@ -725,84 +726,11 @@ CborUtil::crc16(const unsigned char* data, size_t size)
 
 
 
-/* CRC-32C (iSCSI) polynomial in reversed bit order. */
-#define POLY 0x82f63b78
-
-/* Table for a quadword-at-a-time software crc. */
-//static pthread_once_t crc32c_once_sw = PTHREAD_ONCE_INIT;
-uint32_t CborUtil::crc32c_table[8][256];
-bool CborUtil::crc_initialized_ = false;
-
-//----------------------------------------------------------------------
-/* Construct table for software CRC-32C calculation. */
-void
-CborUtil::crc32c_init_sw(void)
-{
-    uint32_t n, crc, k;
-
-    for (n = 0; n < 256; n++) {
-        crc = n;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
-        crc32c_table[0][n] = crc;
-    }
-    for (n = 0; n < 256; n++) {
-        crc = crc32c_table[0][n];
-        for (k = 1; k < 8; k++) {
-            crc = crc32c_table[0][crc & 0xff] ^ (crc >> 8);
-            crc32c_table[k][n] = crc;
-        }
-    }
-}
-
-
 //----------------------------------------------------------------------
-/* Table-driven software version as a fall-back.  This is about 15 times slower
-   than using the hardware instructions.  This assumes little-endian integers,
-   as is the case on Intel processors that the assembler code here is for. */
 uint32_t
-CborUtil::crc32c_sw(uint32_t crci, const unsigned char* buf, size_t len)
+CborUtil::crc32c(uint32_t crci, const unsigned char* buf, size_t len)
 {
-    const unsigned char *next = buf;
-    uint64_t crc;
-    uint64_t next_qword;
-
-    //pthread_once(&crc32c_once_sw, crc32c_init_sw);
-    if ( !crc_initialized_ ) {
-        crc32c_init_sw();
-        crc_initialized_ = true;
-    }
-
-    crc = crci ^ 0xffffffff;
-    while (len && ((uintptr_t)next & 7) != 0) {
-        crc = crc32c_table[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
-        len--;
-    }
-    while (len >= 8) {
-        memcpy(&next_qword, next, 8);
-        crc ^= next_qword;
-        crc = crc32c_table[7][crc & 0xff] ^
-              crc32c_table[6][(crc >> 8) & 0xff] ^
-              crc32c_table[5][(crc >> 16) & 0xff] ^
-              crc32c_table[4][(crc >> 24) & 0xff] ^
-              crc32c_table[3][(crc >> 32) & 0xff] ^
-              crc32c_table[2][(crc >> 40) & 0xff] ^
-              crc32c_table[1][(crc >> 48) & 0xff] ^
-              crc32c_table[0][crc >> 56];
-        next += 8;
-        len -= 8;
-    }
-    while (len) {
-        crc = crc32c_table[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
-        len--;
-    }
-    return (uint32_t)crc ^ 0xffffffff;
+    return oasys::CRC32C::extend(crci, buf, len);
 }
 
 //----------------------------------------------------------------------
@@ -88,16 +88,10 @@ public:
     virtual int decode_crc_and_validate(CborValue& cvElement, uint64_t crc_type, 
                                              const uint8_t* block_first_cbor_byte, bool& validated);
 
-    //XXX/dz  TODO - give credit and location (stackexchange) where CRC calc routines were gotten
     /**
      * CRC calculations
-     * Credit to Mark Adler...
      **/
-    static uint32_t crc32c_table[8][256];
-    static bool crc_initialized_;
-    static void crc32c_init_sw(void);
-
-    virtual uint32_t crc32c_sw(uint32_t crci, const unsigned char* buf, size_t len);
+    virtual uint32_t crc32c(uint32_t crci, const unsigned char* buf, size_t len);
     virtual uint16_t crc16(const unsigned char* data, size_t size);
 
 protected:
@@ -4,13 +4,16 @@
 #include <third_party/oasys/util/StreamBuffer.h>
 
 #include "BlockInfo.h"
+#include "BundlePayload.h"
 
 namespace dtn {
 
 /**
  * This is a BP_Local object used by the PayloadBlockProcessors to maintain 
  * a wroking buffer that allows for reading in chunks of data larger than the
- * production buffer allows.
+ * production buffer allows. When possible a read view of the payload is
+ * held instead so the data can be copied directly into the production
+ * buffer.
  * 
  */
 class PayloadBlockProcessorHelper : public BP_Local {
@@ -25,6 +28,10 @@ public:
     /// Working buffer for reading in large-ish blocks of a payload
     /// before chunking it into the production buffer
     oasys::StreamBuffer work_buf_;
+
+    /// Borrowed view of the whole payload (used instead of the
+    /// working buffer if it could be established)
+    BundlePayload::ReadView view_;
 };
 
 /**
@@ -0,0 +1,300 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <inttypes.h>
+
+#include "BundleDaemonStorage.h"
+#include "BundlePayload.h"
+#include "FormatUtils.h"
+#include "PayloadMemoryManager.h"
+
+template<>
+dtn::PayloadMemoryManager* oasys::Singleton<dtn::PayloadMemoryManager, false>::instance_ = NULL;
+
+namespace dtn {
+
+//----------------------------------------------------------------------
+PayloadMemoryManager::PayloadMemoryManager()
+    : Thread("PayloadMemoryManager", CREATE_JOINABLE),
+      Logger("PayloadMemoryManager", "/dtn/bundle/payload/memory"),
+      notifier_("/dtn/bundle/payload/memory/notifier", true),
+      bytes_used_(0),
+      spilling_(false)
+{
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+//----------------------------------------------------------------------
+PayloadMemoryManager::~PayloadMemoryManager()
+{
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::init()
+{
+    if (instance_ != NULL)
+    {
+        PANIC("PayloadMemoryManager already initialized");
+    }
+
+    instance_ = new PayloadMemoryManager();
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::shutdown()
+{
+    set_should_stop();
+    notifier_.notify();
+
+    while (!is_stopped()) {
+        usleep(100000);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::add_payload(BundlePayload* payload)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    ASSERT(!payload->mem_tracked_);
+
+    payload->mem_tracked_ = true;
+    payload->mem_reserved_ = 0;
+    payload->mem_next_offset_ = SIZE_MAX;
+    payload->mem_last_access_.get_time();
+    payload->mem_lru_iter_ = lru_.insert(lru_.end(), payload);
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::del_payload(BundlePayload* payload)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    if (!payload->mem_tracked_) {
+        return;
+    }
+
+    ASSERT(bytes_used_ >= payload->mem_reserved_);
+    bytes_used_ -= payload->mem_reserved_;
+
+    lru_.erase(payload->mem_lru_iter_);
+    payload->mem_tracked_ = false;
+    payload->mem_reserved_ = 0;
+}
+
+//----------------------------------------------------------------------
+bool
+PayloadMemoryManager::reserve(BundlePayload* payload, size_t amount, bool force)
+{
+    BundleDaemonStorage::Params& params = BundleDaemonStorage::params_;
+
+    oasys::ScopeLock l(&lock_, __func__);
+
+    ASSERT(payload->mem_tracked_);
+
+    if (!force && ((bytes_used_ + amount) > params.payload_mem_budget_)) {
+        ++stats_.budget_denials_;
+        return false;
+    }
+
+    bytes_used_ += amount;
+    payload->mem_reserved_ += amount;
+    payload->mem_last_access_.get_time();
+    lru_.move_to_back(payload->mem_lru_iter_);
+
+    // wake up the spill thread as soon as the high water mark is
+    // crossed rather than waiting for its next pass
+    u_int64_t high_water = params.payload_mem_budget_ * params.payload_mem_high_water_pct_ / 100;
+    if (!spilling_ && (bytes_used_ > high_water)) {
+        spilling_ = true;
+        notifier_.notify();
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::touch(BundlePayload* payload, size_t offset, size_t len)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    if (!payload->mem_tracked_) {
+        return;
+    }
+
+    if (offset != payload->mem_next_offset_) {
+        ++stats_.memory_hits_;
+    }
+    payload->mem_next_offset_ = offset + len;
+
+    payload->mem_last_access_.get_time();
+    lru_.move_to_back(payload->mem_lru_iter_);
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::payload_spilled(BundlePayload* payload)
+{
+    do {
+        oasys::ScopeLock l(&lock_, __func__);
+
+        ++stats_.spills_;
+        stats_.spilled_bytes_ += payload->length();
+    } while (false);  // just limiting the scopelock
+
+    del_payload(payload);
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::run()
+{
+    while (!should_stop()) {
+        notifier_.wait(nullptr, 1000);
+
+        if (should_stop()) {
+            break;
+        }
+
+        spill_payloads();
+    }
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::spill_payloads()
+{
+    size_t attempts;
+    {
+        oasys::ScopeLock l(&lock_, __func__);
+        attempts = lru_.size();
+    }
+
+    // payloads that can't be spilled right now are moved to the back
+    // of the list so each one is only tried once per pass
+    bool aged = false;
+    while ((attempts-- > 0) && !should_stop()) {
+        BundlePayload* payload = next_spill_candidate(&aged);
+        if (payload == nullptr) {
+            break;
+        }
+
+        if (payload->internal_spill()) {
+            if (aged) {
+                oasys::ScopeLock l(&lock_, __func__);
+                ++stats_.aged_spills_;
+            }
+        } else {
+            oasys::ScopeLock l(&lock_, __func__);
+            if (payload->mem_tracked_) {
+                lru_.move_to_back(payload->mem_lru_iter_);
+            }
+        }
+
+        payload->lock_->unlock();
+    }
+}
+
+//----------------------------------------------------------------------
+BundlePayload*
+PayloadMemoryManager::next_spill_candidate(bool* aged)
+{
+    BundleDaemonStorage::Params& params = BundleDaemonStorage::params_;
+
+    oasys::ScopeLock l(&lock_, __func__);
+
+    u_int64_t high_water = params.payload_mem_budget_ * params.payload_mem_high_water_pct_ / 100;
+    u_int64_t low_water  = params.payload_mem_budget_ * params.payload_mem_low_water_pct_ / 100;
+    u_int64_t max_age_ms = (u_int64_t) params.payload_mem_max_age_ * 1000;
+
+    if (bytes_used_ > high_water) {
+        spilling_ = true;
+    } else if (bytes_used_ <= low_water) {
+        spilling_ = false;
+    }
+
+    PayloadLRUList::iterator iter;
+    for (iter = lru_.begin(); iter != lru_.end(); ++iter) {
+        BundlePayload* payload = *iter;
+
+        *aged = (max_age_ms > 0) && (payload->mem_last_access_.elapsed_ms() >= max_age_ms);
+
+        // the list is in access order so once a payload is found that
+        // is young enough the rest of them are too
+        if (!spilling_ && !*aged) {
+            return nullptr;
+        }
+
+        // the payload lock is taken before the manager lock everywhere
+        // else so only try for it here and skip the payload if it is busy
+        if (payload->lock_->try_lock("PayloadMemoryManager::next_spill_candidate") == 0) {
+            return payload;
+        }
+    }
+
+    return nullptr;
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::get_usage(oasys::StringBuffer* buf)
+{
+    BundleDaemonStorage::Params& params = BundleDaemonStorage::params_;
+
+    oasys::ScopeLock l(&lock_, __func__);
+
+    buf->appendf(" memory bytes: %14" PRIu64 "  (%s)  payloads: %zu\n"
+                 "       budget: %14" PRIu64 "  (%s)\n",
+                 bytes_used_,
+                 FORMAT_WITH_MAG(bytes_used_).c_str(),
+                 lru_.size(),
+                 params.payload_mem_budget_,
+                 FORMAT_WITH_MAG(params.payload_mem_budget_).c_str());
+}
+
+//----------------------------------------------------------------------
+void
+PayloadMemoryManager::get_stats(oasys::StringBuffer* buf)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    buf->appendf("Payload Memory: %zu inmemory -- "
+                 "%" PRIu64 " bytes -- "
+                 "%" PRIu64 " memoryhits -- "
+                 "%" PRIu64 " spills -- "
+                 "%" PRIu64 " spilledbytes -- "
+                 "%" PRIu64 " agedspills -- "
+                 "%" PRIu64 " budgetdenials\n",
+                 lru_.size(),
+                 bytes_used_,
+                 stats_.memory_hits_,
+                 stats_.spills_,
+                 stats_.spilled_bytes_,
+                 stats_.aged_spills_,
+                 stats_.budget_denials_);
+}
+
+} // namespace dtn
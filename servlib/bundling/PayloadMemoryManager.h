@@ -0,0 +1,158 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _PAYLOAD_MEMORY_MANAGER_H_
+#define _PAYLOAD_MEMORY_MANAGER_H_
+
+#include <third_party/oasys/debug/Logger.h>
+#include <third_party/oasys/thread/Notifier.h>
+#include <third_party/oasys/thread/SpinLock.h>
+#include <third_party/oasys/thread/Thread.h>
+#include <third_party/oasys/util/LRUList.h>
+#include <third_party/oasys/util/Singleton.h>
+#include <third_party/oasys/util/StringBuffer.h>
+
+namespace dtn {
+
+class BundlePayload;
+
+/**
+ * Tracks the memory used by HYBRID bundle payloads against a fixed
+ * budget. Hybrid payloads are kept in memory while there is room in
+ * the budget and are spilled to their payload file when a payload
+ * would not fit, when usage passes the high water mark (least
+ * recently used payloads first, down to the low water mark) or when
+ * a payload has not been accessed for longer than the max age.
+ */
+class PayloadMemoryManager : public oasys::Singleton<PayloadMemoryManager, false>,
+                             public oasys::Thread,
+                             public oasys::Logger
+{
+public:
+    /**
+     * Boot time initializer.
+     */
+    static void init();
+
+    /**
+     * Whether or not the manager has been initialized.
+     */
+    static bool initialized() { return instance_ != nullptr; }
+
+    /**
+     * Destructor (called at shutdown time).
+     */
+    virtual ~PayloadMemoryManager();
+
+    /**
+     * Stop the spill thread.
+     */
+    void shutdown();
+
+    /**
+     * Start tracking a hybrid payload that is held in memory.
+     */
+    void add_payload(BundlePayload* payload);
+
+    /**
+     * Stop tracking a payload and return its reservation to the
+     * budget. Safe to call for a payload that is not being tracked.
+     */
+    void del_payload(BundlePayload* payload);
+
+    /**
+     * Reserve additional budget for a tracked payload that is
+     * growing. If force is true the reservation is made even if it
+     * exceeds the budget.
+     *
+     * @return true if the reservation was made, false if the payload
+     * should be spilled to disk instead
+     */
+    bool reserve(BundlePayload* payload, size_t amount, bool force = false);
+
+    /**
+     * Note a read of len bytes at offset from a tracked payload. A read
+     * that carries on from where the last one ended is part of the
+     * same access and is not counted as another memory hit.
+     */
+    void touch(BundlePayload* payload, size_t offset, size_t len);
+
+    /**
+     * Note that a payload was spilled to disk.
+     */
+    void payload_spilled(BundlePayload* payload);
+
+    /**
+     * Format the given StringBuffer with the current usage.
+     */
+    void get_usage(oasys::StringBuffer* buf);
+
+    /**
+     * Format the given StringBuffer with the current statistics.
+     */
+    void get_stats(oasys::StringBuffer* buf);
+
+protected:
+    friend class oasys::Singleton<PayloadMemoryManager, false>;
+
+    /**
+     * Constructor.
+     */
+    PayloadMemoryManager();
+
+    /**
+     * Main thread function that spills payloads to disk.
+     */
+    virtual void run();
+
+    /**
+     * Spill payloads while over the high water mark or past their
+     * max age.
+     */
+    void spill_payloads();
+
+    /**
+     * Select the next payload to spill and return it with its lock
+     * held, setting aged if it is being spilled for its age.
+     */
+    BundlePayload* next_spill_candidate(bool* aged);
+
+    /// Payloads held in memory, least recently used at the front
+    typedef oasys::LRUList<BundlePayload*> PayloadLRUList;
+    PayloadLRUList lru_;
+
+    oasys::SpinLock lock_;      ///< lock protecting the list and counters
+    oasys::Notifier notifier_;  ///< wakes the spill thread early
+
+    u_int64_t bytes_used_;      ///< bytes currently reserved
+    bool spilling_;             ///< over the high water mark and not yet back to the low
+
+    /// Statistics
+    struct Stats {
+        u_int64_t spills_;           ///< payloads spilled to disk
+        u_int64_t spilled_bytes_;    ///< bytes spilled to disk
+        u_int64_t aged_spills_;      ///< spills due to the max age
+        u_int64_t budget_denials_;   ///< reservations refused
+        u_int64_t memory_hits_;      ///< accesses served from memory
+    };
+
+    Stats stats_;
+};
+
+} // namespace dtn
+
+#endif /* _PAYLOAD_MEMORY_MANAGER_H_ */
@@ -0,0 +1,225 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <inttypes.h>
+#include <unistd.h>
+
+#include <third_party/oasys/util/CRC32C.h>
+#include <third_party/oasys/util/ScratchBuffer.h>
+
+#include "Bundle.h"
+#include "BundleDaemon.h"
+#include "BundleDaemonStorage.h"
+#include "BundleEvent.h"
+#include "PayloadScrubber.h"
+
+template<>
+dtn::PayloadScrubber* oasys::Singleton<dtn::PayloadScrubber, false>::instance_ = NULL;
+
+namespace dtn {
+
+// bytes read from the payload file at a time
+#define SCRUB_CHUNK_SIZE (64 * 1024)
+
+//----------------------------------------------------------------------
+PayloadScrubber::PayloadScrubber()
+    : Thread("PayloadScrubber", CREATE_JOINABLE),
+      Logger("PayloadScrubber", "/dtn/bundle/payload/scrubber"),
+      notifier_("/dtn/bundle/payload/scrubber/notifier", true),
+      bucket_("/dtn/bundle/payload/scrubber/bucket",
+              SCRUB_CHUNK_SIZE, BundleDaemonStorage::params_.payload_scrub_rate_)
+{
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+//----------------------------------------------------------------------
+PayloadScrubber::~PayloadScrubber()
+{
+}
+
+//----------------------------------------------------------------------
+void
+PayloadScrubber::init()
+{
+    if (instance_ != NULL)
+    {
+        PANIC("PayloadScrubber already initialized");
+    }
+
+    instance_ = new PayloadScrubber();
+}
+
+//----------------------------------------------------------------------
+void
+PayloadScrubber::shutdown()
+{
+    set_should_stop();
+    notifier_.notify();
+
+    while (!is_stopped()) {
+        usleep(100000);
+    }
+
+    oasys::ScopeLock l(&lock_, __func__);
+    queue_.clear();
+}
+
+//----------------------------------------------------------------------
+void
+PayloadScrubber::post(Bundle* bundle)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    queue_.push_back(BundleRef(bundle, "PayloadScrubber"));
+}
+
+//----------------------------------------------------------------------
+void
+PayloadScrubber::run()
+{
+    while (!should_stop()) {
+        BundleRef bref("PayloadScrubber::run");
+        {
+            oasys::ScopeLock l(&lock_, __func__);
+            if (!queue_.empty()) {
+                bref = queue_.front();
+                queue_.pop_front();
+            }
+        }
+
+        if (bref == nullptr) {
+            notifier_.wait(nullptr, 1000);
+            continue;
+        }
+
+        if (!check_payload(bref.object())) {
+            BundleDeleteRequest* event_to_post;
+            event_to_post = new BundleDeleteRequest(bref, BundleProtocol::REASON_BLOCK_UNINTELLIGIBLE);
+            SPtr_BundleEvent sptr_event_to_post(event_to_post);
+            BundleDaemon::post(sptr_event_to_post);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+bool
+PayloadScrubber::check_payload(Bundle* bundle)
+{
+    const BundlePayload& payload = bundle->payload();
+
+    u_int32_t expected = 0;
+    size_t length = 0;
+    if (!payload.get_crc(&expected, &length)) {
+        oasys::ScopeLock l(&lock_, __func__);
+        ++stats_.skipped_;
+        return true;
+    }
+
+    oasys::ScratchBuffer<u_char*, SCRUB_CHUNK_SIZE> buf(SCRUB_CHUNK_SIZE);
+    u_int32_t crc = 0;
+    size_t offset = 0;
+
+    bucket_.set_rate(BundleDaemonStorage::params_.payload_scrub_rate_);
+
+    while (offset < length) {
+        // give up on bundles that are deleted while being checked
+        if (should_stop() || bundle->deleting()) {
+            return true;
+        }
+
+        size_t toread = std::min(length - offset, (size_t) SCRUB_CHUNK_SIZE);
+
+        if (bucket_.rate() != 0) {
+            while (!bucket_.try_to_drain(toread)) {
+                usleep(bucket_.time_to_level(toread).in_milliseconds() * 1000 + 1000);
+                if (should_stop()) {
+                    return true;
+                }
+            }
+        }
+
+        // the payload may have been truncated since the snapshot so
+        // the length is checked under the same lock as the read
+        bool truncated = false;
+        do {
+            oasys::ScopeLock pl(bundle->lock(), __func__);
+            if (payload.length() < length) {
+                truncated = true;
+                break;
+            }
+            const u_char* data = payload.read_data(offset, toread, buf.buf());
+            crc = oasys::CRC32C::extend(crc, data, toread);
+        } while (false);
+
+        if (truncated) {
+            oasys::ScopeLock l(&lock_, __func__);
+            ++stats_.skipped_;
+            return true;
+        }
+        offset += toread;
+
+        oasys::ScopeLock l(&lock_, __func__);
+        stats_.bytes_ += toread;
+    }
+
+    // a truncate and rewrite since the snapshot changes the CRC too
+    u_int32_t current = 0;
+    size_t current_len = 0;
+    if (!payload.get_crc(&current, &current_len) || (current_len < length) ||
+        ((current_len == length) && (current != expected)))
+    {
+        oasys::ScopeLock l(&lock_, __func__);
+        ++stats_.skipped_;
+        return true;
+    }
+
+    oasys::ScopeLock l(&lock_, __func__);
+    ++stats_.checked_;
+
+    if (crc != expected) {
+        ++stats_.failed_;
+        log_err("payload of *%p has CRC32C 0x%08x but expected 0x%08x - deleting bundle",
+                bundle, crc, expected);
+        return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+PayloadScrubber::get_stats(oasys::StringBuffer* buf)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    buf->appendf("Payload Scrubber: %zu queued -- "
+                 "%" PRIu64 " checked -- "
+                 "%" PRIu64 " bytes -- "
+                 "%" PRIu64 " skipped -- "
+                 "%" PRIu64 " failed\n",
+                 queue_.size(),
+                 stats_.checked_,
+                 stats_.bytes_,
+                 stats_.skipped_,
+                 stats_.failed_);
+}
+
+} // namespace dtn
@@ -0,0 +1,119 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _PAYLOAD_SCRUBBER_H_
+#define _PAYLOAD_SCRUBBER_H_
+
+#include <deque>
+
+#include <third_party/oasys/debug/Logger.h>
+#include <third_party/oasys/thread/Notifier.h>
+#include <third_party/oasys/thread/SpinLock.h>
+#include <third_party/oasys/thread/Thread.h>
+#include <third_party/oasys/util/Singleton.h>
+#include <third_party/oasys/util/StringBuffer.h>
+#include <third_party/oasys/util/TokenBucket.h>
+
+#include "BundleRef.h"
+
+namespace dtn {
+
+class Bundle;
+
+/**
+ * Background thread that verifies the CRC32C of reloaded payloads
+ * against the value stored with the bundle, reading the payload files
+ * at no more than payload_scrub_rate bytes per second so that startup
+ * is not held up reading every payload. Bundles with a corrupted
+ * payload are deleted.
+ */
+class PayloadScrubber : public oasys::Singleton<PayloadScrubber, false>,
+                        public oasys::Thread,
+                        public oasys::Logger
+{
+public:
+    /**
+     * Boot time initializer.
+     */
+    static void init();
+
+    /**
+     * Whether or not the scrubber has been initialized.
+     */
+    static bool initialized() { return instance_ != nullptr; }
+
+    /**
+     * Destructor (called at shutdown time).
+     */
+    virtual ~PayloadScrubber();
+
+    /**
+     * Stop the thread, abandoning any bundles not yet checked.
+     */
+    void shutdown();
+
+    /**
+     * Queue a reloaded bundle to have its payload checked.
+     */
+    void post(Bundle* bundle);
+
+    /**
+     * Format the given StringBuffer with the current statistics.
+     */
+    void get_stats(oasys::StringBuffer* buf);
+
+protected:
+    friend class oasys::Singleton<PayloadScrubber, false>;
+
+    /**
+     * Constructor.
+     */
+    PayloadScrubber();
+
+    /**
+     * Main thread function.
+     */
+    virtual void run();
+
+    /**
+     * Check the payload of one bundle.
+     *
+     * @return false if the payload did not match its CRC
+     */
+    bool check_payload(Bundle* bundle);
+
+    /// Bundles waiting to be checked
+    std::deque<BundleRef> queue_;
+
+    oasys::SpinLock lock_;          ///< lock protecting the queue
+    oasys::Notifier notifier_;      ///< signals the thread
+    oasys::TokenBucket bucket_;     ///< limits the read rate
+
+    /// Statistics
+    struct Stats {
+        u_int64_t checked_;         ///< payloads checked
+        u_int64_t bytes_;           ///< bytes read
+        u_int64_t skipped_;         ///< payloads without a usable CRC
+        u_int64_t failed_;          ///< payloads that did not match
+    };
+
+    Stats stats_;
+};
+
+} // namespace dtn
+
+#endif /* _PAYLOAD_SCRUBBER_H_ */
@@ -0,0 +1,258 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "BundleDaemonStorage.h"
+#include "BundlePayload.h"
+#include "PayloadWriter.h"
+
+template<>
+dtn::PayloadWriter* oasys::Singleton<dtn::PayloadWriter, false>::instance_ = NULL;
+
+namespace dtn {
+
+//----------------------------------------------------------------------
+PayloadWriter::PayloadWriter()
+    : Thread("PayloadWriter", CREATE_JOINABLE),
+      Logger("PayloadWriter", "/dtn/bundle/payload/writer"),
+      current_(nullptr),
+      notifier_("/dtn/bundle/payload/writer/notifier", true),
+      waiting_(false),
+      buffered_bytes_(0),
+      over_limit_(0)
+{
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+//----------------------------------------------------------------------
+PayloadWriter::~PayloadWriter()
+{
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::init()
+{
+    if (instance_ != NULL)
+    {
+        PANIC("PayloadWriter already initialized");
+    }
+
+    instance_ = new PayloadWriter();
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::shutdown()
+{
+    lock_.lock(__func__);
+    set_should_stop();
+    if (waiting_) {
+        waiting_ = false;
+        notifier_.notify();
+    }
+    lock_.unlock();
+
+    while (!is_stopped()) {
+        usleep(100000);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::post(BundlePayload* payload)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    if (payload->wb_posted_) {
+        return;
+    }
+
+    payload->wb_posted_ = true;
+    queue_.push_back(payload);
+
+    // only signal the thread when it is blocked so that the notifier
+    // pipe does not fill up while it is busy
+    if (waiting_) {
+        waiting_ = false;
+        notifier_.notify();
+    }
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::cancel(BundlePayload* payload)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    if (payload->wb_posted_) {
+        std::deque<BundlePayload*>::iterator iter;
+        for (iter = queue_.begin(); iter != queue_.end(); ++iter) {
+            if (*iter == payload) {
+                queue_.erase(iter);
+                break;
+            }
+        }
+        payload->wb_posted_ = false;
+    }
+
+    // the thread sets current_ before it lets go of lock_, so once the
+    // payload is off the queue it is either being written now or never
+    l.unlock();
+
+    std::unique_lock<std::mutex> wl(write_lock_);
+    write_done_.wait(wl, [this, payload] { return current_ != payload; });
+}
+
+//----------------------------------------------------------------------
+bool
+PayloadWriter::reserve_buffer(size_t len)
+{
+    size_t limit = BundleDaemonStorage::params_.payload_write_behind_limit_;
+    size_t cur = buffered_bytes_.load();
+
+    do {
+        if ((limit != 0) && ((cur + len) > limit)) {
+            ++over_limit_;
+            return false;
+        }
+    } while (!buffered_bytes_.compare_exchange_weak(cur, cur + len));
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::release_buffer(size_t len)
+{
+    buffered_bytes_ -= len;
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::set_write_in_progress(BundlePayload* payload, bool in_progress)
+{
+    std::lock_guard<std::mutex> l(write_lock_);
+
+    payload->wb_in_progress_ = in_progress;
+    if (!in_progress) {
+        write_done_.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::wait_for_write(BundlePayload* payload)
+{
+    std::unique_lock<std::mutex> l(write_lock_);
+
+    write_done_.wait(l, [payload] { return !payload->wb_in_progress_; });
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::run()
+{
+    lock_.lock(__func__);
+
+    while (true) {
+        if (queue_.empty()) {
+            if (should_stop()) {
+                break;
+            }
+
+            waiting_ = true;
+            notifier_.wait(&lock_, 1000);
+            waiting_ = false;
+            continue;
+        }
+
+        BundlePayload* payload = queue_.front();
+        queue_.pop_front();
+        payload->wb_posted_ = false;
+        do {
+            std::lock_guard<std::mutex> wl(write_lock_);
+            current_ = payload;
+        } while (false);
+        lock_.unlock();
+
+        write_payload(payload);
+
+        do {
+            std::lock_guard<std::mutex> wl(write_lock_);
+            current_ = nullptr;
+            write_done_.notify_all();
+        } while (false);
+        lock_.lock(__func__);
+    }
+
+    lock_.unlock();
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::write_payload(BundlePayload* payload)
+{
+    size_t num_chunks = 0;
+    bool error = false;
+
+    size_t bytes = payload->write_queued_chunks(&num_chunks, &error);
+
+    // sync a payload as soon as it is complete so that the sync before
+    // it is added to the database does not have to wait on the disk
+    bool synced = payload->sync_if_complete();
+
+    oasys::ScopeLock l(&lock_, __func__);
+    stats_.chunks_ += num_chunks;
+    stats_.bytes_  += bytes;
+    if (synced) {
+        ++stats_.syncs_;
+    }
+    if (error) {
+        ++stats_.errors_;
+    }
+}
+
+//----------------------------------------------------------------------
+void
+PayloadWriter::get_stats(oasys::StringBuffer* buf)
+{
+    oasys::ScopeLock l(&lock_, __func__);
+
+    buf->appendf("Payload Writer: %zu queued -- "
+                 "%zu buffered bytes -- "
+                 "%" PRIu64 " over limit -- "
+                 "%" PRIu64 " chunks -- "
+                 "%" PRIu64 " bytes -- "
+                 "%" PRIu64 " syncs -- "
+                 "%" PRIu64 " errors\n",
+                 queue_.size(),
+                 buffered_bytes_.load(),
+                 over_limit_.load(),
+                 stats_.chunks_,
+                 stats_.bytes_,
+                 stats_.syncs_,
+                 stats_.errors_);
+}
+
+} // namespace dtn
@@ -0,0 +1,160 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _PAYLOAD_WRITER_H_
+#define _PAYLOAD_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <third_party/oasys/debug/Logger.h>
+#include <third_party/oasys/thread/Notifier.h>
+#include <third_party/oasys/thread/SpinLock.h>
+#include <third_party/oasys/thread/Thread.h>
+#include <third_party/oasys/util/Singleton.h>
+#include <third_party/oasys/util/StringBuffer.h>
+
+namespace dtn {
+
+class BundlePayload;
+
+/**
+ * I/O thread that writes the buffered chunks of DISK payloads to
+ * their payload files so the convergence layer threads receiving the
+ * data do not block on the disk. Chunks are handed off once they reach
+ * a payload_write_chunk aligned boundary and once a payload has been
+ * completely written the file is synced so the storage thread does
+ * not have to wait on it before adding the bundle to the database.
+ */
+class PayloadWriter : public oasys::Singleton<PayloadWriter, false>,
+                      public oasys::Thread,
+                      public oasys::Logger
+{
+public:
+    /**
+     * Boot time initializer.
+     */
+    static void init();
+
+    /**
+     * Whether or not the writer has been initialized and is running.
+     */
+    static bool initialized() { return instance_ != nullptr; }
+
+    /**
+     * Destructor (called at shutdown time).
+     */
+    virtual ~PayloadWriter();
+
+    /**
+     * Write out everything that is queued and stop the thread.
+     */
+    void shutdown();
+
+    /**
+     * Whether or not chunks are being accepted.
+     */
+    bool accepting() { return !should_stop(); }
+
+    /**
+     * Queue a payload with chunks ready to be written.
+     */
+    void post(BundlePayload* payload);
+
+    /**
+     * Remove a payload from the queue and wait for the thread to be
+     * finished with it if it is currently being written.
+     */
+    void cancel(BundlePayload* payload);
+
+    /**
+     * Charge a new chunk against the payload_write_behind_limit on the
+     * memory buffered by all payloads. Returns false if it would go
+     * over, in which case the caller writes the data directly.
+     */
+    bool reserve_buffer(size_t len);
+
+    /**
+     * Return the memory of a chunk that was written or discarded.
+     */
+    void release_buffer(size_t len);
+
+    /**
+     * Flag that the thread is (or is no longer) writing a chunk of the
+     * payload without holding its lock.
+     */
+    void set_write_in_progress(BundlePayload* payload, bool in_progress);
+
+    /**
+     * Block until the thread is not writing a chunk of the payload.
+     */
+    void wait_for_write(BundlePayload* payload);
+
+    /**
+     * Format the given StringBuffer with the current statistics.
+     */
+    void get_stats(oasys::StringBuffer* buf);
+
+protected:
+    friend class oasys::Singleton<PayloadWriter, false>;
+
+    /**
+     * Constructor.
+     */
+    PayloadWriter();
+
+    /**
+     * Main thread function.
+     */
+    virtual void run();
+
+    /**
+     * Write all of the queued chunks for a payload.
+     */
+    void write_payload(BundlePayload* payload);
+
+    /// Payloads with chunks waiting to be written
+    std::deque<BundlePayload*> queue_;
+
+    BundlePayload* current_;    ///< payload being written by the thread (under write_lock_)
+
+    oasys::SpinLock lock_;      ///< lock protecting the queue
+    oasys::Notifier notifier_;  ///< signals the thread
+    bool waiting_;              ///< thread is blocked on the notifier
+
+    std::mutex write_lock_;                 ///< protects current_ and BundlePayload::wb_in_progress_
+    std::condition_variable write_done_;    ///< signalled when a chunk or payload write finishes
+
+    std::atomic<size_t> buffered_bytes_;    ///< chunk memory held by all payloads
+    std::atomic<u_int64_t> over_limit_;     ///< chunks refused by reserve_buffer()
+
+    /// Statistics
+    struct Stats {
+        u_int64_t chunks_;      ///< chunks written
+        u_int64_t bytes_;       ///< bytes written
+        u_int64_t syncs_;       ///< completed payloads synced
+        u_int64_t errors_;      ///< write errors
+    };
+
+    Stats stats_;
+};
+
+} // namespace dtn
+
+#endif /* _PAYLOAD_WRITER_H_ */
@@ -41,6 +41,22 @@
 #  include <dtn-config.h>
 #endif
 
+#include <string.h>
+
+/*
+ * The decoder reads up to eight bytes of the SDNV with one 64-bit load
+ * on little-endian targets built with gcc or clang, which covers every
+ * value below 2^56. Longer values and other targets use the bytewise
+ * loop.
+ */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SDNV_WORD_DECODE 1
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#endif
+
 #ifdef __cplusplus
 #include "SDNV.h"
 #include <third_party/oasys/debug/DebugUtils.h>
@@ -87,6 +103,24 @@ do {                                                            \
     #
 #endif
 
+//----------------------------------------------------------------------
+size_t
+SDNV_FN(encoding_len)(u_int64_t val)
+{
+#ifdef __GNUC__
+    // one byte for every started group of seven significant bits
+    size_t bits = 64 - __builtin_clzll(val | 1);
+    return (bits + 6) / 7;
+#else
+    size_t val_len = 0;
+    do {
+        val = val >> 7;
+        val_len++;
+    } while (val != 0);
+    return val_len;
+#endif
+}
+
 //----------------------------------------------------------------------
 int
 SDNV_FN(encode)(u_int64_t val, u_char* bp, size_t len)
@@ -94,15 +128,30 @@ SDNV_FN(encode)(u_int64_t val, u_char* bp, size_t len)
     u_char* start = bp;
 
     /*
-     * Figure out how many bytes we need for the encoding.
+     * Most of the values in bundle and segment headers are small
+     * enough to fit in one or two bytes, so handle those directly.
      */
-    size_t val_len = 0;
-    u_int64_t tmp = val;
+    if (val < 0x80) {
+        if (len < 1) {
+            return -1;
+        }
+        bp[0] = (u_char)val;
+        return 1;
+    }
 
-    do {
-        tmp = tmp >> 7;
-        val_len++;
-    } while (tmp != 0);
+    if (val < 0x4000) {
+        if (len < 2) {
+            return -1;
+        }
+        bp[0] = (u_char)(0x80 | (val >> 7));
+        bp[1] = (u_char)(val & 0x7f);
+        return 2;
+    }
+
+    /*
+     * Figure out how many bytes we need for the encoding.
+     */
+    size_t val_len = SDNV_FN(encoding_len)(val);
 
     ASSERT(val_len > 0);
     ASSERT(val_len <= MAX_LENGTH);
@@ -132,15 +181,56 @@ SDNV_FN(encode)(u_int64_t val, u_char* bp, size_t len)
     return val_len;
 }
 
+#ifdef SDNV_WORD_DECODE
 //----------------------------------------------------------------------
-size_t
-SDNV_FN(encoding_len)(u_int64_t val)
+/*
+ * Decode an SDNV of at most eight bytes from a single 64-bit load.
+ *
+ * The last byte of the SDNV is the first one with a clear high bit,
+ * which is found by counting the trailing zeros of the inverted high
+ * bits. The bytes are then swapped so the first one is the most
+ * significant, and their seven-bit groups are packed together with
+ * pext when BMI2 is enabled, or with three mask-and-shift steps that
+ * each halve the number of gaps otherwise.
+ *
+ * Returns 0 if no byte in the first eight (or in the buffer, if it is
+ * shorter) ends the SDNV.
+ */
+static int
+sdnv_decode_word(const u_char* bp, size_t len, u_int64_t* val)
 {
-    u_char buf[16];
-    int ret = SDNV_FN(encode)(val, buf, sizeof(buf));
-    ASSERT(ret != -1 && ret != 0);
-    return ret;
+    u_int64_t word;
+
+    if (len >= 8) {
+        memcpy(&word, bp, 8);
+    } else {
+        // pad a short buffer with continuation bytes so that the end
+        // of the buffer is not mistaken for the end of the SDNV
+        word = 0x8080808080808080ULL;
+        memcpy(&word, bp, len);
+    }
+
+    u_int64_t stops = ~word & 0x8080808080808080ULL;
+    if (stops == 0) {
+        return 0;
+    }
+
+    int nbits = __builtin_ctzll(stops) + 1;
+    word = __builtin_bswap64(word) >> (64 - nbits);
+
+#ifdef __BMI2__
+    *val = _pext_u64(word, 0x7f7f7f7f7f7f7f7fULL);
+#else
+    word &= 0x7f7f7f7f7f7f7f7fULL;
+    word = ((word & 0x7f007f007f007f00ULL) >> 1) | (word & 0x007f007f007f007fULL);
+    word = ((word & 0x3fff00003fff0000ULL) >> 2) | (word & 0x00003fff00003fffULL);
+    word = ((word & 0x0fffffff00000000ULL) >> 4) | (word & 0x000000000fffffffULL);
+    *val = word;
+#endif
+
+    return nbits >> 3;
 }
+#endif // SDNV_WORD_DECODE
 
 //----------------------------------------------------------------------
 int
@@ -152,6 +242,24 @@ SDNV_FN(decode)(const u_char* bp, size_t len, u_int64_t* val)
         return -1;
     }
 
+#ifdef SDNV_WORD_DECODE
+    if (len != 0 && (*bp & 0x80) == 0) {
+        *val = *bp;
+        return 1;
+    }
+
+    int word_len = sdnv_decode_word(bp, len, val);
+    if (word_len != 0) {
+        return word_len;
+    }
+
+    if (len < 8) {
+        return -1; // buffer too short
+    }
+
+    // nine and ten byte values fall through to the loop
+#endif
+
     /*
      * Zero out the existing value, then shift in the bytes of the
      * encoding one by one until we hit a byte that has a zero
@@ -197,6 +305,34 @@ SDNV_FN(decode)(const u_char* bp, size_t len, u_int64_t* val)
     return val_len;
 }
 
+//----------------------------------------------------------------------
+int
+SDNV_FN(decode_n)(const u_char* bp, size_t len, u_int64_t* vals, size_t count)
+{
+    size_t consumed = 0;
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        const u_char* p = bp + consumed;
+        size_t remaining = len - consumed;
+        int ret;
+
+        if (remaining != 0 && (*p & 0x80) == 0) {
+            vals[i] = *p;
+            ret = 1;
+        } else {
+            ret = SDNV_FN(decode)(p, remaining, &vals[i]);
+            if (ret < 0) {
+                return -1;
+            }
+        }
+
+        consumed += ret;
+    }
+
+    return (int)consumed;
+}
+
 //----------------------------------------------------------------------
 size_t
 SDNV_FN(len)(const u_char* bp)
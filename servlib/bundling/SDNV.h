@@ -79,7 +79,7 @@ public:
         u_int64_t lval;
         int ret = decode(bp, len, &lval);
         
-        if (lval > 0xffffffffLL) {
+        if (ret < 0 || lval > 0xffffffffLL) {
             return -1;
         }
 
@@ -88,6 +88,16 @@ public:
         return ret;
     }
 
+    /**
+     * Convert count consecutive SDNVs pointed to by bp into unsigned
+     * 64-bit integers, for headers that are a run of SDNV fields.
+     *
+     * @return The total number of bytes of bp consumed, or -1 if any
+     * of the values is malformed or bp ends before the last one.
+     */
+    static int decode_n(const u_char* bp, size_t len,
+                        u_int64_t* vals, size_t count);
+
     /// @{
     /// Variants of encode/decode that take a char* for the buffer
     /// instead of a u_char*
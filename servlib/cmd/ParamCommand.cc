@@ -83,6 +83,20 @@ ParamCommand::ParamCommand()
                                 "Reject bundles that exceed quota even if CL is unreliable "
                                 "(default is true)"));
     
+    bind_var(new oasys::SizeOpt("block_encoding_cache_size",
+                                &BundleDaemon::params_.block_encoding_cache_size_,
+                                "bytes",
+                                "memory for reusing the encoded primary and payload "
+                                "blocks when a bundle is sent again (0 disables; "
+                                "default: 16M)"));
+
+    bind_var(new oasys::UIntOpt("cl_event_loops",
+                                &BundleDaemon::params_.cl_event_loops_,
+                                "threads",
+                                "number of event loop threads shared by the TCP, STCP "
+                                "and MTCP CL connections instead of a thread per "
+                                "connection (0 disables; default: 0)"));
+
     bind_var(new oasys::BoolOpt("clear_bundles_when_opp_link_unavailable",
                                 &BundleDaemon::params_.clear_bundles_when_opp_link_unavailable_,
                                 "Clear bundles from opportunistic link when it goes unavailable "
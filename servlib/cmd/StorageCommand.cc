@@ -43,6 +43,7 @@
 #include "bundling/BundleDaemon.h"
 #include "bundling/BundleDaemonStorage.h"
 #include "bundling/FormatUtils.h"
+#include "bundling/PayloadMemoryManager.h"
 #include "storage/BundleStore.h"
 #include "storage/DTNStorageConfig.h"
 
@@ -56,6 +57,15 @@ StorageCommand::StorageCommand(DTNStorageConfig* cfg)
         {"memory",   BundlePayload::MEMORY},
         {"disk",     BundlePayload::DISK},
         {"nodata",   BundlePayload::NODATA},
+        {"hybrid",   BundlePayload::HYBRID},
+        {0, 0}
+    };
+
+    static oasys::EnumOpt::Case PayloadReloadCheckCases[] = {
+        {"none",     BundleDaemonStorage::RELOAD_CHECK_NONE},
+        {"size",     BundleDaemonStorage::RELOAD_CHECK_SIZE},
+        {"full",     BundleDaemonStorage::RELOAD_CHECK_FULL},
+        {"scrub",    BundleDaemonStorage::RELOAD_CHECK_SCRUB},
         {0, 0}
     };
     
@@ -108,6 +118,28 @@ StorageCommand::StorageCommand(DTNStorageConfig* cfg)
 				"(default 0)\n"
 		"	valid options:	number"));
 
+    bind_var(new oasys::IntOpt("fs_dir_levels", &cfg->fs_dir_levels_,
+				"num", "number of levels of hashed subdirectories "
+				"(256 per level) the Filesystem DB record files are "
+				"spread over; an existing database is migrated to "
+				"this layout when it is opened (default 1, max 3, "
+				"0 for one flat directory per table)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::BoolOpt("fs_batch_sync", &cfg->fs_batch_sync_,
+				"whether the Filesystem DB fsyncs the files written "
+				"in a transaction and then each directory changed "
+				"once when the transaction is durably committed, "
+				"and after each write outside of a transaction "
+				"(default false)\n"
+		"	valid options:	true or false"));
+
+    bind_var(new oasys::IntOpt("fs_scan_threads", &cfg->fs_scan_threads_,
+				"num", "number of threads used to scan the "
+				"subdirectories of a Filesystem DB table when "
+				"it is iterated or sized (default 4)\n"
+		"	valid options:	number"));
+
     bind_var(new oasys::BoolOpt("auto_commit", &cfg->auto_commit_,
 				"whether auto-commit (if supported) is on or not "
     		    "default is true (auto-commit on)\n"
@@ -162,7 +194,8 @@ StorageCommand::StorageCommand(DTNStorageConfig* cfg)
     bind_var(new oasys::IntOpt("db_lockdetect", &cfg->db_lockdetect_,
 				"num", "frequency to check for Berkeley "
 				"DB deadlocks (default 5000 and "
-                               "zero disables locking)\n"
+                               "zero disables locking, which also "
+                               "serializes access across all tables)\n"
 		"	valid options:	number"));
 
     bind_var(new oasys::StringOpt("payloaddir", &cfg->payload_dir_,
@@ -215,6 +248,19 @@ StorageCommand::StorageCommand(DTNStorageConfig* cfg)
 			 "MySQL server to avoid connections being terminated (default 10)\n"
     		 "	valid options:	positive integer"));
 
+    bind_var(new oasys::IntOpt("odbc_del_batch_size", &cfg->odbc_del_batch_size_,
+				"num", "number of deletes per table queued inside "
+				"a transaction before they are issued as one multi-row "
+				"DELETE when auto-commit is off (default 32, max 500, "
+				"0 to issue each delete immediately)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::BoolOpt("odbc_sqlite_wal", &cfg->odbc_sqlite_wal_,
+				"use the write-ahead log journal mode for SQLite; the "
+				"synchronous level is FULL if max_nondurable_transactions "
+				"is 0 and NORMAL otherwise (default true)\n"
+		"	valid options:	true or false"));
+
     bind_var(new oasys::UIntOpt("interval",
                                 &BundleDaemonStorage::params_.db_storage_ms_interval_,
                                 "milliseconds",
@@ -240,8 +286,84 @@ StorageCommand::StorageCommand(DTNStorageConfig* cfg)
     bind_var(new oasys::EnumOpt("payload_location",
                                 PayloadLocationCases,
                                 (int*)&BundleDaemonStorage::params_.payload_location_,
-                                "memory | disk | nodata",
-                                "where bundle payloads should be stored (nodata is only used for testing)"));
+                                "memory | disk | nodata | hybrid",
+                                "where bundle payloads should be stored (nodata is only used for testing; "
+                                "hybrid keeps payloads in memory within payload_mem_budget and "
+                                "spills them to disk as needed)"));
+
+    bind_var(new oasys::SizeOpt("payload_mem_budget",
+                                &BundleDaemonStorage::params_.payload_mem_budget_,
+                                "bytes", "max bytes of hybrid payloads to hold in memory "
+				"(default 256M; magnitude chars allowed)\n"
+		"	valid options:	number[K | M | G]"));
+
+    bind_var(new oasys::UIntOpt("payload_mem_high_water",
+                                &BundleDaemonStorage::params_.payload_mem_high_water_pct_,
+                                "percent", "percent of payload_mem_budget in use at which the least "
+				"recently used hybrid payloads are spilled to disk (default 90)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::UIntOpt("payload_mem_low_water",
+                                &BundleDaemonStorage::params_.payload_mem_low_water_pct_,
+                                "percent", "percent of payload_mem_budget in use at which spilling "
+				"hybrid payloads to disk stops (default 75)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::UIntOpt("payload_mem_max_age",
+                                &BundleDaemonStorage::params_.payload_mem_max_age_,
+                                "seconds", "spill a hybrid payload to disk after it has not been "
+				"accessed for this many seconds (default 60; 0 = never)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::BoolOpt("payload_write_behind",
+                                &BundleDaemonStorage::params_.payload_write_behind_,
+				"whether received payload data is buffered and written to the "
+				"payload file by a separate I/O thread (default true)\n"
+        		"	valid options:	true or false"));
+
+    bind_var(new oasys::UIntOpt("payload_write_chunk",
+                                &BundleDaemonStorage::params_.payload_write_chunk_,
+                                "bytes", "size of the aligned chunks in which buffered payload "
+				"data is written to the payload file (default 1048576)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::UIntOpt("payload_write_behind_limit",
+                                &BundleDaemonStorage::params_.payload_write_behind_limit_,
+                                "bytes", "max memory buffered for the payload writer across all "
+				"payloads before data is written directly (default 67108864; 0 = no limit)\n"
+		"	valid options:	number"));
+
+    bind_var(new oasys::BoolOpt("payload_preallocate",
+                                &BundleDaemonStorage::params_.payload_preallocate_,
+				"whether to preallocate disk space for a payload file once "
+				"the payload length is known (default true)\n"
+        		"	valid options:	true or false"));
+
+    bind_var(new oasys::BoolOpt("payload_read_views",
+                                &BundleDaemonStorage::params_.payload_read_views_,
+				"whether to transmit payloads directly from a memory mapping "
+				"of the payload file instead of reading them into a work buffer (default true)\n"
+        		"	valid options:	true or false"));
+
+    bind_var(new oasys::BoolOpt("payload_checksums",
+                                &BundleDaemonStorage::params_.payload_checksums_,
+				"whether to compute a CRC32C of payload data as it is written "
+				"and store it with the bundle (default true)\n"
+        		"	valid options:	true or false"));
+
+    bind_var(new oasys::EnumOpt("payload_reload_check",
+                                PayloadReloadCheckCases,
+                                (int*)&BundleDaemonStorage::params_.payload_reload_check_,
+                                "none | size | full | scrub",
+                                "how payload files are checked when bundles are reloaded "
+                                "(default size; full verifies the CRC before loading the "
+                                "bundle and scrub verifies it in the background)"));
+
+    bind_var(new oasys::SizeOpt("payload_scrub_rate",
+                                &BundleDaemonStorage::params_.payload_scrub_rate_,
+                                "bytes", "max bytes per second read when verifying reloaded "
+				"payloads in the background (default 10M; magnitude chars allowed)\n"
+		"	valid options:	number[K | M | G]"));
     
     add_to_help("usage", "print the current storage usage");
     add_to_help("stats", "print storage statistics");
@@ -290,6 +412,12 @@ StorageCommand::exec(int argc, const char** argv, Tcl_Interp* interp)
                 max_disk_size,
                 FORMAT_WITH_MAG(max_disk_size).c_str());
 
+        if (PayloadMemoryManager::initialized()) {
+            oasys::StringBuffer buf("\n");
+            PayloadMemoryManager::instance()->get_usage(&buf);
+            append_result(buf.c_str());
+        }
+
         return TCL_OK;
     }
     else if (!strcmp(cmd, "stats")) {
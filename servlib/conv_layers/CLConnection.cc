@@ -18,10 +18,14 @@
 #  include <dtn-config.h>
 #endif
 
+#include <algorithm>
+#include <unistd.h>
+
 #include <third_party/oasys/util/OptParser.h>
 #include <third_party/oasys/util/Time.h>
 
 #include "CLConnection.h"
+#include "CLEventLoop.h"
 #include "bundling/BundleDaemon.h"
 #include "bundling/BundlePayload.h"
 #include "contacts/ContactManager.h"
@@ -47,7 +51,12 @@ CLConnection::CLConnection(const char*       classname,
       num_pollfds_(0),
       poll_timeout_(-1),
       contact_broken_(false),
-      admin_msg_list_("/clconn/msgq")
+      admin_msg_list_("/clconn/msgq"),
+      link_queue_lock_(&link_queue_lock_own_),
+      bundles_sent_(0),
+      bytes_sent_(0),
+      bundles_rcvd_(0),
+      bytes_rcvd_(0)
 {
     sendbuf_.reserve(params_->sendbuf_len_);
     recvbuf_.reserve(params_->recvbuf_len_);
@@ -65,6 +74,100 @@ CLConnection::force_shutdown()
     break_contact(ContactEvent::USER);
 }
 
+//----------------------------------------------------------------------
+void
+CLConnection::start_connection()
+{
+    CLEventLoopPool::instance()->start_connection(this);
+}
+
+//----------------------------------------------------------------------
+bool
+CLConnection::event_loop_capable()
+{
+    // the test delays are implemented by sleeping in the connection
+    return (params_->test_read_delay_ == 0) && (params_->test_write_delay_ == 0);
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::delay_turns(int msecs)
+{
+    if (on_event_loop_) {
+        delay_msecs_ = std::max(delay_msecs_, msecs);
+        return;
+    }
+
+    if (msecs >= 1000) {
+        sleep(msecs / 1000);
+    }
+    usleep((msecs % 1000) * 1000);
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::set_primary(CLConnection* primary)
+{
+    ASSERT(primary->primary_ == nullptr);
+    primary_         = primary;
+    link_queue_lock_ = primary->link_queue_lock_;
+    contact_         = primary->contact_;
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::add_stripe(CLConnection* stripe)
+{
+    oasys::ScopeLock l(&stripes_lock_, "CLConnection::add_stripe");
+    stripes_.push_back(stripe);
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::take_stripes(std::vector<CLConnection*>* stripes)
+{
+    oasys::ScopeLock l(&stripes_lock_, "CLConnection::take_stripes");
+    stripes->swap(stripes_);
+    stripes_.clear();
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::post_to_stripes(const CLMsg& msg)
+{
+    oasys::ScopeLock l(&stripes_lock_, "CLConnection::post_to_stripes");
+    for (CLConnection* stripe : stripes_) {
+        stripe->cmdqueue_.push_back(msg);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::resize_buffers(u_int sendbuf_len, u_int recvbuf_len)
+{
+    oasys::ScopeLock l(&stripes_lock_, "CLConnection::resize_buffers");
+
+    for (size_t i = 0; i <= stripes_.size(); ++i) {
+        CLConnection* conn = (i == 0) ? this : stripes_[i - 1];
+
+        if ((sendbuf_len != conn->sendbuf_.size()) &&
+            (sendbuf_len >= conn->sendbuf_.fullbytes()))
+        {
+            log_info("resizing session %zu send buffer from %zu -> %u",
+                     i, conn->sendbuf_.size(), sendbuf_len);
+            conn->sendbuf_.set_size(sendbuf_len);
+        }
+
+        if ((recvbuf_len != conn->recvbuf_.size()) &&
+            (recvbuf_len >= conn->recvbuf_.fullbytes()))
+        {
+            log_info("resizing session %zu recv buffer from %zu -> %u",
+                     i, conn->recvbuf_.size(), recvbuf_len);
+            conn->recvbuf_.set_size(recvbuf_len);
+        }
+    }
+}
+
 //----------------------------------------------------------------------
 void
 CLConnection::run()
@@ -242,9 +345,17 @@ CLConnection::contact_up()
 
 //----------------------------------------------------------------------
 void
-CLConnection::break_contact(ContactEvent::reason_t reason)
+CLConnection::set_contact_broken()
 {
+    oasys::ScopeLock l(&session_lock_, "CLConnection::set_contact_broken");
     contact_broken_ = true;
+}
+
+//----------------------------------------------------------------------
+void
+CLConnection::break_contact(ContactEvent::reason_t reason)
+{
+    set_contact_broken();
         
     log_debug("break_contact: %s", ContactEvent::reason_to_str(reason));
 
@@ -379,6 +490,30 @@ CLConnection::get_cla_stats(oasys::StringBuffer& buf)
 {
     buf.appendf("incoming: %zu recv_buf: %zu send_buf: %zu ack_list: %zu",
                 incoming_.size(),  recvbuf_.fullbytes(), sendbuf_.fullbytes(), ack_list_.size());
+
+    oasys::ScopeLock l(&stripes_lock_, "CLConnection::get_cla_stats");
+    if (stripes_.empty()) {
+        return;
+    }
+
+    // one line per session when the link is striped
+    for (size_t i = 0; i <= stripes_.size(); ++i) {
+        CLConnection* conn = (i == 0) ? this : stripes_[i - 1];
+
+        size_t num_inflight;
+        bool   broken;
+        do {
+            oasys::ScopeLock sl(&conn->session_lock_, "CLConnection::get_cla_stats");
+            num_inflight = conn->inflight_.size();
+            broken       = conn->contact_broken_;
+        } while (false);
+
+        buf.appendf("\n  session %zu: sent %" PRIu64 " bundles (%" PRIu64 " bytes) "
+                    "received %" PRIu64 " bundles (%" PRIu64 " bytes) inflight: %zu%s",
+                    i, conn->bundles_sent_.load(), conn->bytes_sent_.load(),
+                    conn->bundles_rcvd_.load(), conn->bytes_rcvd_.load(),
+                    num_inflight, broken ? " (broken)" : "");
+    }
 }
 
 } // namespace dtn
@@ -17,8 +17,10 @@
 #ifndef _CLCONNECTION_H_
 #define _CLCONNECTION_H_
 
+#include <atomic>
 #include <list>
 #include <memory>
+#include <vector>
 
 #include <third_party/oasys/debug/Log.h>
 #include <third_party/oasys/thread/Atomic.h>
@@ -42,6 +44,7 @@ class CLConnection : public CLInfo,
                      public oasys::Logger {
 public:
     friend class ConnectionConvergenceLayer;
+    friend class CLEventLoop;
     typedef ConnectionConvergenceLayer::LinkParams LinkParams;
     
     /**
@@ -73,6 +76,20 @@ public:
      */
     virtual void force_shutdown();
 
+    /**
+     * Start driving the connection, either on its own thread or, if
+     * the cl_event_loops daemon parameter is set, on one of the
+     * shared event loops.
+     */
+    void start_connection();
+
+    /**
+     * Whether the connection can be driven by an event loop instead
+     * of its own thread. Connections that override run() or may
+     * sleep while handling activity must return false.
+     */
+    virtual bool event_loop_capable();
+
 protected:
     /**
      * Main run loop.
@@ -83,10 +100,18 @@ protected:
     /// Utility functions, all virtual so subclasses could override them
     virtual void contact_up();
     virtual void break_contact(ContactEvent::reason_t reason);
+    void set_contact_broken();
     virtual void process_command();
     virtual bool find_contact(const SPtr_EID& sptr_peer_eid);
     /// @}
 
+    /**
+     * Hold off the connection for the given time. A connection thread
+     * just sleeps; on an event loop the connection gets no turns until
+     * the time is up so the other connections on the loop keep going.
+     */
+    void delay_turns(int msecs);
+
     /**
      * Assignment function for the nexthop identifier
      */
@@ -214,6 +239,34 @@ protected:
 //    typedef std::list<std::string> AdminMsgList;
     typedef oasys::MsgQueue<std::string*> AdminMsgList;
 
+    /// @{
+    /**
+     * Parallel sessions striped across one link. The primary
+     * connection is the contact's cl_info and reports the contact up
+     * and down; each stripe shares its contact and link queue and is
+     * owned by it.
+     */
+
+    /// Make this connection a stripe of the primary's contact
+    void set_primary(CLConnection* primary);
+
+    /// Whether this connection is a stripe of another connection
+    bool is_stripe() const { return primary_ != nullptr; }
+
+    /// Add a stripe to this (primary) connection
+    void add_stripe(CLConnection* stripe);
+
+    /// Take the stripes away from this connection
+    void take_stripes(std::vector<CLConnection*>* stripes);
+
+    /// Queue the message for each of the stripes of this connection
+    void post_to_stripes(const CLMsg& msg);
+
+    /// Resize the send and receive buffers of this connection and its
+    /// stripes, skipping any buffer holding more than the new size
+    void resize_buffers(u_int sendbuf_len, u_int recvbuf_len);
+    /// @}
+
 
     /**
      * Struct used to record bundles that are in-flight along with
@@ -309,6 +362,29 @@ protected:
     AckList             ack_list_;
     AdminMsgList        admin_msg_list_;
 
+    CLConnection*              primary_ = nullptr; ///< Primary of a stripe
+    oasys::SpinLock            stripes_lock_;      ///< Protects stripes_
+    std::vector<CLConnection*> stripes_;           ///< Stripes of a primary
+
+    /// Protects inflight_ and contact_broken_ for get_cla_stats, which
+    /// reads them for every stripe from another thread
+    oasys::SpinLock            session_lock_;
+
+    /// Serializes taking bundles off the link queue among the stripes
+    /// of a link (points at the primary's own lock)
+    oasys::SpinLock            link_queue_lock_own_;
+    oasys::SpinLock*           link_queue_lock_;
+
+    bool                       on_event_loop_ = false; ///< Driven by a CLEventLoop
+    int                        delay_msecs_ = 0;       ///< Delay for the event loop to apply
+
+    /// @{ Per session statistics
+    std::atomic<uint64_t>      bundles_sent_;
+    std::atomic<uint64_t>      bytes_sent_;
+    std::atomic<uint64_t>      bundles_rcvd_;
+    std::atomic<uint64_t>      bytes_rcvd_;
+    /// @}
+
 };
 
 } // namespace dtn
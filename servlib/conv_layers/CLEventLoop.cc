@@ -0,0 +1,545 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <third_party/oasys/io/IO.h>
+
+#include "CLEventLoop.h"
+#include "bundling/BundleDaemon.h"
+
+namespace oasys {
+    template <> dtn::CLEventLoopPool* oasys::Singleton<dtn::CLEventLoopPool>::instance_ = nullptr;
+}
+
+namespace dtn {
+
+//----------------------------------------------------------------------
+CLEventLoop::CLEventLoop(int id)
+    : Thread("CLEventLoop"),
+      Logger("CLEventLoop", "/dtn/cl/eventloop/%d", id),
+      id_(id),
+      num_connections_(0),
+      wakeups_(0),
+      turns_(0),
+      timeouts_(0),
+      delays_(0)
+{
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        PANIC("CLEventLoop: error creating epoll instance: %s", strerror(errno));
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        PANIC("CLEventLoop: error creating eventfd: %s", strerror(errno));
+    }
+
+    // a null data pointer identifies the wakeup fd
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events   = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev) != 0) {
+        PANIC("CLEventLoop: error adding eventfd to epoll: %s", strerror(errno));
+    }
+}
+
+//----------------------------------------------------------------------
+CLEventLoop::~CLEventLoop()
+{
+    close(wakeup_fd_);
+    close(epoll_fd_);
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::add(CLConnection* conn)
+{
+    ++num_connections_;
+
+    lock_.lock("CLEventLoop::add");
+    pending_.push_back(conn);
+    lock_.unlock();
+
+    uint64_t one = 1;
+    if (::write(wakeup_fd_, &one, sizeof(one)) != sizeof(one)) {
+        // only fails if the counter is about to overflow, in which
+        // case the loop is already due to wake up
+        log_debug("add: eventfd write failed: %s", strerror(errno));
+    }
+}
+
+//----------------------------------------------------------------------
+uint64_t
+CLEventLoop::now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::run()
+{
+    char threadname[16];
+    snprintf(threadname, sizeof(threadname), "CLEventLoop%d", id_);
+    pthread_setname_np(pthread_self(), threadname);
+
+    static const int MAX_EVENTS = 256;
+    struct epoll_event events[MAX_EVENTS];
+    std::vector<CLConnection*> added;
+
+    while (true) {
+        int timeout = ready_.empty() ? next_timeout() : 0;
+
+        int cc = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout);
+        if (cc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PANIC("CLEventLoop: epoll_wait error: %s", strerror(errno));
+        }
+
+        ++wakeups_;
+
+        for (int i = 0; i < cc; ++i) {
+            Entry* entry = (Entry*)events[i].data.ptr;
+
+            if (entry == nullptr) {
+                uint64_t count;
+                if (::read(wakeup_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                    log_err("error reading eventfd: %s", strerror(errno));
+                }
+
+                lock_.lock("CLEventLoop::run");
+                added.swap(pending_);
+                lock_.unlock();
+
+                for (CLConnection* conn : added) {
+                    attach(conn);
+                }
+                added.clear();
+                continue;
+            }
+
+            make_ready(entry);
+        }
+
+        expire_timers();
+
+        // only give a turn to the entries that were ready when we
+        // started so that ones that keep going back on the list don't
+        // keep the loop from checking for new events
+        size_t num_ready = ready_.size();
+        while (num_ready-- != 0) {
+            Entry* entry = ready_.front();
+            ready_.pop_front();
+            entry->ready_ = false;
+            service(entry);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::attach(CLConnection* conn)
+{
+    // mimic Thread::thread_run() so that the connection's owner sees
+    // the same state changes as for a connection thread
+    conn->set_flag(oasys::Thread::STARTED);
+    conn->clear_flag(oasys::Thread::STOPPED);
+    conn->clear_flag(oasys::Thread::SHOULD_STOP);
+
+    conn->on_event_loop_ = true;
+
+    Entry* entry = new Entry();
+    entry->conn_      = conn;
+    entry->nfds_      = 0;
+    entry->ready_     = false;
+    entry->has_timer_ = false;
+    entry->delayed_   = false;
+
+    conn->initialize_pollfds();
+    if (conn->contact_broken_) {
+        log_debug("contact_broken set during initialization");
+        detach(entry);
+        return;
+    }
+
+    struct pollfd* cmdqueue_poll = &conn->pollfds_[conn->num_pollfds_];
+    cmdqueue_poll->fd     = conn->cmdqueue_.read_fd();
+    cmdqueue_poll->events = POLLIN;
+
+    if (conn->active_connector_) {
+        conn->connect();
+    } else {
+        conn->accept();
+    }
+
+    make_ready(entry);
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::detach(Entry* entry)
+{
+    CLConnection* conn = entry->conn_;
+
+    // the connection may have closed its socket already, in which
+    // case epoll has dropped it and the delete fails harmlessly
+    for (int i = 0; i < entry->nfds_; ++i) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, entry->fds_[i], nullptr);
+    }
+
+    cancel_timer(entry);
+    ASSERT(!entry->ready_);
+    delete entry;
+
+    --num_connections_;
+
+    // once the connection is marked as stopped its owner is free to
+    // delete it, so check the flag before
+    bool delete_on_exit = (conn->flags_ & oasys::Thread::DELETE_ON_EXIT) != 0;
+    conn->set_flag(oasys::Thread::STOPPED);
+
+    if (delete_on_exit) {
+        delete conn;
+    }
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::make_ready(Entry* entry)
+{
+    if (!entry->ready_) {
+        entry->ready_ = true;
+        ready_.push_back(entry);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::service(Entry* entry)
+{
+    CLConnection* conn = entry->conn_;
+    int nfds = conn->num_pollfds_ + 1;
+
+    ++turns_;
+
+    // this is one or more passes of the CLConnection::run() loop,
+    // with poll() only checking for activity instead of waiting
+    for (int budget = SERVICE_BUDGET; budget > 0; --budget) {
+        if (conn->contact_broken_) {
+            log_debug("contact_broken set, detaching connection");
+            detach(entry);
+            return;
+        }
+
+        if (check_delay(entry)) {
+            return;
+        }
+
+        if (conn->cmdqueue_.size() != 0) {
+            conn->process_command();
+            continue;
+        }
+
+        bool more_to_send = conn->send_pending_data();
+
+        if (conn->contact_broken_) {
+            log_debug("contact_broken set, detaching connection");
+            detach(entry);
+            return;
+        }
+
+        for (int i = 0; i < nfds; ++i) {
+            conn->pollfds_[i].revents = 0;
+        }
+
+        int cc = oasys::IO::poll_multiple(conn->pollfds_, nfds, 0, nullptr, logpath_);
+
+        if (conn->contact_broken_) {
+            log_debug("contact_broken set, detaching connection");
+            detach(entry);
+            return;
+        }
+
+        if (cc == oasys::IOTIMEOUT) {
+            if (!more_to_send) {
+                // nothing to do until epoll reports some activity or
+                // the poll timeout runs out
+                update_interest(entry);
+                set_timer(entry);
+                return;
+            }
+
+            // like the connection thread's zero timeout poll
+            conn->handle_poll_timeout();
+        }
+        else if (cc > 0)
+        {
+            if (cc == 1 && conn->pollfds_[nfds - 1].revents != 0) {
+                continue; // activity on the command queue only
+            }
+            conn->handle_poll_activity();
+        }
+        else
+        {
+            log_err("unexpected return from poll_multiple: %d", cc);
+            conn->break_contact(ContactEvent::BROKEN);
+            detach(entry);
+            return;
+        }
+    }
+
+    if (check_delay(entry)) {
+        return;
+    }
+
+    // out of budget with work left to do, so come back to it after
+    // the other connections have had a turn
+    update_interest(entry);
+    set_timer(entry);
+    make_ready(entry);
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::update_interest(Entry* entry)
+{
+    CLConnection* conn = entry->conn_;
+    int nfds = conn->num_pollfds_ + 1;
+
+    // drop registrations for fds the connection no longer polls
+    for (int i = nfds; i < entry->nfds_; ++i) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, entry->fds_[i], nullptr);
+    }
+
+    for (int i = 0; i < nfds; ++i) {
+        struct pollfd* pfd = &conn->pollfds_[i];
+
+        uint32_t events = 0;
+        if (pfd->events & POLLIN)  events |= EPOLLIN;
+        if (pfd->events & POLLOUT) events |= EPOLLOUT;
+        if (pfd->events & POLLPRI) events |= EPOLLPRI;
+
+        int op;
+        if (i >= entry->nfds_) {
+            op = EPOLL_CTL_ADD;
+        } else if (entry->fds_[i] != pfd->fd) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, entry->fds_[i], nullptr);
+            op = EPOLL_CTL_ADD;
+        } else if (entry->events_[i] != events) {
+            op = EPOLL_CTL_MOD;
+        } else {
+            continue;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events   = events;
+        ev.data.ptr = entry;
+
+        if (epoll_ctl(epoll_fd_, op, pfd->fd, &ev) != 0) {
+            if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+                epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, pfd->fd, &ev);
+            } else {
+                log_err("error registering fd %d with epoll: %s",
+                        pfd->fd, strerror(errno));
+            }
+        }
+
+        entry->fds_[i]    = pfd->fd;
+        entry->events_[i] = events;
+    }
+
+    entry->nfds_ = nfds;
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::set_timer(Entry* entry)
+{
+    cancel_timer(entry);
+
+    int poll_timeout = entry->conn_->poll_timeout_;
+    if (poll_timeout < 0) {
+        return;
+    }
+
+    entry->timer_iter_ = timers_.insert(std::make_pair(now_ms() + poll_timeout, entry));
+    entry->has_timer_  = true;
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::cancel_timer(Entry* entry)
+{
+    if (entry->has_timer_) {
+        timers_.erase(entry->timer_iter_);
+        entry->has_timer_ = false;
+    }
+}
+
+//----------------------------------------------------------------------
+bool
+CLEventLoop::check_delay(Entry* entry)
+{
+    CLConnection* conn = entry->conn_;
+
+    if (conn->delay_msecs_ == 0) {
+        return false;
+    }
+
+    // stop watching the connection's fds so that activity doesn't keep
+    // waking up the loop, update_interest() puts them back afterwards
+    for (int i = 0; i < entry->nfds_; ++i) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, entry->fds_[i], nullptr);
+    }
+    entry->nfds_ = 0;
+
+    cancel_timer(entry);
+    entry->timer_iter_ = timers_.insert(std::make_pair(now_ms() + conn->delay_msecs_, entry));
+    entry->has_timer_  = true;
+    entry->delayed_    = true;
+
+    conn->delay_msecs_ = 0;
+    ++delays_;
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::expire_timers()
+{
+    if (timers_.empty()) {
+        return;
+    }
+
+    uint64_t now = now_ms();
+
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+        Entry* entry = timers_.begin()->second;
+        timers_.erase(timers_.begin());
+        entry->has_timer_ = false;
+
+        // the connection picks up where it left off after a delay
+        if (entry->delayed_) {
+            entry->delayed_ = false;
+            make_ready(entry);
+            continue;
+        }
+
+        // an entry that is ready will get its turn anyway and a new
+        // timer afterwards
+        if (entry->ready_) {
+            continue;
+        }
+
+        ++timeouts_;
+        entry->conn_->handle_poll_timeout();
+        make_ready(entry);
+    }
+}
+
+//----------------------------------------------------------------------
+int
+CLEventLoop::next_timeout()
+{
+    if (timers_.empty()) {
+        return -1;
+    }
+
+    uint64_t now = now_ms();
+    uint64_t deadline = timers_.begin()->first;
+    return (deadline <= now) ? 0 : (int)(deadline - now);
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoop::get_stats(oasys::StringBuffer* buf)
+{
+    buf->appendf("    loop %d: %zu connections  %" PRIu64 " wakeups  %" PRIu64 " turns  "
+                 "%" PRIu64 " timeouts  %" PRIu64 " delays\n",
+                 id_, num_connections_.load(), wakeups_.load(), turns_.load(),
+                 timeouts_.load(), delays_.load());
+}
+
+//----------------------------------------------------------------------
+CLEventLoopPool::CLEventLoopPool()
+{
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoopPool::start_connection(CLConnection* conn)
+{
+    u_int num_loops = BundleDaemon::params_.cl_event_loops_;
+
+    if (num_loops == 0 || !conn->event_loop_capable()) {
+        conn->start();
+        return;
+    }
+
+    oasys::ScopeLock l(&lock_, "CLEventLoopPool::start_connection");
+
+    // the pool only ever grows, so lowering the parameter while
+    // running spreads new connections over the existing loops
+    while (loops_.size() < num_loops) {
+        CLEventLoop* loop = new CLEventLoop(loops_.size());
+        loop->start();
+        loops_.push_back(loop);
+    }
+
+    CLEventLoop* least_loaded = loops_[0];
+    for (CLEventLoop* loop : loops_) {
+        if (loop->num_connections() < least_loaded->num_connections()) {
+            least_loaded = loop;
+        }
+    }
+
+    least_loaded->add(conn);
+}
+
+//----------------------------------------------------------------------
+void
+CLEventLoopPool::get_stats(oasys::StringBuffer* buf)
+{
+    oasys::ScopeLock l(&lock_, "CLEventLoopPool::get_stats");
+
+    if (loops_.empty()) {
+        return;
+    }
+
+    buf->appendf("CL Event Loops     : %zu threads\n", loops_.size());
+    for (CLEventLoop* loop : loops_) {
+        loop->get_stats(buf);
+    }
+}
+
+} // namespace dtn
@@ -0,0 +1,177 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _CL_EVENT_LOOP_H_
+#define _CL_EVENT_LOOP_H_
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <third_party/oasys/debug/Log.h>
+#include <third_party/oasys/thread/SpinLock.h>
+#include <third_party/oasys/thread/Thread.h>
+#include <third_party/oasys/util/Singleton.h>
+#include <third_party/oasys/util/StringBuffer.h>
+
+#include "CLConnection.h"
+
+namespace dtn {
+
+/**
+ * Thread that drives many CLConnections from a single epoll loop.
+ *
+ * Each connection does exactly what CLConnection::run() would do on
+ * its own thread -- process commands, send_pending_data(),
+ * handle_poll_activity() and handle_poll_timeout() -- but it only
+ * gets a turn when epoll reports activity on one of its pollfds (the
+ * socket or the command queue notifier), when its poll timeout
+ * expires or when it still had data to send at the end of its
+ * previous turn. The epoll interest set follows the events the
+ * connection asks for in its pollfds_ array.
+ *
+ * A connection that would sleep on its own thread calls
+ * CLConnection::delay_turns() instead, and the loop drops its epoll
+ * registrations and only gives it another turn once the delay is up.
+ *
+ * Connections are handed over from other threads through a queue
+ * and an eventfd that wakes up the loop.
+ */
+class CLEventLoop : public oasys::Thread,
+                    public oasys::Logger {
+public:
+    CLEventLoop(int id);
+    virtual ~CLEventLoop();
+
+    /**
+     * Hand the connection over to the loop, which then calls
+     * connect() or accept() on it. May be called from any thread.
+     */
+    void add(CLConnection* conn);
+
+    /// Number of connections being driven by the loop
+    size_t num_connections() const { return num_connections_; }
+
+    /// Write out the usage statistics
+    void get_stats(oasys::StringBuffer* buf);
+
+protected:
+    /// Per connection state
+    struct Entry {
+        CLConnection* conn_;
+        int           nfds_;                              ///< fds registered with epoll
+        int           fds_[CLConnection::MAXPOLL + 1];    ///< the registered fds
+        uint32_t      events_[CLConnection::MAXPOLL + 1]; ///< the registered events
+        bool          ready_;                             ///< on the ready list
+        bool          has_timer_;                         ///< on the timer list
+        bool          delayed_;                           ///< timer is a delay_turns() delay
+        std::multimap<uint64_t, Entry*>::iterator timer_iter_;
+    };
+
+    /// Virtual from Thread
+    virtual void run() override;
+
+    /// Start driving a newly added connection
+    void attach(CLConnection* conn);
+
+    /// Stop driving the connection and mark it stopped
+    void detach(Entry* entry);
+
+    /// Give the connection a turn
+    void service(Entry* entry);
+
+    /// Put the entry on the ready list to get another turn
+    void make_ready(Entry* entry);
+
+    /// Sync the epoll registrations with the connection's pollfds
+    void update_interest(Entry* entry);
+
+    /// (Re)start the poll timeout of the connection
+    void set_timer(Entry* entry);
+
+    /// Take the entry off the timer list
+    void cancel_timer(Entry* entry);
+
+    /// Apply a delay requested by the connection; returns true if the
+    /// connection is now waiting out the delay
+    bool check_delay(Entry* entry);
+
+    /// Call handle_poll_timeout() on the connections whose timer ran out
+    void expire_timers();
+
+    /// Milliseconds until the next timer runs out (-1 if none)
+    int next_timeout();
+
+    static uint64_t now_ms();
+
+    /// Max number of send/receive units handled per turn so one busy
+    /// connection can't starve the others
+    static const int SERVICE_BUDGET = 64;
+
+    int id_;
+    int epoll_fd_;
+    int wakeup_fd_;                      ///< eventfd signalled by add()
+
+    oasys::SpinLock            lock_;    ///< protects pending_
+    std::vector<CLConnection*> pending_; ///< added but not yet attached
+
+    std::deque<Entry*>              ready_;   ///< entries with work left
+    std::multimap<uint64_t, Entry*> timers_;  ///< entries keyed by poll deadline
+
+    std::atomic<size_t> num_connections_;
+
+    /// @{ Statistics
+    std::atomic<uint64_t> wakeups_;
+    std::atomic<uint64_t> turns_;
+    std::atomic<uint64_t> timeouts_;
+    std::atomic<uint64_t> delays_;
+    /// @}
+};
+
+/**
+ * The set of event loops shared by all of the connection oriented
+ * convergence layers. Loops are created the first time a connection
+ * is started with the cl_event_loops daemon parameter set, and each
+ * new connection goes to the loop with the fewest connections.
+ */
+class CLEventLoopPool : public oasys::Singleton<CLEventLoopPool> {
+public:
+    /**
+     * Start driving the connection, on an event loop if they are
+     * enabled and the connection can run on one, or else on its own
+     * thread.
+     */
+    void start_connection(CLConnection* conn);
+
+    /**
+     * Write out the usage statistics.
+     */
+    void get_stats(oasys::StringBuffer* buf);
+
+protected:
+    friend class oasys::Singleton<CLEventLoopPool>;
+
+    CLEventLoopPool();
+
+    oasys::SpinLock           lock_;
+    std::vector<CLEventLoop*> loops_;
+};
+
+} // namespace dtn
+
+#endif /* _CL_EVENT_LOOP_H_ */
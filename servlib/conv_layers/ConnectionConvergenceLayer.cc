@@ -40,6 +40,7 @@
 
 #include "ConnectionConvergenceLayer.h"
 #include "CLConnection.h"
+#include "CLEventLoop.h"
 #include "bundling/BundleDaemon.h"
 #include "bundling/BundleProtocol.h"
 
@@ -79,6 +80,8 @@ ConnectionConvergenceLayer::ConnectionConvergenceLayer(const char* classname,
                                                        const char* cl_name)
     : ConvergenceLayer(classname, cl_name)
 {
+    // create the event loop pool while startup is still single threaded
+    CLEventLoopPool::instance();
 }
 
 //----------------------------------------------------------------------
@@ -261,24 +264,10 @@ ConnectionConvergenceLayer::reconfigure_link(const LinkRef& link,
         
         CLConnection* conn = dynamic_cast<CLConnection*>(link->contact()->cl_info());
         ASSERT(conn != nullptr);
-        
-        if ((params->sendbuf_len_ != conn->sendbuf_.size()) &&
-            (params->sendbuf_len_ >= conn->sendbuf_.fullbytes()))
-        {
-            log_info("resizing link *%p send buffer from %zu -> %u",
-                     link.object(), conn->sendbuf_.size(),
-                     params->sendbuf_len_);
-            conn->sendbuf_.set_size(params->sendbuf_len_);
-        }
 
-        if ((params->recvbuf_len_ != conn->recvbuf_.size()) &&
-            (params->recvbuf_len_ >= conn->recvbuf_.fullbytes()))
-        {
-            log_info("resizing link *%p recv buffer from %zu -> %u",
-                     link.object(), conn->recvbuf_.size(),
-                     params->recvbuf_len_);
-            conn->recvbuf_.set_size(params->recvbuf_len_);
-        }
+        // every stripe of a striped link gets the new sizes
+        log_info("reconfiguring link *%p buffers", link.object());
+        conn->resize_buffers(params->sendbuf_len_, params->recvbuf_len_);
     }
 
     return true;
@@ -304,7 +293,7 @@ ConnectionConvergenceLayer::open_contact(const ContactRef& contact)
     CLConnection* conn = new_connection(link, params);
     conn->set_contact(contact);
     contact->set_cl_info(conn);
-    conn->start();
+    conn->start_connection();
 
     return true;
 }
@@ -325,6 +314,34 @@ ConnectionConvergenceLayer::close_contact(const ContactRef& contact)
     CLConnection* conn = dynamic_cast<CLConnection*>(contact->cl_info());
     ASSERT(conn != nullptr);
 
+    // stop the primary first so it can't start any more stripes, then
+    // take down the parallel sessions striped across the link
+    stop_connection(conn);
+
+    std::vector<CLConnection*> stripes;
+    conn->take_stripes(&stripes);
+    for (CLConnection* stripe : stripes) {
+        stop_connection(stripe);
+        cleanup_connection(contact, stripe);
+    }
+
+    cleanup_connection(contact, conn);
+    
+    contact->set_cl_info(nullptr);
+
+    if (link->isdeleted()) {
+        ASSERT(link->cl_info() != nullptr);
+        delete link->cl_info();
+        link->set_cl_info(nullptr);
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+ConnectionConvergenceLayer::stop_connection(CLConnection* conn)
+{
     // if the connection isn't already broken, then we need to tell it
     // to do so
     if (! conn->contact_broken_) {
@@ -350,6 +367,14 @@ ConnectionConvergenceLayer::close_contact(const ContactRef& contact)
             oasys::Thread::yield();
         }
     }
+}
+
+//----------------------------------------------------------------------
+void
+ConnectionConvergenceLayer::cleanup_connection(const ContactRef& contact,
+                                               CLConnection* conn)
+{
+    const LinkRef& link = contact->link();
 
     // now that the connection thread is stopped, clean up the in
     // flight and incoming bundles
@@ -403,7 +428,10 @@ ConnectionConvergenceLayer::close_contact(const ContactRef& contact)
             }
         }
 
-        conn->inflight_.pop_front();
+        do {
+            oasys::ScopeLock l(&conn->session_lock_, "ConnectionConvergenceLayer::cleanup_connection");
+            conn->inflight_.pop_front();
+        } while (false);
         delete inflight;
     }
 
@@ -452,16 +480,6 @@ ConnectionConvergenceLayer::close_contact(const ContactRef& contact)
     while (conn->cmdqueue_.try_pop(&msg)) {}
     
     delete conn;
-    
-    contact->set_cl_info(nullptr);
-
-    if (link->isdeleted()) {
-        ASSERT(link->cl_info() != nullptr);
-        delete link->cl_info();
-        link->set_cl_info(nullptr);
-    }
-
-    return true;
 }
 
 //----------------------------------------------------------------------
@@ -500,8 +518,12 @@ ConnectionConvergenceLayer::bundle_queued(const LinkRef& link,
     // note that it's possible the bundle was already picked up and
     // taken off the link queue by the connection thread, so don't
     // assert here.
-    conn->cmdqueue_.push_back(
-        CLConnection::CLMsg(CLConnection::CLMSG_BUNDLES_QUEUED));
+    CLConnection::CLMsg msg(CLConnection::CLMSG_BUNDLES_QUEUED);
+    conn->cmdqueue_.push_back(msg);
+
+    // whichever of the sessions striped across the link has room
+    // takes the bundle
+    conn->post_to_stripes(msg);
 }
 
 //----------------------------------------------------------------------
@@ -555,8 +577,9 @@ ConnectionConvergenceLayer::cancel_bundle(const LinkRef& link,
     log_debug("ConnectionConvergenceLayer::cancel_bundle: "
               "cancelling *%p on *%p", bundle.object(), link.object());
 
-    conn->cmdqueue_.push_back(
-        CLConnection::CLMsg(CLConnection::CLMSG_CANCEL_BUNDLE, bundle));
+    CLConnection::CLMsg msg(CLConnection::CLMSG_CANCEL_BUNDLE, bundle);
+    conn->cmdqueue_.push_back(msg);
+    conn->post_to_stripes(msg);
 }
 
 } // namespace dtn
@@ -147,6 +147,17 @@ protected:
     virtual CLConnection* new_connection(const LinkRef& link,
                                          LinkParams* params) = 0;
 
+    /**
+     * Tell the connection to break contact and wait for it to stop.
+     */
+    void stop_connection(CLConnection* conn);
+
+    /**
+     * Requeue or report the in flight and incoming bundles of a
+     * stopped connection and delete it.
+     */
+    void cleanup_connection(const ContactRef& contact, CLConnection* conn);
+
 };
 
 } // namespace dtn
@@ -22,6 +22,7 @@
 #include <iostream>
 // #include <sys/timeb.h>
 #include <climits>
+#include <netinet/udp.h>
 
 #include <third_party/oasys/io/NetUtils.h>
 #include <third_party/oasys/util/OptParser.h>
@@ -37,6 +38,23 @@
 
 namespace dtn {
 
+// older C libraries don't define the UDP GSO/GRO socket options
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+/// Most segments the kernel takes in one GSO super-packet
+static const size_t LTPUDP_MAX_GSO_SEGMENTS = 64;
+
+/// Most payload bytes in one GSO super-packet (the largest UDP datagram)
+static const size_t LTPUDP_MAX_GSO_BYTES = 65507;
+
+/// Room reserved per burst slot for a data segment's header
+static const size_t LTPUDP_MAX_HDR_LEN = 256;
+
 class LTPUDPConvergenceLayer::Params LTPUDPConvergenceLayer::defaults_;
 
 //----------------------------------------------------------------------
@@ -64,6 +82,10 @@ LTPUDPConvergenceLayer::Params::serialize(oasys::SerializeAction *a)
     a->process("ccsds_compatible", &ccsds_compatible_);
     a->process("sendbuf", &sendbuf_);
     a->process("recvbuf", &recvbuf_);
+    a->process("burst", &burst_);
+    a->process("gso", &gso_);
+    a->process("gro", &gro_);
+    a->process("recv_shards", &recv_shards_);
     a->process("queued_bytes_quota", &ltp_queued_bytes_quota_);
     a->process("bytes_per_checkpoint", &bytes_per_checkpoint_);
     a->process("use_files_xmit", &use_files_xmit_);
@@ -155,6 +177,10 @@ LTPUDPConvergenceLayer::parse_params(Params* params,
     p.addopt(new oasys::UIntOpt("agg_time", &params->agg_time_));
     p.addopt(new oasys::UIntOpt("recvbuf", &params->recvbuf_));
     p.addopt(new oasys::UIntOpt("sendbuf", &params->sendbuf_));
+    p.addopt(new oasys::UIntOpt("burst", &params->burst_));
+    p.addopt(new oasys::BoolOpt("gso", &params->gso_));
+    p.addopt(new oasys::BoolOpt("gro", &params->gro_));
+    p.addopt(new oasys::UIntOpt("recv_shards", &params->recv_shards_));
     p.addopt(new oasys::BoolOpt("clear_stats", &params->clear_stats_));
     p.addopt(new oasys::BoolOpt("dump_sessions", &params->dump_sessions_));
     p.addopt(new oasys::BoolOpt("dump_segs", &params->dump_segs_));
@@ -213,6 +239,24 @@ LTPUDPConvergenceLayer::parse_params(Params* params,
         params->use_files_recv_ = use_files;
     }
 
+    // recvmmsg() and sendmmsg() take at most UIO_MAXIOV messages
+    if (params->burst_ == 0) {
+        log_err("Warning - burst must be at least 1 - using 1");
+        params->burst_ = 1;
+    } else if (params->burst_ > 1024) {
+        log_err("Warning - burst can be at most 1024 - using 1024");
+        params->burst_ = 1024;
+    }
+
+    if (params->recv_shards_ == 0) {
+        log_err("Warning - recv_shards must be at least 1 - using 1");
+        params->recv_shards_ = 1;
+    } else if (params->recv_shards_ > LTPEngine::MAX_RECV_SHARDS) {
+        log_err("Warning - recv_shards can be at most %zu - using %zu",
+                LTPEngine::MAX_RECV_SHARDS, LTPEngine::MAX_RECV_SHARDS);
+        params->recv_shards_ = LTPEngine::MAX_RECV_SHARDS;
+    }
+
     if (params->remote_engine_id_ == 0) {
         if (tmp_engine_id != 0) {
             params->remote_engine_id_ = tmp_engine_id;
@@ -274,6 +318,8 @@ LTPUDPConvergenceLayer::list_link_opts(oasys::StringBuffer& buf)
     buf.append("    bucket_depth <U64>                 - throttle token bucket depth in bits (default: 524280 = 64K * 8)\n");
     //buf.append("    recvbuf <U32>                      - socket receive buffer size  (default: 0 = operating system managed)\n");
     buf.append("    sendbuf <U32>                      - socket send buffer size  (default: 0 = operating system managed)\n");
+    buf.append("    burst <U32>                        - maximum segments sent with one system call (default: 64; 1 = one at a time)\n");
+    buf.append("    gso <Bool>                         - whether to send runs of equal sized segments using UDP GSO if the kernel supports it (default: true)\n");
 
 
     buf.append("  LTP params:\n");
@@ -364,6 +410,12 @@ LTPUDPConvergenceLayer::list_interface_opts(oasys::StringBuffer& buf)
     buf.appendf("    local_addr <IP address>            - IP address of interface on which to listen (default: 0.0.0.0 = all interfaces)\n");
     buf.appendf("    local_port <U16>                   - Port on which to listen (default: 1113)\n");
     buf.appendf("    recvbuf <U32>                      - socket receive buffer size  (default: 0 = operating system managed)\n");
+    buf.appendf("    burst <U32>                        - maximum packets received with one system call (default: 64; each takes a 64 KB buffer)\n");
+    buf.appendf("    gro <Bool>                         - whether to receive using UDP GRO if the kernel supports it (default: true)\n");
+    buf.appendf("    recv_shards <U32>                  - number of SO_REUSEPORT sockets and threads to receive with, with each LTP session\n");
+    buf.appendf("                                            processed on one of as many shards (default: 1; max: %zu)\n",
+                LTPEngine::MAX_RECV_SHARDS);
+    buf.appendf("                                            (the kernel spreads peers across the sockets; applies to links opened afterwards)\n");
 
     buf.appendf("\n");
     buf.appendf("Example:\n");
@@ -405,23 +457,36 @@ LTPUDPConvergenceLayer::interface_up(Interface* iface,
         return false;
     }
 
-    // create a new server socket for the requested interface
+    // create a new server socket for the requested interface plus one
+    // more bound to the same port for each additional receive shard
 
-    Receiver* receiver = new Receiver(params, this);
+    Receiver* receiver = nullptr;
 
-    receiver->logpathf("%s/iface/receiver/%s", logpath_, iface->name().c_str());
-    
-    if (receiver->bind(params->local_addr_, params->local_port_) != 0) {
-        delete params;
-        return false; // error log already emitted
-    }
-    
-    // check if the user specified a remote addr/port to connect to
-    if (params->remote_addr_ != INADDR_NONE) {
-        if (receiver->connect(params->remote_addr_, params->remote_port_) != 0) {
+    for (uint32_t shard = 0; shard < params->recv_shards_; ++shard) {
+        Receiver* shard_receiver = new Receiver(params, this);
+
+        if (shard == 0) {
+            receiver = shard_receiver;
+            receiver->logpathf("%s/iface/receiver/%s", logpath_, iface->name().c_str());
+        } else {
+            receiver->shards_.push_back(std::unique_ptr<Receiver>(shard_receiver));
+            shard_receiver->logpathf("%s/iface/receiver/%s/%u", logpath_, iface->name().c_str(), shard);
+        }
+
+        if (shard_receiver->bind(params->local_addr_, params->local_port_) != 0) {
+            delete receiver;
             delete params;
             return false; // error log already emitted
         }
+
+        // check if the user specified a remote addr/port to connect to
+        if (params->remote_addr_ != INADDR_NONE) {
+            if (shard_receiver->connect(params->remote_addr_, params->remote_port_) != 0) {
+                delete receiver;
+                delete params;
+                return false; // error log already emitted
+            }
+        }
     }
    
     // store the new listener object in the cl specific portion of the
@@ -441,7 +506,7 @@ LTPUDPConvergenceLayer::interface_activate(Interface* iface)
 
     // start listening and then start the thread to loop calling accept()
     Receiver* receiver = (Receiver*)iface->cl_info();
-    receiver->start();
+    receiver->start_shards();
 }
 
 //----------------------------------------------------------------------
@@ -453,11 +518,7 @@ LTPUDPConvergenceLayer::interface_down(Interface* iface)
     // thread to break out of the blocking call to accept() and
     // terminate itself
     Receiver* receiver = (Receiver*)iface->cl_info();
-    receiver->set_should_stop();
-    receiver->interrupt_from_io();
-    while (! receiver->is_stopped()) {
-        oasys::Thread::yield();
-    }
+    receiver->stop_shards();
 
     delete receiver;
 
@@ -475,7 +536,10 @@ LTPUDPConvergenceLayer::dump_interface(Interface* iface,
                  intoa(params->local_addr_), params->local_port_);
     buf->appendf("\tinact_intvl: %d", params->inactivity_intvl_);
     buf->appendf("\tretran_intvl: %d", params->retran_intvl_);
-    buf->appendf("\tretran_retries: %d\n", params->retran_retries_);
+    buf->appendf("\tretran_retries: %d", params->retran_retries_);
+    buf->appendf("\tburst: %u", params->burst_);
+    buf->appendf("\tgro: %s", params->gro_ ? "true" : "false");
+    buf->appendf("\trecv_shards: %u\n", params->recv_shards_);
 
     if (params->remote_addr_ != INADDR_NONE) {
         buf->appendf("\tconnected remote_addr: %s remote_port: %d - socket recvbuf size: %u\n",
@@ -697,6 +761,7 @@ LTPUDPConvergenceLayer::dump_link(const LinkRef& link, oasys::StringBuffer* buf)
     buf->appendf("agg_size: %zu (%s) bytes\n", params->agg_size_, FORMAT_WITH_MAG(params->agg_size_).c_str());
     buf->appendf("agg_time: %u milliseconds\n", params->agg_time_);
     buf->appendf("seg_size: %u bytes\n", params->seg_size_);
+    buf->appendf("burst: %u segments\n", params->burst_);
     buf->appendf("ccsds_compatible: %s\n", params->ccsds_compatible_?"true":"false");
     buf->appendf("max_sessions: %u\n", params->max_sessions_);
     buf->appendf("hexdump: %s\n", params->hexdump_?"true":"false");
@@ -906,6 +971,8 @@ LTPUDPConvergenceLayer::Receiver::Receiver(LTPUDPConvergenceLayer::Params* param
     // bump up the receive buffer size
     params_.recv_bufsize_ = cla_params_.recvbuf_;
 
+    // each receive shard binds its own socket to the interface's port
+    params_.reuseport_ = (cla_params_.recv_shards_ > 1);
 }
 
 //----------------------------------------------------------------------
@@ -913,6 +980,32 @@ LTPUDPConvergenceLayer::Receiver::~Receiver()
 {
 }
 
+//----------------------------------------------------------------------
+void
+LTPUDPConvergenceLayer::Receiver::start_shards()
+{
+    start();
+
+    for (std::unique_ptr<Receiver>& shard : shards_) {
+        shard->start();
+    }
+}
+
+//----------------------------------------------------------------------
+void
+LTPUDPConvergenceLayer::Receiver::stop_shards()
+{
+    for (std::unique_ptr<Receiver>& shard : shards_) {
+        shard->stop_shards();
+    }
+
+    set_should_stop();
+    interrupt_from_io();
+    while (! is_stopped()) {
+        oasys::Thread::yield();
+    }
+}
+
 //----------------------------------------------------------------------
 void
 LTPUDPConvergenceLayer::Receiver::run()
@@ -922,6 +1015,10 @@ LTPUDPConvergenceLayer::Receiver::run()
    
     SPtr_LTPEngine ltp_engine = BundleDaemon::instance()->ltp_engine();
 
+    // one engine receive thread per shard with segments from all of
+    // the sockets dispatched to them by session
+    ltp_engine->set_recv_shards(cla_params_.recv_shards_);
+
     int result;
     socklen_t len = sizeof(result);
     if (::getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &result, &len) != 0) {
@@ -933,26 +1030,88 @@ LTPUDPConvergenceLayer::Receiver::run()
 
 
 
+    // with GRO the kernel hands up runs of same sized segments from
+    // the peer as one buffer along with the segment size
+    bool gro = false;
+    if (cla_params_.gro_) {
+        int one = 1;
+        gro = (::setsockopt(fd_, SOL_UDP, UDP_GRO, &one, sizeof(one)) == 0);
+        if (gro) {
+            log_always("LTPUDP Receiver using UDP GRO");
+        } else {
+            log_always("LTPUDP Receiver - UDP GRO not available: %s", strerror(errno));
+        }
+    }
+
     int ret;
-    in_addr_t addr;
-    u_int16_t port;
-    u_char buf[MAX_UDP_PACKET];
+    u_int burst = cla_params_.burst_;
+    size_t cmsg_space = CMSG_SPACE(sizeof(int));
+
+    std::unique_ptr<u_char[]> bufs(new u_char[burst * MAX_UDP_PACKET]);
+    std::vector<struct iovec> iovs(burst);
+    std::vector<struct mmsghdr> msgs(burst);
+    std::vector<char> cmsgs(burst * cmsg_space);
+
+    for (u_int i = 0; i < burst; ++i) {
+        iovs[i].iov_base = bufs.get() + (i * MAX_UDP_PACKET);
+        iovs[i].iov_len  = MAX_UDP_PACKET;
+
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov    = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
     while (!should_stop()) {
         
-        ret = recvfrom((char*)buf, MAX_UDP_PACKET, 0, &addr, &port); 
+        // the kernel shrinks msg_controllen to what it filled in
+        if (gro) {
+            for (u_int i = 0; i < burst; ++i) {
+                msgs[i].msg_hdr.msg_control    = &cmsgs[i * cmsg_space];
+                msgs[i].msg_hdr.msg_controllen = cmsg_space;
+            }
+        }
+
+        // block for the first datagram and then take whatever else
+        // is already queued on the socket
+        ret = recvmmsg(msgs.data(), burst, MSG_WAITFORONE);
         if (ret <= 0) {    
             if (errno == EINTR) {
                 continue;
             }
-            log_err("error in recvfrom(): %d %s", 
+            log_err("error in recvmmsg(): %d %s", 
                     errno, strerror(errno));
             close();
             break;
         }
         
-        if (!should_stop() ) {
-            ltp_engine->post_data (buf, ret);
+        if (should_stop()) {
+            break;
+        }
+
+        for (int i = 0; i < ret; ++i) {
+            u_char* bp     = (u_char*)iovs[i].iov_base;
+            size_t  len    = msgs[i].msg_len;
+            size_t  seglen = len;
+
+            if (gro) {
+                struct msghdr* hdr = &msgs[i].msg_hdr;
+                for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+                     cmsg = CMSG_NXTHDR(hdr, cmsg))
+                {
+                    if ((cmsg->cmsg_level == SOL_UDP) && (cmsg->cmsg_type == UDP_GRO)) {
+                        int gso_size;
+                        memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                        if (gso_size > 0) {
+                            seglen = gso_size;
+                        }
+                    }
+                }
+            }
+
+            // every segment but the last of a coalesced run is seglen
+            for (size_t offset = 0; offset < len; offset += seglen) {
+                ltp_engine->post_data(bp + offset, std::min(seglen, len - offset));
+            }
         }
     }
 }
@@ -1309,6 +1468,27 @@ LTPUDPConvergenceLayer::LTPUDPSender::init(Params* params, in_addr_t addr, u_int
         log_always("LTPUDPConvergenceLayer::LTPUDPSender socket send_buffer size = %d", bufsize);
     }
 
+    // GSO is requested per message but make sure the kernel knows
+    // the option before counting on it
+    gso_ = false;
+    if (params->gso_) {
+        int zero = 0;
+        gso_ = (::setsockopt(socket_.fd(), SOL_UDP, UDP_SEGMENT, &zero, sizeof(zero)) == 0);
+        if (gso_) {
+            log_always("LTPUDPConvergenceLayer::LTPUDPSender using UDP GSO");
+        } else {
+            log_always("LTPUDPConvergenceLayer::LTPUDPSender - UDP GSO not available: %s",
+                       strerror(errno));
+        }
+    }
+
+    burst_.reserve(params->burst_);
+    burst_iovs_.resize(2 * params->burst_);
+    burst_msgs_.resize(params->burst_);
+    burst_msg_segs_.resize(params->burst_);
+    burst_cmsgs_.resize(params->burst_ * CMSG_SPACE(sizeof(uint16_t)));
+    burst_hdrs_.resize(params->burst_ * LTPUDP_MAX_HDR_LEN);
+
     // do not bind or connect the socket
     if (params->rate_ != 0) {
 
@@ -1346,14 +1526,10 @@ LTPUDPConvergenceLayer::LTPUDPSender::run()
     poller_ = std::unique_ptr<SendPoller>(new SendPoller(this, contact_->link()));
     poller_->start();
 
-    std::unique_lock<std::mutex> qlok(eventq_size_lock_, std::defer_lock);
-
     const char* event_priority = nullptr;
-    bool okay_to_send = true;
 
     bool event_was_queued = true;
     size_t num_timeouts = 0;
-    ssize_t cc = 0;
 
     while (!should_stop()) {
 
@@ -1376,148 +1552,333 @@ LTPUDPConvergenceLayer::LTPUDPSender::run()
         got_event = false;
 
         if (event_was_queued) {
-            if (qptr_admin_eventq_->try_pop(&event)) {
-                event_priority = "high priority admin";
-                got_event = true;
-            } else if (qptr_ds_high_eventq_->try_pop(&event)) {
-                event_priority = "higher priority DS resend";
-                got_event = true;
-            } else if (qptr_ds_low_eventq_->try_pop(&event)) {
-                event_priority = "low priority DS send";
+            // take whatever is queued, up to a burst, to send together
+            while ((burst_.size() < burst_msgs_.size()) &&
+                   pop_event(&event, &event_priority))
+            {
                 got_event = true;
+                prepare_segment(event, event_priority);
             }
         }
 
-        if (got_event) {
+        if (!burst_.empty()) {
+            send_burst();
+        }
+    }
+}
 
-            ASSERT(event != NULL)
+//----------------------------------------------------------------------
+bool
+LTPUDPConvergenceLayer::LTPUDPSender::pop_event(MySendObject** event, const char** event_priority)
+{
+    if (qptr_admin_eventq_->try_pop(event)) {
+        *event_priority = "high priority admin";
+    } else if (qptr_ds_high_eventq_->try_pop(event)) {
+        *event_priority = "higher priority DS resend";
+    } else if (qptr_ds_low_eventq_->try_pop(event)) {
+        *event_priority = "low priority DS send";
+    } else {
+        return false;
+    }
 
-            okay_to_send = true;
+    ASSERT(*event != NULL)
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+LTPUDPConvergenceLayer::LTPUDPSender::prepare_segment(MySendObject* event, const char* event_priority)
+{
+    bool okay_to_send = true;
+
+    std::string* xmit_str = nullptr;
 
-            std::string* xmit_str = nullptr;
+    BurstSeg bseg;
+    bseg.event_    = event;
+    bseg.xmit_str_ = nullptr;
+    bseg.priority_ = event_priority;
+    bseg.iov_[1].iov_base = nullptr;
+    bseg.iov_[1].iov_len  = 0;
 
-            ssize_t xmit_len;
-            const char* str_data;
-            if (event->str_data_) {
-                str_data = event->str_data_->data();
-                xmit_len = event->str_data_->size();
+    bool in_place = false;
 
-                if (event->timer_) {
-                    event->timer_->start();
+    if (event->str_data_) {
+        if (event->timer_) {
+            event->timer_->start();
+        }
+    } else {
+        // prevent LTPEngine from modifying this segment 
+        // while it is being processed for transmission
+        // (LTP Engine can change it to a checkpoint while it is queued,
+        //  but, now it is too late and it will have to resend it)
+
+        bool do_start_timer = false;
+
+        do {
+            oasys::ScopeLock scoplok(event->sptr_ds_seg_->lock(), __func__);
+
+            // The LTP session may have been cancelled or completed
+            // while this segment was queued for transmission
+            if (event->sptr_ds_seg_->IsDeleted()) {
+                if (event->sptr_ds_seg_->Retransmission_Timer_Raw_Ptr() != nullptr) {
+                    // XXX/dz This should not happen [any longer ;)]
+                    //        but if the timer is not cancelled then the segment and the timer leak
+                    log_err("not sending deleted segment %s-%zu Chkpt: %zu  that has a Retransmission Timer",
+                               event->sptr_ds_seg_->session_key_str().c_str(), 
+                               event->sptr_ds_seg_->Offset(),
+                               event->sptr_ds_seg_->Checkpoint_ID());
+
+                    event->sptr_ds_seg_->Set_Deleted();  // cancels the timer
                 }
+
+                okay_to_send = false;
             } else {
-                // prevent LTPEngine from modifying this segment 
-                // while it is being processed for transmission
-                // (LTP Engine can change it to a checkpoint while it is queued,
-                //  but, now it is too late and it will have to resend it)
-
-                bool do_start_timer = false;
-
-                do {
-                    oasys::ScopeLock scoplok(event->sptr_ds_seg_->lock(), __func__);
-
-                    // The LTP session may have been cancelled or completed
-                    // while this segment was queued for transmission
-                    if (event->sptr_ds_seg_->IsDeleted()) {
-                        if (event->sptr_ds_seg_->Retransmission_Timer_Raw_Ptr() != nullptr) {
-                            // XXX/dz This should not happen [any longer ;)]
-                            //        but if the timer is not cancelled then the segment and the timer leak
-                            log_err("not sending deleted segment %s-%zu Chkpt: %zu  that has a Retransmission Timer",
-                                       event->sptr_ds_seg_->session_key_str().c_str(), 
-                                       event->sptr_ds_seg_->Offset(),
-                                       event->sptr_ds_seg_->Checkpoint_ID());
-
-                            event->sptr_ds_seg_->Set_Deleted();  // cancels the timer
-                        }
-    
-                        okay_to_send = false;
-                    } else {
-                        // xmit_str maintains the new string in scope until it is transmitted
-                        // NOTE: the xmit_len may differ from event->bytes_queued if the
-                        //       LTPEngine changed it to a checkpoint while it was queued
-                        xmit_str = event->sptr_ds_seg_->asNewString();
-                        if (xmit_str == nullptr) {
-                            // Error reading from an LTP Session Data file
-                            okay_to_send = false;
-                            SPtr_LTPEngine ltp_engine = BundleDaemon::instance()->ltp_engine();
-
-                            ltp_engine->force_cancel_by_sender(event->sptr_ds_seg_.get());
-                        } else {
-                            str_data = xmit_str->data();
-                            xmit_len = xmit_str->size();
-
-                            do_start_timer = true;
-
-                            event->sptr_ds_seg_->Set_Queued_To_Send(false);
-                        }
-                    }
-                } while (false); // just limiting the scope of the lock
+                // send the payload from where it is held (event->sptr_ds_seg_ keeps
+                // it in scope until it is transmitted) and only fall back to
+                // copying it into xmit_str if that is not possible
+                // NOTE: the xmit_len may differ from event->bytes_queued if the
+                //       LTPEngine changed it to a checkpoint while it was queued
+                u_char* hdr_buf = &burst_hdrs_[burst_.size() * LTPUDP_MAX_HDR_LEN];
+                in_place = event->sptr_ds_seg_->asIOVecs(hdr_buf, LTPUDP_MAX_HDR_LEN, bseg.iov_);
+                if (!in_place) {
+                    xmit_str = event->sptr_ds_seg_->asNewString();
+                }
 
-                // don't try to start the timer until releasing the lock on the data segment
-                // to prevent deadly embrace while shutting down
-                if ( do_start_timer)
-                {
-                    if (event->timer_) {
-                        event->timer_->start();
-                    } else {
-                        // in case the segment was changed to a Checkpoint while it was queued
-                        event->sptr_ds_seg_->Start_Retransmission_Timer();
-                    }
+                if (!in_place && (xmit_str == nullptr)) {
+                    // Error reading from an LTP Session Data file
+                    okay_to_send = false;
+                    SPtr_LTPEngine ltp_engine = BundleDaemon::instance()->ltp_engine();
+
+                    ltp_engine->force_cancel_by_sender(event->sptr_ds_seg_.get());
+                } else {
+                    do_start_timer = true;
+
+                    event->sptr_ds_seg_->Set_Queued_To_Send(false);
                 }
             }
+        } while (false); // just limiting the scope of the lock
+
+        // don't try to start the timer until releasing the lock on the data segment
+        // to prevent deadly embrace while shutting down
+        if ( do_start_timer)
+        {
+            if (event->timer_) {
+                event->timer_->start();
+            } else {
+                // in case the segment was changed to a Checkpoint while it was queued
+                event->sptr_ds_seg_->Start_Retransmission_Timer();
+            }
+        }
+    }
+
+
+    if (okay_to_send && (params_->xmit_test_ > 0)) {
+        // drop every nth packet
+        okay_to_send = (packets_transmitted_ % (uint32_t) params_->xmit_test_) != 
+                               (uint32_t) (params_->xmit_test_ - 1);
+
+        if (!okay_to_send) {
+            ++packets_dropped_for_xmit_test_;
+        }
+    }
+    ++packets_transmitted_;
+
+    if (okay_to_send) {
+        if (!in_place) {
+            // admin segment or a copy of the data segment
+            const std::string* str = event->str_data_ ? event->str_data_ : xmit_str;
+            bseg.iov_[0].iov_base = const_cast<char*>(str->data());
+            bseg.iov_[0].iov_len  = str->size();
+        }
 
+        bseg.xmit_str_ = xmit_str;
+        bseg.len_      = bseg.iov_[0].iov_len + bseg.iov_[1].iov_len;
+        burst_.push_back(bseg);
+    } else {
+        finish_event(event, xmit_str);
+    }
+}
 
-            if (okay_to_send && (params_->xmit_test_ > 0)) {
-                // drop every nth packet
-                okay_to_send = (packets_transmitted_ % (uint32_t) params_->xmit_test_) != 
-                                       (uint32_t) (params_->xmit_test_ - 1);
+//----------------------------------------------------------------------
+size_t
+LTPUDPConvergenceLayer::LTPUDPSender::build_burst_msgs(size_t first)
+{
+    // keep each message within what the token bucket can meter out
+    size_t max_msg_bytes = LTPUDP_MAX_GSO_BYTES;
+    if (use_rate_socket_) {
+        max_msg_bytes = std::min(max_msg_bytes, (size_t)(rate_socket_->bucket()->depth() / 8));
+    }
 
-                if (!okay_to_send) {
-                    ++packets_dropped_for_xmit_test_;
+    size_t cmsg_space = CMSG_SPACE(sizeof(uint16_t));
+    size_t num_msgs = 0;
+    size_t num_iovs = 0;
+    size_t seg = first;
+
+    while (seg < burst_.size()) {
+        struct mmsghdr* mmsg = &burst_msgs_[num_msgs];
+        struct msghdr*  msg  = &mmsg->msg_hdr;
+
+        memset(mmsg, 0, sizeof(*mmsg));
+        msg->msg_iov = &burst_iovs_[num_iovs];
+
+        // a GSO run is any number of segments of the first one's
+        // length, optionally ending with one shorter segment
+        size_t seglen = 0;
+        size_t total  = 0;
+        size_t count  = 0;
+        while (seg < burst_.size()) {
+            const BurstSeg& bseg = burst_[seg];
+            size_t len = bseg.len_;
+
+            if (count > 0) {
+                if (!gso_ || (count >= LTPUDP_MAX_GSO_SEGMENTS) ||
+                    (len > seglen) || (total + len > max_msg_bytes))
+                {
+                    break;
                 }
+            } else {
+                seglen = len;
             }
-            ++packets_transmitted_;
-
-            if (okay_to_send) {
-                if (use_rate_socket_) {
-                    cc = rate_socket_->sendto((char*)str_data, xmit_len, 0,
-                                              params_->remote_addr_, 
-                                              params_->remote_port_, 
-                                              true);  // block until data can be sent
-                } else {
-                    cc = socket_.sendto((char*)str_data, xmit_len, 0,
-                                        params_->remote_addr_, 
-                                        params_->remote_port_);
-                }
 
-                if (cc == xmit_len) {
-                    //log_debug("Send: transmitted %s %zd byte segment to %s:%d",
-                    //          event_priority, cc, intoa(params_->remote_addr_), params_->remote_port_);
-                } else {
-                    log_err("Send: error sending %s segment to %s:%d (wrote %zd/%zd): %s",
-                            event_priority, intoa(params_->remote_addr_), params_->remote_port_,
-                            cc, xmit_len, strerror(errno));
-                }
+            // the kernel gathers a segment's header and payload
+            // before cutting the message into gso_size pieces
+            burst_iovs_[num_iovs++] = bseg.iov_[0];
+            if (bseg.iov_[1].iov_len > 0) {
+                burst_iovs_[num_iovs++] = bseg.iov_[1];
+            }
+            total += len;
+            ++count;
+            ++seg;
+
+            if (len < seglen) {
+                break;
             }
+        }
+
+        msg->msg_iovlen = &burst_iovs_[num_iovs] - msg->msg_iov;
+
+        sockaddr_in* sa = &burst_addrs_;
+        msg->msg_name    = sa;
+        msg->msg_namelen = sizeof(*sa);
+
+        if (count > 1) {
+            char* control = &burst_cmsgs_[num_msgs * cmsg_space];
+            memset(control, 0, cmsg_space);
+            msg->msg_control    = control;
+            msg->msg_controllen = cmsg_space;
 
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type  = UDP_SEGMENT;
+            cmsg->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+            uint16_t gso_size = seglen;
+            memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+        }
+
+        burst_msg_segs_[num_msgs] = count;
+        ++num_msgs;
+    }
+
+    return num_msgs;
+}
+
+//----------------------------------------------------------------------
+void
+LTPUDPConvergenceLayer::LTPUDPSender::send_burst()
+{
+    burst_addrs_.sin_family      = AF_INET;
+    burst_addrs_.sin_addr.s_addr = params_->remote_addr_;
+    burst_addrs_.sin_port        = htons(params_->remote_port_);
+
+    size_t next = 0;    // first segment not yet sent
+    while (next < burst_.size()) {
+        size_t num_msgs = build_burst_msgs(next);
+        size_t m = 0;
+
+        while (m < num_msgs) {
+            int cc;
+            if (use_rate_socket_) {
+                // meter as much of the burst at a time as the bucket holds
+                uint64_t max_bytes = rate_socket_->bucket()->depth() / 8;
+                uint64_t bytes = 0;
+                size_t   group = 0;
+                while (m + group < num_msgs) {
+                    uint64_t len = oasys::IO::iovec_size(burst_msgs_[m + group].msg_hdr.msg_iov,
+                                                         burst_msgs_[m + group].msg_hdr.msg_iovlen);
+                    if ((group > 0) && (bytes + len > max_bytes)) {
+                        break;
+                    }
+                    bytes += len;
+                    ++group;
+                }
 
-            qlok.lock();
-            ASSERT(eventq_bytes_ >= event->bytes_queued_);
-            eventq_bytes_ -= event->bytes_queued_;
-            qlok.unlock();
+                cc = rate_socket_->sendmmsg(&burst_msgs_[m], group, 0,
+                                            true);  // block until data can be sent
+            } else {
+                cc = socket_.sendmmsg(&burst_msgs_[m], num_msgs - m, 0);
+            }
+            ++send_calls_;
 
+            if (cc > 0) {
+                for (int i = 0; i < cc; ++i) {
+                    next += burst_msg_segs_[m + i];
+                }
+                m += cc;
+                continue;
+            }
 
-            // clean up
-            if (event->str_data_) {
-                delete event->str_data_;
-            } else if (xmit_str != nullptr) {
-                delete xmit_str;
+            // not every path supports GSO (no checksum offload or the
+            // segments are larger than the MTU) so fall back to
+            // sending them one by one for good
+            if (gso_ && (burst_msg_segs_[m] > 1) &&
+                ((errno == EIO) || (errno == EINVAL) || (errno == EOPNOTSUPP)))
+            {
+                log_err("Send: UDP GSO failed sending to %s:%d (%s) - no longer using it",
+                        intoa(params_->remote_addr_), params_->remote_port_, strerror(errno));
+                gso_ = false;
+                break;
             }
 
-            event->sptr_ds_seg_.reset();
-            delete event;
+            const BurstSeg& bseg = burst_[next];
+            size_t xmit_len = oasys::IO::iovec_size(burst_msgs_[m].msg_hdr.msg_iov,
+                                                    burst_msgs_[m].msg_hdr.msg_iovlen);
+            log_err("Send: error sending %s segment%s to %s:%d (wrote %d/%zu): %s",
+                    bseg.priority_, (burst_msg_segs_[m] > 1) ? "s" : "",
+                    intoa(params_->remote_addr_), params_->remote_port_,
+                    cc, xmit_len, strerror(errno));
+
+            // drop it and let LTP recover as for any lost segment
+            next += burst_msg_segs_[m];
+            ++m;
         }
     }
+
+    for (BurstSeg& bseg : burst_) {
+        finish_event(bseg.event_, bseg.xmit_str_);
+    }
+    burst_.clear();
+}
+
+//----------------------------------------------------------------------
+void
+LTPUDPConvergenceLayer::LTPUDPSender::finish_event(MySendObject* event, std::string* xmit_str)
+{
+    do {
+        std::lock_guard<std::mutex> qlok(eventq_size_lock_);
+        ASSERT(eventq_bytes_ >= event->bytes_queued_);
+        eventq_bytes_ -= event->bytes_queued_;
+    } while (false);
+
+
+    // clean up
+    if (event->str_data_) {
+        delete event->str_data_;
+    } else if (xmit_str != nullptr) {
+        delete xmit_str;
+    }
+
+    event->sptr_ds_seg_.reset();
+    delete event;
 }
  
 //----------------------------------------------------------------------
@@ -1677,7 +2038,9 @@ LTPUDPConvergenceLayer::LTPUDPSender::dump_stats(oasys::StringBuffer* buf)
                  qptr_admin_eventq_->size(), qptr_ds_high_eventq_->size(), qptr_ds_low_eventq_->size(), 
                  eventq_bytes_, FORMAT_WITH_MAG(eventq_bytes_).c_str(),
                  eventq_bytes_max_, FORMAT_WITH_MAG(eventq_bytes_max_).c_str());
-    
+
+    buf->appendf("Segments transmitted: %zu in %zu send calls  (UDP GSO %s)\n\n",
+                 packets_transmitted_, send_calls_, gso_ ? "active" : "not active");
 }
 
 
@@ -159,6 +159,10 @@ public:
         bool        ccsds_compatible_         = false;          ///< CCSDS compatibility (uses Client Service ID = 2 to signal Data Aggregation)
         uint32_t    recvbuf_                  = 0;              ///< set size for receive buffer
         uint32_t    sendbuf_                  = 0;              ///< set size for send buffer
+        uint32_t    burst_                    = 64;             ///< max segments sent or received with one system call
+        bool        gso_                      = true;           ///< whether to send runs of equal sized segments with UDP GSO
+        bool        gro_                      = true;           ///< whether to receive with UDP GRO
+        uint32_t    recv_shards_              = 1;              ///< number of SO_REUSEPORT sockets and threads to receive with
         bool        clear_stats_              = false;          ///< Transient signal to clear the statistics
         bool        dump_sessions_            = true;           ///< Whether link dump report should detail the sessions
         bool        dump_segs_                = false;          ///< Whether link dump report should detail the red segments of sessions
@@ -222,9 +226,10 @@ public:
         virtual ~Receiver();
 
         /**
-         * Loop forever, issuing blocking calls to IPSocket::recvfrom(),
-         * then calling the process_data function when new data does
-         * arrive
+         * Loop forever, issuing blocking calls to IPSocket::recvmmsg()
+         * for up to burst_ datagrams at a time (each of which may hold
+         * several segments coalesced by UDP GRO), then passing each
+         * segment to the LTP engine
          *
          * Note that unlike in the Thread base class, this run() method is
          * public in case we don't want to actually create a new thread
@@ -232,8 +237,19 @@ public:
          */
         void run() override;
 
+        /**
+         * Start, or stop and wait for, this receiver and the others
+         * sharing its port
+         */
+        void start_shards();
+        void stop_shards();
+
         LTPUDPConvergenceLayer::Params cla_params_;
 
+        /// The other receivers bound to the same port with SO_REUSEPORT
+        /// when the interface receives with more than one shard
+        std::vector<std::unique_ptr<Receiver>> shards_;
+
     protected:
 
         /**
@@ -356,6 +372,44 @@ protected:
 
 
         virtual bool check_ready_for_bundle();
+
+        /**
+         * Pop the next segment to send, taking the queues in priority
+         * order.
+         */
+        bool pop_event(MySendObject** event, const char** event_priority);
+
+        /**
+         * Get the popped segment ready to send and add it to the
+         * burst, or finish with it if it is not to be sent after all.
+         */
+        void prepare_segment(MySendObject* event, const char* event_priority);
+
+        /**
+         * Send the segments of the burst with as few system calls as
+         * possible and finish with them.
+         */
+        void send_burst();
+
+        /**
+         * Fill in burst_msgs_ for the segments of the burst starting
+         * with the first'th, one message per segment or, with GSO,
+         * per run of equal sized segments.
+         * @return the number of messages
+         */
+        size_t build_burst_msgs(size_t first);
+
+        /// Release a segment once it is sent (or dropped)
+        void finish_event(MySendObject* event, std::string* xmit_str);
+
+        /// A segment of the burst being sent
+        struct BurstSeg {
+            MySendObject* event_;
+            std::string*  xmit_str_;    ///< copied data segment if it could not be referenced in place
+            const char*   priority_;
+            struct iovec  iov_[2];      ///< header and payload to send
+            size_t        len_;
+        };
  
         // Poll the Link queue for bundles
         class SendPoller: public Logger,
@@ -388,6 +442,19 @@ protected:
  
         size_t packets_dropped_for_xmit_test_ = 0;
         size_t packets_transmitted_ = 0;
+        size_t send_calls_ = 0;
+
+        /// Segments taken off the queues to send together
+        std::vector<BurstSeg>        burst_;
+        std::vector<struct iovec>    burst_iovs_;
+        std::vector<struct mmsghdr>  burst_msgs_;
+        std::vector<size_t>          burst_msg_segs_;   ///< segments carried by each message
+        std::vector<char>            burst_cmsgs_;      ///< UDP_SEGMENT control message of each message
+        std::vector<u_char>          burst_hdrs_;       ///< fixed size slot per segment for its header
+        struct sockaddr_in           burst_addrs_;      ///< destination of every message
+
+        /// Whether runs of equal sized segments go out as UDP GSO super-packets
+        bool gso_ = false;
 
         LinkRef     link_ref_;
         Params*     params_ = nullptr;
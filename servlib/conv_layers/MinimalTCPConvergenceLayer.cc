@@ -412,7 +412,7 @@ MinimalTCPConvergenceLayer::Listener::accepted(int fd, in_addr_t addr, uint16_t
 
     Connection* conn =
         new Connection(cl_, params_, fd, addr, port);
-    conn->start();
+    conn->start_connection();
 }
 
 //----------------------------------------------------------------------
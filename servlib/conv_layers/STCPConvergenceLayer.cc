@@ -431,7 +431,7 @@ STCPConvergenceLayer::Listener::accepted(int fd, in_addr_t addr, u_int16_t port)
     *params = *params_;
 
     Connection* conn = new Connection(cl_, params, fd, addr, port);
-    conn->start();
+    conn->start_connection();
 }
 
 //----------------------------------------------------------------------
@@ -437,7 +437,7 @@ StreamConvergenceLayer::Connection::handle_contact_initiation()
     // If external router - delay 5 seconds befoe reading bundles to give time for contact up to be processed?
     int secs_to_delay = bdaemon_->router()->delay_after_contact_up();
     if (0 != secs_to_delay) {
-        sleep(secs_to_delay);
+        delay_turns(secs_to_delay * 1000);
     }
 }
 
@@ -622,6 +622,13 @@ StreamConvergenceLayer::Connection::queue_acks_for_incoming_bundle(IncomingBundl
     }
 }
 
+//----------------------------------------------------------------------
+bool
+StreamConvergenceLayer::Connection::inflight_window_open()
+{
+    return inflight_.size() < stream_lparams()->max_inflight_bundles_;
+}
+
 //----------------------------------------------------------------------
 bool
 StreamConvergenceLayer::Connection::start_next_bundle()
@@ -634,9 +641,7 @@ StreamConvergenceLayer::Connection::start_next_bundle()
         return false;
     }
     
-    StreamLinkParams* params = stream_lparams();
-
-    if (inflight_.size() >= params->max_inflight_bundles_) {
+    if (!inflight_window_open()) {
         return false;
     }
 
@@ -649,6 +654,10 @@ StreamConvergenceLayer::Connection::start_next_bundle()
 
     BundleRef bundle("StreamCL::Connection::start_next_bundle");
 
+    // sessions striped across the link take turns at its queue so
+    // each bundle goes out on exactly one of them
+    oasys::ScopeLock dispatch_lock(link_queue_lock_, "StreamCL::Connection::start_next_bundle");
+
     // try to pop the next bundle off the link queue and put it in
     // flight, making sure to hold the link queue lock until it's
     // safely on the link's inflight queue
@@ -685,12 +694,17 @@ StreamConvergenceLayer::Connection::start_next_bundle()
         return false;
     }
     inflight->total_length_ = BundleProtocol::total_length(bundle.object(), inflight->blocks_.get());
-    inflight_.push_back(inflight);
+    do {
+        oasys::ScopeLock l(&session_lock_, "StreamCL::Connection::start_next_bundle");
+        inflight_.push_back(inflight);
+    } while (false);
     current_inflight_ = inflight;
 
     link->add_to_inflight(bundle);
     link->del_from_queue(bundle);
 
+    dispatch_lock.unlock();
+
     // now send the first segment for the bundle
     return send_next_segment(current_inflight_);
 }
@@ -894,10 +908,18 @@ StreamConvergenceLayer::Connection::check_completed(InFlightBundle* inflight)
         }
     }
 
+    if (!inflight->bundle_refused_) {
+        ++bundles_sent_;
+        bytes_sent_ += inflight->total_length_;
+    }
+
     //log_debug("check_completed: bundle %" PRIbid " transmission complete",
     //          inflight->bundle_->bundleid());
     ASSERT(inflight == inflight_.front());
-    inflight_.pop_front();
+    do {
+        oasys::ScopeLock l(&session_lock_, "StreamCL::Connection::check_completed");
+        inflight_.pop_front();
+    } while (false);
 
     delete inflight;
 }
@@ -965,7 +987,10 @@ StreamConvergenceLayer::Connection::handle_cancel_bundle(Bundle* bundle)
                 //log_debug("handle_cancel_bundle: "
                 //          "bundle %" PRIbid " not yet in flight, cancelling send",
                 //          bundle->bundleid());
-                inflight_.erase(iter);
+                do {
+                    oasys::ScopeLock l(&session_lock_, "StreamCL::Connection::handle_cancel_bundle");
+                    inflight_.erase(iter);
+                } while (false);
                 delete inflight;
 
                 BundleSendCancelledEvent* event_to_post;
@@ -982,8 +1007,11 @@ StreamConvergenceLayer::Connection::handle_cancel_bundle(Bundle* bundle)
         }
     }
 
-    log_warn("handle_cancel_bundle: "
-             "can't find bundle %" PRIbid " in the in flight list", bundle->bundleid());
+    // with parallel sessions the bundle may be on one of the others
+    if (!is_stripe() && stripes_.empty()) {
+        log_warn("handle_cancel_bundle: "
+                 "can't find bundle %" PRIbid " in the in flight list", bundle->bundleid());
+    }
 }
 
 //----------------------------------------------------------------------
@@ -995,11 +1023,11 @@ StreamConvergenceLayer::Connection::handle_poll_timeout()
     // deadlock caused by simultaneous poll_timeout and close_contact
     // activities.
     //
-    // Before we return, sleep a bit to avoid continuous
+    // Before we return, delay a bit to avoid continuous
     // handle_poll_timeout calls
     if (BundleDaemon::shutting_down())
     {
-        usleep(100000);
+        delay_turns(100);
         return;
     }
     
@@ -1496,6 +1524,9 @@ StreamConvergenceLayer::Connection::check_completed(IncomingBundle* incoming)
 
     incoming->bundle_accepted_ = true;  // as far as payload storage is concerned
 
+    ++bundles_rcvd_;
+    bytes_rcvd_ += incoming->total_length_;
+
     BundleReceivedEvent* event_to_post;
     event_to_post = new BundleReceivedEvent(incoming->bundle_.object(),
                                             EVENTSRC_PEER,
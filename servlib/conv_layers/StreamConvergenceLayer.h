@@ -242,6 +242,11 @@ protected:
         virtual bool finish_bundle(InFlightBundle* inflight);
         virtual void send_keepalive();
         virtual void check_completed(InFlightBundle* inflight);
+        virtual void check_completed(IncomingBundle* incoming);
+
+        /// Whether another bundle may be put in flight (by default
+        /// when fewer than max_inflight_bundles are unacked)
+        virtual bool inflight_window_open();
 
         virtual void handle_contact_initiation();
         virtual bool handle_data_segment(u_int8_t flags);
@@ -269,7 +274,6 @@ protected:
         virtual bool send_next_segment(InFlightBundle* inflight);
         
         virtual bool handle_shutdown(u_int8_t flags);
-        virtual void check_completed(IncomingBundle* incoming);
         /// @}
 
         
@@ -25,6 +25,9 @@
 
 #include <netinet/tcp.h>
 #include <sys/poll.h>
+#ifdef __linux__
+#  include <sys/sendfile.h>
+#endif
 #include <stdlib.h>
 
 #include <third_party/oasys/io/NetUtils.h>
@@ -39,6 +42,7 @@
 #include "TCPConvergenceLayer.h"
 #include "IPConvergenceLayerUtils.h"
 #include "bundling/BundleDaemon.h"
+#include "bundling/BundleProtocol.h"
 #include "contacts/ContactManager.h"
 #include "routing/BundleRouter.h"
 #include "storage/BundleStore.h"
@@ -78,6 +82,13 @@ TCPConvergenceLayer::TCPLinkParams::serialize(oasys::SerializeAction *a)
     a->process("max_rcv_bundle_size", &max_rcv_bundle_size_);
     a->process("tls_enabled", &tls_enabled_);
     a->process("require_tls", &require_tls_);
+    a->process("vectored_send", &vectored_send_);
+    a->process("sendfile", &sendfile_);
+    a->process("direct_recv", &direct_recv_);
+    a->process("adaptive_window", &adaptive_window_);
+    a->process("max_inflight_bytes", &max_inflight_bytes_);
+    a->process("adaptive_segments", &adaptive_segments_);
+    a->process("parallel_sessions", &parallel_sessions_);
 
     a->process("tls_iface_cert_file", &tls_iface_cert_file_);
     a->process("tls_iface_cert_chain_file", &tls_iface_cert_chain_file_);
@@ -167,6 +178,13 @@ TCPConvergenceLayer::parse_link_params(LinkParams* lparams,
     p.addopt(new oasys::BoolOpt("require_tls", &params->require_tls_));
     p.addopt(new oasys::UInt64Opt("max_rcv_seg_len", &params->max_rcv_seg_len_));
     p.addopt(new oasys::UInt64Opt("max_rcv_bundle_size", &params->max_rcv_bundle_size_));
+    p.addopt(new oasys::BoolOpt("vectored_send", &params->vectored_send_));
+    p.addopt(new oasys::BoolOpt("sendfile", &params->sendfile_));
+    p.addopt(new oasys::BoolOpt("direct_recv", &params->direct_recv_));
+    p.addopt(new oasys::BoolOpt("adaptive_window", &params->adaptive_window_));
+    p.addopt(new oasys::UInt64Opt("max_inflight_bytes", &params->max_inflight_bytes_));
+    p.addopt(new oasys::BoolOpt("adaptive_segments", &params->adaptive_segments_));
+    p.addopt(new oasys::UIntOpt("parallel_sessions", &params->parallel_sessions_));
 
     p.addopt(new oasys::StringOpt("tls_link_cert_file", &params->tls_link_cert_file_));
     p.addopt(new oasys::StringOpt("tls_link_cert_chain_file", &params->tls_link_cert_chain_file_));
@@ -185,6 +203,11 @@ TCPConvergenceLayer::parse_link_params(LinkParams* lparams,
     }
 
     
+    if (params->parallel_sessions_ == 0) {
+        log_err("parallel_sessions cannot be zero - resetting to 1");
+        params->parallel_sessions_ = 1;
+    }
+
     if (params->local_addr_ == INADDR_NONE) {
         params->local_addr_ = INADDR_ANY;
         log_err("invalid local address setting of INADDR_NONE - resetting to default INADDR_ANY");
@@ -229,6 +252,13 @@ TCPConvergenceLayer::dump_link(const LinkRef& link, oasys::StringBuffer* buf)
     buf->appendf("max_inflight_bundles: %u\n", params->max_inflight_bundles_);
     buf->appendf("keepalive_interval: %u\n", params->keepalive_interval_);
     buf->appendf("reactive_frag_enabled: %s\n", params->reactive_frag_enabled_ ? "true": "false");
+    buf->appendf("vectored_send: %s\n", params->vectored_send_ ? "true": "false");
+    buf->appendf("sendfile: %s\n", params->sendfile_ ? "true": "false");
+    buf->appendf("direct_recv: %s\n", params->direct_recv_ ? "true": "false");
+    buf->appendf("adaptive_window: %s\n", params->adaptive_window_ ? "true": "false");
+    buf->appendf("max_inflight_bytes: %" PRIu64 "\n", params->max_inflight_bytes_);
+    buf->appendf("adaptive_segments: %s\n", params->adaptive_segments_ ? "true": "false");
+    buf->appendf("parallel_sessions: %u\n", params->parallel_sessions_);
 
     buf->appendf("tls_link_cert_file: %s\n", params->tls_link_cert_file_.c_str());
     buf->appendf("tls_link_cert_chain_file: %s\n", params->tls_link_cert_chain_file_.c_str());
@@ -272,10 +302,24 @@ TCPConvergenceLayer::list_link_opts(oasys::StringBuffer& buf)
     buf.appendf("                                                  could also set the keepalive_interval to zero.)\n");
     buf.appendf("    segment_length <U64>               - Max length of an outgoing data segment  (default: 10MB)\n");
     buf.appendf("    max_inflight_bundles <U32>         - Max number of inflight unacked bundles to allow  (default: 100)\n");
+    buf.appendf("    adaptive_window <Bool>             - Whether to keep starting bundles past max_inflight_bundles while the\n"
+                "                                         unacked bytes are below twice the measured bandwidth-delay product\n"
+                "                                         (default: true)\n");
+    buf.appendf("    max_inflight_bytes <U64>           - Max unacked bytes the adaptive window allows (0 = no limit) (default: 256MB)\n");
+    buf.appendf("    adaptive_segments <Bool>           - Whether to size outgoing segments to about a quarter round trip of the\n"
+                "                                         measured throughput, up to segment_length (default: true)\n");
+    buf.appendf("    parallel_sessions <U32>            - Number of TCPCL sessions to open to the peer, with whole bundles\n"
+                "                                         dispatched to whichever session has room (default: 1)\n");
 
     buf.appendf("    reactive_frag_enabled <Bool>       - Whether to reactively fragment partially sent bundles (default: false)\n");
     buf.appendf("    recvbuf_len <U32>                  - Length of internal receive buffer (not socket buffer) (default: 2048000)\n");
     buf.appendf("    sendbuf_len <U32>                  - Length of internal send buffer (not socket buffer) (default: 2048000)\n");
+    buf.appendf("    vectored_send <Bool>               - Whether to write bundle data to the socket directly from the payload\n"
+                "                                         instead of copying it through the send buffer (default: true)\n");
+    buf.appendf("    sendfile <Bool>                    - Whether vectored sends pass payload bytes stored on disk to the socket\n"
+                "                                         with sendfile() (default: true)\n");
+    buf.appendf("    direct_recv <Bool>                 - Whether to read received payload data straight into the payload\n"
+                "                                         instead of through the receive buffer (default: true)\n");
     buf.appendf("    data_timeout <U32>                 - Milliseconds to wait for socket read before timeout (default: 30000)\n");
 
     buf.appendf("    test_read_delay <U32>              - (for testing) Milliseconds to delay read between read attempts (default: 0)\n");
@@ -344,10 +388,22 @@ TCPConvergenceLayer::list_interface_opts(oasys::StringBuffer& buf)
     buf.appendf("                                                  could also set the keepalive_interval to zero.)\n");
     buf.appendf("    segment_length <U64>               - Max length of an outgoing data segment  (default: 10MB)\n");
     buf.appendf("    max_inflight_bundles <U32>         - Max number of inflight unacked bundles to allow  (default: 100)\n");
+    buf.appendf("    adaptive_window <Bool>             - Whether to keep starting bundles past max_inflight_bundles while the\n"
+                "                                         unacked bytes are below twice the measured bandwidth-delay product\n"
+                "                                         (default: true)\n");
+    buf.appendf("    max_inflight_bytes <U64>           - Max unacked bytes the adaptive window allows (0 = no limit) (default: 256MB)\n");
+    buf.appendf("    adaptive_segments <Bool>           - Whether to size outgoing segments to about a quarter round trip of the\n"
+                "                                         measured throughput, up to segment_length (default: true)\n");
 
     buf.appendf("    reactive_frag_enabled <Bool>       - Whether to reactively fragment partially sent bundles (default: false)\n");
     buf.appendf("    recvbuf_len <U32>                  - Length of internal receive buffer (not socket buffer) (default: 2048000)\n");
     buf.appendf("    sendbuf_len <U32>                  - Length of internal send buffer (not socket buffer) (default: 2048000)\n");
+    buf.appendf("    vectored_send <Bool>               - Whether to write bundle data to the socket directly from the payload\n"
+                "                                         instead of copying it through the send buffer (default: true)\n");
+    buf.appendf("    sendfile <Bool>                    - Whether vectored sends pass payload bytes stored on disk to the socket\n"
+                "                                         with sendfile() (default: true)\n");
+    buf.appendf("    direct_recv <Bool>                 - Whether to read received payload data straight into the payload\n"
+                "                                         instead of through the receive buffer (default: true)\n");
     buf.appendf("    data_timeout <U32>                 - Milliseconds to wait for socket read before timeout (default: 30000)\n");
 
     buf.appendf("    test_read_delay <U32>              - (for testing) Milliseconds to delay read between read attempts (default: 0)\n");
@@ -433,6 +489,12 @@ TCPConvergenceLayer::interface_up(Interface* iface,
     p.addopt(new oasys::BoolOpt("require_tls", &params->require_tls_));
     p.addopt(new oasys::UInt64Opt("max_rcv_seg_len", &params->max_rcv_seg_len_));
     p.addopt(new oasys::UInt64Opt("max_rcv_bundle_size", &params->max_rcv_bundle_size_));
+    p.addopt(new oasys::BoolOpt("vectored_send", &params->vectored_send_));
+    p.addopt(new oasys::BoolOpt("sendfile", &params->sendfile_));
+    p.addopt(new oasys::BoolOpt("direct_recv", &params->direct_recv_));
+    p.addopt(new oasys::BoolOpt("adaptive_window", &params->adaptive_window_));
+    p.addopt(new oasys::UInt64Opt("max_inflight_bytes", &params->max_inflight_bytes_));
+    p.addopt(new oasys::BoolOpt("adaptive_segments", &params->adaptive_segments_));
 
     p.addopt(new oasys::StringOpt("tls_iface_cert_file", &params->tls_iface_cert_file_));
     p.addopt(new oasys::StringOpt("tls_iface_cert_chain_file", &params->tls_iface_cert_chain_file_));
@@ -854,10 +916,10 @@ TCPConvergenceLayer::Connection0::run()
 
     if (peer_tcpcl_version_ == 3) {
         Connection3* conn = new Connection3(tcp_cl, tcpcl_params, sock_, nexthop_, recvbuf_);
-        conn->start();
+        conn->start_connection();
     } else {
         Connection4* conn = new Connection4(tcp_cl, tcpcl_params, sock_, nexthop_, recvbuf_);
-        conn->start();
+        conn->start_connection();
     }
 
     sock_ = nullptr;
@@ -897,7 +959,7 @@ TCPConvergenceLayer::Connection0::break_contact(ContactEvent::reason_t reason)
     
     // just close the socket at this stage
         
-    contact_broken_ = true;
+    set_contact_broken();
 
     disconnect();
 }
@@ -1420,6 +1482,13 @@ TCPConvergenceLayer::Connection4::serialize(oasys::SerializeAction *a)
     a->process("require_tls", &params->require_tls_);
     a->process("max_rcv_seg_len", &params->max_rcv_seg_len_);
     a->process("max_rcv_bundle_size", &params->max_rcv_bundle_size_);
+    a->process("vectored_send", &params->vectored_send_);
+    a->process("sendfile", &params->sendfile_);
+    a->process("direct_recv", &params->direct_recv_);
+    a->process("adaptive_window", &params->adaptive_window_);
+    a->process("max_inflight_bytes", &params->max_inflight_bytes_);
+    a->process("adaptive_segments", &params->adaptive_segments_);
+    a->process("parallel_sessions", &params->parallel_sessions_);
 
     a->process("tls_iface_cert_file", &params->tls_iface_cert_file_);
     a->process("tls_iface_cert_chain_file", &params->tls_iface_cert_chain_file_);
@@ -2193,20 +2262,54 @@ TCPConvergenceLayer::Connection4::handle_session_negotiation()
     link->params().mtu_ = max_bundle_size;
 
     /*
-     * Finally, we note that the contact is now up.
+     * Finally, we note that the contact is now up. The sessions
+     * striped across the link join the primary's contact instead.
      */
+    if (is_stripe()) {
+        contact_up_ = true;
+        return true;
+    }
+
     contact_up();
 
+    start_stripes();
+
 
     // If external router - delay 5 seconds befoe reading bundles to give time for contact up to be processed?
     int secs_to_delay = BundleDaemon::instance()->router()->delay_after_contact_up();
     if (0 != secs_to_delay) {
-        sleep(secs_to_delay);
+        delay_turns(secs_to_delay * 1000);
     }
 
     return true;
 }
 
+//----------------------------------------------------------------------
+void
+TCPConvergenceLayer::Connection4::start_stripes()
+{
+    TCPLinkParams* params = tcp_lparams();
+    if (!active_connector_ || (params->parallel_sessions_ <= 1)) {
+        return;
+    }
+
+    TCPConvergenceLayer* cl = dynamic_cast<TCPConvergenceLayer*>(cl_);
+    ASSERT(cl != nullptr);
+
+    // a stripe that fails takes the whole contact down with it (its
+    // break posts the link state change for the shared contact), so
+    // the link reopens with all of its sessions
+    for (uint32_t i = 1; i < params->parallel_sessions_; ++i) {
+        Connection4* stripe = new Connection4(cl, params);
+        stripe->set_primary(this);
+        add_stripe(stripe);
+        stripe->start_connection();
+    }
+
+    log_info("opened %u parallel sessions on link %s",
+             params->parallel_sessions_, contact_->link()->name());
+}
+
 //----------------------------------------------------------------------
 bool
 TCPConvergenceLayer::Connection4::handle_data_segment(uint8_t flags)
@@ -2697,6 +2800,9 @@ TCPConvergenceLayer::Connection4::handle_ack_segment(uint8_t flags)
     
     inflight->ack_data_.set(0, acked_len);
 
+    xmit_window_.segment_acked(transfer_id, acked_len, acked_len - ack_begin,
+                               TransferWindow::now_us());
+
     // now check if this was the last ack for the bundle, in which
     // case we can pop it off the list and post a
     // BundleTransmittedEvent
@@ -2803,6 +2909,9 @@ TCPConvergenceLayer::Connection4::handle_refuse_bundle(uint8_t flags)
 
     inflight->bundle_refused_ = true;
 
+    size_t bytes_sent = inflight->sent_data_.empty() ? 0 : inflight->sent_data_.last() + 1;
+    xmit_window_.transfer_refused(transfer_id, bytes_sent - inflight->ack_data_.num_contiguous());
+
     if (inflight == current_inflight_) {
         finish_bundle(inflight);
         check_completed(inflight);
@@ -2814,7 +2923,10 @@ TCPConvergenceLayer::Connection4::handle_refuse_bundle(uint8_t flags)
         SPtr_BundleEvent sptr_event_to_post(event_to_post);
         BundleDaemon::post(sptr_event_to_post);
 
-        inflight_.erase(iter);
+        do {
+            oasys::ScopeLock l(&session_lock_, "TCPConvergenceLayer::Connection4::handle_refuse_bundle");
+            inflight_.erase(iter);
+        } while (false);
         delete inflight;
     }
 
@@ -3081,11 +3193,11 @@ TCPConvergenceLayer::Connection4::handle_poll_activity_while_waiting_for_tcpcl3_
         conn->set_contact(contact_);
         contact_->set_cl_info(nullptr);
         contact_->set_cl_info(conn);
-        conn->start();
+        conn->start_connection();
         sock_ = nullptr;
         
 
-        contact_broken_ = true;
+        set_contact_broken();
     }
 }
 
@@ -3197,6 +3309,31 @@ TCPConvergenceLayer::Connection4::run()
 
 
 
+//----------------------------------------------------------------------
+bool
+TCPConvergenceLayer::Connection4::event_loop_capable()
+{
+    TCPLinkParams* params = dynamic_cast<TCPLinkParams*>(params_);
+    ASSERT(params != nullptr);
+
+    if (params->tls_enabled_) {
+        return false;
+    }
+
+    if (active_connector_ && params->delay_for_tcpcl3_ != 0) {
+        return false;
+    }
+
+    // with a payload quota the receive side can block retrying the
+    // payload space reservation for a transfer which would hold up
+    // every other connection on the loop
+    if (BundleStore::instance()->payload_quota() != 0) {
+        return false;
+    }
+
+    return StreamConvergenceLayer::Connection::event_loop_capable();
+}
+
 //----------------------------------------------------------------------
 bool
 TCPConvergenceLayer::Connection4::run_delay_for_tcpcl3()
@@ -3333,12 +3470,18 @@ TCPConvergenceLayer::Connection4::send_next_segment(InFlightBundle* inflight)
     if (bytes_sent == 0) {
         flags |= BUNDLE_START;
     }
+
+    // segment_length is already limited to the peer's segment MRU
+    uint64_t max_segment_len = params->segment_length_;
+    if (tcp_lparams()->adaptive_segments_) {
+        max_segment_len = xmit_window_.segment_length(max_segment_len);
+    }
     
-    if (params->segment_length_ >= inflight->total_length_ - bytes_sent) {
+    if (max_segment_len >= inflight->total_length_ - bytes_sent) {
         flags |= BUNDLE_END;
         segment_len = inflight->total_length_ - bytes_sent;
     } else {
-        segment_len = params->segment_length_;
+        segment_len = max_segment_len;
     }
    
     if (bytes_sent == 0) {
@@ -3398,10 +3541,27 @@ TCPConvergenceLayer::Connection4::send_next_segment(InFlightBundle* inflight)
 
     send_segment_todo_ = segment_len;
 
+    xmit_window_.segment_sent(inflight->transfer_id_, bytes_sent + segment_len,
+                              segment_len, TransferWindow::now_us());
+
     // send_data_todo actually does the deed
     return send_data_todo(inflight);
 }
 
+//----------------------------------------------------------------------
+bool
+TCPConvergenceLayer::Connection4::inflight_window_open()
+{
+    TCPLinkParams* params = tcp_lparams();
+
+    if (!params->adaptive_window_) {
+        return StreamConvergenceLayer::Connection::inflight_window_open();
+    }
+
+    return xmit_window_.open(inflight_.size(), params->max_inflight_bundles_,
+                             params->max_inflight_bytes_);
+}
+
 //----------------------------------------------------------------------
 void
 TCPConvergenceLayer::Connection4::queue_acks_for_incoming_bundle(IncomingBundle* incoming)
@@ -3433,7 +3593,7 @@ TCPConvergenceLayer::Connection4::queue_acks_for_incoming_bundle(IncomingBundle*
             u64 = htobe64(in_ackptr->acked_len_);
             memcpy(&buf[10], &u64, sizeof(u64));
 
-            admin_msg_list_.push_back(new std::string(buf, need_bytes));
+            ack_batch_.append(buf, need_bytes);
         }
 
         incoming->acked_length_ = in_ackptr->acked_len_;
@@ -3442,6 +3602,39 @@ TCPConvergenceLayer::Connection4::queue_acks_for_incoming_bundle(IncomingBundle*
     }
 }
 
+//----------------------------------------------------------------------
+bool
+TCPConvergenceLayer::Connection4::send_pending_acks()
+{
+    if (contact_broken_) {
+        return false;
+    }
+
+    // the acks of all the bundles completed since the last call go
+    // out in one write instead of a queued message each
+    bool sent_acks = false;
+    if (!ack_batch_.empty()) {
+        static const size_t XFER_ACK_LEN = 1 + 1 + 8 + 8;
+
+        size_t len = std::min(ack_batch_.size(), sendbuf_.tailbytes());
+        len -= len % XFER_ACK_LEN;
+
+        if (len > 0) {
+            memcpy(sendbuf_.end(), ack_batch_.data(), len);
+            sendbuf_.fill(len);
+            ack_batch_.erase(0, len);
+
+            send_data();
+            note_data_sent();
+            sent_acks = true;
+        }
+    }
+
+    bool sent_msgs = StreamConvergenceLayer::Connection::send_pending_acks();
+
+    return sent_acks || sent_msgs || !ack_batch_.empty();
+}
+
 //----------------------------------------------------------------------
 void
 TCPConvergenceLayer::Connection4::send_data()
@@ -3463,6 +3656,11 @@ TCPConvergenceLayer::Connection4::send_data()
         ASSERT(! contact_broken_);
     }
 
+    if (! xmit_iov_.empty()) {
+        send_data_iov();
+        return;
+    }
+
     u_int towrite = sendbuf_.fullbytes();
     if (params_->test_write_limit_ != 0) {
         towrite = std::min(towrite, params_->test_write_limit_);
@@ -3514,6 +3712,142 @@ TCPConvergenceLayer::Connection4::send_data()
     }
 }
 
+//----------------------------------------------------------------------
+bool
+TCPConvergenceLayer::Connection4::send_data_todo(InFlightBundle* inflight)
+{
+    TCPLinkParams* params = tcp_lparams();
+
+    // the byte-at-a-time test limits, hexdumps and TLS all need the
+    // data in the send buffer
+    if (!params->vectored_send_ || tls_active_ || params->hexdump_ ||
+        params->test_write_limit_ != 0 || params->test_write_delay_ != 0)
+    {
+        return StreamConvergenceLayer::Connection::send_data_todo(inflight);
+    }
+
+    ASSERT(send_segment_todo_ != 0);
+
+    // the rest of the segment has already been produced and is only
+    // waiting for the socket to drain
+    if (! xmit_iov_.empty()) {
+        if (! (sock_pollfd_->events & POLLOUT)) {
+            send_data();
+        }
+        return (send_segment_todo_ == 0);
+    }
+
+    // produce the whole segment at once. send_segment_todo_ is left
+    // set until the bytes are actually written to the socket so that
+    // nothing else (acks, keepalives, shutdown) gets written into the
+    // middle of the segment
+    size_t bytes_sent = inflight->sent_data_.empty() ? 0 :
+                        inflight->sent_data_.last() + 1;
+
+    Bundle* bundle = inflight->bundle_.object();
+    SPtr_BlockInfoVec sptr_blocks = inflight->blocks_;
+
+#ifdef __linux__
+    xmit_iov_.set_use_files(params->sendfile_);
+#endif
+
+    size_t ret =
+        BundleProtocol::produce_iov(bundle, sptr_blocks.get(), bytes_sent,
+                                    send_segment_todo_, &xmit_iov_,
+                                    &inflight->send_complete_);
+    ASSERT(ret == send_segment_todo_);
+    inflight->sent_data_.set(bytes_sent, send_segment_todo_);
+
+    note_data_sent();
+    send_data();
+
+    return (send_segment_todo_ == 0);
+}
+
+//----------------------------------------------------------------------
+void
+TCPConvergenceLayer::Connection4::send_data_iov()
+{
+    // the segment header and anything queued ahead of it go out of the
+    // send buffer first, followed by as many of the bundle segments as
+    // fit in one call. segments that come from a payload file go
+    // straight from the file with sendfile() once everything ahead of
+    // them has been written
+    static const int MAX_IOV = 64;
+    struct iovec iov[MAX_IOV];
+    int iovcnt = 0;
+
+    size_t buffered = sendbuf_.fullbytes();
+    if (buffered != 0) {
+        iov[0].iov_base = sendbuf_.start();
+        iov[0].iov_len  = buffered;
+        iovcnt = 1;
+    }
+
+    int in_mem = xmit_iov_.iovcnt_before_file();
+    int n = std::min(in_mem, MAX_IOV - iovcnt);
+    memcpy(&iov[iovcnt], xmit_iov_.iov(), n * sizeof(struct iovec));
+    iovcnt += n;
+
+    int cc;
+    if (iovcnt != 0) {
+#ifdef MSG_MORE
+        // hold the header back if the payload follows in a sendfile()
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = iovcnt;
+        int flags = (n == in_mem && n < xmit_iov_.iovcnt()) ? MSG_MORE : 0;
+        cc = ::sendmsg(sock_->fd(), &msg, flags);
+#else
+        cc = sock_->writev(iov, iovcnt);
+#endif
+    } else {
+#ifdef __linux__
+        off_t file_offset;
+        int fd = xmit_iov_.file_fd(0, &file_offset);
+        ASSERT(fd != -1);
+        cc = ::sendfile(sock_->fd(), fd, &file_offset, xmit_iov_.iov()[0].iov_len);
+        if (cc == 0) {
+            log_err("send_data_iov: payload file is shorter than the bundle");
+            break_contact(ContactEvent::BROKEN);
+            return;
+        }
+#else
+        NOTREACHED;
+#endif
+    }
+
+    if (cc > 0) {
+        size_t written = cc;
+        size_t from_buf = std::min(written, buffered);
+        sendbuf_.consume(from_buf);
+        written -= from_buf;
+
+        if (written != 0) {
+            xmit_iov_.consume(written);
+            send_segment_todo_ -= written;
+        }
+
+        if (sendbuf_.fullbytes() != 0 || ! xmit_iov_.empty()) {
+            //log_debug("send_data_iov: incomplete write, setting POLLOUT bit");
+            sock_pollfd_->events |= POLLOUT;
+
+        } else {
+            if (sock_pollfd_->events & POLLOUT) {
+                sock_pollfd_->events &= ~POLLOUT;
+            }
+        }
+    } else if (errno == EWOULDBLOCK || errno == EINTR) {
+        sock_pollfd_->events |= POLLOUT;
+        
+    } else {
+        log_err("send_data: remote connection unexpectedly closed: %s",
+                 strerror(errno));
+        break_contact(ContactEvent::BROKEN);
+    }
+}
+
 //----------------------------------------------------------------------
 void
 TCPConvergenceLayer::Connection4::send_data_tls()
@@ -3584,6 +3918,10 @@ TCPConvergenceLayer::Connection4::recv_data()
     // chains where the contact is broken but we're still using the
     // socket
     ASSERT(! contact_broken_);
+
+    if (recv_payload_direct()) {
+        return;
+    }
     
     // this shouldn't ever happen
     if (recvbuf_.tailbytes() == 0) {
@@ -3616,6 +3954,64 @@ TCPConvergenceLayer::Connection4::recv_data()
     recvbuf_.fill(cc);
 }
 
+//----------------------------------------------------------------------
+bool
+TCPConvergenceLayer::Connection4::recv_payload_direct()
+{
+    // only the payload data of a data segment is read directly and
+    // only once everything ahead of it has been drained from the
+    // receive buffer
+    TCPLinkParams* params = tcp_lparams();
+    if (!params->direct_recv_ || params->hexdump_ || (params->test_read_limit_ != 0) ||
+        (recv_segment_todo_ == 0) || (recv_segment_to_refuse_ != 0) ||
+        (recvbuf_.fullbytes() != 0) || incoming_.empty() ||
+        delay_reads_to_free_some_storage_)
+    {
+        return false;
+    }
+
+    IncomingBundle* incoming = incoming_.back();
+    Bundle* bundle = incoming->bundle_.object();
+
+    size_t len = std::min(recv_segment_todo_,
+                          BundleProtocol::direct_payload_len(bundle));
+    if (len < MIN_DIRECT_RECV) {
+        return false;
+    }
+
+    size_t avail = 0;
+    u_char* buf = bundle->mutable_payload()->direct_append_buf(len, &avail);
+    if (buf == nullptr) {
+        return false;
+    }
+
+    int cc = sock_->read((char*)buf, avail);
+
+    bundle->mutable_payload()->direct_append_done((cc > 0) ? cc : 0);
+
+    if (cc < 1) {
+        log_err("remote connection unexpectedly closed");
+        break_contact(ContactEvent::BROKEN);
+        return true;
+    }
+
+    // process_data() won't see these bytes so do its bookkeeping
+    note_data_rcvd();
+
+    if (bundle->is_fragment()) {
+        bundle->set_frag_length(bundle->payload().length());
+    }
+
+    recv_segment_todo_ -= cc;
+    incoming->bytes_received_ += cc;
+
+    if (recv_segment_todo_ == 0) {
+        check_completed(incoming);
+    }
+
+    return true;
+}
+
 //----------------------------------------------------------------------
 void
 TCPConvergenceLayer::Connection4::recv_data_tls()
@@ -3754,7 +4150,11 @@ TCPConvergenceLayer::Connection4::break_contact(ContactEvent::reason_t reason)
         send_data();
     }
         
-    contact_broken_ = true;
+    set_contact_broken();
+
+    // the unwritten segments may point into the payload so they must
+    // not outlive the in flight bundle
+    xmit_iov_.clear();
         
     log_debug("break_contact: %s", ContactEvent::reason_to_str(reason));
 
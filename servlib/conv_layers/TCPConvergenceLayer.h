@@ -22,6 +22,8 @@
 #include <third_party/oasys/serialize/Serialize.h>
 
 #include "StreamConvergenceLayer.h"
+#include "TransferWindow.h"
+#include "bundling/BundleIOVec.h"
 
 
 #ifdef WOLFSSL_TLS_ENABLED
@@ -95,6 +97,16 @@ public:
         bool require_tls_ = false;        ///< wheter to force use of TLS
         bool tls_active_ = false;         ///< negotiated state for reporting purposes (not configurable)
 
+        bool vectored_send_ = true;       ///< writev segments straight from the bundle instead of copying into sendbuf
+        bool sendfile_ = true;            ///< sendfile payload bytes on disk when doing vectored sends
+        bool direct_recv_ = true;         ///< read payload data straight into the payload
+
+        bool adaptive_window_ = true;     ///< grow the inflight window to the measured bandwidth-delay product
+        uint64_t max_inflight_bytes_ = 256000000; ///< limit on unacked bytes when the window grows past max_inflight_bundles
+        bool adaptive_segments_ = true;   ///< size segments from the measured throughput (up to segment_length)
+
+        uint32_t parallel_sessions_ = 1;  ///< sessions a link opens to the peer and stripes its bundles across
+
         std::string tls_iface_cert_file_ = "./certs/server/server-cert.pem";
         std::string tls_iface_cert_chain_file_ = "";
         std::string tls_iface_private_key_file_ = "./certs/server/server-key.pem";
@@ -132,6 +144,16 @@ public:
                 require_tls_ = other.require_tls_;
                 tls_active_ = other.tls_active_;
 
+                vectored_send_ = other.vectored_send_;
+                sendfile_ = other.sendfile_;
+                direct_recv_ = other.direct_recv_;
+
+                adaptive_window_ = other.adaptive_window_;
+                max_inflight_bytes_ = other.max_inflight_bytes_;
+                adaptive_segments_ = other.adaptive_segments_;
+
+                parallel_sessions_ = other.parallel_sessions_;
+
                 tls_iface_cert_file_ = other.tls_iface_cert_file_;
                 tls_iface_cert_chain_file_ = other.tls_iface_cert_chain_file_;
                 tls_iface_private_key_file_ = other.tls_iface_private_key_file_;
@@ -511,6 +533,12 @@ protected:
          */
         virtual void break_contact(ContactEvent::reason_t reason) override;
 
+        /**
+         * Override CLConnection since the TCPCL3 delay runs its own
+         * poll loop and the TLS handshake sleeps
+         */
+        virtual bool event_loop_capable() override;
+
     protected:
 
         /// @{ Virtual from CLConnection
@@ -541,11 +569,18 @@ protected:
 
         virtual void send_data() override;
         virtual void send_data_tls();
+        virtual bool send_data_todo(InFlightBundle* inflight) override;
         virtual void send_keepalive() override;
         virtual bool send_next_segment(InFlightBundle* inflight) override;
         virtual void send_msg_reject(uint8_t msg_type, uint8_t reason);
         virtual void queue_acks_for_incoming_bundle(IncomingBundle* incoming) override;
+        virtual bool send_pending_acks() override;
+        virtual bool inflight_window_open() override;
         /// @}
+
+        /// Open the rest of the link's parallel sessions once the
+        /// contact is up on this (primary) connection
+        virtual void start_stripes();
         
         /// @{ methods active connector uses to delay for peer to announce it
         ///    is a TCPCL3 before continuing with the TCPCL4 hadnshaking
@@ -554,10 +589,23 @@ protected:
         /// @}
 
 
+        /// Write the send buffer followed by the bundle segments in
+        /// xmit_iov_ with a single writev(), or with sendfile() for
+        /// the segments that come from a payload file
+        virtual void send_data_iov();
+
         /// Hook for handle_poll_activity to receive data
         virtual void recv_data();
         virtual void recv_data_tls();
 
+        /// Read payload data of the current data segment straight into
+        /// the payload of the incoming bundle
+        /// @return false if the data has to go through the receive buffer
+        virtual bool recv_payload_direct();
+
+        /// Smallest run of payload data worth reading directly
+        static const size_t MIN_DIRECT_RECV = 4096;
+
         virtual void refuse_bundle(uint64_t transfer_id, uint8_t reason);
 
         virtual bool parse_xfer_segment_extension_items(u_char* buf, uint32_t len, 
@@ -586,6 +634,19 @@ protected:
 
         bool tls_active_ = false;
 
+        /// Bundle bytes of the current segment that were produced but
+        /// not yet written to the socket
+        BundleIOVec xmit_iov_;
+
+        /// Sender side estimates of the path that size the inflight
+        /// window and the segments
+        TransferWindow xmit_window_;
+
+        /// XFER_ACKs of the received bundles waiting to be copied into
+        /// the send buffer, kept together so a batch of bundles is
+        /// acknowledged with one write
+        std::string ack_batch_;
+
 #ifdef WOLFSSL_TLS_ENABLED
         WOLFSSL_CTX* wolfssl_ctx_ = nullptr;
         WOLFSSL* wolfssl_handle_ = nullptr;
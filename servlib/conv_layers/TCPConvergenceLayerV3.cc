@@ -456,7 +456,7 @@ TCPConvergenceLayerV3::Listener::accepted(int fd, in_addr_t addr, u_int16_t port
     *params = default_link_params_;
 
     Connection3* conn = new Connection3(cl_, params, fd, addr, port);
-    conn->start();
+    conn->start_connection();
 }
 
 //----------------------------------------------------------------------
@@ -0,0 +1,176 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <algorithm>
+#include <time.h>
+
+#include "TransferWindow.h"
+
+namespace dtn {
+
+const uint64_t TransferWindow::MIN_SEGMENT_LENGTH;
+const uint64_t TransferWindow::SEGMENTS_PER_RTT;
+const uint64_t TransferWindow::MIN_RTT_LIFETIME_US;
+const uint64_t TransferWindow::MIN_RATE_INTERVAL_US;
+
+//----------------------------------------------------------------------
+TransferWindow::TransferWindow()
+    : unacked_bytes_(0),
+      min_rtt_us_(0),
+      min_rtt_stamp_us_(0),
+      ack_rate_(0),
+      rate_start_us_(0),
+      rate_bytes_(0),
+      last_ack_us_(0)
+{
+}
+
+//----------------------------------------------------------------------
+uint64_t
+TransferWindow::now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+//----------------------------------------------------------------------
+void
+TransferWindow::segment_sent(uint64_t transfer_id, uint64_t end_offset,
+                             uint64_t len, uint64_t now)
+{
+    // a window that sat empty for longer than a rate sample interval
+    // was idle, so the next ack starts a new sample rather than
+    // counting the idle time; a prompt refill keeps the sample going
+    if ((unacked_bytes_ == 0) && (rate_start_us_ != 0) &&
+        (now - last_ack_us_ > std::max(min_rtt_us_, MIN_RATE_INTERVAL_US)))
+    {
+        rate_start_us_ = 0;
+    }
+
+    segments_.push_back({transfer_id, end_offset, now});
+    unacked_bytes_ += len;
+}
+
+//----------------------------------------------------------------------
+void
+TransferWindow::segment_acked(uint64_t transfer_id, uint64_t acked_len,
+                              uint64_t newly_acked, uint64_t now)
+{
+    unacked_bytes_ -= std::min(newly_acked, unacked_bytes_);
+
+    // acks come back in the order the segments went out, so anything
+    // ahead of the acked segment belongs to a refused transfer or was
+    // covered by a later ack
+    while (!segments_.empty()) {
+        const Segment& seg = segments_.front();
+        if ((seg.transfer_id_ == transfer_id) && (seg.end_offset_ > acked_len)) {
+            break;
+        }
+
+        if ((seg.transfer_id_ == transfer_id) && (seg.end_offset_ == acked_len) &&
+            (now >= seg.sent_us_))
+        {
+            uint64_t rtt = std::max(now - seg.sent_us_, (uint64_t)1);
+            if ((min_rtt_us_ == 0) || (rtt <= min_rtt_us_) ||
+                (now - min_rtt_stamp_us_ > MIN_RTT_LIFETIME_US))
+            {
+                min_rtt_us_       = rtt;
+                min_rtt_stamp_us_ = now;
+            }
+        }
+
+        segments_.pop_front();
+    }
+
+    // sample the rate over at least a round trip so a burst of acks
+    // for one large transfer doesn't look like a fast path
+    if (rate_start_us_ == 0) {
+        rate_start_us_ = now;
+        rate_bytes_    = 0;
+    } else {
+        rate_bytes_ += newly_acked;
+
+        uint64_t elapsed = now - rate_start_us_;
+        if (elapsed >= std::max(min_rtt_us_, MIN_RATE_INTERVAL_US)) {
+            double sample = (rate_bytes_ * 1000000.0) / elapsed;
+            if (sample > ack_rate_) {
+                ack_rate_ = sample;
+            } else {
+                ack_rate_ += (sample - ack_rate_) / 8;
+            }
+            rate_start_us_ = now;
+            rate_bytes_    = 0;
+        }
+    }
+
+    last_ack_us_ = now;
+}
+
+//----------------------------------------------------------------------
+void
+TransferWindow::transfer_refused(uint64_t transfer_id, uint64_t unacked)
+{
+    unacked_bytes_ -= std::min(unacked, unacked_bytes_);
+
+    segments_.erase(std::remove_if(segments_.begin(), segments_.end(),
+                                   [transfer_id](const Segment& seg) {
+                                       return seg.transfer_id_ == transfer_id;
+                                   }),
+                    segments_.end());
+}
+
+//----------------------------------------------------------------------
+uint64_t
+TransferWindow::window_bytes() const
+{
+    return (uint64_t)(2 * ack_rate_ * min_rtt_us_ / 1000000);
+}
+
+//----------------------------------------------------------------------
+bool
+TransferWindow::open(size_t num_inflight, size_t min_inflight, uint64_t max_bytes) const
+{
+    if (num_inflight < min_inflight) {
+        return true;
+    }
+
+    if ((max_bytes != 0) && (unacked_bytes_ >= max_bytes)) {
+        return false;
+    }
+
+    return unacked_bytes_ < window_bytes();
+}
+
+//----------------------------------------------------------------------
+uint64_t
+TransferWindow::segment_length(uint64_t max_len) const
+{
+    if ((ack_rate_ == 0) || (min_rtt_us_ == 0)) {
+        return max_len;
+    }
+
+    uint64_t len = (uint64_t)(ack_rate_ * min_rtt_us_ / 1000000) / SEGMENTS_PER_RTT;
+    len = std::max(len, MIN_SEGMENT_LENGTH);
+    return std::min(len, max_len);
+}
+
+} // namespace dtn
@@ -0,0 +1,131 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _TRANSFER_WINDOW_H_
+#define _TRANSFER_WINDOW_H_
+
+#include <deque>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace dtn {
+
+/**
+ * Sender side estimate of how much a TCPCLv4 session can keep in
+ * flight.
+ *
+ * The window follows every XFER_SEGMENT from the time it is queued
+ * until its XFER_ACK comes back. From that it keeps the bytes sent but
+ * not yet acknowledged, the smallest round trip time seen recently and
+ * the rate at which the peer acknowledges data. Twice the product of
+ * the two is the amount of data the session may have outstanding, so
+ * on a long delay path the sender keeps starting transfers while the
+ * acks of the earlier ones are still on their way, and the window
+ * grows with the ack rate until the path (or the byte limit) is full.
+ *
+ * The same estimates size the segments: about a quarter of a round
+ * trip worth of data each, so a slow session gets finer grained acks
+ * while a fast one sends segments as large as the peer accepts.
+ *
+ * Times are microseconds from an arbitrary origin, passed in by the
+ * caller so the window can also be driven from a simulated clock.
+ * Not thread safe; a connection only touches it from its own thread.
+ */
+class TransferWindow {
+public:
+    TransferWindow();
+
+    /// Microseconds on the monotonic clock
+    static uint64_t now_us();
+
+    /**
+     * Note that a segment ending at end_offset of the transfer was
+     * queued for transmission.
+     */
+    void segment_sent(uint64_t transfer_id, uint64_t end_offset,
+                      uint64_t len, uint64_t now);
+
+    /**
+     * Note an XFER_ACK for the transfer up to acked_len that
+     * acknowledged newly_acked bytes not acknowledged before.
+     */
+    void segment_acked(uint64_t transfer_id, uint64_t acked_len,
+                       uint64_t newly_acked, uint64_t now);
+
+    /**
+     * Forget a transfer the peer refused, whose unacked bytes will
+     * never be acknowledged.
+     */
+    void transfer_refused(uint64_t transfer_id, uint64_t unacked);
+
+    /**
+     * Whether another transfer may be started.
+     *
+     * @param num_inflight  transfers currently in flight
+     * @param min_inflight  transfers always allowed regardless of the estimate
+     * @param max_bytes     limit on the unacknowledged bytes (0 for none)
+     */
+    bool open(size_t num_inflight, size_t min_inflight, uint64_t max_bytes) const;
+
+    /**
+     * Length of the next segment, between MIN_SEGMENT_LENGTH and
+     * max_len (which is already limited to the peer's segment MRU).
+     * Until there is an estimate this is max_len.
+     */
+    uint64_t segment_length(uint64_t max_len) const;
+
+    /// Bytes of the window given the current estimates (0 if none yet)
+    uint64_t window_bytes() const;
+
+    uint64_t unacked_bytes() const { return unacked_bytes_; }
+    uint64_t min_rtt_us()    const { return min_rtt_us_; }
+    uint64_t ack_rate()      const { return (uint64_t)ack_rate_; }
+
+    /// Smallest segment length the window picks
+    static const uint64_t MIN_SEGMENT_LENGTH = 64 * 1024;
+
+    /// Segments per round trip the segment length aims for
+    static const uint64_t SEGMENTS_PER_RTT = 4;
+
+    /// How long a minimum round trip time sample is trusted
+    static const uint64_t MIN_RTT_LIFETIME_US = 10 * 1000 * 1000;
+
+    /// Shortest interval over which the ack rate is sampled
+    static const uint64_t MIN_RATE_INTERVAL_US = 10 * 1000;
+
+protected:
+    /// A segment waiting for its ack
+    struct Segment {
+        uint64_t transfer_id_;
+        uint64_t end_offset_;
+        uint64_t sent_us_;
+    };
+
+    std::deque<Segment> segments_;      ///< in the order they were sent
+
+    uint64_t unacked_bytes_;            ///< sent but not yet acknowledged
+    uint64_t min_rtt_us_;               ///< smallest recent round trip (0 if none)
+    uint64_t min_rtt_stamp_us_;         ///< when min_rtt_us_ was taken
+    double   ack_rate_;                 ///< smoothed bytes per second acknowledged
+    uint64_t rate_start_us_;            ///< start of the current rate sample (0 if none)
+    uint64_t rate_bytes_;               ///< bytes acknowledged since rate_start_us_
+    uint64_t last_ack_us_;              ///< time of the last ack
+};
+
+} // namespace dtn
+
+#endif /* _TRANSFER_WINDOW_H_ */
@@ -69,6 +69,7 @@ UDPConvergenceLayer::Params::serialize(oasys::SerializeAction *a)
     a->process("bucket_depth", &bucket_depth_);
     a->process("recvbuf", &recvbuf_);
     a->process("sendbuf", &sendbuf_);
+    a->process("batch", &batch_);
 
     if (a->action_code() == oasys::Serialize::UNMARSHAL) {
         bucket_type_ = (oasys::RateLimitedSocket::BUCKET_TYPE) temp;
@@ -88,6 +89,7 @@ UDPConvergenceLayer::UDPConvergenceLayer()
     defaults_.bucket_depth_             = 0; // default
     defaults_.recvbuf_                  = 0; // OS managed
     defaults_.sendbuf_                  = 0; // OS managed
+    defaults_.batch_                    = 32;
     next_hop_addr_                      = INADDR_NONE;
     next_hop_port_                      = 0;
 //    next_hop_flags_                     = 0;
@@ -125,11 +127,17 @@ UDPConvergenceLayer::parse_params(Params* params,
     p.addopt(new oasys::UInt64Opt("bucket_depth", &params->bucket_depth_));
     p.addopt(new oasys::UIntOpt("recvbuf", &params->recvbuf_));
     p.addopt(new oasys::UIntOpt("sendbuf", &params->sendbuf_));
+    p.addopt(new oasys::UIntOpt("batch", &params->batch_));
 
     if (! p.parse(argc, argv, invalidp)) {
         return false;
     }
 
+    if (params->batch_ == 0 || params->batch_ > MAX_BATCH) {
+        *invalidp = "batch";
+        return false;
+    }
+
     params->bucket_type_ = (oasys::RateLimitedSocket::BUCKET_TYPE) temp;
 
     return true;
@@ -150,6 +158,7 @@ UDPConvergenceLayer::list_link_opts(oasys::StringBuffer& buf)
     buf.appendf("    bucket_type <0 or 1>               - Throttle token bucket type: 0=standard, 1=leaky (default: 0)\n");
     buf.appendf("    bucket_depth <U64>                 - Throttle token bucket depth in bits (default: 524280 = 64K * 8)\n");
     buf.appendf("    sendbuf <U32>                      - Size of socket send buffer in bytes (default: 0 = OS managed)\n");
+    buf.appendf("    batch <U32>                        - Max bundles sent with one system call (default: 32, max: %u)\n", MAX_BATCH);
 
 
     buf.appendf("\nOptions for all links:\n");
@@ -194,6 +203,8 @@ UDPConvergenceLayer::list_interface_opts(oasys::StringBuffer& buf)
     buf.appendf("    remote_addr <IP address>           - Only accept packets from specified IP address (usually not needed)\n");
     buf.appendf("    remote_port <U16>                  - Only accept packets from specified port (usually not needed)\n");
     buf.appendf("    recvbuf <U32>                      - Size of socket receive buffer in bytes (default: 0 = OS managed)\n");
+    buf.appendf("    batch <U32>                        - Max packets received with one system call (default: 32, max: %u)\n", MAX_BATCH);
+    buf.appendf("                                           (each takes a 64 KB receive buffer)\n");
 
     buf.appendf("\n");
     buf.appendf("Example:\n");
@@ -289,8 +300,9 @@ UDPConvergenceLayer::dump_interface(Interface* iface,
 {
     Params* params = &((Receiver*)iface->cl_info())->cla_params_;
     
-    buf->appendf("\tlocal_addr: %s local_port: %d  recvbuf: %u\n",
-                 intoa(params->local_addr_), params->local_port_, params->recvbuf_);
+    buf->appendf("\tlocal_addr: %s local_port: %d  recvbuf: %u  batch: %u\n",
+                 intoa(params->local_addr_), params->local_port_, params->recvbuf_,
+                 params->batch_);
     
     if (params->remote_addr_ != INADDR_NONE) {
         buf->appendf("\tconnected remote_addr: %s remote_port: %d\n",
@@ -377,6 +389,7 @@ UDPConvergenceLayer::dump_link(const LinkRef& link, oasys::StringBuffer* buf)
     buf->appendf("rate: %" PRIu64 " (%s)\n", params->rate_, FORMAT_AS_RATE(params->rate_).c_str());
     buf->appendf("bucket_depth: %" PRIu64 "\n", params->bucket_depth_);
     buf->appendf("sendbuf: %u\n", params->sendbuf_);
+    buf->appendf("batch: %u\n", params->batch_);
 }
 
 //----------------------------------------------------------------------
@@ -494,20 +507,10 @@ UDPConvergenceLayer::bundle_queued_orig(const LinkRef& link, const BundleRef& bu
     }
 
     if (link->get_contact_state()) {
-        BundleRef lbundle = link->queue()->front();
         ASSERT(contact == sender->contact_);
 
-        int len = sender->send_bundle(lbundle, next_hop_addr_, next_hop_port_);
-
-        if (len > 0) {
-            link->del_from_queue(lbundle);
-            link->add_to_inflight(lbundle);
-
-            BundleTransmittedEvent* event_to_post;
-            event_to_post = new BundleTransmittedEvent(lbundle.object(), contact, link, 
-                                                       len, 0, true, false);
-            SPtr_BundleEvent sptr_event_to_post(event_to_post);
-            BundleDaemon::post(sptr_event_to_post);
+        if (sender->next_batch() > 0) {
+            sender->send_batch();
         }
     }
 }
@@ -559,8 +562,7 @@ UDPConvergenceLayer::Receiver::process_data(u_char* bp, size_t len)
         SPtr_EID sptr_dummy_prevhop = BD_MAKE_EID_NULL();
         BundleReceivedEvent* event_to_post;
         event_to_post = new BundleReceivedEvent(bundle, EVENTSRC_PEER, len, sptr_dummy_prevhop);
-        SPtr_BundleEvent sptr_event_to_post(event_to_post);
-        BundleDaemon::post(sptr_event_to_post);
+        rcvd_events_.push_back(SPtr_BundleEvent(event_to_post));
     } else {
         bdaemon->release_bundle_without_bref_reserved_space(bundle);
 
@@ -578,6 +580,52 @@ UDPConvergenceLayer::Receiver::run()
    
 
     int ret;
+
+#ifdef __linux__
+    u_int batch = cla_params_.batch_;
+
+    // a ring of full sized buffers, one per datagram of a batch
+    std::unique_ptr<u_char[]> bufs(new u_char[batch * MAX_UDP_PACKET]);
+    std::vector<struct iovec> iovs(batch);
+    std::vector<struct mmsghdr> msgs(batch);
+
+    for (u_int i = 0; i < batch; ++i) {
+        iovs[i].iov_base = bufs.get() + (i * MAX_UDP_PACKET);
+        iovs[i].iov_len  = MAX_UDP_PACKET;
+
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov    = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    rcvd_events_.reserve(batch);
+
+    while (!should_stop()) {
+        // block for the first datagram and then take whatever else
+        // is already queued on the socket
+        ret = recvmmsg(msgs.data(), batch, MSG_WAITFORONE);
+
+        if (ret <= 0) {   
+            if (errno == EINTR) {
+                continue;
+            }
+            log_err("error in recvmmsg(): %d %s",
+                    errno, strerror(errno));
+            close();
+            break;
+        }
+        
+        for (int i = 0; i < ret; ++i) {
+            process_data((u_char*)iovs[i].iov_base, msgs[i].msg_len);
+        }
+
+        if (!rcvd_events_.empty()) {
+            BundleDaemon::post_batch(rcvd_events_);
+            rcvd_events_.clear();
+        }
+    }
+#else
+    // no recvmmsg() here so it is one datagram per call
     in_addr_t addr;
     u_int16_t port;
     u_char buf[MAX_UDP_PACKET];
@@ -595,10 +643,14 @@ UDPConvergenceLayer::Receiver::run()
             break;
         }
         
-        //log_debug("got %d byte packet from %s:%d",
-        //          ret, intoa(addr), port);               
         process_data(buf, ret);
+
+        if (!rcvd_events_.empty()) {
+            BundleDaemon::post_batch(rcvd_events_);
+            rcvd_events_.clear();
+        }
     }
+#endif
 }
 
 //----------------------------------------------------------------------
@@ -611,6 +663,7 @@ UDPConvergenceLayer::Sender::Sender(const LinkRef& link, const ContactRef& conta
       link_(link.object(), "UDPCovergenceLayer::Sender"),
       contact_(contact.object(), "UDPCovergenceLayer::Sender")
 {
+    memset(&xmit_addr_, 0, sizeof(xmit_addr_));
 }
 
 UDPConvergenceLayer::Sender::~Sender()
@@ -632,6 +685,16 @@ UDPConvergenceLayer::Sender::init(Params* params,
     cla_params_ = params;
     next_hop_addr_ = addr;
     next_hop_port_ = port;
+
+    xmit_addr_.sin_family      = AF_INET;
+    xmit_addr_.sin_addr.s_addr = addr;
+    xmit_addr_.sin_port        = htons(port);
+
+    xmit_bundles_.reserve(params->batch_);
+    xmit_msgs_.resize(params->batch_);
+    for (u_int i = 0; i < params->batch_; ++i) {
+        xmit_iovs_.emplace_back(new BundleIOVec());
+    }
     
     socket_.logpathf("%s/conn/%s:%d", logpath_, intoa(addr), port);
     socket_.set_logfd(false);
@@ -678,12 +741,11 @@ UDPConvergenceLayer::Sender::init(Params* params,
 }
     
 //----------------------------------------------------------------------
-int
-UDPConvergenceLayer::Sender::send_bundle(const BundleRef& bundle, in_addr_t next_hop_addr, u_int16_t next_hop_port)
+size_t
+UDPConvergenceLayer::Sender::format_bundle(const BundleRef& bundle, BundleIOVec* iov)
 {
     oasys::ScopeLock scoplok(bundle->lock(), __func__);
 
-    int cc = 0;
 //    SPtr_BlockInfoVec sptr_blocks = bundle->xmit_blocks()->find_blocks(contact_->link());
     SPtr_BlockInfoVec sptr_blocks = bundle->xmit_blocks()->find_blocks(link_);
     ASSERT(sptr_blocks != nullptr);
@@ -691,38 +753,132 @@ UDPConvergenceLayer::Sender::send_bundle(const BundleRef& bundle, in_addr_t next
     scoplok.unlock();
 
 
+    // check the length up front so an oversized payload doesn't get
+    // mapped in just to be thrown away
+    size_t formatted_len = BundleProtocol::total_length(bundle.object(), sptr_blocks.get());
+    if (formatted_len > UDPConvergenceLayer::MAX_BUNDLE_LEN) {
+        log_err("format_bundle: bundle too big (%zu > %u)",
+                formatted_len, UDPConvergenceLayer::MAX_BUNDLE_LEN);
+        return 0;
+    }
+
     bool complete = false;
-    size_t total_len = BundleProtocol::produce(bundle.object(), sptr_blocks.get(),
-                                               buf_, 0, sizeof(buf_),
-                                               &complete);
+    iov->clear();
+    size_t total_len = BundleProtocol::produce_iov(bundle.object(), sptr_blocks.get(),
+                                                   0, formatted_len, iov,
+                                                   &complete);
+    ASSERT(complete && total_len == formatted_len);
 
-    scoplok.unlock();
+    return total_len;
+}
 
-    if (!complete) {
-        size_t formatted_len = BundleProtocol::total_length(bundle.object(), sptr_blocks.get());
-        log_err("send_bundle: bundle too big (%zu > %u)",
-                formatted_len, UDPConvergenceLayer::MAX_BUNDLE_LEN);
-        return -1;
+//----------------------------------------------------------------------
+size_t
+UDPConvergenceLayer::Sender::next_batch()
+{
+    const BundleList* queue = link_->queue();
+
+    oasys::ScopeLock l(queue->lock(), "UDPConvergenceLayer::Sender::next_batch");
+
+    BundleList::iterator iter = queue->begin();
+    while ((iter != queue->end()) && (xmit_bundles_.size() < cla_params_->batch_)) {
+        xmit_bundles_.push_back(BundleRef(*iter, "UdpClaSender"));
+        ++iter;
     }
-        
-    // write it out the socket and make sure we wrote it all
-    if(cla_params_->rate_ > 0) {
-        cc = rate_socket_->sendto((char*)buf_, total_len, 0, next_hop_addr, next_hop_port, true);
-    } else {
-        cc = socket_.sendto((char*)buf_, total_len, 0, next_hop_addr, next_hop_port);
+
+    return xmit_bundles_.size();
+}
+
+//----------------------------------------------------------------------
+void
+UDPConvergenceLayer::Sender::send_batch()
+{
+    // gather every bundle of the batch up to the first that can't be
+    // sent, which is left at the front of the queue as before
+    size_t num_msgs = 0;
+    while (num_msgs < xmit_bundles_.size()) {
+        BundleIOVec* iov = xmit_iovs_[num_msgs].get();
+        if (format_bundle(xmit_bundles_[num_msgs], iov) == 0) {
+            break;
+        }
+
+        struct msghdr* msg = &xmit_msgs_[num_msgs].msg_hdr;
+        memset(msg, 0, sizeof(*msg));
+        msg->msg_name    = &xmit_addr_;
+        msg->msg_namelen = sizeof(xmit_addr_);
+        msg->msg_iov     = const_cast<struct iovec*>(iov->iov());
+        msg->msg_iovlen  = iov->iovcnt();
+        xmit_msgs_[num_msgs].msg_len = 0;
+
+        ++num_msgs;
     }
 
-    //int cc = socket_.write((char*)buf_, total_len);
-    if (cc == (int)total_len) {
-        log_info("send_bundle: successfully sent bundle (id:%" PRIbid ") length %d", 
-                 bundle.object()->bundleid(), cc);
-        return total_len;
-    } else {
-        log_err("send_bundle: error sending bundle (id:%" PRIbid ") (wrote %d/%zu): %s",
-                bundle.object()->bundleid(), 
-                cc, total_len, strerror(errno));
-        return -1;
+    // write them out the socket; the rate limited socket has to meter
+    // each datagram out on its own
+    size_t num_sent = 0;
+    while (num_sent < num_msgs) {
+        int cc;
+        if (cla_params_->rate_ > 0) {
+            cc = rate_socket_->sendmsg(&xmit_msgs_[num_sent].msg_hdr, 0, true);
+            if (cc >= 0) {
+                xmit_msgs_[num_sent].msg_len = cc;
+                cc = 1;
+            }
+        } else {
+#ifdef __linux__
+            cc = socket_.sendmmsg(&xmit_msgs_[num_sent], num_msgs - num_sent, 0);
+#else
+            cc = socket_.sendmsg(&xmit_msgs_[num_sent].msg_hdr, 0);
+            if (cc >= 0) {
+                xmit_msgs_[num_sent].msg_len = cc;
+                cc = 1;
+            }
+#endif
+        }
+
+        if (cc <= 0) {
+            log_err("send_batch: error sending bundle (id:%" PRIbid ") (wrote %d/%zu): %s",
+                    xmit_bundles_[num_sent]->bundleid(),
+                    cc, xmit_iovs_[num_sent]->length(), strerror(errno));
+            break;
+        }
+        num_sent += cc;
+    }
+
+    std::vector<SPtr_BundleEvent> events;
+    events.reserve(num_sent);
+
+    for (size_t i = 0; i < num_sent; ++i) {
+        BundleRef& bref = xmit_bundles_[i];
+        size_t len = xmit_iovs_[i]->length();
+
+        if (xmit_msgs_[i].msg_len != len) {
+            log_err("send_batch: error sending bundle (id:%" PRIbid ") (wrote %u/%zu)",
+                    bref->bundleid(), xmit_msgs_[i].msg_len, len);
+            continue;
+        }
+
+        log_info("send_batch: successfully sent bundle (id:%" PRIbid ") length %zu", 
+                 bref->bundleid(), len);
+
+        link_->del_from_queue(bref);
+        link_->add_to_inflight(bref);
+
+        BundleTransmittedEvent* event_to_post;
+        event_to_post = new BundleTransmittedEvent(bref.object(), contact_, link_, 
+                                                   len, 0, true, false);
+        events.push_back(SPtr_BundleEvent(event_to_post));
+    }
+
+    if (!events.empty()) {
+        BundleDaemon::post_batch(events);
     }
+
+    // release the payload views as soon as the datagrams are out
+    for (size_t i = 0; i < num_msgs; ++i) {
+        xmit_iovs_[i]->clear();
+    }
+    xmit_bundles_.clear();
 }
 
 //----------------------------------------------------------------------
@@ -733,31 +889,9 @@ UDPConvergenceLayer::Sender::run()
     pthread_setname_np(pthread_self(), threadname);
    
 
-    int len = 0;
-    BundleRef bref("UdpClaSender");
-
     while (!should_stop()) {
-        if (link_->get_contact_state()) {
-            bref = link_->queue()->front();
-
-            if (bref != nullptr) {
-                len = send_bundle(bref, next_hop_addr_, next_hop_port_);
-
-                if (len > 0) {
-                    link_->del_from_queue(bref);
-                    link_->add_to_inflight(bref);
-
-                    BundleTransmittedEvent* event_to_post;
-                    event_to_post = new BundleTransmittedEvent(bref.object(), contact_, link_, 
-                                                               len, 0, true, false);
-                    SPtr_BundleEvent sptr_event_to_post(event_to_post);
-                    BundleDaemon::post(sptr_event_to_post);
-                }
-            } else {
-                usleep(10000);
-            }
-
-            bref = nullptr;
+        if (link_->get_contact_state() && (next_batch() > 0)) {
+            send_batch();
         } else {
             usleep(10000);
         }
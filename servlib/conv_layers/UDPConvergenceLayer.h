@@ -35,11 +35,16 @@
 #ifndef _UDP_CONVERGENCE_LAYER_H_
 #define _UDP_CONVERGENCE_LAYER_H_
 
+#include <memory>
+#include <vector>
+
 #include <third_party/oasys/io/UDPClient.h>
 #include <third_party/oasys/thread/Thread.h>
 #include <third_party/oasys/io/RateLimitedSocket.h>
 
 #include "IPConvergenceLayer.h"
+#include "bundling/BundleEvent.h"
+#include "bundling/BundleIOVec.h"
 
 namespace dtn {
 
@@ -54,6 +59,12 @@ public:
      * Default port used by the udp cl.
      */
     static const u_int16_t UDPCL_DEFAULT_PORT = 4556;
+
+    /**
+     * Largest number of datagrams moved by one recvmmsg() or
+     * sendmmsg() call (the kernel's UIO_MAXIOV).
+     */
+    static const u_int MAX_BATCH = 1024;
     
     /**
      * Constructor.
@@ -144,6 +155,7 @@ public:
         uint64_t  bucket_depth_;	///< Token bucket depth (in bits)
         uint32_t  recvbuf_;         ///< Size for the socket receive buffer in bytes
         uint32_t  sendbuf_;         ///< Size for the socket send buffer in bytes
+        uint32_t  batch_;           ///< Max datagrams per recvmmsg() / sendmmsg()
 
         oasys::RateLimitedSocket::BUCKET_TYPE bucket_type_;         ///< bucket type for standard or leaky
     };
@@ -182,9 +194,11 @@ protected:
         virtual ~Receiver() {}
         
         /**
-         * Loop forever, issuing blocking calls to IPSocket::recvfrom(),
-         * then calling the process_data function when new data does
-         * arrive
+         * Loop forever, issuing blocking calls to IPSocket::recvmmsg()
+         * that take up to batch_ datagrams at a time, then calling the
+         * process_data function on each one and posting the received
+         * bundles to the daemon together. Without recvmmsg() (anything
+         * but Linux) it falls back to one recvfrom() per datagram.
          * 
          * Note that unlike in the Thread base class, this run() method is
          * public in case we don't want to actually create a new thread
@@ -196,9 +210,13 @@ protected:
         
     protected:
         /**
-         * Handler to process an arrived packet.
+         * Handler to process an arrived packet. The event for the
+         * bundle is added to rcvd_events_.
          */
         void process_data(u_char* bp, size_t len);
+
+        /// Events for the bundles of the current batch
+        std::vector<SPtr_BundleEvent> rcvd_events_;
     };
 
     /*
@@ -232,10 +250,24 @@ protected:
         void run() override;
 
         /**
-         * Send one bundle.
-         * @return the length of the bundle sent or -1 on error
+         * Take up to batch_ bundles from the front of the link queue
+         * into xmit_bundles_ (leaving them on the queue).
+         * @return the number of bundles taken
          */
-        int send_bundle(const BundleRef& bundle, in_addr_t next_hop_addr, u_int16_t next_hop_port);
+        size_t next_batch();
+
+        /**
+         * Send the bundles in xmit_bundles_, as many as possible with
+         * a single sendmmsg(). Those that go out are moved to the
+         * inflight list; the rest stay at the front of the queue.
+         */
+        void send_batch();
+
+        /**
+         * Gather the formatted bundle into iov.
+         * @return the length of the bundle or 0 if it can't be sent
+         */
+        size_t format_bundle(const BundleRef& bundle, BundleIOVec* iov);
 
         /**
          * Pointer to the link parameters.
@@ -268,12 +300,30 @@ protected:
          */
         ContactRef contact_;
 
+        /// Destination address of every datagram
+        struct sockaddr_in xmit_addr_;
+
+        /// Bundles of the batch being sent
+        std::vector<BundleRef> xmit_bundles_;
+
         /**
-         * Temporary buffer for formatting bundles. Note that the
-         * fixed-length buffer is big enough since UDP packets can't
-         * be any bigger than that.
+         * Segments of each bundle of the batch, gathered straight from
+         * the block contents and the payload by sendmmsg().
          */
-        u_char buf_[UDPConvergenceLayer::MAX_BUNDLE_LEN];
+        std::vector<std::unique_ptr<BundleIOVec>> xmit_iovs_;
+
+#ifdef __linux__
+        typedef struct mmsghdr xmit_msg_t;
+#else
+        /// Stand-in for struct mmsghdr where there is no sendmmsg()
+        struct xmit_msg_t {
+            struct msghdr msg_hdr;
+            unsigned int  msg_len;
+        };
+#endif
+
+        /// One message header per bundle of the batch
+        std::vector<xmit_msg_t> xmit_msgs_;
 
     };   
 };
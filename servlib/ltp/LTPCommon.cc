@@ -22,6 +22,7 @@
 #include <inttypes.h>
 
 #include <errno.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/time.h>
@@ -2983,15 +2984,14 @@ int LTPSegment::Parse_Buffer(u_char * bp, size_t length, size_t * byte_offset)
     // Or at least parse off the front end to get the session and source. 
     //  Then add it to an existing session map or create a new one then add.
 
-    // this should pull the engine id from and returns bytes used
-    decode_status = SDNV::decode(bp+current_byte, length-current_byte, &engine_id_);
+    // pull the engine id and session id from the buffer
+    u_int64_t ids[2];
+    decode_status = SDNV::decode_n(bp+current_byte, length-current_byte, ids, 2);
 
     CHECK_DECODE_STATUS
 
-    // this should pull the session id from the buffer
-    decode_status = SDNV::decode(bp+current_byte, length-current_byte, &session_id_); 
-
-    CHECK_DECODE_STATUS
+    engine_id_  = ids[0];
+    session_id_ = ids[1];
 
     // pull off each nibble and make int.
     //
@@ -3169,14 +3169,14 @@ bool LTPSegment::Parse_Engine_and_Session(u_char * bp, size_t length, uint64_t&
     uint8_t seg_type_flags = bp[0];
     seg_type = LTPSegment::SegTypeFlags_to_SegType(seg_type_flags);
 
-    decode_status = SDNV::decode(bp+current_byte, length-current_byte, &engine_id);
-    if (decode_status > 0)
-        current_byte += decode_status;
-    else
+    u_int64_t ids[2];
+    decode_status = SDNV::decode_n(bp+current_byte, length-current_byte, ids, 2);
+    if (decode_status < 0)
         return false;
 
-    decode_status = SDNV::decode(bp+current_byte, length-current_byte, &session_id);
-    return (decode_status > 0);
+    engine_id  = ids[0];
+    session_id = ids[1];
+    return true;
 }
 
 //----------------------------------------------------------------------
@@ -3785,6 +3785,63 @@ LTPDataSegment::asNewString()
     return result;
 }
 
+//-----------------------------------------------------------------
+bool
+LTPDataSegment::asIOVecs(u_char* hdr_buf, size_t hdr_buf_len, struct iovec iov[2])
+{
+    if (packet_len_ > hdr_buf_len) {
+        return false;
+    }
+
+    const u_char* payload = payload_;
+    if (sptr_file_) {
+        payload = map_seg_from_file();
+        if (payload == nullptr) {
+            return false;
+        }
+    }
+
+    memcpy(hdr_buf, packet_.buf(), packet_len_);
+
+    iov[0].iov_base = hdr_buf;
+    iov[0].iov_len  = packet_len_;
+    iov[1].iov_base = const_cast<u_char*>(payload);
+    iov[1].iov_len  = payload_length_;
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+const u_char*
+LTPDataSegment::map_seg_from_file()
+{
+    oasys::ScopeLock scoplok(&sptr_file_->lock_, __func__);
+
+    // map the whole file once and let every segment reference it
+    if (!sptr_file_->map_ && !sptr_file_->map_failed_) {
+        struct stat st;
+        if ((sptr_file_->data_file_fd_ < 0) ||
+            (::fstat(sptr_file_->data_file_fd_, &st) != 0) || (st.st_size == 0))
+        {
+            sptr_file_->map_failed_ = true;
+        } else {
+            sptr_file_->map_.reset(new oasys::MmapFile("/dtn/ltp/datafile/map"));
+            if (sptr_file_->map_->map_fd(sptr_file_->data_file_fd_, PROT_READ, MAP_SHARED,
+                                         st.st_size) == nullptr) {
+                sptr_file_->map_.reset();
+                sptr_file_->map_failed_ = true;
+            } else {
+                ::madvise(sptr_file_->map_->ptr(), st.st_size, MADV_SEQUENTIAL);
+            }
+        }
+    }
+
+    if (!sptr_file_->map_ || (offset_ + payload_length_ > sptr_file_->map_->len())) {
+        return nullptr;
+    }
+
+    return (const u_char*)sptr_file_->map_->ptr() + offset_;
+}
 
 //----------------------------------------------------------------------
 bool
@@ -3826,14 +3883,18 @@ int LTPDataSegment::Parse_Buffer(u_char * bp, size_t length)
     {
         segment_type_ = LTP_SEGMENT_DS;
 
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &client_service_id_);
+        u_int64_t fields[3];
+        decode_status = SDNV::decode_n(bp+current_byte, length-current_byte, fields, 3);
         CHECK_DECODE_STATUS
 
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &offset_);
-        CHECK_DECODE_STATUS
+        if (fields[0] > 0xffffffffLL) {
+            is_valid_ = false;
+            return -1;
+        }
 
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &payload_length_);
-        CHECK_DECODE_STATUS
+        client_service_id_ = fields[0];
+        offset_            = fields[1];
+        payload_length_    = fields[2];
 
         start_byte_ = offset_;
         stop_byte_  = offset_ + payload_length_ - 1;
@@ -3842,11 +3903,11 @@ int LTPDataSegment::Parse_Buffer(u_char * bp, size_t length)
 
             if (is_checkpoint_)  // this is a checkpoint segment so it should contain these two entries.
             {
-                decode_status = SDNV::decode(bp+current_byte, length-current_byte, &checkpoint_id_);
+                decode_status = SDNV::decode_n(bp+current_byte, length-current_byte, fields, 2);
                 CHECK_DECODE_STATUS
 
-                decode_status = SDNV::decode(bp+current_byte, length-current_byte, &serial_number_);
-                CHECK_DECODE_STATUS
+                checkpoint_id_ = fields[0];
+                serial_number_ = fields[1];
             }
         }
         
@@ -4009,30 +4070,25 @@ int LTPReportSegment::Parse_Buffer(u_char * bp, size_t length)
         logpathf("/ltp/seg/%s/%lu-%lu", Get_Seg_Str(), engine_id_, session_id_);
 
 
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &serial_number_);
+        u_int64_t fields[5];
+        decode_status = SDNV::decode_n(bp+current_byte, length-current_byte, fields, 5);
         CHECK_DECODE_STATUS
 
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &checkpoint_id_);
-        CHECK_DECODE_STATUS
-        
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &upper_bounds_);
-        CHECK_DECODE_STATUS
-        
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &lower_bounds_);
-        CHECK_DECODE_STATUS
-        
-        decode_status = SDNV::decode(bp+current_byte, length-current_byte, &claims_);
-        CHECK_DECODE_STATUS
+        serial_number_ = fields[0];
+        checkpoint_id_ = fields[1];
+        upper_bounds_  = fields[2];
+        lower_bounds_  = fields[3];
+        claims_        = fields[4];
 
         SPtr_LTPReportClaim rc;
         for(ctr = 0 ; ctr < (int) claims_ ; ctr++) {// step through the claims
 
-            decode_status = SDNV::decode(bp+current_byte, length-current_byte, &reception_offset);
-            CHECK_DECODE_STATUS
-            
-            decode_status = SDNV::decode(bp+current_byte, length-current_byte, &reception_length);
+            decode_status = SDNV::decode_n(bp+current_byte, length-current_byte, fields, 2);
             CHECK_DECODE_STATUS
 
+            reception_offset = fields[0];
+            reception_length = fields[1];
+
             rc = std::make_shared<LTPReportClaim>(reception_offset,reception_length);
             claim_map_[rc->Offset()] = rc;
 
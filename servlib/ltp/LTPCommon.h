@@ -28,11 +28,14 @@
 #include <map>
 #include <stdio.h>
 #include <stdlib.h>     /* malloc, free, rand */
+#include <memory>
 #include <string>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 
 #include <third_party/oasys/io/FileIOClient.h>
+#include <third_party/oasys/io/MmapFile.h>
 #include <third_party/oasys/thread/Timer.h>
 #include <third_party/oasys/thread/Thread.h>
 #include <third_party/oasys/util/Time.h>
@@ -103,6 +106,11 @@ struct LTPDataFile {
     oasys::SpinLock lock_;
     //std::fstream data_file_;
     int data_file_fd_ = -1;         ///< Handle for the data file if in use
+
+    /// Read only mapping of the file that outgoing segments are sent
+    /// from, set up the first time one of them is transmitted
+    std::unique_ptr<oasys::MmapFile> map_;
+    bool map_failed_ = false;       ///< don't try to map the file again
 };
 
 typedef std::shared_ptr<LTPDataFile> SPtr_LTPDataFile;
@@ -471,6 +479,24 @@ public:
      */
     std::string* asNewString() override; ///< return then packet header plus payload as a string for transmission
 
+    /**
+     * Points iov at the bytes to transmit for this segment without
+     * copying the payload, which is referenced where it lives: in
+     * memory or in a read only mapping of the session's data file.
+     * The header is copied into hdr_buf because the LTPEngine may
+     * re-encode it as a checkpoint once the segment lock is released.
+     *
+     * The caller must hold the segment lock and keep a reference to
+     * the segment until the bytes have been sent.
+     *
+     * @param hdr_buf Buffer for the header
+     * @param hdr_buf_len Length of hdr_buf
+     * @param iov Filled in with the header and the payload
+     * @return false if the header does not fit or the payload cannot be
+     *         mapped, in which case asNewString() is still available
+     */
+    bool asIOVecs(u_char* hdr_buf, size_t hdr_buf_len, struct iovec iov[2]);
+
     u_char* Payload() { return payload_; }      ///< return a pointer to the payload data
     u_char* Release_Payload();                  ///< release the payload to the caller to lifetime manage
     void    Set_Payload(u_char* payload);       ///< take over lifetime management of the provided payload
@@ -525,6 +551,7 @@ protected:
     LTPDataSegment& operator= ( LTPDataSegment& ) = delete;
 
     bool read_seg_from_file(u_char* buf, size_t buf_len);
+    const u_char* map_seg_from_file();
 
 protected:
 
@@ -19,6 +19,7 @@
 #  include <dtn-config.h>
 #endif
 
+#include <algorithm>
 #include <inttypes.h>
 
 #include <errno.h>
@@ -69,6 +70,8 @@ LTPEngineReg::~LTPEngineReg()
 
 
 
+const size_t LTPEngine::MAX_RECV_SHARDS;
+
 //----------------------------------------------------------------------
 LTPEngine::LTPEngine(uint64_t local_engine_id) 
      : Logger("LTPEngine::", "/dtn/ltpeng")
@@ -76,8 +79,52 @@ LTPEngine::LTPEngine(uint64_t local_engine_id)
     local_engine_id_ = local_engine_id;
     session_id_ = 0;
 
-    data_processor_ = std::unique_ptr<RecvDataProcessor>(new RecvDataProcessor());
-    data_processor_->start();
+    data_processors_[0] = std::unique_ptr<RecvDataProcessor>(new RecvDataProcessor(0));
+    data_processors_[0]->start();
+    num_data_processors_ = 1;
+}
+
+//----------------------------------------------------------------------
+void
+LTPEngine::set_recv_shards(size_t num_shards)
+{
+    oasys::ScopeLock scoplok(&data_processors_lock_, __func__);
+
+    num_shards = std::min(num_shards, MAX_RECV_SHARDS);
+
+    size_t num_running = num_data_processors_;
+    if (num_shards <= num_running) {
+        return;
+    }
+
+    for (size_t shard = num_running; shard < num_shards; ++shard) {
+        data_processors_[shard] = std::unique_ptr<RecvDataProcessor>(new RecvDataProcessor(shard));
+        data_processors_[shard]->start();
+    }
+
+    // post_data only looks at processors below the count so they
+    // must all be in place before it goes up
+    num_data_processors_.store(num_shards, std::memory_order_release);
+
+    log_always("LTPEngine receiving with %zu shards", num_shards);
+}
+
+//----------------------------------------------------------------------
+size_t
+LTPEngine::recv_shard(uint64_t engine_id, uint64_t session_id, size_t num_shards)
+{
+    if (num_shards <= 1) {
+        return 0;
+    }
+
+    // session IDs are mostly sequential so mix the bits before taking
+    // the modulus to spread them evenly
+    uint64_t hash = (engine_id * 0x9e3779b97f4a7c15ULL) ^ session_id;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+
+    return hash % num_shards;
 }
 
 //----------------------------------------------------------------------
@@ -159,11 +206,13 @@ LTPEngine::start_shutdown()
 void
 LTPEngine::shutdown()
 {
-    // stop the incoming data processor
+    // stop the incoming data processors
     // (interface receiving packets should have already been shutdown)
-    if (data_processor_ != nullptr) {
-        data_processor_->shutdown();
-        data_processor_ = nullptr;
+    for (size_t shard = 0; shard < MAX_RECV_SHARDS; ++shard) {
+        if (data_processors_[shard] != nullptr) {
+            data_processors_[shard]->shutdown();
+            data_processors_[shard] = nullptr;
+        }
     }
 
 
@@ -185,7 +234,23 @@ LTPEngine::shutdown()
 void
 LTPEngine::post_data(u_char* buffer, size_t length)
 {
-    data_processor_->post_data(buffer, length);
+    size_t num_shards = num_data_processors_.load(std::memory_order_acquire);
+    size_t shard = 0;
+
+    if (num_shards > 1) {
+        // keep each session on one processor - anything that does not
+        // parse is left for the first one to reject
+        uint64_t engine_id = 0;
+        uint64_t session_id = 0;
+        int seg_type = 0;
+
+        if ((length > 1) && ((buffer[0] & 0xf0) == 0) &&
+            LTPSegment::Parse_Engine_and_Session(buffer, length, engine_id, session_id, seg_type)) {
+            shard = recv_shard(engine_id, session_id, num_shards);
+        }
+    }
+
+    data_processors_[shard]->post_data(buffer, length);
 }
 
 //-------------------------------------------------------------3---------
@@ -358,9 +423,9 @@ LTPEngine::send_bundle(const BundleRef& bundle, uint64_t engine)
 }
 
 //----------------------------------------------------------------------
-LTPEngine::RecvDataProcessor::RecvDataProcessor()
+LTPEngine::RecvDataProcessor::RecvDataProcessor(size_t shard)
     : Logger("LTPEngine::RecvDataProcessor",
-             "/dtn/ltp/rcvdata"),
+             "/dtn/ltp/rcvdata/%zu", shard),
       Thread("LTPEngine::RecvDataProcessor")
 {
 }
@@ -484,6 +549,8 @@ LTPEngine::RecvDataProcessor::run()
             if (engptr != nullptr) {
                 // pass the received data on to the correct LTPNode
                 event->seg_type_ = seg_type;
+                event->engine_id_ = engine_id;
+                event->session_id_ = session_id;
 
                 // LTP_Node will delete the event...
                 engptr->LTP_Node()->post_data(event);
@@ -744,10 +811,18 @@ LTPNode::Receiver::Receiver(LTPNode* parent_node, SPtr_LTPCLSenderIF sptr_clsend
       sptr_clsender_(sptr_clsender),
       parent_node_(parent_node)
 {
-    memset(&stats_, 0, sizeof(stats_));
+    stats_.clear();
 
-    seg_processor_ = QPtr_RecvSegProcessor(new RecvSegProcessor(this, sptr_clsender_->Remote_Engine_ID()));
-    seg_processor_->start();
+    // as many shards as the LTP engine is receiving with so that
+    // independent sessions are processed in parallel
+    size_t num_shards = std::max(parent_node_->ltp_engine_sptr_->recv_shards(), (size_t)1);
+
+    for (size_t shard = 0; shard < num_shards; ++shard) {
+        session_shards_.push_back(QPtr_SessionShard(new SessionShard()));
+
+        seg_processors_.push_back(QPtr_RecvSegProcessor(new RecvSegProcessor(this, sptr_clsender_->Remote_Engine_ID(), shard)));
+        seg_processors_.back()->start();
+    }
 
     bundle_processor_ = QPtr_RecvBundleProcessor(new RecvBundleProcessor(this, sptr_clsender_->Remote_Engine_ID()));
     bundle_processor_->start();
@@ -769,7 +844,9 @@ LTPNode::Receiver::~Receiver()
     shutdown();
 
     /* ---- cleanup sessions -----*/
-    incoming_sessions_.clear();
+    for (QPtr_SessionShard& sess_shard : session_shards_) {
+        sess_shard->incoming_sessions_.clear();
+    }
 }
 
 //----------------------------------------------------------------------
@@ -779,8 +856,10 @@ LTPNode::Receiver::start_shutdown()
     // signal to start discarding all segments
     start_shutting_down_ = true;
 
-    // signal seg processor to start discarding queued segments
-    seg_processor_->start_shutdown();
+    // signal seg processors to start discarding queued segments
+    for (QPtr_RecvSegProcessor& seg_processor : seg_processors_) {
+        seg_processor->start_shutdown();
+    }
 
     cancel_all_sessions();
 
@@ -801,9 +880,11 @@ LTPNode::Receiver::shutdown()
     set_should_stop();
 
     // do not accept/process any new segments
-    seg_processor_->shutdown();
-    while (!seg_processor_->is_stopped()) {
-        usleep(100000);
+    for (QPtr_RecvSegProcessor& seg_processor : seg_processors_) {
+        seg_processor->shutdown();
+        while (!seg_processor->is_stopped()) {
+            usleep(100000);
+        }
     }
 
     // wait for the bundle processing thread to complete queued up data
@@ -816,7 +897,7 @@ LTPNode::Receiver::shutdown()
         usleep(100000);
     }
 
-    seg_processor_.reset();
+    seg_processors_.clear();
     bundle_processor_.reset();
     sptr_clsender_.reset();
     sptr_blank_session_.reset();
@@ -831,7 +912,9 @@ LTPNode::Receiver::reconfigured()
     retran_interval_     = sptr_clsender_->Retran_Intvl();
     inactivity_interval_ = sptr_clsender_->Inactivity_Intvl();
 
-    seg_processor_->reconfigured();
+    for (QPtr_RecvSegProcessor& seg_processor : seg_processors_) {
+        seg_processor->reconfigured();
+    }
     bundle_processor_->reconfigured();
 }
 
@@ -849,22 +932,25 @@ LTPNode::Receiver::post_data(LTPDataReceivedEvent* event)
     int32_t recv_test = sptr_clsender_->Recv_Test();
     bool okay_to_process = true;
 
+    size_t packet_num = packets_received_++;
     if (recv_test > 0) {
-        okay_to_process = ((packets_received_ % (uint32_t)recv_test) != (uint32_t)(recv_test - 1));
+        okay_to_process = ((packet_num % (uint32_t)recv_test) != (uint32_t)(recv_test - 1));
     }
-    ++packets_received_;
 
 
     if (okay_to_process) {
+        size_t shard = LTPEngine::recv_shard(event->engine_id_, event->session_id_,
+                                             seg_processors_.size());
+
         switch (event->seg_type_) {
             case LTP_SEGMENT_DS:
-                seg_processor_->post_ds(event);
+                seg_processors_[shard]->post_ds(event);
                 break;
 
             case LTP_SEGMENT_RAS:
             case LTP_SEGMENT_CS_BS:
             case LTP_SEGMENT_CAS_BR:
-                seg_processor_->post_admin(event);
+                seg_processors_[shard]->post_admin(event);
                 break;
 
             default:
@@ -993,9 +1079,14 @@ LTPNode::Receiver::RSIF_closeout_timer_triggered(uint64_t engine_id, uint64_t se
     ASSERT(engine_id == sptr_clsender_->Remote_Engine_ID());
 
     // remove from closed sessions
-    oasys::ScopeLock scoplok(&session_list_lock_, __func__);
+    SessionShard* sess_shard = session_shard(engine_id, session_id);
+
+    oasys::ScopeLock scoplok(&sess_shard->lock_, __func__);
 
-    closed_session_map_.erase(session_id);
+    if (sess_shard->closed_session_map_.erase(session_id) > 0) {
+        oasys::ScopeLock countlok(&session_list_lock_, __func__);
+        --num_closed_sessions_;
+    }
 }
 
 
@@ -1113,32 +1204,39 @@ LTPNode::Receiver::dump_sessions(oasys::StringBuffer* buf)
         return;
     }
 
-    oasys::ScopeLock scoplok(&session_list_lock_, __func__);
+    do {
+        oasys::ScopeLock scoplok(&session_list_lock_, __func__);
 
-    buf->appendf("\nReceiver Sessions: Total: %zu  (States- DS: %zu  RS: %zu  CS: %zu - Closing: %zu)\n",
-                 incoming_sessions_.size(), sessions_state_ds_, sessions_state_rs_, sessions_state_cs_,
-                 closed_session_map_.size());
+        buf->appendf("\nReceiver Sessions: Total: %zu  (States- DS: %zu  RS: %zu  CS: %zu - Closing: %zu)\n",
+                     num_incoming_sessions_, sessions_state_ds_, sessions_state_rs_, sessions_state_cs_,
+                     num_closed_sessions_);
+    } while (false);  // just limiting the scopelock
 
 
-    if (sptr_clsender_->Dump_Sessions() && (incoming_sessions_.size() > 0)) {
+    if (sptr_clsender_->Dump_Sessions() && (num_incoming_sessions_ > 0)) {
         buf->append("Receiver Session List:\n");
 
         SPtr_LTPSession sptr_session;
-        SESS_SPTR_MAP::iterator iter = incoming_sessions_.begin();
 
-        while (iter != incoming_sessions_.end())
-        {
-            sptr_session = iter->second;
+        for (QPtr_SessionShard& sess_shard : session_shards_) {
+            oasys::ScopeLock scoplok(&sess_shard->lock_, __func__);
 
-            buf->appendf("    %s [%s]  red segs: %zu  rcvd bytes: %zu of %zu  EOB rcvd: %s  contig blocks: %zu\n",
-                         sptr_session->key_str().c_str(), sptr_session->Get_Session_State(),
-                         sptr_session->Red_Segments()->size(),
-                         sptr_session->Red_Bytes_Received(),
-                         sptr_session->Expected_Red_Bytes(),
-                         sptr_session->Is_EOB_Defined()?"true":"false",
-                         sptr_session->get_num_red_contiguous_bloks());
+            SESS_SPTR_MAP::iterator iter = sess_shard->incoming_sessions_.begin();
 
-            ++iter;
+            while (iter != sess_shard->incoming_sessions_.end())
+            {
+                sptr_session = iter->second;
+
+                buf->appendf("    %s [%s]  red segs: %zu  rcvd bytes: %zu of %zu  EOB rcvd: %s  contig blocks: %zu\n",
+                             sptr_session->key_str().c_str(), sptr_session->Get_Session_State(),
+                             sptr_session->Red_Segments()->size(),
+                             sptr_session->Red_Bytes_Received(),
+                             sptr_session->Expected_Red_Bytes(),
+                             sptr_session->Is_EOB_Defined()?"true":"false",
+                             sptr_session->get_num_red_contiguous_bloks());
+
+                ++iter;
+            }
         }
         buf->append("\n");
     }
@@ -1155,12 +1253,27 @@ LTPNode::Receiver::dump_sessions(oasys::StringBuffer* buf)
     size_t bundle_bytes_queued_max = 0;
     size_t bundle_quota = 0;
 
-    seg_processor_->get_queue_stats(seg_queue_size, seg_bytes_queued, seg_bytes_queued_max, seg_bytes_quota, seg_ds_discards);
+    // totals across the shards
+    for (QPtr_RecvSegProcessor& seg_processor : seg_processors_) {
+        size_t queue_size = 0;
+        size_t bytes_queued = 0;
+        size_t bytes_queued_max = 0;
+        size_t bytes_quota = 0;
+        size_t ds_discards = 0;
+
+        seg_processor->get_queue_stats(queue_size, bytes_queued, bytes_queued_max, bytes_quota, ds_discards);
+
+        seg_queue_size       += queue_size;
+        seg_bytes_queued     += bytes_queued;
+        seg_bytes_queued_max += bytes_queued_max;
+        seg_bytes_quota      += bytes_quota;
+        seg_ds_discards      += ds_discards;
+    }
     bundle_processor_->get_queue_stats(bundle_queue_size, bundle_bytes_queued, bundle_bytes_queued_max, bundle_quota);
 
-    buf->appendf("Receiver threads: SegProcessor: queued: %zu  bytes: %zu (%s)  max bytes: %zu (%s)   quota: %zu (%s)  DS discards: %zu\n"
+    buf->appendf("Receiver threads: SegProcessor (%zu): queued: %zu  bytes: %zu (%s)  max bytes: %zu (%s)   quota: %zu (%s)  DS discards: %zu\n"
                  "               BundleProcessor: queued: %zu  bytes: %zu (%s)  max bytes: %zu (%s)\n",
-                 seg_queue_size, 
+                 seg_processors_.size(), seg_queue_size, 
                  seg_bytes_queued, 
                  FORMAT_WITH_MAG(seg_bytes_queued).c_str(),
                  seg_bytes_queued_max,
@@ -1191,10 +1304,10 @@ LTPNode::Receiver::dump_success_stats(oasys::StringBuffer* buf)
                //Receiver 1234567890 / 1234  12345678  123456789012 / 1234567890  1234567890 / 12345678  1234567890  1234567890
 
     buf->appendf("Receiver %10" PRIu64 " / %4" PRIu64 "  %8" PRIu64 "  %12" PRIu64 " / %10" PRIu64 "  %10" PRIu64 " / %8" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "\n", 
-                 stats_.total_sessions_, stats_.max_sessions_,
-                 stats_.ds_sessions_with_resends_, stats_.total_ds_unique_, stats_.total_ds_duplicate_,
-                 stats_.total_rs_segs_generated_, stats_.rs_segment_resends_, stats_.total_rcv_ra_,
-                 stats_.bundles_success_);
+                 stats_.total_sessions_.load(), stats_.max_sessions_.load(),
+                 stats_.ds_sessions_with_resends_.load(), stats_.total_ds_unique_.load(), stats_.total_ds_duplicate_.load(),
+                 stats_.total_rs_segs_generated_.load(), stats_.rs_segment_resends_.load(), stats_.total_rcv_ra_.load(),
+                 stats_.bundles_success_.load());
 }
 
 //----------------------------------------------------------------------
@@ -1211,17 +1324,50 @@ LTPNode::Receiver::dump_cancel_stats(oasys::StringBuffer* buf)
                //Sender   1234567890 / 1234567890  1234567890 / 1234567890  1234567890  1234567890  1234567890  1234567890  1234567890
                //Receiver 1234567890 / 1234567890  1234567890 / 1234567890  1234567890  1234567890  1234567890  1234567890  1234567890
     buf->appendf("Receiver %10" PRIu64 " / %10" PRIu64 "  %10" PRIu64 " / %10" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "  %10" PRIu64 "\n",
-                 stats_.cancel_by_sndr_sessions_, stats_.cancel_by_sndr_segs_, 
-                 stats_.cancel_by_rcvr_sessions_, stats_.cancel_by_rcvr_segs_, stats_.total_sent_and_rcvd_ca_, 
-                 stats_.session_cancelled_but_got_it_, stats_.RAS_not_received_but_got_bundles_,
-                 stats_.bundles_expired_in_queue_, stats_.bundles_failed_ );
+                 stats_.cancel_by_sndr_sessions_.load(), stats_.cancel_by_sndr_segs_.load(), 
+                 stats_.cancel_by_rcvr_sessions_.load(), stats_.cancel_by_rcvr_segs_.load(), stats_.total_sent_and_rcvd_ca_.load(), 
+                 stats_.session_cancelled_but_got_it_.load(), stats_.RAS_not_received_but_got_bundles_.load(),
+                 stats_.bundles_expired_in_queue_.load(), stats_.bundles_failed_.load() );
 }
 
 //----------------------------------------------------------------------
 void
 LTPNode::Receiver::clear_statistics()
 {
-    memset(&stats_, 0, sizeof(stats_));
+    stats_.clear();
+}
+
+//----------------------------------------------------------------------
+void
+LTPNode::Receiver::Stats::clear()
+{
+    total_sessions_ = 0;
+    max_sessions_ = 0;
+
+    ds_sessions_with_resends_ = 0;
+    total_rcv_ds_ = 0;
+    total_ds_unique_ = 0;
+    total_ds_duplicate_ = 0;
+    ds_segment_resends_ = 0;
+
+    total_rs_segs_generated_ = 0;
+    rs_segment_resends_ = 0;
+    total_rcv_ra_ = 0;
+
+    bundles_success_ = 0;
+
+    cancel_by_sndr_sessions_ = 0;
+    cancel_by_sndr_segs_ = 0;
+
+    cancel_by_rcvr_sessions_ = 0;
+    cancel_by_rcvr_segs_ = 0;
+    total_sent_and_rcvd_ca_ = 0;
+
+    session_cancelled_but_got_it_ = 0;
+    RAS_not_received_but_got_bundles_ = 0;
+
+    bundles_expired_in_queue_ = 0;
+    bundles_failed_ = 0;
 }
 
 //----------------------------------------------------------------------
@@ -1313,24 +1459,26 @@ LTPNode::Receiver::build_CS_segment(LTPSegment* seg_ptr, int segment_type, u_cha
 void
 LTPNode::Receiver::cancel_all_sessions()
 {
-    oasys::ScopeLock scoplok(&session_list_lock_, __func__);
-
     SPtr_LTPSession sptr_session;
-    SESS_SPTR_MAP::iterator iter = incoming_sessions_.begin();
-
     size_t num_cancelled = 0;
 
-    while (iter != incoming_sessions_.end())
-    {
-        sptr_session = iter->second;
+    for (QPtr_SessionShard& sess_shard : session_shards_) {
+        oasys::ScopeLock scoplok(&sess_shard->lock_, __func__);
 
-        if (!sptr_session->Is_LTP_Cancelled()) {
-            build_CS_segment(sptr_session.get(), LTP_SEGMENT_CS_BR, 
-                             LTPCancelSegment::LTP_CS_REASON_SYS_CNCLD);
-            ++num_cancelled;
-        }
+        SESS_SPTR_MAP::iterator iter = sess_shard->incoming_sessions_.begin();
 
-        ++iter;
+        while (iter != sess_shard->incoming_sessions_.end())
+        {
+            sptr_session = iter->second;
+
+            if (!sptr_session->Is_LTP_Cancelled()) {
+                build_CS_segment(sptr_session.get(), LTP_SEGMENT_CS_BR, 
+                                 LTPCancelSegment::LTP_CS_REASON_SYS_CNCLD);
+                ++num_cancelled;
+            }
+
+            ++iter;
+        }
     }
 
     log_always("LTPEngine::Receiver(%zu) cancelled %zu sesssions while shutting down",
@@ -1361,10 +1509,12 @@ LTPNode::Receiver::find_incoming_session(LTPSegment* seg_ptr, bool create_flag,
 
     SPtr_LTPSession sptr_session;
 
-    oasys::ScopeLock scoplok(&session_list_lock_, __func__);
+    SessionShard* sess_shard = session_shard(seg_ptr->Engine_ID(), seg_ptr->Session_ID());
+
+    oasys::ScopeLock scoplok(&sess_shard->lock_, __func__);
 
-    CLOSED_SESSION_MAP::iterator closed_iter = closed_session_map_.find(seg_ptr->Session_ID());
-    if (closed_iter != closed_session_map_.end()) {
+    CLOSED_SESSION_MAP::iterator closed_iter = sess_shard->closed_session_map_.find(seg_ptr->Session_ID());
+    if (closed_iter != sess_shard->closed_session_map_.end()) {
         closed = true;
         closed_session_size = closed_iter->second;
         cancelled = (closed_session_size == 0);
@@ -1390,10 +1540,13 @@ LTPNode::Receiver::find_incoming_session(LTPSegment* seg_ptr, bool create_flag,
                     sptr_session->set_file_usage(sptr_clsender_->Dir_Path(), run_with_disk_io_kludges);
                 }
 
-                incoming_sessions_[sptr_session.get()] = sptr_session;
+                sess_shard->incoming_sessions_[sptr_session.get()] = sptr_session;
 
-                if (incoming_sessions_.size() > stats_.max_sessions_) {
-                    stats_.max_sessions_ = incoming_sessions_.size();
+                oasys::ScopeLock countlok(&session_list_lock_, __func__);
+
+                ++num_incoming_sessions_;
+                if (num_incoming_sessions_ > stats_.max_sessions_) {
+                    stats_.max_sessions_ = num_incoming_sessions_;
                 }
                 ++stats_.total_sessions_;
             }
@@ -1413,10 +1566,12 @@ LTPNode::Receiver::find_incoming_session(uint64_t engine_id, uint64_t session_id
 
     SESS_SPTR_MAP::iterator iter; 
 
-    oasys::ScopeLock scoplok(&session_list_lock_, __func__);
+    SessionShard* sess_shard = session_shard(engine_id, session_id);
+
+    oasys::ScopeLock scoplok(&sess_shard->lock_, __func__);
 
-    iter = incoming_sessions_.find(qkey.get());
-    if (iter != incoming_sessions_.end())
+    iter = sess_shard->incoming_sessions_.find(qkey.get());
+    if (iter != sess_shard->incoming_sessions_.end())
     {
         sptr_session = iter->second;
     }
@@ -1424,6 +1579,13 @@ LTPNode::Receiver::find_incoming_session(uint64_t engine_id, uint64_t session_id
     return sptr_session;
 }
 
+//----------------------------------------------------------------------
+LTPNode::Receiver::SessionShard*
+LTPNode::Receiver::session_shard(uint64_t engine_id, uint64_t session_id)
+{
+    return session_shards_[LTPEngine::recv_shard(engine_id, session_id, session_shards_.size())].get();
+}
+
 //----------------------------------------------------------------------
 void
 LTPNode::Receiver::erase_incoming_session(LTPSession* session_ptr)
@@ -1432,9 +1594,11 @@ LTPNode::Receiver::erase_incoming_session(LTPSession* session_ptr)
     SPtr_LTPNodeRcvrSndrIF rcvr_if = parent_node_->receiver_rsif_sptr();
     session_ptr->Start_Closeout_Timer(rcvr_if, inactivity_interval_);
 
-    oasys::ScopeLock scoplok(&session_list_lock_, __func__);
+    SessionShard* sess_shard = session_shard(session_ptr->Engine_ID(), session_ptr->Session_ID());
+
+    oasys::ScopeLock scoplok(&sess_shard->lock_, __func__);
 
-    incoming_sessions_.erase(session_ptr);
+    size_t num_erased = sess_shard->incoming_sessions_.erase(session_ptr);
 
     uint64_t session_size = 0;  // 0 indicates session was cancelled
     if (!session_ptr->Is_LTP_Cancelled()) {
@@ -1444,10 +1608,23 @@ LTPNode::Receiver::erase_incoming_session(LTPSession* session_ptr)
     // this changes the session state so it must be after checking for cancelled
     update_session_counts(session_ptr, LTPSession::LTP_SESSION_STATE_UNDEFINED); 
 
-    closed_session_map_[session_ptr->Session_ID()] = session_size;
+    auto closed_result = sess_shard->closed_session_map_.insert(
+                             std::make_pair(session_ptr->Session_ID(), session_size));
+    bool newly_closed = closed_result.second;
+    if (!newly_closed) {
+        closed_result.first->second = session_size;
+    }
 
-    if (closed_session_map_.size() > max_closed_sessions_) {
-        max_closed_sessions_ = closed_session_map_.size();
+    // the shard lock is always taken before this one
+    oasys::ScopeLock countlok(&session_list_lock_, __func__);
+
+    num_incoming_sessions_ -= num_erased;
+    if (newly_closed) {
+        ++num_closed_sessions_;
+    }
+
+    if (num_closed_sessions_ > max_closed_sessions_) {
+        max_closed_sessions_ = num_closed_sessions_;
     }
 }
 
@@ -2519,15 +2696,16 @@ LTPNode::Receiver::RecvBundleProcessor::is_bibe_with_custody_transfer(Bundle* bu
 
 
 //----------------------------------------------------------------------
-LTPNode::Receiver::RecvSegProcessor::RecvSegProcessor(Receiver* parent_rcvr, uint64_t engine_id)
+LTPNode::Receiver::RecvSegProcessor::RecvSegProcessor(Receiver* parent_rcvr, uint64_t engine_id, size_t shard)
     : Logger("LTPNode::Receiver::RecvSegProcessor",
-             "/dtn/ltp/node/%lu/rcvr/segproc", engine_id),
+             "/dtn/ltp/node/%lu/rcvr/segproc/%zu", engine_id, shard),
       Thread("LTPNode::Receiver::RecvSegProcessor"),
       eventq_admin_(logpath_),
       eventq_ds_(logpath_)
 {
     parent_rcvr_ = parent_rcvr;
-    queued_bytes_quota_  = parent_rcvr_->ltp_queued_bytes_quota();
+
+    // queued_bytes_quota_ is set by the Receiver's reconfigured() once all of the shards exist
 }
 
 //----------------------------------------------------------------------
@@ -2576,7 +2754,8 @@ LTPNode::Receiver::RecvSegProcessor::shutdown()
 void
 LTPNode::Receiver::RecvSegProcessor::reconfigured()
 {
-    queued_bytes_quota_  = parent_rcvr_->ltp_queued_bytes_quota();
+    // the shards split the quota between them
+    queued_bytes_quota_  = parent_rcvr_->ltp_queued_bytes_quota() / parent_rcvr_->seg_processors_.size();
 }
 
 //----------------------------------------------------------------------
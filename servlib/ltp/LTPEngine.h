@@ -23,6 +23,7 @@
 #endif
 
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <limits.h>
@@ -31,6 +32,7 @@
 #include <stdarg.h>
 #include <time.h>
 #include <unistd.h>
+#include <vector>
 #include <sys/types.h>
 #include <sys/syscall.h>
 
@@ -85,6 +87,8 @@ struct LTPDataReceivedEvent {
     int  seg_type_  = -1;
     bool closed_    = false;
     bool cancelled_ = false;
+    uint64_t engine_id_  = 0;   ///< session originator as parsed by the RecvDataProcessor
+    uint64_t session_id_ = 0;
 };
 
 class LTPEngine : public oasys::Logger
@@ -129,6 +133,22 @@ public:
     virtual void post_data(u_char * buffer, size_t length);
     virtual int64_t send_bundle(const BundleRef& bundle, uint64_t engine);
 
+    /// Most receive shards an interface can ask for
+    static const size_t MAX_RECV_SHARDS = 8;
+
+    /**
+     * Run enough RecvDataProcessor threads to service the given
+     * number of receive shards (never fewer than are already running)
+     */
+    virtual void   set_recv_shards(size_t num_shards);
+    virtual size_t recv_shards() { return num_data_processors_; }
+
+    /**
+     * The shard that all segments of a session are processed on so
+     * that a session is only ever worked on by one thread at a time
+     */
+    static size_t recv_shard(uint64_t engine_id, uint64_t session_id, size_t num_shards);
+
     virtual SPtr_LTPEngineReg lookup_engine(uint64_t engine);
     virtual SPtr_LTPEngineReg lookup_engine(uint64_t engine, uint64_t session, bool& closed, bool& cancelled);
    
@@ -179,7 +199,7 @@ private:
     {
         public:
 
-            RecvDataProcessor();
+            RecvDataProcessor(size_t shard);
             virtual ~RecvDataProcessor();
             virtual void shutdown();
 
@@ -202,8 +222,11 @@ private:
     };
     
 
-    std::unique_ptr<RecvDataProcessor> data_processor_;
-
+    /// One processor per receive shard with received data dispatched
+    /// to them by session
+    std::unique_ptr<RecvDataProcessor> data_processors_[MAX_RECV_SHARDS];
+    std::atomic<size_t> num_data_processors_;
+    oasys::SpinLock data_processors_lock_;
 
 };
 
@@ -376,7 +399,7 @@ protected:
         {
         public:
 
-            RecvSegProcessor(Receiver* parent_rcvr, uint64_t engine_id);
+            RecvSegProcessor(Receiver* parent_rcvr, uint64_t engine_id, size_t shard);
             virtual ~RecvSegProcessor();
             void run();
             void start_shutdown();
@@ -456,14 +479,30 @@ protected:
 
 
 
-        QPtr_RecvSegProcessor seg_processor_;
+        /// One processor per receive shard with each session's
+        /// segments always going to the same one
+        std::vector<QPtr_RecvSegProcessor> seg_processors_;
         QPtr_RecvBundleProcessor bundle_processor_;
 
     protected:
 
-        /// Lock to protect internal data structures and state.
+        /// Lock to protect the session counts and statistics shared by the shards
         oasys::SpinLock session_list_lock_;
 
+        typedef std::map<uint64_t, uint64_t>  CLOSED_SESSION_MAP;
+
+        /// The incoming and closed sessions that hash to a receive shard
+        struct SessionShard {
+            oasys::SpinLock    lock_;
+            SESS_SPTR_MAP      incoming_sessions_;
+            CLOSED_SESSION_MAP closed_session_map_;     ///< map of closed sessions and the size of the sessions if not cancelled else zero
+        };
+        typedef std::unique_ptr<SessionShard> QPtr_SessionShard;
+
+        std::vector<QPtr_SessionShard> session_shards_;
+
+        virtual SessionShard*      session_shard(uint64_t engine_id, uint64_t session_id);
+
         virtual SPtr_LTPSession    find_incoming_session(LTPSegment* seg_ptr, bool create_flag, 
                                                          bool& closed, size_t& closed_session_size, bool& cancelled);
         virtual SPtr_LTPSession    find_incoming_session(uint64_t engine_id, uint64_t session_id);
@@ -475,8 +514,6 @@ protected:
         virtual void build_CS_segment(LTPSegment* seg_ptr, int segment_type, u_char reason_code);
         virtual void build_CAS_for_CSS(LTPCancelSegment* seg);
 
-        SESS_SPTR_MAP           incoming_sessions_;
-
         /**
          * Handler to process an arrived packet.
          */
@@ -495,36 +532,39 @@ protected:
         uint32_t inactivity_interval_ = 30;   // seconds
 
         /// Statistics structure definition
+        /// (atomic since the receive shards all update them)
         struct Stats {
             // success oriented stats
-            uint64_t total_sessions_;
-            uint64_t max_sessions_;
+            std::atomic<uint64_t> total_sessions_;
+            std::atomic<uint64_t> max_sessions_;
 
-            uint64_t ds_sessions_with_resends_;
-            uint64_t total_rcv_ds_;
-            uint64_t total_ds_unique_;
-            uint64_t total_ds_duplicate_;
-            uint64_t ds_segment_resends_;
+            std::atomic<uint64_t> ds_sessions_with_resends_;
+            std::atomic<uint64_t> total_rcv_ds_;
+            std::atomic<uint64_t> total_ds_unique_;
+            std::atomic<uint64_t> total_ds_duplicate_;
+            std::atomic<uint64_t> ds_segment_resends_;
 
-            uint64_t total_rs_segs_generated_;
-            uint64_t rs_segment_resends_;
-            uint64_t total_rcv_ra_;
+            std::atomic<uint64_t> total_rs_segs_generated_;
+            std::atomic<uint64_t> rs_segment_resends_;
+            std::atomic<uint64_t> total_rcv_ra_;
 
-            uint64_t bundles_success_;
+            std::atomic<uint64_t> bundles_success_;
 
             // cancel oriented stats
-            uint64_t cancel_by_sndr_sessions_;
-            uint64_t cancel_by_sndr_segs_;
+            std::atomic<uint64_t> cancel_by_sndr_sessions_;
+            std::atomic<uint64_t> cancel_by_sndr_segs_;
 
-            uint64_t cancel_by_rcvr_sessions_;
-            uint64_t cancel_by_rcvr_segs_;
-            uint64_t total_sent_and_rcvd_ca_;
+            std::atomic<uint64_t> cancel_by_rcvr_sessions_;
+            std::atomic<uint64_t> cancel_by_rcvr_segs_;
+            std::atomic<uint64_t> total_sent_and_rcvd_ca_;
 
-            uint64_t session_cancelled_but_got_it_;
-            uint64_t RAS_not_received_but_got_bundles_;
+            std::atomic<uint64_t> session_cancelled_but_got_it_;
+            std::atomic<uint64_t> RAS_not_received_but_got_bundles_;
 
-            uint64_t bundles_expired_in_queue_;
-            uint64_t bundles_failed_;
+            std::atomic<uint64_t> bundles_expired_in_queue_;
+            std::atomic<uint64_t> bundles_failed_;
+
+            void clear();
         };
 
         bool start_shutting_down_ = false;
@@ -536,8 +576,8 @@ protected:
         size_t eventq_bytes_ = 0;
         size_t eventq_bytes_max_ = 0;
 
-        size_t packets_received_ = 0;
-        size_t packets_dropped_for_recv_test_ = 0;
+        std::atomic<size_t> packets_received_{0};
+        std::atomic<size_t> packets_dropped_for_recv_test_{0};
 
         SPtr_LTPSession sptr_blank_session_;
         /// Stats instance
@@ -549,8 +589,8 @@ protected:
         size_t sessions_state_rs_ = 0;
         size_t sessions_state_cs_ = 0;
 
-        typedef std::map<uint64_t, uint64_t>  CLOSED_SESSION_MAP;
-        CLOSED_SESSION_MAP closed_session_map_;     ///< map of closed sessions and the size of the sessions if not cancelled else zero
+        size_t num_incoming_sessions_ = 0;
+        size_t num_closed_sessions_ = 0;
         size_t max_closed_sessions_ = 0;
     };
 
@@ -36,7 +36,10 @@
 #  include <dtn-config.h>
 #endif
 
+#include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
+#include <unistd.h>
 
 #include "BundleStore.h"
 #include "bundling/Bundle.h"
@@ -301,6 +304,66 @@ BundleStore::release_payload_space(u_int64_t durable_size)
     total_size_lock_.unlock();
 }
 
+//----------------------------------------------------------------------
+void
+BundleStore::payload_file_created(const std::string& dir, bool new_dir)
+{
+    oasys::ScopeLock l(&payload_dirs_lock_, "BundleStore::payload_file_created");
+    payload_dirs_.insert(dir);
+    if (new_dir) {
+        payload_dirs_.insert(cfg_.payload_dir_);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BundleStore::sync_payload_dirs(bool sync)
+{
+    std::set<std::string> dirs;
+    payload_dirs_lock_.lock("BundleStore::sync_payload_dirs");
+    dirs.swap(payload_dirs_);
+    payload_dirs_lock_.unlock();
+
+    if (!sync) {
+        return;
+    }
+
+    std::set<std::string>::iterator iter;
+    for (iter = dirs.begin(); iter != dirs.end(); ++iter) {
+        int fd = open(iter->c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            // the directory is removed once its last payload is deleted
+            if (errno != ENOENT) {
+                log_err_p("/dtn/storage/bundles", "error opening payload dir %s: %s",
+                          iter->c_str(), strerror(errno));
+            }
+            continue;
+        }
+
+        if (fsync(fd) != 0) {
+            log_err_p("/dtn/storage/bundles", "error syncing payload dir %s: %s",
+                      iter->c_str(), strerror(errno));
+        }
+        ::close(fd);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BundleStore::lock_db_access(const char* lockedby)
+{
+    lock_.lock(lockedby);
+    bundles_.lock()->lock(lockedby);
+}
+
+//----------------------------------------------------------------------
+void
+BundleStore::unlock_db_access()
+{
+    bundles_.lock()->unlock();
+    lock_.unlock();
+}
+
 //----------------------------------------------------------------------
 BundleStore::iterator*
 BundleStore::new_iterator()
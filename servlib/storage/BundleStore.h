@@ -35,6 +35,9 @@
 #ifndef _BUNDLE_STORE_H_
 #define _BUNDLE_STORE_H_
 
+#include <set>
+#include <string>
+
 #include <third_party/oasys/debug/DebugUtils.h>
 #include <third_party/oasys/serialize/TypeShims.h>
 #include <third_party/oasys/storage/DurableStore.h>
@@ -93,6 +96,14 @@ public:
     /// Delete the bundle
     bool del(bundleid_t bundleid, u_int64_t durable_size);
 
+    /// Take the locks used to access the bundle table. A caller that
+    /// adds or updates a bundle takes them before the bundle's lock
+    /// to keep the same lock order as the other table users.
+    void lock_db_access(const char* lockedby);
+
+    /// Release the bundle table locks
+    void unlock_db_access();
+
     /// Return a new iterator
     iterator* new_iterator();
         
@@ -108,6 +119,16 @@ public:
     /// Decrement the total size in use
     void release_payload_space(u_int64_t payload_size);
 
+    /// Note that a payload file was created in dir, and if new_dir is
+    /// set that dir was itself just created in the payload directory
+    void payload_file_created(const std::string& dir, bool new_dir);
+
+    /// fsync each directory that payload files have been created in
+    /// since the last call once, so that the files of the bundles being
+    /// added to the database can't be lost from their directories. If
+    /// sync is false the directories are just forgotten.
+    void sync_payload_dirs(bool sync);
+
     /// @{ Accessors
     const std::string& payload_dir()     { return cfg_.payload_dir_; }
     u_int64_t          payload_quota()   { return cfg_.payload_quota_; }
@@ -142,6 +163,9 @@ protected:
 
 
     mutable oasys::SpinLock total_size_lock_;       ///< Lock for accessing the total_size_ variable
+
+    std::set<std::string> payload_dirs_; ///< Payload dirs with new entries
+    oasys::SpinLock payload_dirs_lock_;  ///< Lock for payload_dirs_
 };
 
 } // namespace dtn
@@ -93,7 +93,8 @@ GlobalStore* GlobalStore::instance_;
 GlobalStore::GlobalStore()
     : Logger("GlobalStore", "/dtn/storage/%s", GLOBAL_TABLE),
       globals_(NULL), store_(NULL),
-      needs_update_(false)
+      needs_update_(false),
+      db_access_lock_(&table_lock_)
 {
     lock_ = new oasys::Mutex(logpath_,
                              oasys::Mutex::TYPE_RECURSIVE,
@@ -140,6 +141,8 @@ GlobalStore::do_init(const oasys::StorageConfig& cfg,
         return err;
     }
 
+    db_access_lock_ = store->table_access_lock(&table_lock_);
+
     // if we're initializing the database for the first time, then we
     // prime the values accordingly and sync the database version
     if (cfg.init_) 
@@ -451,14 +454,14 @@ GlobalStore::close()
 void 
 GlobalStore::lock_db_access(const char* lockedby )
 {
-  db_access_lock_.lock(lockedby);
+  db_access_lock_->lock(lockedby);
 }
 
 //----------------------------------------------------------------------
 void
 GlobalStore::unlock_db_access()
 {
-  db_access_lock_.unlock();
+  db_access_lock_->unlock();
 }
 
 
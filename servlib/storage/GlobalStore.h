@@ -142,12 +142,13 @@ public:
     void close();
 
     /**
-     * Lock to synchronize database access between BundleDaemonStorage and GlobalStore
+     * Lock access to the globals table (the other tables are locked
+     * by their InternalKeyDurableTable on each access)
      */
      void lock_db_access(const char* lockedby);
 
     /**
-     * Release lock to synchronize database access
+     * Release the globals table lock
      */
     void unlock_db_access();
 
@@ -182,8 +183,11 @@ protected:
     /// flag indicating if a database update is needed
     bool needs_update_;
 
-    /// control db access between the BundleDaemonStorage and the GlobalStore
-    mutable oasys::SpinLock db_access_lock_;
+    /// the globals table's own lock
+    oasys::SpinLock table_lock_;
+
+    /// table_lock_ or the store's shared lock if tables can't be accessed concurrently
+    oasys::Lock* db_access_lock_;
 
     static GlobalStore* instance_; ///< singleton instance
 };
@@ -21,7 +21,6 @@
 
 #include "IMCRegionGroupRecStore.h"
 #include "routing/IMCRegionGroupRec.h"
-#include "storage/GlobalStore.h"
 
 #include <third_party/oasys/storage/DurableStore.h>
 
@@ -36,7 +35,6 @@ IMCRegionGroupRecStore::IMCRegionGroupRecStore()
     : IMCRegionGroupRecStoreImpl("IMCRegionGroupRecStore", "/dtn/storage/imcrgngrp", 
                                  "imcrgngrp", "imcrgngrp")
 {
-    global_store_ = GlobalStore::instance();
 }
 
 //----------------------------------------------------------------------
@@ -68,14 +66,14 @@ IMCRegionGroupRecStore::set_durable_store(oasys::DurableStore* store)
 void
 IMCRegionGroupRecStore::lock_db_access(const char* lockedby)
 {
-    global_store_->lock_db_access(lockedby);
+    lock()->lock(lockedby);
 }
 
 //----------------------------------------------------------------------
 void
 IMCRegionGroupRecStore::unlock_db_access()
 {
-    global_store_->unlock_db_access();
+    lock()->unlock();
 }
 
 //----------------------------------------------------------------------
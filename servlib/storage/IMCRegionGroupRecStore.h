@@ -28,7 +28,6 @@
 namespace dtn {
 
 class IMCRegionGroupRec;
-class GlobalStore;
 
 /**
  * Convenience typedef for the oasys adaptor that implements the IMCRegionGroupRec 
@@ -61,12 +60,13 @@ public:
     static bool initialized() { return (instance() != NULL); }
 
     /**
-     * Lock to synchronize database access between BundleDaemonStorage and GlobalStore
+     * Lock the table so that a series of accesses is not interleaved
+     * with accesses from other threads
      */
      void lock_db_access(const char* lockedby);
 
     /**
-     * Release lock to synchronize database access
+     * Release the table lock
      */
     void unlock_db_access();
 
@@ -97,9 +97,6 @@ protected:
     /// Pointer to the DurableStore object used to begin/end transactions
     oasys::DurableStore* durable_store_ = nullptr;
 
-    /// Pointer to the GlobaStore object used to serialize access to the datastore
-    GlobalStore* global_store_ = nullptr;
-
 };
 
 } // namespace dtn
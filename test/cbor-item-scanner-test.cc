@@ -0,0 +1,317 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include <third_party/oasys/util/UnitTest.h>
+
+#include "bundling/CborItemScanner.h"
+
+using namespace oasys;
+using namespace dtn;
+
+typedef std::vector<u_char> bytes_t;
+
+//----------------------------------------------------------------------
+void
+cbor_head(bytes_t* out, u_char major, u_int64_t val)
+{
+    major <<= 5;
+    if (val < 24) {
+        out->push_back(major | val);
+        return;
+    }
+
+    int len = (val <= 0xff) ? 1 : (val <= 0xffff) ? 2 : (val <= 0xffffffff) ? 4 : 8;
+    out->push_back(major | ((len == 1) ? 24 : (len == 2) ? 25 : (len == 4) ? 26 : 27));
+    for (int i = len - 1; i >= 0; --i) {
+        out->push_back((u_char)(val >> (i * 8)));
+    }
+}
+
+//----------------------------------------------------------------------
+void
+cbor_bstr(bytes_t* out, size_t len)
+{
+    cbor_head(out, 2, len);
+    for (size_t i = 0; i < len; ++i) {
+        out->push_back((u_char)i);
+    }
+}
+
+//----------------------------------------------------------------------
+/**
+ * Hand the item to a new scanner chunk bytes at a time the way a
+ * convergence layer does, stopping at the first call that does not
+ * need more. Trailing bytes after the item must be left unconsumed.
+ */
+CborItemScanner::status_t
+scan_in_chunks(const bytes_t& item, size_t chunk, size_t* consumed,
+               bool stop_at_string = false)
+{
+    CborItemScanner scanner;
+    scanner.set_stop_at_string(stop_at_string);
+
+    CborItemScanner::status_t status = CborItemScanner::SCAN_NEED_MORE;
+    size_t offset = 0;
+
+    while (offset < item.size()) {
+        size_t len = std::min(chunk, item.size() - offset);
+        size_t cc = 0;
+        status = scanner.scan(item.data() + offset, len, &cc);
+        offset += cc;
+
+        if (status != CborItemScanner::SCAN_NEED_MORE) {
+            break;
+        }
+        if (cc != len) {
+            return CborItemScanner::SCAN_ERROR;
+        }
+    }
+
+    if (scanner.scanned() != offset) {
+        return CborItemScanner::SCAN_ERROR;
+    }
+
+    *consumed = offset;
+    return status;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(Simple) {
+    bytes_t item;
+    size_t consumed = 0;
+
+    // small, one byte and eight byte integers
+    item = { 0x05 };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(consumed, 1);
+
+    item.clear();
+    cbor_head(&item, 0, 0x123456789aULL);
+    CHECK_EQUAL(item.size(), 9);
+    CHECK_EQUAL(scan_in_chunks(item, 100, &consumed), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(consumed, 9);
+
+    // an empty byte string is complete at its header
+    item = { 0x40 };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(consumed, 1);
+
+    // bytes after the item are not consumed
+    item.clear();
+    cbor_bstr(&item, 30);
+    item.push_back(0x01);
+    item.push_back(0x02);
+    CHECK_EQUAL(scan_in_chunks(item, item.size(), &consumed), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(consumed, item.size() - 2);
+
+    // reserved additional info values are malformed
+    item = { 0x1c };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_ERROR);
+
+    // indefinite length integers are malformed
+    item = { 0x1f };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_ERROR);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(Indefinite) {
+    bytes_t item;
+    size_t consumed = 0;
+
+    // indefinite byte string of three chunks
+    item = { 0x5f };
+    cbor_bstr(&item, 3);
+    cbor_bstr(&item, 0);
+    cbor_bstr(&item, 300);
+    item.push_back(0xff);
+    size_t len = item.size();
+    item.push_back(0x00);
+
+    for (size_t chunk = 1; chunk <= item.size(); ++chunk) {
+        CHECK_EQUAL(scan_in_chunks(item, chunk, &consumed), CborItemScanner::SCAN_COMPLETE);
+        CHECK_EQUAL(consumed, len);
+    }
+
+    // indefinite array and map, the map nested in the array
+    item = { 0x9f, 0x01, 0xbf, 0x61, 'a', 0x02, 0x61, 'b', 0x80, 0xff, 0x03, 0xff };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(consumed, item.size());
+
+    // the item is not complete without the final break
+    item.pop_back();
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_NEED_MORE);
+    CHECK_EQUAL(consumed, item.size());
+
+    // a break outside of an indefinite container is malformed
+    item = { 0x82, 0x01, 0xff };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_ERROR);
+
+    item = { 0xff };
+    CHECK_EQUAL(scan_in_chunks(item, 1, &consumed), CborItemScanner::SCAN_ERROR);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(Nested) {
+    bytes_t item;
+    size_t consumed = 0;
+
+    // [1, [2, [], {3: h'..'}], tag(24, h'..'), {}, -1]
+    cbor_head(&item, 4, 5);
+    cbor_head(&item, 0, 1);
+    cbor_head(&item, 4, 3);
+    cbor_head(&item, 0, 2);
+    cbor_head(&item, 4, 0);
+    cbor_head(&item, 5, 1);
+    cbor_head(&item, 0, 3);
+    cbor_bstr(&item, 1000);
+    cbor_head(&item, 6, 24);
+    cbor_bstr(&item, 70000);
+    cbor_head(&item, 5, 0);
+    cbor_head(&item, 1, 0);
+    size_t len = item.size();
+    cbor_head(&item, 0, 7);
+
+    size_t chunks[] = { 1, 2, 3, 7, 64, 1024, 65536, item.size() };
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+        CHECK_EQUAL(scan_in_chunks(item, chunks[i], &consumed), CborItemScanner::SCAN_COMPLETE);
+        CHECK_EQUAL(consumed, len);
+    }
+
+    // nesting up to the maximum depth is fine, one more is not
+    item.assign(16, 0x81);
+    item.push_back(0x00);
+    CHECK_EQUAL(scan_in_chunks(item, 4, &consumed), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(consumed, item.size());
+
+    item.assign(17, 0x81);
+    item.push_back(0x00);
+    CHECK_EQUAL(scan_in_chunks(item, 4, &consumed), CborItemScanner::SCAN_ERROR);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(SplitHeaders) {
+    // every header size split at every possible point
+    u_int64_t values[] = { 23, 24, 0xff, 0x100, 0xffff, 0x10000,
+                           0xffffffffULL, 0x100000000ULL };
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        bytes_t item;
+        cbor_head(&item, 4, 2);
+        cbor_head(&item, 0, values[i]);
+        cbor_head(&item, 1, values[i]);
+
+        for (size_t split = 1; split < item.size(); ++split) {
+            CborItemScanner scanner;
+            size_t cc1 = 0, cc2 = 0;
+
+            CHECK_EQUAL(scanner.scan(item.data(), split, &cc1),
+                        CborItemScanner::SCAN_NEED_MORE);
+            CHECK_EQUAL(cc1, split);
+            CHECK_EQUAL(scanner.scan(item.data() + split, item.size() - split, &cc2),
+                        CborItemScanner::SCAN_COMPLETE);
+            CHECK_EQUAL(cc1 + cc2, item.size());
+        }
+    }
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(StopAtString) {
+    // a BPv7 payload block: [1, 1, 0, 0, h'...']
+    bytes_t item;
+    cbor_head(&item, 4, 5);
+    cbor_head(&item, 0, 1);
+    cbor_head(&item, 0, 1);
+    cbor_head(&item, 0, 0);
+    cbor_head(&item, 0, 0);
+    cbor_head(&item, 2, 100000);
+    size_t header_len = item.size();
+    item.insert(item.end(), 100000, 0x55);
+
+    for (size_t chunk = 1; chunk <= header_len + 1; ++chunk) {
+        CborItemScanner scanner;
+        scanner.set_stop_at_string(true);
+
+        CborItemScanner::status_t status = CborItemScanner::SCAN_NEED_MORE;
+        size_t offset = 0;
+        while (status == CborItemScanner::SCAN_NEED_MORE) {
+            size_t cc = 0;
+            status = scanner.scan(item.data() + offset, chunk, &cc);
+            offset += cc;
+        }
+
+        // the scan stops right after the string header with the
+        // contents left to the caller
+        CHECK_EQUAL(status, CborItemScanner::SCAN_STRING_HEADER);
+        CHECK_EQUAL(offset, header_len);
+        CHECK_EQUAL(scanner.string_length(), 100000);
+    }
+
+    // a string nested deeper than the block array is skipped
+    item.clear();
+    cbor_head(&item, 4, 2);
+    cbor_head(&item, 4, 1);
+    cbor_bstr(&item, 10);
+    cbor_bstr(&item, 5);
+
+    size_t consumed = 0;
+    CHECK_EQUAL(scan_in_chunks(item, 3, &consumed, true), CborItemScanner::SCAN_STRING_HEADER);
+    CHECK_EQUAL(consumed, item.size() - 5);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(Reset) {
+    bytes_t item = { 0x82, 0x01 };
+    CborItemScanner scanner;
+    size_t cc = 0;
+
+    CHECK_EQUAL(scanner.scan(item.data(), item.size(), &cc), CborItemScanner::SCAN_NEED_MORE);
+
+    scanner.reset();
+    item = { 0x01 };
+    CHECK_EQUAL(scanner.scan(item.data(), item.size(), &cc), CborItemScanner::SCAN_COMPLETE);
+    CHECK_EQUAL(scanner.scanned(), 1);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TESTER(CborItemScannerTester) {
+    ADD_TEST(Simple);
+    ADD_TEST(Indefinite);
+    ADD_TEST(Nested);
+    ADD_TEST(SplitHeaders);
+    ADD_TEST(StopAtString);
+    ADD_TEST(Reset);
+}
+
+DECLARE_TEST_FILE(CborItemScannerTester, "cbor item scanner test");
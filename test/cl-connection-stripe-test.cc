@@ -0,0 +1,165 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <string>
+
+#include <third_party/oasys/util/StringBuffer.h>
+#include <third_party/oasys/util/UnitTest.h>
+
+#include "conv_layers/CLConnection.h"
+
+using namespace oasys;
+using namespace dtn;
+
+class TestParams : public ConnectionConvergenceLayer::LinkParams {
+public:
+    TestParams() : LinkParams(true)
+    {
+        sendbuf_len_ = 1000;
+        recvbuf_len_ = 2000;
+    }
+};
+
+/**
+ * A connection that is never started, just enough to set up a primary
+ * with its stripes and look at the state they share.
+ */
+class TestConnection : public CLConnection {
+public:
+    TestConnection(TestParams* params)
+        : CLConnection("TestConnection", "/test/clconn", nullptr, params, true) {}
+
+    ~TestConnection()
+    {
+        while (! inflight_.empty()) {
+            delete inflight_.front();
+            inflight_.pop_front();
+        }
+    }
+
+    void connect() override {}
+    void disconnect() override {}
+    void initialize_pollfds() override {}
+    void handle_bundles_queued() override {}
+    void handle_cancel_bundle(Bundle*) override {}
+    bool send_pending_data() override { return false; }
+    void handle_poll_activity() override {}
+    void handle_poll_timeout() override {}
+
+    void stripe_of(TestConnection* primary)
+    {
+        set_primary(primary);
+        primary->add_stripe(this);
+    }
+
+    void add_inflight() { inflight_.push_back(new InFlightBundle(nullptr)); }
+    void set_broken()   { set_contact_broken(); }
+    void fill_sendbuf(size_t len) { sendbuf_.reserve(len); sendbuf_.fill(len); }
+
+    void resize(u_int sendbuf_len, u_int recvbuf_len)
+    {
+        resize_buffers(sendbuf_len, recvbuf_len);
+    }
+
+    size_t sendbuf_size() { return sendbuf_.size(); }
+    size_t recvbuf_size() { return recvbuf_.size(); }
+};
+
+//----------------------------------------------------------------------
+DECLARE_TEST(Stats) {
+    TestParams params;
+    TestConnection primary(&params);
+    TestConnection stripe1(&params);
+    TestConnection stripe2(&params);
+
+    // an unstriped connection has no per session lines
+    StringBuffer buf;
+    primary.get_cla_stats(buf);
+    CHECK(std::string(buf.c_str()).find("session") == std::string::npos);
+
+    stripe1.stripe_of(&primary);
+    stripe2.stripe_of(&primary);
+
+    primary.add_inflight();
+    stripe2.add_inflight();
+    stripe2.add_inflight();
+    stripe1.set_broken();
+
+    StringBuffer buf2;
+    primary.get_cla_stats(buf2);
+    std::string stats(buf2.c_str());
+    log_notice_p("/test", "%s", stats.c_str());
+
+    size_t s0 = stats.find("session 0:");
+    size_t s1 = stats.find("session 1:");
+    size_t s2 = stats.find("session 2:");
+    CHECK(s0 != std::string::npos);
+    CHECK(s1 != std::string::npos);
+    CHECK(s2 != std::string::npos);
+
+    std::string line0 = stats.substr(s0, s1 - s0);
+    std::string line1 = stats.substr(s1, s2 - s1);
+    std::string line2 = stats.substr(s2);
+    CHECK(line0.find("inflight: 1") != std::string::npos);
+    CHECK(line0.find("(broken)") == std::string::npos);
+    CHECK(line1.find("inflight: 0 (broken)") != std::string::npos);
+    CHECK(line2.find("inflight: 2") != std::string::npos);
+    CHECK(line2.find("(broken)") == std::string::npos);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(ResizeBuffers) {
+    TestParams params;
+    TestConnection primary(&params);
+    TestConnection stripe1(&params);
+    TestConnection stripe2(&params);
+
+    stripe1.stripe_of(&primary);
+    stripe2.stripe_of(&primary);
+
+    primary.resize(4000, 5000);
+    CHECK_EQUAL(primary.sendbuf_size(), 4000);
+    CHECK_EQUAL(primary.recvbuf_size(), 5000);
+    CHECK_EQUAL(stripe1.sendbuf_size(), 4000);
+    CHECK_EQUAL(stripe1.recvbuf_size(), 5000);
+    CHECK_EQUAL(stripe2.sendbuf_size(), 4000);
+    CHECK_EQUAL(stripe2.recvbuf_size(), 5000);
+
+    // a stripe holding more than the new size keeps its send buffer
+    // while the others shrink
+    stripe2.fill_sendbuf(3000);
+    primary.resize(2500, 2500);
+    CHECK_EQUAL(primary.sendbuf_size(), 2500);
+    CHECK_EQUAL(stripe1.sendbuf_size(), 2500);
+    CHECK_EQUAL(stripe2.sendbuf_size(), 4000);
+    CHECK_EQUAL(stripe2.recvbuf_size(), 2500);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TESTER(CLConnectionStripeTester) {
+    ADD_TEST(Stats);
+    ADD_TEST(ResizeBuffers);
+}
+
+DECLARE_TEST_FILE(CLConnectionStripeTester, "cl connection stripe test");
@@ -0,0 +1,247 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <dtn-config.h>
+#endif
+
+#include <third_party/oasys/util/UnitTest.h>
+
+#include "conv_layers/TransferWindow.h"
+
+using namespace oasys;
+using namespace dtn;
+
+/**
+ * Exposes the segments still waiting for an ack. All times below are
+ * on a made up clock passed in through the now parameters.
+ */
+class TestWindow : public TransferWindow {
+public:
+    size_t num_segments() const { return segments_.size(); }
+};
+
+//----------------------------------------------------------------------
+DECLARE_TEST(MinRtt) {
+    TestWindow w;
+
+    // no estimate until the first ack
+    CHECK_EQUAL_U64(w.min_rtt_us(), 0ULL);
+
+    w.segment_sent(1, 100, 100, 1000);
+    w.segment_acked(1, 100, 100, 51000);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 50000ULL);
+    CHECK_EQUAL(w.num_segments(), 0);
+
+    // a longer round trip does not replace a recent minimum
+    w.segment_sent(2, 100, 100, 100000);
+    w.segment_acked(2, 100, 100, 180000);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 50000ULL);
+
+    // a shorter one does
+    w.segment_sent(3, 100, 100, 200000);
+    w.segment_acked(3, 100, 100, 230000);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 30000ULL);
+
+    // only the last segment of a transfer an ack covers is timed
+    w.segment_sent(4, 100, 100, 300000);
+    w.segment_sent(4, 200, 100, 390000);
+    w.segment_acked(4, 200, 200, 400000);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 10000ULL);
+    CHECK_EQUAL(w.num_segments(), 0);
+
+    // an ack short of the segment end leaves it waiting
+    w.segment_sent(5, 100, 100, 500000);
+    w.segment_acked(5, 50, 50, 501000);
+    CHECK_EQUAL(w.num_segments(), 1);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 10000ULL);
+    w.segment_acked(5, 100, 50, 600000);
+    CHECK_EQUAL(w.num_segments(), 0);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 10000ULL);
+
+    // once the minimum is older than its lifetime any sample replaces it
+    uint64_t later = 400000 + TransferWindow::MIN_RTT_LIFETIME_US + 1;
+    w.segment_sent(6, 100, 100, later);
+    w.segment_acked(6, 100, 100, later + 90000);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 90000ULL);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(AckRate) {
+    TestWindow w;
+
+    w.segment_sent(1, 100000, 100000, 1000);
+    w.segment_sent(1, 200000, 100000, 1000);
+    w.segment_sent(1, 300000, 100000, 1000);
+    w.segment_sent(1, 400000, 100000, 1000);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 400000ULL);
+
+    // the first ack only starts the sample
+    w.segment_acked(1, 100000, 100000, 11000);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 10000ULL);
+    CHECK_EQUAL_U64(w.ack_rate(), 0ULL);
+    CHECK_EQUAL_U64(w.window_bytes(), 0ULL);
+
+    // no sample until a round trip has gone by
+    w.segment_acked(1, 200000, 100000, 16000);
+    CHECK_EQUAL_U64(w.ack_rate(), 0ULL);
+
+    // 200000 bytes in 10 ms
+    w.segment_acked(1, 300000, 100000, 21000);
+    CHECK_EQUAL_U64(w.ack_rate(), 20000000ULL);
+    CHECK_EQUAL_U64(w.window_bytes(), 400000ULL);
+
+    // a lower sample only pulls the rate down by an eighth of the
+    // difference
+    w.segment_acked(1, 400000, 100000, 31000);
+    CHECK_EQUAL_U64(w.ack_rate(), 18750000ULL);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 0ULL);
+    CHECK_EQUAL_U64(w.window_bytes(), 375000ULL);
+
+    // after sitting idle the next ack starts a new sample rather than
+    // counting the idle time
+    w.segment_sent(2, 100000, 100000, 5000000);
+    w.segment_sent(2, 200000, 100000, 5000000);
+    w.segment_acked(2, 100000, 100000, 5010000);
+    CHECK_EQUAL_U64(w.ack_rate(), 18750000ULL);
+
+    // the ack empties the window but the sample stays open across a
+    // send that promptly refills it
+    w.segment_acked(2, 200000, 100000, 5012000);
+    CHECK_EQUAL_U64(w.ack_rate(), 18750000ULL);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 0ULL);
+
+    // so a higher sample over the whole 10 ms is taken as is
+    w.segment_sent(2, 300000, 100000, 5012000);
+    w.segment_acked(2, 300000, 100000, 5020000);
+    CHECK_EQUAL_U64(w.ack_rate(), 20000000ULL);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(Open) {
+    TestWindow w;
+
+    // with no estimate only the minimum number of transfers may start
+    CHECK(w.open(0, 1, 0));
+    CHECK(! w.open(1, 1, 0));
+
+    w.segment_sent(1, 100000, 100000, 1000);
+    w.segment_sent(1, 200000, 100000, 1000);
+    w.segment_sent(1, 300000, 100000, 1000);
+    w.segment_acked(1, 100000, 100000, 11000);
+    w.segment_acked(1, 300000, 200000, 21000);
+    CHECK_EQUAL_U64(w.window_bytes(), 400000ULL);
+
+    w.segment_sent(2, 300000, 300000, 30000);
+    CHECK(w.open(1, 1, 0));
+    CHECK(! w.open(1, 1, 200000));
+    CHECK(w.open(0, 1, 200000));
+
+    w.segment_sent(2, 400000, 100000, 30000);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 400000ULL);
+    CHECK(! w.open(1, 1, 0));
+    CHECK(w.open(1, 2, 0));
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(TransferRefused) {
+    TestWindow w;
+
+    w.segment_sent(1, 100, 100, 1000);
+    w.segment_sent(2, 100, 100, 1000);
+    w.segment_sent(2, 200, 100, 1000);
+    w.segment_sent(3, 100, 100, 1000);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 400ULL);
+
+    // the refused transfer's segments and bytes are dropped, the others
+    // keep waiting for their acks
+    w.transfer_refused(2, 200);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 200ULL);
+    CHECK_EQUAL(w.num_segments(), 2);
+
+    // the ack for a later transfer passes over earlier segments without
+    // timing them
+    w.segment_acked(3, 100, 100, 6000);
+    CHECK_EQUAL(w.num_segments(), 0);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 100ULL);
+    CHECK_EQUAL_U64(w.min_rtt_us(), 5000ULL);
+
+    // more than is outstanding is clamped rather than wrapping
+    w.transfer_refused(1, 1000);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 0ULL);
+    w.segment_acked(1, 100, 1000, 7000);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 0ULL);
+
+    // refusing a transfer with nothing outstanding is harmless
+    w.transfer_refused(9, 0);
+    CHECK_EQUAL_U64(w.unacked_bytes(), 0ULL);
+
+    return UNIT_TEST_PASSED;
+}
+
+//----------------------------------------------------------------------
+DECLARE_TEST(SegmentLength) {
+    const uint64_t mru = 1024 * 1024;
+
+    // no estimate yet
+    TestWindow w;
+    CHECK_EQUAL_U64(w.segment_length(mru), mru);
+    CHECK_EQUAL_U64(w.segment_length(1000), 1000ULL);
+
+    // 20 MB/s over 10 ms is 200 KB per round trip, a quarter of that
+    // is below the minimum
+    w.segment_sent(1, 100000, 100000, 1000);
+    w.segment_sent(1, 300000, 200000, 1000);
+    w.segment_sent(1, 400000, 100000, 1000);
+    w.segment_acked(1, 100000, 100000, 11000);
+    w.segment_acked(1, 300000, 200000, 21000);
+    CHECK_EQUAL_U64(w.ack_rate(), 20000000ULL);
+    CHECK_EQUAL_U64(w.segment_length(mru), TransferWindow::MIN_SEGMENT_LENGTH);
+
+    // but never above the limit passed in
+    CHECK_EQUAL_U64(w.segment_length(1000), 1000ULL);
+
+    // 20 MB/s over 100 ms is 2 MB per round trip
+    TestWindow w2;
+    w2.segment_sent(1, 1000000, 1000000, 1000);
+    w2.segment_sent(1, 3000000, 2000000, 1000);
+    w2.segment_sent(1, 5000000, 2000000, 1000);
+    w2.segment_acked(1, 1000000, 1000000, 101000);
+    w2.segment_acked(1, 3000000, 2000000, 201000);
+    CHECK_EQUAL_U64(w2.min_rtt_us(), 100000ULL);
+    CHECK_EQUAL_U64(w2.ack_rate(), 20000000ULL);
+    CHECK_EQUAL_U64(w2.segment_length(mru), 500000ULL);
+    CHECK_EQUAL_U64(w2.segment_length(300000), 300000ULL);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TESTER(TransferWindowTester) {
+    ADD_TEST(MinRtt);
+    ADD_TEST(AckRate);
+    ADD_TEST(Open);
+    ADD_TEST(TransferRefused);
+    ADD_TEST(SegmentLength);
+}
+
+DECLARE_TEST_FILE(TransferWindowTester, "transfer window test");
@@ -7,6 +7,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 namespace meutils {
 
@@ -50,6 +51,12 @@ public:
         push(msg, true);
     }
 
+    /**
+     * Atomically add all of msgs to the back of the queue, and
+     * signal waiting threads once for the lot.
+     */
+    void push_back_all(const std::vector<_elt_t>& msgs);
+
     /**
      * Try to pop a msg from the queue, but don't block. Return
      * true if there was a message on the queue, false otherwise.
@@ -41,6 +41,20 @@ void MsgQueue<_elt_t>::push(_elt_t msg, bool at_back)
     cond_var_.notify_all();
 }
 
+template<typename _elt_t> 
+void MsgQueue<_elt_t>::push_back_all(const std::vector<_elt_t>& msgs)
+{
+    std::lock_guard<std::mutex> l(lock_);
+
+    queue_.insert(queue_.end(), msgs.begin(), msgs.end());
+
+    if (queue_.size() > max_size_) {
+        max_size_ = queue_.size();
+    }
+
+    cond_var_.notify_all();
+}
+
 template<typename _elt_t> 
 bool MsgQueue<_elt_t>::try_pop(_elt_t* eltp)
 {
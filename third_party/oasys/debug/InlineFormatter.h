@@ -61,6 +61,22 @@ InlineFormatter<int>::format(const int& i)
     return buf_.c_str();
 }
 
+template <>
+inline const char*
+InlineFormatter<u_int32_t>::format(const u_int32_t& i)
+{
+    buf_.appendf("%u", i);
+    return buf_.c_str();
+}
+
+template <>
+inline const char*
+InlineFormatter<u_int64_t>::format(const u_int64_t& i)
+{
+    buf_.appendf("%llu", (unsigned long long)i);
+    return buf_.c_str();
+}
+
 } // namespace oasys
 
 #endif /* _INLINEFORMATTER_H_ */
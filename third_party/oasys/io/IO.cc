@@ -487,6 +487,20 @@ IO::recvmsg(int fd, struct msghdr* msg, int flags,
                   intr, false, log);
 }
 
+#ifdef __linux__
+//----------------------------------------------------------------------------
+int
+IO::recvmmsg(int fd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
+             Notifier* intr, const char* log)
+{
+    RwDataExtraArgs args;
+    args.mmsg.msgvec = msgvec;
+    args.mmsg.vlen   = vlen;
+    return rwdata(RECVMMSG, fd, 0, 0, flags, -1, &args, 0,
+                  intr, false, log);
+}
+#endif
+
 
 //----------------------------------------------------------------------------
 int
@@ -619,6 +633,20 @@ IO::sendmsg(int fd, const struct msghdr* msg, int flags,
                   intr, false, log);
 }
 
+#ifdef __linux__
+//----------------------------------------------------------------------------
+int
+IO::sendmmsg(int fd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
+             Notifier* intr, const char* log)
+{
+    RwDataExtraArgs args;
+    args.mmsg.msgvec = msgvec;
+    args.mmsg.vlen   = vlen;
+    return rwdata(SENDMMSG, fd, 0, 0, flags, -1, &args, 0,
+                  intr, false, log);
+}
+#endif
+
 //----------------------------------------------------------------------------
 int
 IO::poll_single(int fd, short events, short* revents, int timeout_ms, 
@@ -897,16 +925,18 @@ IO::rwdata(
               (iovcnt != 1 || args == 0)));
     ASSERT(! ((op == RECVMSG || op == SENDMSG) && 
               (iov != 0 && args == 0)));
+    ASSERT(! ((op == RECVMMSG || op == SENDMMSG) &&
+              (iov != 0 || args == 0)));
     ASSERT(timeout >= -1);
     ASSERT(! (timeout > -1 && start_time == 0));
 
     struct pollfd poll_fd;
     poll_fd.fd = fd;
     switch (op) {
-    case READV: case RECV: case RECVFROM: case RECVMSG:
+    case READV: case RECV: case RECVFROM: case RECVMSG: case RECVMMSG:
         poll_fd.events = POLLIN | POLLPRI; 
         break;
-    case WRITEV: case SEND: case SENDTO: case SENDMSG:
+    case WRITEV: case SEND: case SENDTO: case SENDMSG: case SENDMMSG:
         poll_fd.events = POLLOUT; 
         break;
     default:
@@ -966,6 +996,18 @@ IO::rwdata(
             if (log) log_debug_p(log, "::sendmsg() fd %d %p cc %d", 
                                  fd, args->sendmsg_hdr, cc);
             break;
+#ifdef __linux__
+        case RECVMMSG:
+            cc = ::recvmmsg(fd, args->mmsg.msgvec, args->mmsg.vlen, flags, 0);
+            if (log) log_debug_p(log, "::recvmmsg() fd %d %p/%u cc %d",
+                                 fd, args->mmsg.msgvec, args->mmsg.vlen, cc);
+            break;
+        case SENDMMSG:
+            cc = ::sendmmsg(fd, args->mmsg.msgvec, args->mmsg.vlen, flags);
+            if (log) log_debug_p(log, "::sendmmsg() fd %d %p/%u cc %d",
+                                 fd, args->mmsg.msgvec, args->mmsg.vlen, cc);
+            break;
+#endif
         default:
             PANIC("Unknown IO type");
         }
@@ -59,6 +59,8 @@ struct IO {
         SEND,
         SENDTO,
         SENDMSG,
+        RECVMMSG,
+        SENDMMSG,
 
         CONNECT,
         ACCEPT,
@@ -146,6 +148,12 @@ struct IO {
 
     static int recvmsg(int fd, struct msghdr* msg, int flags,
                        Notifier* intr = 0, const char* log = 0);
+
+#ifdef __linux__
+    //! @return the number of messages received into msgvec
+    static int recvmmsg(int fd, struct mmsghdr* msgvec, unsigned int vlen,
+                        int flags, Notifier* intr = 0, const char* log = 0);
+#endif
     
     static int write(int fd, const char* bp, size_t len,
                      Notifier* intr = 0, const char* log = 0);
@@ -183,6 +191,12 @@ struct IO {
 
     static int sendmsg(int fd, const struct msghdr* msg, int flags,
                        Notifier* intr = 0, const char* log = 0);
+
+#ifdef __linux__
+    //! @return the number of messages of msgvec that were sent
+    static int sendmmsg(int fd, struct mmsghdr* msgvec, unsigned int vlen,
+                        int flags, Notifier* intr = 0, const char* log = 0);
+#endif
     //! @}
 
     //! @return IOTIMEOUT, IOINTR, 1 indicates readiness, otherwise
@@ -232,6 +246,11 @@ struct IO {
         const struct msghdr* sendmsg_hdr;
 
         struct msghdr* recvmsg_hdr;
+
+        struct {
+            struct mmsghdr* msgvec;
+            unsigned int vlen;
+        } mmsg;
         
         struct {
             const struct sockaddr* to;
@@ -504,6 +504,20 @@ IPSocket::recvmsg(struct msghdr* msg, int flags)
     return IO::recvmsg(fd_, msg, flags, get_notifier(), logpath_);
 }
 
+#ifdef __linux__
+int
+IPSocket::sendmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags)
+{
+    return IO::sendmmsg(fd_, msgvec, vlen, flags, get_notifier(), logpath_);
+}
+
+int
+IPSocket::recvmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags)
+{
+    return IO::recvmmsg(fd_, msgvec, vlen, flags, get_notifier(), logpath_);
+}
+#endif
+
 int
 IPSocket::poll_sockfd(int events, int* revents, int timeout_ms)
 {
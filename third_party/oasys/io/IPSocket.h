@@ -85,6 +85,12 @@ public:
                          in_addr_t *addr, u_int16_t *port);
     virtual int recvmsg(struct msghdr* msg, int flags);
 
+#ifdef __linux__
+    /// Send or receive up to vlen datagrams with a single system call
+    virtual int sendmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags);
+    virtual int recvmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags);
+#endif
+
     //@}
 
     /// In case connect() was called on a nonblocking socket and
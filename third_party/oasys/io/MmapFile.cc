@@ -89,6 +89,26 @@ MmapFile::map(const char* filename, int prot, int flags,
     return ptr_;
 }
 
+//----------------------------------------------------------------------
+void*
+MmapFile::map_fd(int fd, int prot, int flags, size_t len, off_t offset)
+{
+    ASSERT(ptr_ == NULL);
+    ASSERT(len != 0);
+
+    len_ = len;
+    ptr_ = mmap(0, len, prot, flags, fd, offset);
+    if (ptr_ == (void*)-1) {
+        log_err("error in mmap of fd %d (len %zu offset %llu): %s",
+                fd, len, U64FMT(offset), strerror(errno));
+        ptr_ = NULL;
+        len_ = 0;
+        return NULL;
+    }
+
+    return ptr_;
+}
+
 //----------------------------------------------------------------------
 bool
 MmapFile::unmap()
@@ -46,6 +46,16 @@ public:
      */
     void* map(const char* filename, int prot, int flags, 
               size_t len = 0, off_t offset = 0);
+
+    /**
+     * Sets up a mmap of an already open file descriptor. The
+     * descriptor is not owned by this object and can be closed by
+     * the caller once the mapping is established. The offset must be
+     * a multiple of the page size.
+     *
+     * @return the mapping pointer or NULL if there's an error
+     */
+    void* map_fd(int fd, int prot, int flags, size_t len, off_t offset = 0);
     
     /**
      * Unmaps the current mapping (if any).
@@ -36,6 +36,14 @@
 #  include <oasys-config.h>
 #endif
 
+#include <algorithm>
+#include <errno.h>
+#include <time.h>
+
+#ifdef __linux__
+#  include <sys/prctl.h>
+#endif
+
 #include "RateLimitedSocket.h"
 
 namespace oasys {
@@ -65,29 +73,94 @@ RateLimitedSocket::~RateLimitedSocket()
    delete bucket_;
 }
 
+//----------------------------------------------------------------------
+void
+RateLimitedSocket::sleep_until_ns(u_int64_t deadline)
+{
+    struct timespec ts;
+    ts.tv_sec  = deadline / 1000000000;
+    ts.tv_nsec = deadline % 1000000000;
+
+#ifdef __linux__
+    // the default 50us of timer slack would be most of a packet time
+    // at high rates, so a thread that paces wants its sleeps exact
+    static thread_local bool slack_set = false;
+    if (!slack_set) {
+        prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+        slack_set = true;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+#else
+    u_int64_t now = TokenBucket::now_ns();
+    if (deadline > now) {
+        ts.tv_sec  = (deadline - now) / 1000000000;
+        ts.tv_nsec = (deadline - now) % 1000000000;
+        nanosleep(&ts, NULL);
+    }
+#endif
+}
+
+//----------------------------------------------------------------------
+bool
+RateLimitedSocket::wait_for_tokens(size_t len, bool wait_till_sent,
+                                   bool drain_tokens)
+{
+    if (bucket_->rate() == 0) {
+        return true;
+    }
+
+    // a standard bucket never holds more than its depth, so a larger
+    // send waits for a full bucket and leaves it in debt
+    u_int64_t bits  = len * 8;
+    u_int64_t level = bits;
+    if (bucket_->is_type_standard()) {
+        level = std::min(bits, bucket_->depth());
+    }
+
+    while (true) {
+        u_int64_t wait_ns = bucket_->time_to_drain_ns(level);
+        if (wait_ns == 0) {
+            break;
+        }
+
+        if (!wait_till_sent) {
+            log_debug("can't send %zu bytes since only %lld tokens in bucket",
+                      len, I64FMT(bucket_->tokens()));
+            return false;
+        }
+
+        // a standard bucket keeps filling while the sender oversleeps
+        // so it sleeps the whole wait, and at least long enough that
+        // high rates go out a few packets per wakeup, but a leaky one
+        // loses any time overslept so the last stretch before the
+        // departure time is spun instead
+        u_int64_t deadline = TokenBucket::now_ns() + wait_ns;
+        if (bucket_->is_type_standard()) {
+            sleep_until_ns(deadline + ((wait_ns < PACING_MIN_SLEEP_NS) ?
+                                       (PACING_MIN_SLEEP_NS - wait_ns) : 0));
+        } else if (wait_ns > PACING_SPIN_NS) {
+            sleep_until_ns(deadline - PACING_SPIN_NS);
+        } else {
+            while (TokenBucket::now_ns() < deadline) {}
+        }
+    }
+
+    log_debug("%lld tokens sufficient for %zu bytes",
+              I64FMT(bucket_->tokens()), len);
+    if (drain_tokens) {
+        bucket_->drain(bits);
+    }
+    return true;
+}
+
 //----------------------------------------------------------------------
 int
 RateLimitedSocket::send(const char* bp, size_t len, int flags, bool wait_till_sent)
 {
     ASSERT(socket_ != NULL);
-    bool send_data = true;
-    if (bucket_->rate() != 0) {
-        while(send_data) {
-            if(!wait_till_sent)send_data = false;
-            bool can_send = bucket_->try_to_drain(len * 8);
-            if (!can_send) {
-                if(!send_data)
-                {
-                    log_debug("can't send %zu byte packet since only %llu tokens in bucket",
-                          len, U64FMT(bucket_->tokens()));
-                    return IORATELIMIT;
-                }
-            } else {
-               log_debug("%llu tokens sufficient for %zu byte packet",
-                      U64FMT(bucket_->tokens()), len);
-               send_data = false; /// force loop to end
-            }
-        }
+    if (!wait_for_tokens(len, wait_till_sent)) {
+        return IORATELIMIT;
     }
 
     return socket_->send(bp, len, flags);
@@ -98,28 +171,65 @@ int
 RateLimitedSocket::sendto(char* bp, size_t len, int flags,
                           in_addr_t addr, u_int16_t port,bool wait_till_sent)
 {
-    int sent = 0;
     ASSERT(socket_ != NULL);
-    if (bucket_->rate() != 0) {
-        while(sent == 0)
-        {
-            bool can_send = bucket_->try_to_drain(len * 8);
-            if (!can_send) {
-                if(!wait_till_sent) {
-                    log_debug("can't send %zu byte packet since only %llu tokens in bucket",
-                              len, U64FMT(bucket_->tokens()));
-                    return IORATELIMIT; 
-                }
-                usleep(1);
-            } else {
-                log_debug("%llu tokens sufficient for %zu byte packet",
-                      U64FMT(bucket_->tokens()), len);
-                 sent = 1;
-            }
-        }
+    if (!wait_for_tokens(len, wait_till_sent)) {
+        return IORATELIMIT;
     }
 
     return socket_->sendto(bp, len, flags, addr, port);
 }
 
+//----------------------------------------------------------------------
+int
+RateLimitedSocket::sendmsg(const struct msghdr* msg, int flags,
+                           bool wait_till_sent)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < (size_t)msg->msg_iovlen; ++i) {
+        len += msg->msg_iov[i].iov_len;
+    }
+
+    ASSERT(socket_ != NULL);
+    if (!wait_for_tokens(len, wait_till_sent)) {
+        return IORATELIMIT;
+    }
+
+    return socket_->sendmsg(msg, flags);
+}
+
+#ifdef __linux__
+//----------------------------------------------------------------------
+int
+RateLimitedSocket::sendmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags,
+                            bool wait_till_sent)
+{
+    size_t len = 0;
+    for (unsigned int m = 0; m < vlen; ++m) {
+        const struct msghdr* msg = &msgvec[m].msg_hdr;
+        for (size_t i = 0; i < (size_t)msg->msg_iovlen; ++i) {
+            len += msg->msg_iov[i].iov_len;
+        }
+    }
+
+    ASSERT(socket_ != NULL);
+    if (!wait_for_tokens(len, wait_till_sent, false)) {
+        return IORATELIMIT;
+    }
+
+    int cc = socket_->sendmmsg(msgvec, vlen, flags);
+
+    // the socket may take only the first few messages (or none), so
+    // charge the bucket for what went out rather than for the burst
+    if ((cc > 0) && (bucket_->rate() != 0)) {
+        size_t sent = 0;
+        for (int m = 0; m < cc; ++m) {
+            sent += msgvec[m].msg_len;
+        }
+        bucket_->drain(sent * 8);
+    }
+
+    return cc;
+}
+#endif
+
 } // namespace oasys
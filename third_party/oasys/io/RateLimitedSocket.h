@@ -96,6 +96,31 @@ enum BUCKET_TYPE {
      */
     int sendto(char* bp, size_t len, int flags,
                in_addr_t addr, u_int16_t port, bool wait_till_sent);
+
+    /**
+     * Send the gathered data described by msg on the socket iff the
+     * rate controller indicates that there is space for all of it.
+     *
+     * @return IORATELIMIT if there isn't space in the token bucket
+     * for the total length of msg's iovecs, the return from
+     * IPSocket::sendmsg if there is space.
+     */
+    int sendmsg(const struct msghdr* msg, int flags, bool wait_till_sent);
+
+#ifdef __linux__
+    /**
+     * Send the vlen messages of msgvec with a single sendmmsg() iff
+     * the rate controller indicates that there is space for all of
+     * them, so the whole burst is metered at once. Only the messages
+     * the socket actually took are drained from the bucket.
+     *
+     * @return IORATELIMIT if there isn't space in the token bucket
+     * for the total length of the messages, the return from
+     * IPSocket::sendmmsg if there is space.
+     */
+    int sendmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags,
+                 bool wait_till_sent);
+#endif
     
     
     /// @{ Accessors
@@ -108,6 +133,30 @@ enum BUCKET_TYPE {
     /// @}
     
 protected:
+    /**
+     * Wait until the bucket has the tokens for len bytes, sleeping
+     * until the departure time it computes rather than polling, then
+     * drain them unless drain_tokens is false (for a caller that only
+     * knows what to charge once the send returns).
+     *
+     * @return false if the tokens aren't there and wait_till_sent is
+     * not set
+     */
+    bool wait_for_tokens(size_t len, bool wait_till_sent,
+                         bool drain_tokens = true);
+
+    /// Sleep until the given time on the monotonic clock (with the
+    /// calling thread's timer slack turned down on Linux)
+    static void sleep_until_ns(u_int64_t deadline);
+
+    /// How close to its departure time a leaky bucket sender spins
+    /// rather than sleeps, to cover the wakeup latency
+    static const u_int64_t PACING_SPIN_NS = 20000;
+
+    /// Shortest sleep of a standard bucket sender (its bucket absorbs
+    /// the burst as long as this is well under the depth)
+    static const u_int64_t PACING_MIN_SLEEP_NS = 50000;
+
     BUCKET_TYPE  bucket_type_;
     TokenBucket* bucket_;
     IPSocket*    socket_;
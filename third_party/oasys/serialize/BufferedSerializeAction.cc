@@ -53,33 +53,48 @@ BufferedSerializeAction::BufferedSerializeAction(
       buf_(NULL), length_(0), offset_(0)
 {
     expandable_buf_->set_len(0);
+
+    if (expandable_buf_->buf_len() != 0) {
+        buf_    = (u_char*)expandable_buf_->raw_buf();
+        length_ = expandable_buf_->buf_len();
+    }
+}
+
+void
+BufferedSerializeAction::end_action()
+{
+    if (expandable_buf_ != NULL) {
+        expandable_buf_->set_len(offset_);
+    }
 }
 
 u_char*
 BufferedSerializeAction::buf()
 {
-    return (expandable_buf_ ? (u_char*)expandable_buf_->raw_buf() : buf_);
+    return buf_;
 }
 
 size_t
 BufferedSerializeAction::length()
 {
-    return (expandable_buf_ ? expandable_buf_->buf_len() : length_);
+    return length_;
 }
 
 size_t
 BufferedSerializeAction::offset()
 {
-    return (expandable_buf_ ? expandable_buf_->len() : offset_);
+    return offset_;
 }
 
 /**
- * Return the next chunk of buffer. If there was a previous error or
- * if we're in fixed-length mode and the buffer isn't big enough, set
- * the error_ flag and return NULL.
+ * Slow path for next_slice(). The expandable buffer is grown by at
+ * least doubling it so that a large object isn't realloc'd for each
+ * field that's appended. If there was a previous error or if we're in
+ * fixed-length mode and the buffer isn't big enough, set the error_
+ * flag and return NULL.
  */
 u_char*
-BufferedSerializeAction::next_slice(size_t length)
+BufferedSerializeAction::grow_slice(size_t length)
 {
     u_char* ret;
     
@@ -87,20 +102,21 @@ BufferedSerializeAction::next_slice(size_t length)
         return NULL;
     
     if (expandable_buf_ != NULL) {
-        ret = (u_char*)expandable_buf_->tail_buf(length);
-        expandable_buf_->incr_len(length);
+        size_t need = offset_ + length;
+        size_t grow = length_ * 2;
+        expandable_buf_->reserve(need > grow ? need : grow);
+
+        buf_    = (u_char*)expandable_buf_->raw_buf();
+        length_ = expandable_buf_->buf_len();
+        
+        ret = &buf_[offset_];
+        offset_ += length;
         return ret;
     }
     
-    if (offset_ + length > length_) {
-        log_err("serialization buffer not large enough");
-        signal_error();
-        return NULL;
-    }
-
-    ret = &buf_[offset_];
-    offset_ += length;
-    return ret;
+    log_err("serialization buffer not large enough");
+    signal_error();
+    return NULL;
 }
 
 } // namespace oasys
@@ -19,11 +19,10 @@
 
 #include "Serialize.h"
 #include "../debug/Log.h"
+#include "../util/ExpandableBuffer.h"
 
 namespace oasys {
 
-struct ExpandableBuffer;
-
 //////////////////////////////////////////////////////////////////////////////
 /**
  * Common base class for Marshal and Unmarshal that manages the flat
@@ -55,14 +54,35 @@ public:
         (void)name;
         object->serialize(this);
     }
+
+    /**
+     * Set the length of the expandable buffer (if any) to the amount
+     * that has been marshalled.
+     */
+    virtual void end_action();
     
 protected:
     /**  
      * Get the next R/W length of the buffer.
      *
+     * Both the fixed-length and expandable modes work on buf_,
+     * length_ and offset_ so a field that fits in the space left in
+     * the buffer is handled inline, and only growing the expandable
+     * buffer or running out of room goes through grow_slice(). The
+     * expandable buffer's length is updated by end_action().
+     *
      * @return R/W buffer of size length or NULL on error
      */
-    u_char* next_slice(size_t length);
+    u_char* next_slice(size_t length)
+    {
+        if (offset_ + length > length_) {
+            return grow_slice(length);
+        }
+
+        u_char* ret = &buf_[offset_];
+        offset_ += length;
+        return ret;
+    }
     
     /** @return buffer */
     u_char* buf();
@@ -74,10 +94,17 @@ protected:
     size_t offset();
     
  private:
+    /**
+     * Slow path of next_slice() that grows the expandable buffer, or
+     * signals an error if the fixed-length buffer is full.
+     */
+    u_char* grow_slice(size_t length);
+
     /// Expandable buffer
     ExpandableBuffer* expandable_buf_;
 
-    // Fields used for fixed length buffer
+    // Fields used for the fixed length buffer, or the current memory
+    // of the expandable buffer
     
     u_char* buf_;	///< Buffer that is un/marshalled
     size_t  length_;	///< Length of the buffer.
@@ -22,11 +22,32 @@
 #include "debug/Log.h"
 #include "util/StringUtils.h"
 #include "util/CRC32.h"
+#include "util/ScratchBuffer.h"
+#include "thread/TLS.h"
 
 #include "MarshalSerialize.h"
 
 namespace oasys {
 
+/// Per-thread buffer returned by Marshal::thread_buf()
+typedef ScratchBuffer<u_char*> MarshalThreadBuf;
+template<> pthread_key_t TLS<MarshalThreadBuf>::key_ = 0;
+
+static pthread_once_t marshal_thread_buf_once = PTHREAD_ONCE_INIT;
+
+static void
+marshal_thread_buf_init()
+{
+    TLS<MarshalThreadBuf>::init();
+}
+
+/// Initial size of a thread's marshal buffer, enough for most records
+static const size_t MARSHAL_THREAD_BUF_LEN = 4096;
+
+/// A thread's buffer is given back once it has grown past this so one
+/// unusually large record doesn't pin the memory for the thread's life
+static const size_t MARSHAL_THREAD_BUF_MAX_LEN = 1024 * 1024;
+
 /******************************************************************************
  *
  * Marshal
@@ -43,6 +64,25 @@ Marshal::Marshal(context_t context, ExpandableBuffer* buf, int options)
 {
 }
 
+//----------------------------------------------------------------------------
+ExpandableBuffer*
+Marshal::thread_buf()
+{
+    pthread_once(&marshal_thread_buf_once, marshal_thread_buf_init);
+
+    MarshalThreadBuf* buf = TLS<MarshalThreadBuf>::get();
+    if (buf == NULL) {
+        buf = new MarshalThreadBuf(MARSHAL_THREAD_BUF_LEN);
+        TLS<MarshalThreadBuf>::set(buf);
+    } else if (buf->buf_len() > MARSHAL_THREAD_BUF_MAX_LEN) {
+        buf->free_buf();
+        buf->reserve(MARSHAL_THREAD_BUF_LEN);
+    }
+
+    buf->clear();
+    return buf;
+}
+
 //----------------------------------------------------------------------------
 void
 Marshal::end_action()
@@ -62,6 +102,8 @@ Marshal::end_action()
             }
         }
     }
+
+    BufferedSerializeAction::end_action();
 }
 
 //----------------------------------------------------------------------------
@@ -123,6 +165,34 @@ Marshal::process(const char* name, u_int8_t* i)
     if (log_) logf(log_, LOG_DEBUG, "int8   %s=>(%d)", name, *i);
 }
 
+//----------------------------------------------------------------------------
+void
+Marshal::process(const char* name, int64_t* i)
+{
+    Marshal::process(name, (u_int64_t*)i);
+}
+
+//----------------------------------------------------------------------------
+void
+Marshal::process(const char* name, int32_t* i)
+{
+    Marshal::process(name, (u_int32_t*)i);
+}
+
+//----------------------------------------------------------------------------
+void 
+Marshal::process(const char* name, int16_t* i)
+{
+    Marshal::process(name, (u_int16_t*)i);
+}
+
+//----------------------------------------------------------------------------
+void 
+Marshal::process(const char* name, int8_t* i)
+{
+    Marshal::process(name, (u_int8_t*)i);
+}
+
 //----------------------------------------------------------------------------
 void 
 Marshal::process(const char* name, bool* b)
@@ -160,7 +230,7 @@ Marshal::process(const char*            name,
     len_name += ".len";
 
     u_int32_t len = carrier->len();
-    process(len_name.c_str(), &len);
+    Marshal::process(len_name.c_str(), &len);
     process(name, carrier->buf(), carrier->len());
 }
 
@@ -185,7 +255,7 @@ void
 Marshal::process(const char* name, std::string* s)
 {
     u_int32_t len = s->length();
-    process(name, &len);
+    Marshal::process(name, &len);
 
     u_char* buf = next_slice(len);
     if (buf == NULL) return;
@@ -42,6 +42,20 @@ public:
      */
     Marshal(context_t context, ExpandableBuffer* buf, int options = 0);
 
+    /**
+     * Return the calling thread's marshal buffer, cleared. Marshalling
+     * into it with the expandable buffer constructor flattens an object
+     * in a single pass, without a MarshalSize pass to find its length
+     * first, and since the buffer keeps its memory from one call to the
+     * next there is no allocation once it has grown to the size of the
+     * records being written.
+     *
+     * The contents are only valid until the next call from the same
+     * thread, so it must not be held across anything that might
+     * marshal another record.
+     */
+    static ExpandableBuffer* thread_buf();
+
     /**
      * Since the Marshal operation doesn't actually modify the
      * SerializableObject, define a variant of action() and process()
@@ -78,6 +92,16 @@ public:
                  u_char                 terminator);
     void process(const char* name, std::string* s);
 
+    /// @{
+    /// The signed variants are overridden so that the fixed width
+    /// integer fields take a direct call to the unsigned ones instead
+    /// of being dispatched a second time through the virtual table.
+    void process(const char* name, int64_t* i);
+    void process(const char* name, int32_t* i);
+    void process(const char* name, int16_t* i);
+    void process(const char* name, int8_t* i);
+    /// @}
+
 private:
     // future use?  bool add_crc_;
 };
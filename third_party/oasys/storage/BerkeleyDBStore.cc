@@ -504,6 +504,14 @@ BerkeleyDBStore::get_info() const
     return "BerkeleyDB";
 }
 
+//----------------------------------------------------------------------------
+bool
+BerkeleyDBStore::concurrent_tables() const
+{
+    // the handles are only opened with DB_THREAD when locking is enabled
+    return (deadlock_timer_ != nullptr);
+}
+
 //----------------------------------------------------------------------------
 int  
 BerkeleyDBStore::get_meta_table(BerkeleyDBTable** table)
@@ -805,48 +813,17 @@ BerkeleyDBTable::put(const SerializableObject&  key,
         }
     }
 
-    // figure out the size of the data
-    MarshalSize sizer(Serialize::CONTEXT_LOCAL);
-    if (sizer.action(data) != 0) {
-        log_err("error sizing data object");
+    // marshal the type code (if multitype) and the object in a single
+    // pass into this thread's reusable buffer
+    ExpandableBuffer* buf = marshal_data(typecode, data);
+    if (buf == NULL) {
+        log_err("error serializing data object");
         return DS_ERR;
     }
-    size_t object_sz = sizer.size();
 
-    // and the size of the type code (if multitype)
-    size_t typecode_sz = 0;
-    if (multitype_) {
-        typecode_sz = MarshalSize::get_size(&typecode);
-    }
-
-    // XXX/demmer -- one little optimization would be to pass the
-    // calculated size out to the caller (the generic DurableTable),
-    // so we don't have to re-calculate it in the object cache code
-    
-    log_debug("put: serializing %zu byte object (plus %zu byte typecode)",
-              object_sz, typecode_sz);
+    log_debug("put: serialized %zu byte object", buf->len());
 
-    ScratchBuffer<u_char*, 1024> scratch;
-    u_char* buf = scratch.buf(typecode_sz + object_sz);
-    DBTRef d(buf, typecode_sz + object_sz);
-    
-    // if we're a multitype table, marshal the type code
-    if (multitype_) 
-    {
-        Marshal typemarshal(Serialize::CONTEXT_LOCAL, buf, typecode_sz);
-        UIntShim type_shim(typecode);
-            
-        if (typemarshal.action(&type_shim) != 0) {
-            log_err("error serializing type code");
-            return DS_ERR;
-        }
-    }
-        
-    Marshal m(Serialize::CONTEXT_LOCAL, buf + typecode_sz, object_sz);
-    if (m.action(data) != 0) {
-        log_err("error serializing data object");
-        return DS_ERR;
-    }
+    DBTRef d(buf->raw_buf(), buf->len());
     
     int db_flags = 0;
     if (flags & DS_EXCL) {
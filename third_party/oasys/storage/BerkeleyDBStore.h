@@ -81,6 +81,7 @@ public:
     int del_table(const std::string& name);
     int get_table_names(StringVector* names);
     std::string get_info() const;
+    bool concurrent_tables() const;
     /// @}
 
 private:
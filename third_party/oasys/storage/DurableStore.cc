@@ -321,4 +321,17 @@ DurableStore::aux_tables_available()
 	return impl_->aux_tables_available();
 }
 
+//----------------------------------------------------------------------------
+Lock*
+DurableStore::table_access_lock(Lock* table_lock)
+{
+    ASSERT(impl_ != NULL);
+
+    if (impl_->concurrent_tables()) {
+        return table_lock;
+    }
+
+    return &shared_table_lock_;
+}
+
 } // namespace oasys
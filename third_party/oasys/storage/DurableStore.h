@@ -265,9 +265,26 @@ public:
      */
     bool aux_tables_available();
 
+    /**
+     * Return the lock a table should hold while it is accessed. If the
+     * implementation allows different tables to be used concurrently
+     * this is the table's own lock, otherwise it is a lock shared by
+     * all of the tables in the store.
+     *
+     * @param table_lock The table's own lock
+     * @return the lock to take for each access to the table
+     */
+    Lock* table_access_lock(Lock* table_lock);
+
 private:
     friend class oasys::Singleton<DurableStore, false>;
 
+    /*
+     * Serializes table accesses for implementations that can't handle
+     * concurrent use of different tables.
+     */
+    SpinLock shared_table_lock_;
+
     /*
      * Serialize all transactionalized database accesses, whether
      * the underlying database mechanism actually supports
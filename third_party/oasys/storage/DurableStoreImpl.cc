@@ -138,6 +138,14 @@ DurableStoreImpl::aux_tables_available()
 	return false;
 }
 
+// Default implementation - all tables share a single lock unless the
+// derived class is known to be safe to use from multiple threads.
+bool
+DurableStoreImpl::concurrent_tables() const
+{
+    return false;
+}
+
 int
 DurableTableImpl::get(const SerializableObject&   key,
                       SerializableObject**        data,
@@ -168,4 +176,22 @@ DurableTableImpl::flatten(const SerializableObject& key,
     return sizer.size();
 }
 
+ExpandableBuffer*
+DurableTableImpl::marshal_data(TypeCollection::TypeCode_t typecode,
+                               const SerializableObject*  data)
+{
+    ExpandableBuffer* buf = Marshal::thread_buf();
+    Marshal m(Serialize::CONTEXT_LOCAL, buf);
+
+    if (multitype_) {
+        m.process("typecode", &typecode);
+    }
+    
+    if (m.action(data) != 0) {
+        return NULL;
+    }
+
+    return buf;
+}
+
 } // namespace oasys
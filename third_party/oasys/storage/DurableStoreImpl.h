@@ -112,6 +112,21 @@ public:
      */
     virtual bool aux_tables_available();
 
+    /**
+     * Indicates if operations on different tables can be run by
+     * multiple threads at the same time, either because the database
+     * handles are free threaded or because the implementation does its
+     * own serialization. Operations on any one table are always
+     * serialized by the caller (see DurableStore::table_access_lock).
+     *
+     * Of the current implementations, Berkeley DB only allows this
+     * when its locking subsystem is enabled (db_lockdetect != 0) and
+     * ODBC never does because all of its tables share one connection.
+     *
+     * @return true if tables may be accessed concurrently
+     */
+    virtual bool concurrent_tables() const;
+
 protected:
 
     /**
@@ -221,6 +236,16 @@ protected:
     template<size_t _size>
     size_t flatten(const SerializableObject&      key,
                    ScratchBuffer<u_char*, _size>* scratch);
+
+    /**
+     * Helper method to marshal the type code (for multitype tables)
+     * followed by the data object in a single pass into the calling
+     * thread's reusable marshal buffer (see Marshal::thread_buf()).
+     *
+     * @return the buffer or NULL on error
+     */
+    ExpandableBuffer* marshal_data(TypeCollection::TypeCode_t typecode,
+                                   const SerializableObject*  data);
     
     std::string table_name_;	///< Name of the table
     bool multitype_;		///< Whether single or multi-type table
@@ -27,23 +27,32 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <vector>
 
 #include "../util/ExpandableBuffer.h"
+#include "../util/jenkins_hash.h"
 #include "../serialize/KeySerialize.h"
 #include "../serialize/TypeCollection.h"
 #include "../io/FileUtils.h"
 #include "../io/IO.h"
+#include "../thread/Thread.h"
 
 
 namespace oasys {
 
+const char* FileSystemStore::LAYOUT_FILE = ".layout";
+
 //----------------------------------------------------------------------------
 FileSystemStore::FileSystemStore(const char* logpath)
     : DurableStoreImpl("FileSystemStore", logpath),
       db_dir_("INVALID"),
       tables_dir_("INVALID"),
       default_perm_(S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP),
-      fd_cache_(0)
+      fd_cache_(0),
+      dir_levels_(0),
+      scan_threads_(1),
+      batch_sync_(false),
+      in_txn_(false)
 {}
 
 //----------------------------------------------------------------------------
@@ -107,6 +116,33 @@ FileSystemStore::init(const StorageConfig& cfg)
         fd_cache_ = new FdCache(logpath_, cfg.fs_fd_cache_size_);
     }
 
+    batch_sync_   = cfg.fs_batch_sync_;
+    scan_threads_ = (cfg.fs_scan_threads_ > 0) ? cfg.fs_scan_threads_ : 1;
+
+    int levels = cfg.fs_dir_levels_;
+    if (levels < 0) {
+        levels = 0;
+    } else if (levels > MAX_DIR_LEVELS) {
+        log_warn("fs_dir_levels %d is too large, using %d",
+                 levels, MAX_DIR_LEVELS);
+        levels = MAX_DIR_LEVELS;
+    }
+
+    // a database without a layout file was either just created or
+    // written before there were subdirectories
+    int err = read_layout(&dir_levels_);
+    if (err == -2) {
+        dir_levels_ = 0;
+    } else if (err != 0) {
+        return -1;
+    }
+
+    if (err == -2 || dir_levels_ != levels) {
+        if (migrate_layout(levels) != 0) {
+            return -1;
+        }
+    }
+
     log_info("init() done");
     init_ = true;
 
@@ -121,7 +157,20 @@ FileSystemStore::end_transaction(void *txid, bool be_durable)
 
     log_debug("FileSystemStore::end_transaction %p enter.", txid);
 
-    if (be_durable)
+    in_txn_ = false;
+
+    if (batch_sync_)
+    {
+        // a non-durable commit leaves the batch to be synced with the
+        // next durable one
+        if (be_durable && sync_batch() != 0)
+        {
+            return DS_ERR;
+        }
+    }
+    // without the fd cache the table files are closed after each access
+    // so there is nothing open to sync
+    else if (be_durable && (fd_cache_ != 0))
     {
         fd_cache_->sync_all();
     }
@@ -129,6 +178,21 @@ FileSystemStore::end_transaction(void *txid, bool be_durable)
     return DS_OK;
 }
 
+//----------------------------------------------------------------------------
+int
+FileSystemStore::begin_transaction(void **txid)
+{
+    log_debug("FileSystemStore::begin_transaction enter.");
+
+    in_txn_ = true;
+
+    if (txid != NULL) {
+        *txid = this;
+    }
+
+    return DS_OK;
+}
+
 //----------------------------------------------------------------------------
 int 
 FileSystemStore::get_table(DurableTableImpl** table,
@@ -159,6 +223,10 @@ FileSystemStore::get_table(DurableTableImpl** table,
             log_err("Couldn't mkdir: %s", strerror(err));
             return DS_ERR;
         }
+
+        if (batch_sync_) {
+            sync_dir(tables_dir_);
+        }
     } else if (err != 0) { 
         return DS_ERR;
     } else if (err == 0 && (flags & DS_EXCL)) {
@@ -170,7 +238,7 @@ FileSystemStore::get_table(DurableTableImpl** table,
                             name, 
                             dir_path, 
                             flags & DS_MULTITYPE, 
-                            fd_cache_);
+                            this);
     ASSERT(table_ptr);
     
     *table = table_ptr;
@@ -189,7 +257,7 @@ FileSystemStore::del_table(const std::string& name)
     dir_path.append("/");
     dir_path.append(name);
     
-    FileUtils::rm_all_from_dir(dir_path.c_str());
+    FileUtils::rm_all_from_dir(dir_path.c_str(), true);
 
     // clean out the directory
     int err;
@@ -214,9 +282,12 @@ FileSystemStore::get_table_names(StringVector* names)
         return DS_ERR;
     }
 
+    // skip . and .. and the layout file
     struct dirent* ent = readdir(dir);
     while (ent != 0) {
-        names->push_back(ent->d_name);
+        if (ent->d_name[0] != '.') {
+            names->push_back(ent->d_name);
+        }
         ent = readdir(dir);
     }
 
@@ -286,22 +357,416 @@ FileSystemStore::tidy_database()
     }
 }
 
+//----------------------------------------------------------------------------
+std::string
+FileSystemStore::shard_dir(const std::string& table_dir,
+                           const char* key, int levels)
+{
+    if (levels == 0) {
+        return table_dir;
+    }
+    
+    u_int32_t hash = jenkins_hash((u_int8_t*)key, strlen(key), 0);
+
+    std::string dir = table_dir;
+    char shard[4];
+    for (int i = 0; i < levels; ++i) {
+        snprintf(shard, sizeof(shard), "/%02x", (hash >> (8 * i)) & 0xff);
+        dir.append(shard);
+    }
+
+    return dir;
+}
+
+//----------------------------------------------------------------------------
+int
+FileSystemStore::make_shard_dirs(const std::string& table_dir,
+                                 const std::string& dir)
+{
+    ASSERT(dir.compare(0, table_dir.length(), table_dir) == 0);
+
+    // each level is a '/' followed by two hex digits
+    size_t len = table_dir.length();
+    while (len < dir.length()) {
+        len += 3;
+        std::string sub = dir.substr(0, len);
+        
+        if (mkdir(sub.c_str(), default_perm_) != 0) {
+            if (errno == EEXIST) {
+                continue;
+            }
+            log_err("couldn't mkdir %s: %s", sub.c_str(), strerror(errno));
+            return -1;
+        }
+
+        if (batch_sync_) {
+            sync_dir_changed(dir.substr(0, len - 3));
+        }
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+int
+FileSystemStore::read_layout(int* levels)
+{
+    std::string path = tables_dir_ + "/" + LAYOUT_FILE;
+
+    FILE* f = fopen(path.c_str(), "r");
+    if (f == NULL) {
+        if (errno == ENOENT) {
+            return -2;
+        }
+        log_err("can't open layout file %s: %s",
+                path.c_str(), strerror(errno));
+        return -1;
+    }
+
+    int cc = fscanf(f, "levels %d", levels);
+    fclose(f);
+
+    if (cc != 1 || *levels < 0 || *levels > MAX_DIR_LEVELS) {
+        log_err("invalid layout file %s", path.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+int
+FileSystemStore::write_layout(int levels)
+{
+    std::string path = tables_dir_ + "/" + LAYOUT_FILE;
+    std::string tmp  = path + ".tmp";
+
+    int fd = open(tmp.c_str(), O_CREAT | O_TRUNC | O_WRONLY,
+                  S_IRUSR | S_IWUSR | S_IRGRP);
+    if (fd == -1) {
+        log_err("can't create layout file %s: %s",
+                tmp.c_str(), strerror(errno));
+        return -1;
+    }
+
+    StringBuffer buf("levels %d\n", levels);
+    int cc = IO::writeall(fd, buf.c_str(), buf.length());
+    if (cc != static_cast<int>(buf.length()) || fsync(fd) != 0) {
+        log_err("error writing layout file %s: %s",
+                tmp.c_str(), strerror(errno));
+        IO::close(fd);
+        return -1;
+    }
+    IO::close(fd);
+
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        log_err("can't rename layout file %s: %s",
+                tmp.c_str(), strerror(errno));
+        return -1;
+    }
+
+    return sync_dir(tables_dir_);
+}
+
+//----------------------------------------------------------------------------
+/**
+ * Collect the paths (relative to dir) of all the files in the tree
+ * under dir, along with the subdirectories. This doesn't rely on the
+ * layout so it also picks up files left behind by an interrupted
+ * migration.
+ */
+static int
+collect_tree(const std::string& dir, const std::string& rel,
+             StringVector* files, StringVector* subdirs)
+{
+    std::string path = rel.empty() ? dir : dir + "/" + rel;
+    DIR* d = opendir(path.c_str());
+    if (d == 0) {
+        return -1;
+    }
+
+    struct dirent* ent;
+    while ((ent = readdir(d)) != 0) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) {
+            continue;
+        }
+
+        std::string ent_rel = rel.empty() ? std::string(ent->d_name) :
+                              rel + "/" + ent->d_name;
+
+        bool is_dir;
+#if defined(DT_DIR)
+        if (ent->d_type != DT_UNKNOWN) {
+            is_dir = (ent->d_type == DT_DIR);
+        } else
+#endif
+        {
+            struct stat st;
+            if (lstat((dir + "/" + ent_rel).c_str(), &st) != 0) {
+                closedir(d);
+                return -1;
+            }
+            is_dir = S_ISDIR(st.st_mode);
+        }
+
+        if (is_dir) {
+            if (collect_tree(dir, ent_rel, files, subdirs) != 0) {
+                closedir(d);
+                return -1;
+            }
+            subdirs->push_back(ent_rel);
+        } else {
+            files->push_back(ent_rel);
+        }
+    }
+
+    closedir(d);
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+int
+FileSystemStore::migrate_layout(int levels)
+{
+    StringVector tables;
+    if (get_table_names(&tables) != 0) {
+        return -1;
+    }
+
+    if (! tables.empty()) {
+        log_notice("migrating %zu tables from %d to %d levels of subdirectories",
+                   tables.size(), dir_levels_, levels);
+    }
+
+    // the renames are made durable before the new layout is written,
+    // so if this is interrupted it is just run again
+    std::set<std::string> changed;
+    bool saved_batch_sync = batch_sync_;
+    batch_sync_ = false;
+    
+    for (size_t i = 0; i < tables.size(); ++i) {
+        std::string table_dir = tables_dir_ + "/" + tables[i];
+
+        StringVector files, subdirs;
+        if (collect_tree(table_dir, "", &files, &subdirs) != 0) {
+            log_err("can't scan table directory %s: %s",
+                    table_dir.c_str(), strerror(errno));
+            batch_sync_ = saved_batch_sync;
+            return -1;
+        }
+
+        size_t moved = 0;
+        for (size_t j = 0; j < files.size(); ++j) {
+            std::string old_path = table_dir + "/" + files[j];
+            
+            size_t slash = files[j].rfind('/');
+            std::string key = (slash == std::string::npos) ? files[j] :
+                              files[j].substr(slash + 1);
+
+            std::string dir = shard_dir(table_dir, key.c_str(), levels);
+            std::string new_path = dir + "/" + key;
+            if (new_path == old_path) {
+                continue;
+            }
+
+            if (make_shard_dirs(table_dir, dir) != 0 ||
+                rename(old_path.c_str(), new_path.c_str()) != 0)
+            {
+                log_err("can't move %s to %s: %s", old_path.c_str(),
+                        new_path.c_str(), strerror(errno));
+                batch_sync_ = saved_batch_sync;
+                return -1;
+            }
+
+            changed.insert(old_path.substr(0, old_path.rfind('/')));
+            for (std::string sub = dir; sub.length() > table_dir.length();
+                 sub = sub.substr(0, sub.rfind('/')))
+            {
+                changed.insert(sub.substr(0, sub.rfind('/')));
+                changed.insert(sub);
+            }
+            ++moved;
+        }
+
+        // subdirs are listed deepest first, so the ones that have been
+        // emptied can be removed in order
+        for (size_t j = 0; j < subdirs.size(); ++j) {
+            std::string sub = table_dir + "/" + subdirs[j];
+            if (rmdir(sub.c_str()) == 0) {
+                changed.erase(sub);
+                changed.insert(sub.substr(0, sub.rfind('/')));
+            }
+        }
+
+        log_info("moved %zu of %zu files in table %s",
+                 moved, files.size(), tables[i].c_str());
+    }
+
+    batch_sync_ = saved_batch_sync;
+
+    // the new subdirectories have to be synced to their parents too
+    for (std::set<std::string>::reverse_iterator iter = changed.rbegin();
+         iter != changed.rend(); ++iter)
+    {
+        if (sync_dir(*iter) != 0) {
+            return -1;
+        }
+    }
+
+    if (write_layout(levels) != 0) {
+        return -1;
+    }
+
+    dir_levels_ = levels;
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+void
+FileSystemStore::sync_write(int fd, const std::string& path,
+                            const std::string& dir, bool new_entry)
+{
+    ASSERT(batch_sync_);
+
+    if (! in_txn_) {
+        if (fsync(fd) != 0) {
+            log_err("error syncing %s: %s", path.c_str(), strerror(errno));
+        }
+        if (new_entry) {
+            sync_dir(dir);
+        }
+        return;
+    }
+
+    ScopeLock l(&sync_lock_, "FileSystemStore::sync_write");
+    sync_files_.insert(path);
+    if (new_entry) {
+        sync_dirs_.insert(dir);
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+FileSystemStore::sync_dir_changed(const std::string& dir)
+{
+    ASSERT(batch_sync_);
+
+    if (! in_txn_) {
+        sync_dir(dir);
+        return;
+    }
+
+    ScopeLock l(&sync_lock_, "FileSystemStore::sync_dir_changed");
+    sync_dirs_.insert(dir);
+}
+
+//----------------------------------------------------------------------------
+int
+FileSystemStore::sync_batch()
+{
+    std::set<std::string> files, dirs;
+    {
+        ScopeLock l(&sync_lock_, "FileSystemStore::sync_batch");
+        files.swap(sync_files_);
+        dirs.swap(sync_dirs_);
+    }
+
+    log_debug("syncing %zu files and %zu directories",
+              files.size(), dirs.size());
+    
+    int ret = 0;
+    std::set<std::string>::iterator iter;
+    for (iter = files.begin(); iter != files.end(); ++iter) {
+        int fd = -1;
+        if (fd_cache_ != 0) {
+            fd = fd_cache_->get_and_pin(*iter);
+        }
+
+        bool pinned = (fd != -1);
+        if (! pinned) {
+            fd = open(iter->c_str(), O_RDONLY);
+            if (fd == -1) {
+                // deleted again later in the batch
+                if (errno != ENOENT) {
+                    log_err("can't open %s to sync: %s",
+                            iter->c_str(), strerror(errno));
+                    ret = -1;
+                }
+                continue;
+            }
+        }
+
+        if (fsync(fd) != 0) {
+            log_err("error syncing %s: %s", iter->c_str(), strerror(errno));
+            ret = -1;
+        }
+
+        if (pinned) {
+            fd_cache_->unpin(*iter);
+        } else {
+            IO::close(fd);
+        }
+    }
+
+    // the directories are synced after the files so that a new entry
+    // never points at a file whose data isn't on disk
+    for (iter = dirs.begin(); iter != dirs.end(); ++iter) {
+        if (sync_dir(*iter) != 0) {
+            ret = -1;
+        }
+    }
+
+    return ret;
+}
+
+//----------------------------------------------------------------------------
+int
+FileSystemStore::sync_dir(const std::string& dir)
+{
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd == -1) {
+        if (errno == ENOENT) {
+            return 0;
+        }
+        log_err("can't open directory %s to sync: %s",
+                dir.c_str(), strerror(errno));
+        return -1;
+    }
+
+    int err = fsync(fd);
+    if (err != 0) {
+        log_err("error syncing directory %s: %s", dir.c_str(), strerror(errno));
+    }
+    IO::close(fd);
+
+    return (err == 0) ? 0 : -1;
+}
+
 //----------------------------------------------------------------------------
 FileSystemTable::FileSystemTable(const char*               logpath,
                                  const std::string&        table_name,
                                  const std::string&        path,
                                  bool                      multitype,
-                                 FileSystemStore::FdCache* cache)
+                                 FileSystemStore*          store)
     : DurableTableImpl(table_name, multitype),
       Logger("FileSystemTable", "%s/%s", logpath, table_name.c_str()),
       path_(path),
-      cache_(cache)
+      store_(store),
+      cache_(store->fd_cache_)
 {}
 
 //----------------------------------------------------------------------
 FileSystemTable::~FileSystemTable()
 {}
 
+//----------------------------------------------------------------------------
+std::string
+FileSystemTable::file_path(const char* key_str, std::string* dir) const
+{
+    *dir = FileSystemStore::shard_dir(path_, key_str, store_->dir_levels_);
+    return *dir + "/" + key_str;
+}
+
 //----------------------------------------------------------------------------
 int 
 FileSystemTable::get(const SerializableObject& key,
@@ -370,18 +835,14 @@ FileSystemTable::put(const SerializableObject&  key,
         return DS_ERR;
     }
     
-    ScratchBuffer<u_char*, 4096> scratch;
-    Marshal m(Serialize::CONTEXT_LOCAL, &scratch);
-    
-    if (multitype_) {
-        m.process("typecode", &typecode);
-    }
-    if (m.action(data) != 0) {
+    ExpandableBuffer* scratch = marshal_data(typecode, data);
+    if (scratch == NULL) {
         log_warn("can't marshal data");
         return DS_ERR;
     }
 
-    std::string filename = path_ + "/" + key_str.buf();
+    std::string dir;
+    std::string filename = file_path(key_str.buf(), &dir);
     int data_elt_fd      = -1;
     int open_flags       = O_TRUNC | O_RDWR;
 
@@ -404,6 +865,18 @@ FileSystemTable::put(const SerializableObject&  key,
     {
         data_elt_fd = open(filename.c_str(), open_flags, 
                            S_IRUSR | S_IWUSR | S_IRGRP);
+
+        // the first record in a subdirectory creates it
+        if (data_elt_fd == -1 && errno == ENOENT &&
+            (open_flags & O_CREAT) && dir != path_)
+        {
+            if (store_->make_shard_dirs(path_, dir) != 0) {
+                return DS_ERR;
+            }
+            data_elt_fd = open(filename.c_str(), open_flags, 
+                               S_IRUSR | S_IWUSR | S_IRGRP);
+        }
+        
         if (data_elt_fd == -1)
         {
             if (errno == ENOENT) 
@@ -452,10 +925,8 @@ FileSystemTable::put(const SerializableObject&  key,
         ASSERT(cc == 0);
     }
 
-    int cc = IO::writeall(data_elt_fd, 
-                          reinterpret_cast<char*>(scratch.buf()), 
-                          scratch.len());
-    if (cc != static_cast<int>(scratch.len())) 
+    int cc = IO::writeall(data_elt_fd, scratch->raw_buf(), scratch->len());
+    if (cc != static_cast<int>(scratch->len())) 
     {
         log_warn("put() - errors writing to file %s, %d: %s",
                  filename.c_str(), cc, strerror(errno));
@@ -465,10 +936,24 @@ FileSystemTable::put(const SerializableObject&  key,
         }
         return DS_ERR;
     }
+
+    // a cached fd isn't truncated when it's reused, so drop whatever
+    // was left over from a longer record
+    if (cache_ && IO::truncate(data_elt_fd, scratch->len()) != 0)
+    {
+        log_warn("put() - error truncating file %s: %s",
+                 filename.c_str(), strerror(errno));
+        cache_->unpin(filename);
+        return DS_ERR;
+    }
+
+    if (store_->batch_sync_)
+    {
+        store_->sync_write(data_elt_fd, filename, dir, flags & DS_CREATE);
+    }
     
     if (cache_)
     {
-        // close(data_elt_fd); XXX/bowei -- fsync?
         cache_->unpin(filename);
     }
     else
@@ -491,7 +976,8 @@ FileSystemTable::del(const SerializableObject& key)
         return DS_ERR;
     }
     
-    std::string filename = path_ + "/" + key_str.buf();
+    std::string dir;
+    std::string filename = file_path(key_str.buf(), &dir);
 
     if (cache_)
     {
@@ -509,6 +995,11 @@ FileSystemTable::del(const SerializableObject& key)
                  strerror(errno));
         return DS_ERR;
     }
+
+    if (store_->batch_sync_)
+    {
+        store_->sync_dir_changed(dir);
+    }
     
     return 0;
 }
@@ -518,32 +1009,20 @@ size_t
 FileSystemTable::size() const
 {
     // XXX/bowei -- be inefficient for now
-    DIR* dir = opendir(path_.c_str());
-    ASSERT(dir != 0);
-    
-    size_t count;
-    struct dirent* ent;
+    size_t count = FileSystemIterator::scan(path_, store_->dir_levels_,
+                                            store_->scan_threads_, NULL);
 
-    for (count = 0, ent = readdir(dir); 
-         ent != 0; ent = readdir(dir))
-    {
-        ASSERT(ent != 0);
-        ++count;
-    }
+    log_debug("table size = %zu", count);
 
-    closedir(dir);
-
-    // count always includes '.' and '..'
-    log_debug("table size = %zu", count - 2);
-
-    return count - 2; 
+    return count; 
 }
     
 //----------------------------------------------------------------------------
 DurableIterator* 
 FileSystemTable::itr()
 {
-    return new FileSystemIterator(path_);
+    return new FileSystemIterator(path_, store_->dir_levels_,
+                                  store_->scan_threads_);
 }
 
 //----------------------------------------------------------------------------
@@ -558,8 +1037,8 @@ FileSystemTable::get_common(const SerializableObject& key,
         return DS_ERR;
     }
     
-    std::string file_name(key_str.at(0));
-    std::string file_path = path_ + "/" + file_name;
+    std::string dir;
+    std::string file_path = this->file_path(key_str.at(0), &dir);
     log_debug("opening file %s", file_path.c_str());
 
     
@@ -621,23 +1100,147 @@ FileSystemTable::get_common(const SerializableObject& key,
 }
 
 //----------------------------------------------------------------------------
-FileSystemIterator::FileSystemIterator(const std::string& path)
-    : ent_(0)
+/**
+ * List the record files under dir, which is depth levels down in a
+ * table with levels levels of subdirectories.
+ */
+static void
+scan_dir(const std::string& dir, int depth, int levels,
+         StringVector* names, size_t* count)
+{
+    DIR* d = opendir(dir.c_str());
+    if (d == 0) {
+        // subdirectories are only created when they're first used
+        if (errno != ENOENT) {
+            log_warn_p("/oasys/storage/filesysdb", "can't scan %s: %s",
+                       dir.c_str(), strerror(errno));
+        }
+        return;
+    }
+
+    struct dirent* ent;
+    while ((ent = readdir(d)) != 0) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) {
+            continue;
+        }
+
+        if (depth < levels) {
+            scan_dir(dir + "/" + ent->d_name, depth + 1, levels, names, count);
+        } else {
+            ++(*count);
+            if (names != NULL) {
+                names->push_back(ent->d_name);
+            }
+        }
+    }
+
+    closedir(d);
+}
+
+/**
+ * Thread that scans every step'th top level subdirectory of a table,
+ * starting with first.
+ */
+class ShardScanThread : public Thread {
+public:
+    ShardScanThread(const std::string& path, int levels,
+                    int first, int step, bool keep_names)
+        : Thread("ShardScanThread", CREATE_JOINABLE), count_(0),
+          path_(path), levels_(levels), first_(first), step_(step),
+          keep_names_(keep_names) {}
+
+    StringVector names_;    ///< Files found (if keep_names)
+    size_t       count_;    ///< Number of files found
+
+protected:
+    void run() {
+        char shard[4];
+        for (int i = first_; i < 256; i += step_) {
+            snprintf(shard, sizeof(shard), "/%02x", i);
+            scan_dir(path_ + shard, 1, levels_,
+                     keep_names_ ? &names_ : NULL, &count_);
+        }
+    }
+
+    std::string path_;
+    int         levels_;
+    int         first_;
+    int         step_;
+    bool        keep_names_;
+};
+
+//----------------------------------------------------------------------------
+size_t
+FileSystemIterator::scan(const std::string& path, int levels,
+                         int scan_threads, StringVector* names)
 {
-    dir_ = opendir(path.c_str());
-    ASSERT(dir_ != 0);
+    size_t count = 0;
+
+    if (levels == 0 || scan_threads <= 1) {
+        scan_dir(path, 0, levels, names, &count);
+        return count;
+    }
+
+    if (scan_threads > 256) {
+        scan_threads = 256;
+    }
+
+    std::vector<ShardScanThread*> threads;
+    for (int i = 0; i < scan_threads; ++i) {
+        ShardScanThread* t = new ShardScanThread(path, levels, i, scan_threads,
+                                                 names != NULL);
+        t->start();
+        threads.push_back(t);
+    }
+
+    for (int i = 0; i < scan_threads; ++i) {
+        ShardScanThread* t = threads[i];
+        t->join();
+        count += t->count_;
+        if (names != NULL) {
+            names->insert(names->end(), t->names_.begin(), t->names_.end());
+        }
+        delete t;
+    }
+
+    return count;
+}
+
+//----------------------------------------------------------------------------
+FileSystemIterator::FileSystemIterator(const std::string& path,
+                                       int levels, int scan_threads)
+    : ent_(0), dir_(0), cur_(0)
+{
+    if (levels == 0) {
+        dir_ = opendir(path.c_str());
+        ASSERT(dir_ != 0);
+    } else {
+        scan(path, levels, scan_threads, &names_);
+    }
 }
 
 //----------------------------------------------------------------------------
 FileSystemIterator::~FileSystemIterator()
 {
-    closedir(dir_);
+    if (dir_ != 0) {
+        closedir(dir_);
+    }
 }
     
 //----------------------------------------------------------------------------
 int 
 FileSystemIterator::next()
 {
+    if (dir_ == 0) 
+    {
+        if (cur_ == names_.size()) 
+        {
+            return DS_NOTFOUND;
+        }
+        ++cur_;
+        return 0;
+    }
+
   skip_dots:
     ent_ = readdir(dir_);
 
@@ -666,9 +1269,16 @@ FileSystemIterator::next()
 int 
 FileSystemIterator::get_key(SerializableObject* key)
 {
-    ASSERT(ent_ != 0);
+    const char* name;
+    if (dir_ == 0) {
+        ASSERT(cur_ != 0);
+        name = names_[cur_ - 1].c_str();
+    } else {
+        ASSERT(ent_ != 0);
+        name = ent_->d_name;
+    }
     
-    KeyUnmarshal um(ent_->d_name, strlen(ent_->d_name), "-");
+    KeyUnmarshal um(name, strlen(name), "-");
     int err = um.action(key);
     if (err != 0) {
         return DS_ERR;
@@ -20,6 +20,8 @@
 
 #include <sys/types.h>
 #include <dirent.h>
+#include <set>
+#include <string>
 
 #include "../debug/Logger.h"
 #include "../thread/SpinLock.h"
@@ -43,6 +45,17 @@ class FileSystemIterator;
  * directly.
  *
  * NEW: Now with a level of indirection!
+ *
+ * Each table is a directory holding one file per record. So that the
+ * directories stay small the files are spread over fs_dir_levels_
+ * levels of subdirectories named by successive bytes of a hash of the
+ * key (e.g. table/3f/key with one level). The layout in use is kept
+ * in the .layout file in the tables directory and an existing database
+ * is migrated when it is opened with a different setting.
+ *
+ * With fs_batch_sync_ the files written inside a transaction and the
+ * directories whose entries changed are remembered and each one is
+ * fsync'ed once when the transaction is durably committed.
  */
 class FileSystemStore : public DurableStoreImpl {
     friend class FileSystemTable;
@@ -67,12 +80,15 @@ public:
     int del_table(const std::string& name);
     int get_table_names(StringVector* names);
     std::string get_info() const;
+    bool concurrent_tables() const { return true; }
 
     //! FileSystemStore doesn't really do transactions, so
-    //! begin_transaction is not implemented, but
-    //! end_transaction forces an fsync of all the open
-    //! file descriptors used for tables (in the cache_).
-    //! get_underlying can't return anything useful either.
+    //! begin_transaction only notes that writes should be batched
+    //! up for fs_batch_sync_, and end_transaction forces an fsync of
+    //! the batch or all the open file descriptors used for tables
+    //! (in the cache_). get_underlying can't return anything useful
+    //! either.
+    int begin_transaction(void **txid);
     int end_transaction (void *txid, bool be_durable);
     //! @}
 
@@ -86,6 +102,21 @@ private:
     
     FdCache*    fd_cache_;
 
+    int         dir_levels_;    //!< Levels of subdirectories in a table
+    int         scan_threads_;  //!< Threads used to scan a table
+    bool        batch_sync_;    //!< Sync the writes once per commit
+    bool        in_txn_;        //!< A transaction is open
+
+    SpinLock              sync_lock_;  //!< Lock for the sync sets
+    std::set<std::string> sync_files_; //!< Files written in the batch
+    std::set<std::string> sync_dirs_;  //!< Directories changed in the batch
+
+    //! Maximum number of subdirectory levels
+    static const int MAX_DIR_LEVELS = 3;
+
+    //! Name of the file holding the layout in the tables directory
+    static const char* LAYOUT_FILE;
+
     //! Check for the existance of databases. @return 0 on no error.
     //! @return -2 if the database file doesn't exist. Otherwise -1.
     int check_database();
@@ -101,6 +132,41 @@ private:
     int acquire_table(const std::string& table);
     int release_table(const std::string& table);
     /// @}
+
+    //! @return the subdirectory of table_dir holding the file for key
+    static std::string shard_dir(const std::string& table_dir,
+                                 const char* key, int levels);
+
+    //! Create the subdirectories down to dir. @return 0 on no error.
+    int make_shard_dirs(const std::string& table_dir,
+                        const std::string& dir);
+
+    //! Read the number of subdirectory levels from the layout
+    //! file. @return 0 on no error, -2 if there is no layout file.
+    int read_layout(int* levels);
+
+    //! Durably write the layout file. @return 0 on no error.
+    int write_layout(int levels);
+
+    //! Move the files of every table into the subdirectories for
+    //! the given number of levels. @return 0 on no error.
+    int migrate_layout(int levels);
+
+    /// @{ Called with fs_batch_sync_ after a file has been written or
+    /// a directory entry has been added or removed. Outside of a
+    /// transaction the change is synced right away, otherwise it's
+    /// added to the batch.
+    void sync_write(int fd, const std::string& path,
+                    const std::string& dir, bool new_entry);
+    void sync_dir_changed(const std::string& dir);
+    /// @}
+
+    //! fsync the batched files and then directories. @return 0 on no
+    //! error.
+    int sync_batch();
+
+    //! fsync a directory. @return 0 on no error.
+    int sync_dir(const std::string& dir);
 };
 
 class FileSystemTable : public DurableTableImpl, public Logger {
@@ -131,6 +197,11 @@ public:
 private:
     std::string path_;
 
+    /*!
+     * The store, for the layout and batched syncs.
+     */
+    FileSystemStore* store_;
+
     /*!
      * Shared Fd cache.
      */
@@ -140,7 +211,11 @@ private:
                     const std::string&        table_name,
                     const std::string&        path,
                     bool                      multitype,
-                    FileSystemStore::FdCache* cache);
+                    FileSystemStore*          store);
+
+    //! @return the path of the file for the given key string, and the
+    //! subdirectory it is in in dir
+    std::string file_path(const char* key_str, std::string* dir) const;
 
     int get_common(const SerializableObject& key,
                    ExpandableBuffer* buf);
@@ -151,9 +226,12 @@ class FileSystemIterator : public DurableIterator {
 private:
     /**
      * Create an iterator for table t. These should not be called
-     * except by FileSystemTable.
+     * except by FileSystemTable. A flat table is read one entry at a
+     * time, otherwise the subdirectories are all scanned up front by
+     * scan_threads threads.
      */
-    FileSystemIterator(const std::string& directory);
+    FileSystemIterator(const std::string& directory,
+                       int levels, int scan_threads);
 
 public:
     virtual ~FileSystemIterator();
@@ -163,9 +241,20 @@ public:
     int get_key(SerializableObject* key);
     //! @}
 
+    /**
+     * Count the record files in the table directory and (if names is
+     * non-NULL) list them, with each of up to scan_threads threads
+     * scanning a share of the top level subdirectories.
+     */
+    static size_t scan(const std::string& directory, int levels,
+                       int scan_threads, StringVector* names);
+
 protected:
     struct dirent* ent_;
     DIR*           dir_;
+
+    StringVector   names_;  ///< Scanned record files
+    size_t         cur_;    ///< Position in names_
 };
 
 } // namespace oasys
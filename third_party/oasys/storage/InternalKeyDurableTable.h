@@ -19,6 +19,7 @@
 
 #include "../debug/Logger.h"
 #include "../debug/DebugUtils.h"
+#include "../thread/SpinLock.h"
 #include "DurableStore.h"
 #include "StorageConfig.h"
 
@@ -46,6 +47,11 @@ namespace oasys {
  * unexpected cases in the interface, e.g. logging a warning on a call
  * to get() for an id that's not in the table, PANIC on internal
  * database errors, etc.
+ *
+ * Each access to the table is made holding the lock returned by
+ * lock(), which is private to the table if the store allows tables to
+ * be used concurrently and shared by all tables otherwise, so callers
+ * don't need to serialize access to the store themselves.
  */
 template <typename _ShimType, typename _KeyType, typename _DataType>
 class InternalKeyDurableTable : public Logger {
@@ -78,6 +84,13 @@ public:
 
     bool del(_KeyType id);
 
+    /**
+     * The lock held while the table is accessed. Callers can hold it
+     * to make a series of accesses atomic with respect to other users
+     * of the table.
+     */
+    Lock* lock() const { return lock_; }
+
     /**
      * STL-style iterator.
      */
@@ -138,6 +151,9 @@ protected:
     SingleTypeDurableTable<_DataType>* table_;
     const char* datatype_;
     const char* table_name_;
+
+    mutable SpinLock table_lock_;   ///< the table's own lock
+    Lock* lock_;                    ///< table_lock_ or the store's shared lock
 };
 
 #include "InternalKeyDurableTable.tcc"
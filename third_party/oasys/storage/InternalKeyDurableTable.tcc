@@ -35,7 +35,8 @@ _InternalKeyDurableTableClass::InternalKeyDurableTable(const char* classname,
                                                        const char* datatype,
                                                        const char* table_name)
     : Logger(classname, "%s", logpath),
-      datatype_(datatype), table_name_(table_name)
+      datatype_(datatype), table_name_(table_name),
+      lock_(&table_lock_)
 {
 }
 
@@ -68,6 +69,8 @@ _InternalKeyDurableTableClass::do_init(const StorageConfig& cfg,
         log_err("error initializing durable store");
         return err;
     }
+
+    lock_ = store->table_access_lock(&table_lock_);
     
     return 0;
 }
@@ -95,6 +98,8 @@ _InternalKeyDurableTableClass::do_init_aux(const StorageConfig& cfg,
         log_err("error initializing durable store");
         return err;
     }
+
+    lock_ = store->table_access_lock(&table_lock_);
     
     return 0;
 }
@@ -105,6 +110,7 @@ inline bool
 _InternalKeyDurableTableClass::add(_DataType* data)
 {
     _ShimType shim(data->durable_key());
+    ScopeLock l(lock_, "InternalKeyDurableTable::add");
     int err = table_->put(shim, data, DS_CREATE | DS_EXCL);
 
     if (err == DS_EXISTS) {
@@ -127,6 +133,7 @@ _InternalKeyDurableTableClass::get(_KeyType key)
 {
     _DataType* data = NULL;
     _ShimType shim(key);
+    ScopeLock l(lock_, "InternalKeyDurableTable::get");
     int err = table_->get(shim, &data);
 
     if (err == DS_NOTFOUND) {
@@ -151,6 +158,7 @@ bool
 _InternalKeyDurableTableClass::update(_DataType* data)
 {
     _ShimType shim(data->durable_key());
+    ScopeLock l(lock_, "InternalKeyDurableTable::update");
     int err = table_->put(shim, data, 0);
 
     if (err == DS_NOTFOUND) {
@@ -173,6 +181,7 @@ bool
 _InternalKeyDurableTableClass::del(_KeyType key)
 {
     _ShimType shim(key);
+    ScopeLock l(lock_, "InternalKeyDurableTable::del");
 
     int err = table_->del(shim);
     
@@ -224,6 +233,8 @@ template <typename _ShimType, typename _KeyType, typename _DataType>
 int
 _InternalKeyDurableTableClass::iterator::next()
 {
+    ScopeLock l(table_->lock_, "InternalKeyDurableTable::iterator::next");
+
     int err = iter_->next();
     if (err == DS_NOTFOUND)
     {
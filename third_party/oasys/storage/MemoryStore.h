@@ -115,6 +115,7 @@ public:
     int del_table(const std::string& name);
     int get_table_names(StringVector* names);
     std::string get_info() const;
+    bool concurrent_tables() const { return true; }
 
     //! Memory Store doesn't do transactions, so
     //! begin_transaction, end_transaction are not implemented.
@@ -572,6 +572,11 @@ ODBCDBSQLite::init(const StorageConfig & cfg)
     	return ret;
     }
 
+    ret = set_pragmas( cfg );
+    if ( ret != DS_OK ) {
+    	return ret;
+    }
+
     // If tidy was requested and the database was not scrubbed by previous directory
     // pruning, drop all the tables and recreate them.
     if (cfg.tidy_ && !dirs_are_same){
@@ -740,6 +745,53 @@ ODBCDBSQLite::create_finalize(const StorageConfig& cfg)
 
 }
 
+//----------------------------------------------------------------------------
+// The write-ahead log lets readers carry on while the storage thread is
+// writing and turns each commit into a sequential append rather than a
+// rewrite of the rollback journal.  The synchronous level follows the
+// durability setting: if every transaction is meant to be durable the
+// log is synced on each commit (FULL), otherwise it is only synced at
+// checkpoints (NORMAL) which in WAL mode can lose the most recent
+// transactions after a power failure but can not corrupt the database.
+// The journal mode is persistent in the database file and must be set
+// while auto-commit is still on, so this is done straight after
+// connecting.
+int
+ODBCDBSQLite::set_pragmas(const StorageConfig& cfg)
+{
+    const char *pragmas[2];
+    pragmas[0] = cfg.odbc_sqlite_wal_ ? "PRAGMA journal_mode=WAL"
+                                      : "PRAGMA journal_mode=DELETE";
+    pragmas[1] = (cfg.max_nondurable_transactions_ > 0) ? "PRAGMA synchronous=NORMAL"
+                                                        : "PRAGMA synchronous=FULL";
+
+    for (int i = 0; i < 2; ++i) {
+        sqlRC = SQLFreeStmt(dbenv_.hstmt, SQL_CLOSE);
+        if (!SQL_SUCCEEDED(sqlRC))
+        {
+            log_crit("ERROR:  set_pragmas - failed Statement Handle SQL_CLOSE");
+            return DS_ERR;
+        }
+
+        sqlRC = SQLExecDirect(dbenv_.hstmt, (SQLCHAR *) pragmas[i], SQL_NTS);
+        if (!(SQL_SUCCEEDED(sqlRC) || (sqlRC == SQL_NO_DATA))) {
+            log_crit("ERROR: set_pragmas - '%s' failed - ret %d", pragmas[i], sqlRC);
+            return DS_ERR;
+        }
+        log_info("set_pragmas: %s", pragmas[i]);
+    }
+
+    // journal_mode returns the resulting mode as a row so close the cursor
+    sqlRC = SQLFreeStmt(dbenv_.hstmt, SQL_CLOSE);
+    if (!SQL_SUCCEEDED(sqlRC))
+    {
+        log_crit("ERROR:  set_pragmas - failed Statement Handle SQL_CLOSE");
+        return DS_ERR;
+    }
+
+    return DS_OK;
+}
+
 //----------------------------------------------------------------------------
 std::string
 ODBCDBSQLite::get_info()const
@@ -80,6 +80,10 @@ class ODBCDBSQLite: public ODBCDBStore
     //! Parser for odbc.ini files - identifies DSN corresponding to dsn_name
     //  and returns selected items from the DSN as output parameters.
     int parse_odbc_ini_SQLite(const char *dsn_name, char *full_path);
+
+    //! Select the journal mode and the synchronous level that match the
+    //  configured durability.
+    int set_pragmas(const StorageConfig& cfg);
     std::string schema_creation_command_;	///< Holds command to be run at end of initialisation.
 };
 
@@ -223,7 +223,8 @@ ODBCDBStore::ODBCDBStore(const char* derived_classname, const char *logpath):
 DurableStoreImpl(derived_classname, logpath),
 init_(false),
 auto_commit_(true),
-serialize_all_(true)
+serialize_all_(true),
+del_batch_size_(0)
 {
     logpath_appendf("/ODBCDBStore/%s", derived_classname);
     log_debug("constructor enter/exit.");
@@ -287,7 +288,7 @@ ODBCDBStore::begin_transaction(void **txid)
     log_debug("ODBCDBStore::begin_transaction enter.");
 
     /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+     * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
      * Probably overkill as trans_hstmt doesn't use parameters or columns.
      */
     ret = SQLFreeStmt(dbenv_.trans_hstmt, SQL_CLOSE);
@@ -340,6 +341,10 @@ ODBCDBStore::end_transaction(void *txid, bool be_durable)
 
     log_debug("ODBCDBStore::end_transaction %p enter.", txid);
 
+    if (flush_pending_dels() != DS_OK) {
+        log_err("end_transaction: error issuing queued deletes");
+    }
+
     if (be_durable)
     {
         SQLRETURN ret;
@@ -352,7 +357,7 @@ ODBCDBStore::end_transaction(void *txid, bool be_durable)
         }
 
         /*!
-         * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+         * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
          * Probably overkill as trans_hstmt doesn't use parameters or columns.
          */
         ret = SQLFreeStmt(dbenv_.trans_hstmt, SQL_CLOSE);
@@ -383,6 +388,27 @@ ODBCDBStore::end_transaction(void *txid, bool be_durable)
     return DS_OK;
 }
 
+//----------------------------------------------------------------------------
+int
+ODBCDBStore::flush_pending_dels()
+{
+    std::set<ODBCDBTable*> tables;
+    {
+        ScopeLock l(&pending_del_lock_, "flush_pending_dels()");
+        tables.swap(pending_del_tables_);
+    }
+
+    int ret = DS_OK;
+    std::set<ODBCDBTable*>::iterator iter;
+    for (iter = tables.begin(); iter != tables.end(); ++iter) {
+        ScopeLock l(&(*iter)->lock_, "flush_pending_dels()");
+        if ((*iter)->flush_pending_dels() != DS_OK) {
+            ret = DS_ERR;
+        }
+    }
+    return ret;
+}
+
 //----------------------------------------------------------------------------
 void *
 ODBCDBStore::get_underlying()
@@ -423,7 +449,7 @@ ODBCDBStore::get_table(DurableTableImpl ** table,
     snprintf(my_SQL_str, 500, "SELECT count(*) FROM %s", name.c_str());
 
     /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+     * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
      * Probably overkill as trans_hstmt doesn't use parameters or columns.
      */
     sqlRC = SQLFreeStmt(dbenv_.hstmt, SQL_CLOSE);
@@ -531,7 +557,7 @@ ODBCDBStore::del_table(const std::string & name)
     log_info("del_table DROPPING table %s", name.c_str());
 
     /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+     * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
      * Probably overkill as trans_hstmt doesn't use parameters or columns.
      */
     sqlRC = SQLFreeStmt(dbenv_.hstmt, SQL_CLOSE);
@@ -577,7 +603,7 @@ ODBCDBStore::get_table_names(StringVector * names)
              META_TABLE_NAME.c_str());
 
     /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+     * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
      */
     sql_ret = SQLFreeStmt(dbenv_.hstmt, SQL_CLOSE);
     if (!SQL_SUCCEEDED(sql_ret))
@@ -657,6 +683,16 @@ ODBCDBStore::aux_tables_available()
 {
 	return aux_tables_available_;
 }
+
+//----------------------------------------------------------------------------
+bool
+ODBCDBStore::concurrent_tables() const
+{
+    // serialize_all_ is always set since the tables share one ODBC
+    // connection, so every access already goes through
+    // serialization_lock_ and the tables only run one at a time
+    return !serialize_all_;
+}
 //----------------------------------------------------------------------------
 int
 ODBCDBStore::acquire_table(const std::string & table)
@@ -697,6 +733,15 @@ ODBCDBStore::release_table(const std::string & table)
 DurableStoreResult_t
 ODBCDBStore::connect_to_database(const StorageConfig & cfg)
 {
+    // Deletes are only queued when auto-commit is off so that they are
+    // still committed along with the transaction they were made in.
+    del_batch_size_ = 0;
+    if (!cfg.auto_commit_ && (cfg.odbc_del_batch_size_ > 1)) {
+        del_batch_size_ = (size_t) cfg.odbc_del_batch_size_;
+        if (del_batch_size_ > MAX_DEL_BATCH_SIZE) {
+            del_batch_size_ = MAX_DEL_BATCH_SIZE;
+        }
+    }
 
     dbenv_.m_henv = SQL_NULL_HENV;
     dbenv_.m_hdbc = SQL_NULL_HDBC;
@@ -960,6 +1005,10 @@ is_aux_table_(is_aux_table)
     log_debug("logpath is: <%s>", logpath);
     store_->acquire_table(table_name);
 
+    for (int i = 0; i < STMT_MAX; ++i) {
+        prepared_[i] = SQL_NULL_HSTMT;
+    }
+
     hstmt_ = SQL_NULL_HSTMT;
     if ((sqlRC =
          SQLAllocHandle(SQL_HANDLE_STMT, db_->m_hdbc,
@@ -1007,6 +1056,24 @@ ODBCDBTable::~ODBCDBTable()
     // Note: If we are to multithread access to the same table, this
     // will have potential concurrency problems, because close can
     // only happen if no other instance of Db is around.
+    {
+        ScopeLockIf sl(&store_->serialization_lock_,
+                       "Access by ~ODBCDBTable()",
+                       store_->serialize_all_);
+        ScopeLock l(&lock_, "Access by ~ODBCDBTable()");
+        flush_pending_dels();
+
+        ScopeLock pl(&store_->pending_del_lock_, "Access by ~ODBCDBTable()");
+        store_->pending_del_tables_.erase(this);
+    }
+
+    for (int i = 0; i < STMT_MAX; ++i) {
+        if (prepared_[i] != SQL_NULL_HSTMT) {
+            SQLFreeHandle(SQL_HANDLE_STMT, prepared_[i]);
+            prepared_[i] = SQL_NULL_HSTMT;
+        }
+    }
+
     store_->release_table(name());
 
     // SQLFreeHandle(SQL_HANDLE_STMT, hstmt_);
@@ -1042,6 +1109,10 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
     u_char *fetched_blob = NULL;
 
     log_debug("get  Table=%s: key length %d", name(), (int)key_buf_len);
+
+    flush_pending_dels();
+
+    SQLHSTMT stmt;
     char my_SQL_str[500];
     if (is_aux_table()){
     	// Check that we have a vector of descriptors to work with
@@ -1060,43 +1131,16 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
     	}
     	snprintf(my_SQL_str, 500, "SELECT %s FROM %s WHERE the_key = ?",
     			 col_list, name());
+        log_debug("get SQL command is '%s'", my_SQL_str);
+        stmt = dynamic_stmt(my_SQL_str);
 
     } else {
-        snprintf(my_SQL_str, 500, "SELECT the_data FROM %s WHERE the_key = ?",
-                 name());
+        stmt = prepared_stmt(STMT_GET);
     }
-    log_debug("get SQL command is '%s'", my_SQL_str);
 
-    /*!
-     * To fully free up the hstmt_ it is necessary to both unbind any preexisting
-     * bound output columns (SQL_CLOSE) and any preexisting bound parameters (SQL_RESET_PARAMETERS)
-     * This needs two calls to SQLFreeStmt (nicer if you could combine the options..).
-     * If this is not done and the last usage was a 'put' or 'get' with multiple
-     * parameters you run the risk of seeing random data in the bound parameters
-     * which have potentially recorded addresses which are no longer valid.  If
-     * you get an unexpected 'SQL_NEED_DATA' return from SQLExecute this is a
-     * possible (and *extremely* difficult to diagnose) problem.
-     */
-    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);       //close from any prior use
-    if (!SQL_SUCCEEDED(sql_ret))
+    if (stmt == SQL_NULL_HSTMT)
     {
-        log_crit("ERROR:  get - failed Statement Handle SQL_CLOSE");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
-
-    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  get - failed Statement Handle SQL_RESET_PARAMS");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
-
-    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
-
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_err("get SQLPrepare error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        log_err("get unable to prepare statement");
         return DS_ERR;
     }
 
@@ -1104,14 +1148,14 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
  	log_debug("get bind table key");
 
     sql_ret =
-         SQLBindParameter(hstmt_, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+         SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
                           (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                           0, 0, key_buf_ptr, 0, &key_buf_len);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("get SQLBindParameter error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
@@ -1122,7 +1166,7 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
     	for (iter = data_detail->begin();
     			iter != data_detail->end(); ++iter) {
             sql_ret =
-                SQLBindCol(hstmt_, col_no,
+                SQLBindCol(stmt, col_no,
                 		   odbc_col_c_type_map[(*iter)->column_type()],
                 		   (*iter)->data_ptr(),
                 		   (*iter)->data_size(),
@@ -1131,7 +1175,7 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
             if (!SQL_SUCCEEDED(sql_ret))
             {
                 log_err("get SQLBindCol error %d at column %d", sql_ret, col_no);
-                print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+                print_error(db_->m_henv, db_->m_hdbc, stmt);
                 delete user_data_sizes;
                 return DS_ERR;
             }
@@ -1149,13 +1193,13 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
         user_data_sizes[0] = 0;
 
         sql_ret =
-            SQLBindCol(hstmt_, 1, SQL_C_BINARY, fetched_blob, DATA_MAX_SIZE,
+            SQLBindCol(stmt, 1, SQL_C_BINARY, fetched_blob, DATA_MAX_SIZE,
                        &user_data_sizes[0]);
 
         if (!SQL_SUCCEEDED(sql_ret))
         {
             log_err("get SQLBindCol error %d", sql_ret);
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
             free(fetched_blob);
             fetched_blob = NULL;
             delete user_data_sizes;
@@ -1163,7 +1207,7 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
         }
     }
 
-    sql_ret = SQLExecute(hstmt_);
+    sql_ret = SQLExecute(stmt);
 
     if (sql_ret == SQL_NO_DATA_FOUND)
     {
@@ -1185,14 +1229,14 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
     	// Fall through
     default:
         log_debug("get SQLExecute error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         if (fetched_blob != NULL) free(fetched_blob);
         fetched_blob = NULL;
         delete user_data_sizes;
         return DS_ERR;
     }
 
-    sql_ret = SQLFetch(hstmt_);
+    sql_ret = SQLFetch(stmt);
 
     if (sql_ret == SQL_NO_DATA_FOUND)
     {
@@ -1205,7 +1249,7 @@ ODBCDBTable::get(const SerializableObject & key, SerializableObject * data)
     if (!(SQL_SUCCEEDED(sql_ret) || (sql_ret == SQL_NEED_DATA)))
     {
         log_err("get SQLFetch error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         if (fetched_blob != NULL) free(fetched_blob);
         fetched_blob = NULL;
         delete user_data_sizes;
@@ -1291,47 +1335,27 @@ ODBCDBTable::get(const SerializableObject & key,
     SQLLEN user_data_size;
 
     log_debug("get2  Table=%s", name());
-    char my_SQL_str[500];
-    snprintf(my_SQL_str, 500, "SELECT the_data FROM %s WHERE the_key = ?",
-             name());
 
-    /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
-     */
-    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  ODBCDBStore::get2 - failed Statement Handle SQL_CLOSE");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
+    flush_pending_dels();
 
-    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-    if (!SQL_SUCCEEDED(sql_ret))
+    SQLHSTMT stmt = prepared_stmt(STMT_GET);
+    if (stmt == SQL_NULL_HSTMT)
     {
-        log_crit("ERROR:  get2 - failed Statement Handle SQL_RESET_PARAMS");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
-
-    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
-
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_err("get2 SQLPrepare error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        log_err("get2 unable to prepare statement");
         return DS_ERR;
     }
 
     // Bind the key parameter
  	log_debug("get2 bind table key");
     sql_ret =
-         SQLBindParameter(hstmt_, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+         SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
                           (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                           0, 0, key_buf_ptr, 0, &key_buf_len);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("get2 SQLBindParameter error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
@@ -1342,19 +1366,19 @@ ODBCDBTable::get(const SerializableObject & key,
     }
 
     sql_ret =
-        SQLBindCol(hstmt_, 1, SQL_C_BINARY, fetched_blob, DATA_MAX_SIZE,
+        SQLBindCol(stmt, 1, SQL_C_BINARY, fetched_blob, DATA_MAX_SIZE,
                    &user_data_size);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("get2 SQLBindCol error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         free(fetched_blob);
         fetched_blob = NULL;
         return DS_ERR;
     }
 
-    sql_ret = SQLExecute(hstmt_);
+    sql_ret = SQLExecute(stmt);
 
     if (sql_ret == SQL_NO_DATA_FOUND)
     {
@@ -1366,13 +1390,13 @@ ODBCDBTable::get(const SerializableObject & key,
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("get2 SQLExecute error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         free(fetched_blob);
         fetched_blob = NULL;
         return DS_ERR;
     }
 
-    sql_ret = SQLFetch(hstmt_);
+    sql_ret = SQLFetch(stmt);
 
     if (sql_ret == SQL_NO_DATA_FOUND)
     {
@@ -1384,7 +1408,7 @@ ODBCDBTable::get(const SerializableObject & key,
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("get2 SQLFetch error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         free(fetched_blob);
         fetched_blob = NULL;
         return DS_ERR;
@@ -1483,17 +1507,19 @@ ODBCDBTable::put(const SerializableObject & key,
     SQLLEN key_buf_len = flatten(key, &key_buf);
     u_char * key_buf_ptr = key_buf.buf();
 
-    // Temporary buffer to store serialized data
-    ScratchBuffer < u_char *, 1024 > data_buf;
-    SQLLEN data_buf_len;
-    u_char *full_buf;
+    // Serialized data, in the thread's marshal buffer
+    SQLLEN data_buf_len = 0;
+    u_char *full_buf = NULL;
 
+    SQLHSTMT stmt;
     SQLRETURN sql_ret;
     char my_SQL_str[500];
     int insert_sqlcode;
     bool row_exists = false;
     bool create_new_row = false;
 
+    flush_pending_dels();
+
     log_debug("put checking if key size %d exists", (int)key_buf_len);
     int err = key_exists(key_buf_ptr, key_buf_len);
     if (err == DS_ERR)
@@ -1533,113 +1559,72 @@ ODBCDBTable::put(const SerializableObject & key,
     	create_new_row = true;
     }
 
-    // Check if need to insert a new row -
-    if ( create_new_row ) {
-        log_debug("put inserting the_data blob with NULL value into new table row");
-        snprintf(my_SQL_str, 500, "INSERT INTO %s values(?, NULL)", name());
-
-        /*!
-         * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
-         */
-        sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);       //close for later reuse
-        if (!SQL_SUCCEEDED(sql_ret))
+    if (!is_aux_table()){
+        // marshal the type code (if multitype) and the object in a
+        // single pass into this thread's reusable buffer
+        ExpandableBuffer* data_buf = marshal_data(typecode, data);
+        if (data_buf == NULL)
         {
-            log_crit("ERROR:  put insert - failed Statement Handle SQL_CLOSE");
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            log_err("put error serializing data object");
+            return DS_ERR;
         }
 
-        sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-        if (!SQL_SUCCEEDED(sql_ret))
-        {
-            log_crit("ERROR:  put insert - failed Statement Handle SQL_RESET_PARAMS");
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-        }
+        log_debug("put serialized %zu byte object", data_buf->len());
 
-        sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
+        data_buf_len = data_buf->len();
+        full_buf = (u_char*)data_buf->raw_buf();
+    }
 
-        if (!SQL_SUCCEEDED(sql_ret))
+    // New rows (only ever in standard tables) are inserted along with
+    // their data in a single statement
+    if ( create_new_row ) {
+        log_debug("put inserting new table row");
+
+        stmt = prepared_stmt(STMT_INSERT);
+        if (stmt == SQL_NULL_HSTMT)
         {
-            log_err("put insert SQLPrepare error %d", sql_ret);
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            log_err("put insert unable to prepare statement");
             return DS_ERR;
         }
+
         sql_ret =
-                SQLBindParameter(hstmt_, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+                SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
                                  (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                                  0, 0, key_buf_ptr, 0, &key_buf_len);
 
         if (!SQL_SUCCEEDED(sql_ret))
         {
-            log_err("put insert SQLBindParameter error %d", sql_ret);
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            log_err("put insert SQLBindParameter PK error %d", sql_ret);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
             return DS_ERR;
         }
 
-        insert_sqlcode = 0;
-        sql_ret = SQLExecute(hstmt_);
-
+        sql_ret = SQLBindParameter(stmt, 2, SQL_PARAM_INPUT, SQL_C_BINARY,
+								   SQL_LONGVARBINARY,
+                                   0, 0, full_buf, 0, &data_buf_len);
         if (!SQL_SUCCEEDED(sql_ret))
         {
-        	//need to capture internal SQLCODE from SQLError for processing Duplicate PK
-            log_debug("put insert SQLExecute error %d", sql_ret);
-            insert_sqlcode = print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-            return DS_ERR;
-        } else {
-            log_debug("put insert SQLExecute succeeded");
-        }
-    }
-
-    if (!is_aux_table()){
-        // figure out the size of the data
-        MarshalSize sizer(Serialize::CONTEXT_LOCAL);
-        if (sizer.action(data) != 0)
-        {
-            log_err("put error sizing data object");
+            log_err("put insert SQLBindParameter DATA error %d", sql_ret);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
             return DS_ERR;
         }
-        size_t object_sz = sizer.size();
 
-        // and the size of the type code (if multitype)
-        size_t typecode_sz = 0;
-        if (multitype_)
-        {
-            typecode_sz = MarshalSize::get_size(&typecode);
-        }
-        // XXX/demmer -- one little optimization would be to pass the
-        // calculated size out to the caller (the generic DurableTable),
-        // so we don't have to re-calculate it in the object cache code
-
-        log_debug
-            ("put serializing %zu byte object (plus %zu byte typecode)",
-             object_sz, typecode_sz);
-
-        data_buf_len = typecode_sz + object_sz;
-        full_buf = data_buf.buf(data_buf_len);
-
-        // if we're a multitype table, marshal the type code
-        if (multitype_)
-        {
-            log_debug("marshaling type code");
-            Marshal typemarshal(Serialize::CONTEXT_LOCAL, full_buf, typecode_sz);
-            UIntShim type_shim(typecode);
-
-            if (typemarshal.action(&type_shim) != 0)
-            {
-                log_err("put error serializing type code");
-                return DS_ERR;
-            }
-        }
+        insert_sqlcode = 0;
+        sql_ret = SQLExecute(stmt);
 
-        Marshal m(Serialize::CONTEXT_LOCAL, full_buf + typecode_sz, object_sz);
-        if (m.action(data) != 0)
+        if (!SQL_SUCCEEDED(sql_ret))
         {
-            log_err("put error serializing data object");
+        	//need to capture internal SQLCODE from SQLError for processing Duplicate PK
+            log_debug("put insert SQLExecute error %d", sql_ret);
+            insert_sqlcode = print_error(db_->m_henv, db_->m_hdbc, stmt);
             return DS_ERR;
         }
+
+        log_debug("put exit (insert) thread(%08X)", (u_int32_t) pthread_self());
+        return 0;
     }
 
-    // added - after insert, now do update of the_data blob (update is easier since PUT() supports both)
-    log_debug("put update table row (real data this time)");
+    log_debug("put update table row");
     if (is_aux_table()){
     	// Check that we have a vector of descriptors to work with
     	data_detail = dynamic_cast<StoreDetail *>(const_cast<SerializableObject *>(data));
@@ -1660,35 +1645,15 @@ ODBCDBTable::put(const SerializableObject & key,
     	snprintf(my_SQL_str, 500, "UPDATE %s SET %s = ? WHERE the_key = ?",
     			 name(), col_list);
     	log_debug("put: SQL for aux table is '%s'.", my_SQL_str);
+        stmt = dynamic_stmt(my_SQL_str);
 
     } else {
-        snprintf(my_SQL_str, 500,
-                 "UPDATE %s SET the_data = ? WHERE the_key = ?", name());
-    }
-
-    /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
-     */
-    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);       //close for later reuse
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  put update - failed Statement Handle SQL_CLOSE");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        stmt = prepared_stmt(STMT_UPDATE);
     }
 
-    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  put update - failed Statement Handle SQL_RESET_PARAMS");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
-
-    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
-
-    if (!SQL_SUCCEEDED(sql_ret))
+    if (stmt == SQL_NULL_HSTMT)
     {
-        log_err("put update SQLPrepare error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        log_err("put update unable to prepare statement");
         return DS_ERR;
     }
 
@@ -1704,7 +1669,7 @@ ODBCDBTable::put(const SerializableObject & key,
     				  (*iter)->column_name(),
     				  odbc_col_c_type_map[col_type],
     				  *((*iter)->data_size_ptr()));
-            sql_ret = SQLBindParameter(hstmt_, col_no, SQL_PARAM_INPUT,
+            sql_ret = SQLBindParameter(stmt, col_no, SQL_PARAM_INPUT,
 									   odbc_col_c_type_map[col_type],
 									   odbc_col_sql_type_map[col_type],
 									   0,
@@ -1717,7 +1682,7 @@ ODBCDBTable::put(const SerializableObject & key,
                 log_err
                     ("put update SQLBindParameter %s:  error %d",
                     		(*iter)->column_name(), sql_ret);
-                print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+                print_error(db_->m_henv, db_->m_hdbc, stmt);
                 return DS_ERR;
             }
 
@@ -1725,7 +1690,7 @@ ODBCDBTable::put(const SerializableObject & key,
         // Bind the key parameter
     	log_debug("put aux table key col_no %d", col_no);
         sql_ret =
-            SQLBindParameter(hstmt_, col_no, SQL_PARAM_INPUT, SQL_C_BINARY,
+            SQLBindParameter(stmt, col_no, SQL_PARAM_INPUT, SQL_C_BINARY,
                              (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                              0, 0, key_buf_ptr, 0, &key_buf_len);
 
@@ -1733,7 +1698,7 @@ ODBCDBTable::put(const SerializableObject & key,
         {
             log_err("put update SQLBindParameter PK:  error %d",
                     sql_ret);
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
             return DS_ERR;
         }
 
@@ -1743,7 +1708,7 @@ ODBCDBTable::put(const SerializableObject & key,
         log_debug
             ("put update first 8-bytes of DATA=%x08 plus size=%d",
              *((u_int32_t* ) full_buf), (int)data_buf_len);
-        sql_ret = SQLBindParameter(hstmt_, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+        sql_ret = SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
 								   SQL_LONGVARBINARY,
                                    0, 0, full_buf, 0, &data_buf_len);
         if (!SQL_SUCCEEDED(sql_ret))
@@ -1751,13 +1716,13 @@ ODBCDBTable::put(const SerializableObject & key,
             log_err
                 ("put update SQLBindParameter DATA  error %d",
                  sql_ret);
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
             return DS_ERR;
         }
         // Bind the key parameter
     	log_debug("put standard table key");
         sql_ret =
-            SQLBindParameter(hstmt_, 2, SQL_PARAM_INPUT, SQL_C_BINARY,
+            SQLBindParameter(stmt, 2, SQL_PARAM_INPUT, SQL_C_BINARY,
                              (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                              0, 0, key_buf_ptr, 0, &key_buf_len);
 
@@ -1765,13 +1730,13 @@ ODBCDBTable::put(const SerializableObject & key,
         {
             log_err("put update SQLBindParameter PK  error %d",
                     sql_ret);
-            print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
             return DS_ERR;
         }
 
     }
 
-    sql_ret = SQLExecute(hstmt_);
+    sql_ret = SQLExecute(stmt);
 
     switch (sql_ret)
     {
@@ -1785,7 +1750,7 @@ ODBCDBTable::put(const SerializableObject & key,
         break;
     default:
         log_err("put update: SQLExecute returned error code %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
@@ -1815,6 +1780,14 @@ ODBCDBTable::del(const SerializableObject & key)
     }
     u_char * key_buf_ptr = key_buf;
 
+    // a row with a queued delete is already gone as far as the caller
+    // is concerned
+    if (del_pending(key_buf_ptr, key_buf_len))
+    {
+        log_debug("::del return NO_DATA_FOUND per queued delete");
+        return DS_NOTFOUND;
+    }
+
     //check if PK row already exists
     int err = key_exists(key_buf_ptr, key_buf_len);
     if (err == DS_NOTFOUND)
@@ -1823,53 +1796,54 @@ ODBCDBTable::del(const SerializableObject & key)
         return DS_NOTFOUND;
     }
 
-    SQLRETURN sql_ret;
-
-    log_debug("del");
-    char my_SQL_str[500];
-    snprintf(my_SQL_str, 500, "DELETE FROM %s WHERE the_key = ?", name());
-
-    /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
-     */
-    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);       //close from any prior use
-    if (!SQL_SUCCEEDED(sql_ret))
+    // With auto-commit off the delete only has to be issued before the
+    // transaction is committed, so queue it up and issue a batch of them
+    // as one multi-row DELETE.  Any other access to the table issues the
+    // queued deletes first.
+    if (store_->del_batch_size_ > 0)
     {
-        log_crit("ERROR:  del - failed Statement Handle SQL_CLOSE");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
+        pending_dels_.push_back(std::string((const char *) key_buf_ptr, key_buf_len));
+        if (pending_dels_.size() == 1)
+        {
+            ScopeLock pl(&store_->pending_del_lock_, "Access by del()");
+            store_->pending_del_tables_.insert(this);
+        }
 
-    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  del - failed Statement Handle SQL_RESET_PARAMS");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        if (pending_dels_.size() >= store_->del_batch_size_)
+        {
+            return flush_pending_dels();
+        }
+
+        log_debug("del queued (%zu pending) thread (%08X)",
+                  pending_dels_.size(), (u_int32_t) pthread_self());
+        return 0;
     }
 
-    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
+    SQLRETURN sql_ret;
 
-    if (!SQL_SUCCEEDED(sql_ret))
+    log_debug("del");
+    SQLHSTMT stmt = prepared_stmt(STMT_DELETE);
+    if (stmt == SQL_NULL_HSTMT)
     {
-        log_err("del SQLPrepare error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        log_err("del unable to prepare statement");
         return DS_ERR;
     }
 
     // Bind the key parameter
  	log_debug("del bind table key");
     sql_ret =
-         SQLBindParameter(hstmt_, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+         SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
                           (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                           0, 0, key_buf, 0, &key_buf_len);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("del SQLBindParameter error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
-    sql_ret = SQLExecute(hstmt_);
+    sql_ret = SQLExecute(stmt);
 
     if (sql_ret == SQL_NO_DATA_FOUND)
     {
@@ -1880,7 +1854,7 @@ ODBCDBTable::del(const SerializableObject & key)
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_debug("del SQLExecute error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
@@ -1899,33 +1873,20 @@ ODBCDBTable::size() const
     size_t ret;
 
     log_debug("size  Table=%s", name());
-    char my_SQL_str[500];
-    snprintf(my_SQL_str, 500, "SELECT count(*) FROM %s", name());
-
-    /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
-     */
-    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);        //close from any prior use
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  size - failed Statement Handle SQL_CLOSE");
-    }
-
-    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  size - failed Statement Handle SQL_RESET_PARAMS");
-    }
 
-    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
+    // the statement cache and the queued deletes are not part of the
+    // logical state of the table
+    ODBCDBTable *self = const_cast<ODBCDBTable *>(this);
+    self->flush_pending_dels();
 
-    if (!SQL_SUCCEEDED(sql_ret))
+    SQLHSTMT stmt = self->prepared_stmt(STMT_COUNT);
+    if (stmt == SQL_NULL_HSTMT)
     {
-        log_err("size SQLPrepare error %d", sql_ret);
+        log_err("size unable to prepare statement");
         return DS_ERR;
     }
 
-    sql_ret = SQLBindCol(hstmt_, 1, SQL_C_SLONG, &my_count, 0, NULL);
+    sql_ret = SQLBindCol(stmt, 1, SQL_C_SLONG, &my_count, 0, NULL);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
@@ -1933,7 +1894,7 @@ ODBCDBTable::size() const
         return DS_ERR;
     }
 
-    sql_ret = SQLExecute(hstmt_);
+    sql_ret = SQLExecute(stmt);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
@@ -1941,7 +1902,7 @@ ODBCDBTable::size() const
         return DS_ERR;
     }
 
-    sql_ret = SQLFetch(hstmt_);
+    sql_ret = SQLFetch(stmt);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
@@ -1973,60 +1934,36 @@ ODBCDBTable::key_exists(const void *key, size_t key_len)
     SQLLEN sql_key_len = key_len;
 
     log_debug("key_exists.");
-    char my_SQL_str[500];
-    snprintf(my_SQL_str, 500, "SELECT count(*) FROM %s WHERE the_key = ?",
-             name());
-
-    /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
-     */
-    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);
-    if (!SQL_SUCCEEDED(sql_ret))
+    SQLHSTMT stmt = prepared_stmt(STMT_EXISTS);
+    if (stmt == SQL_NULL_HSTMT)
     {
-        log_crit("ERROR:  key_exists - failed Statement Handle SQL_CLOSE");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
-
-    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_crit("ERROR:  key_exists - failed Statement Handle SQL_RESET_PARAMS");
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
-    }
-
-    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) my_SQL_str, SQL_NTS);
-
-    if (!SQL_SUCCEEDED(sql_ret))
-    {
-        log_err("key_exists SQLPrepare error %d",
-                sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        log_err("key_exists unable to prepare statement");
         return DS_ERR;
     }
     // Bind the key parameter
  	log_debug("key exists bind table key");
     sql_ret =
-         SQLBindParameter(hstmt_, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+         SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
                           (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
                           0, 0, const_cast < void *>(key), 0, &sql_key_len);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("key_exists SQLBindParameter error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
-    sql_ret = SQLBindCol(hstmt_, 1, SQL_C_SLONG, &my_count, 0, NULL);
+    sql_ret = SQLBindCol(stmt, 1, SQL_C_SLONG, &my_count, 0, NULL);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("key_exists SQLBindCol error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
-    sql_ret = SQLExecute(hstmt_);
+    sql_ret = SQLExecute(stmt);
 
     switch ( sql_ret ) {
     case SQL_SUCCESS:
@@ -2037,16 +1974,16 @@ ODBCDBTable::key_exists(const void *key, size_t key_len)
         break;
     default:
         log_err("key_exists SQLExecute error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
-    sql_ret = SQLFetch(hstmt_);
+    sql_ret = SQLFetch(stmt);
 
     if (!SQL_SUCCEEDED(sql_ret))
     {
         log_err("key_exists SQLFetch error %d", sql_ret);
-        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
         return DS_ERR;
     }
 
@@ -2061,6 +1998,249 @@ ODBCDBTable::key_exists(const void *key, size_t key_len)
     return 0;
 }
 
+//----------------------------------------------------------------------------
+SQLHSTMT
+ODBCDBTable::prepared_stmt(prepared_stmt_t which)
+{
+    SQLRETURN sql_ret;
+    SQLHSTMT stmt = prepared_[which];
+
+    if (stmt != SQL_NULL_HSTMT)
+    {
+        /*!
+         * Close any cursor left open by the last use and drop the old
+         * parameter bindings but keep the prepared statement.  See the
+         * comment in dynamic_stmt about needing both SQLFreeStmt calls.
+         */
+        sql_ret = SQLFreeStmt(stmt, SQL_CLOSE);
+        if (!SQL_SUCCEEDED(sql_ret))
+        {
+            log_crit("ERROR:  prepared_stmt - failed Statement Handle SQL_CLOSE");
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
+        }
+
+        sql_ret = SQLFreeStmt(stmt, SQL_RESET_PARAMS);
+        if (!SQL_SUCCEEDED(sql_ret))
+        {
+            log_crit("ERROR:  prepared_stmt - failed Statement Handle SQL_RESET_PARAMS");
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
+        }
+        return stmt;
+    }
+
+    StringBuffer sql;
+    switch (which) {
+    case STMT_GET:
+        sql.appendf("SELECT the_data FROM %s WHERE the_key = ?", name());
+        break;
+    case STMT_INSERT:
+        sql.appendf("INSERT INTO %s values(?, ?)", name());
+        break;
+    case STMT_UPDATE:
+        sql.appendf("UPDATE %s SET the_data = ? WHERE the_key = ?", name());
+        break;
+    case STMT_DELETE:
+        sql.appendf("DELETE FROM %s WHERE the_key = ?", name());
+        break;
+    case STMT_DELETE_BATCH:
+        sql.appendf("DELETE FROM %s WHERE the_key IN (?", name());
+        for (size_t i = 1; i < store_->del_batch_size_; ++i) {
+            sql.append(", ?");
+        }
+        sql.append(")");
+        break;
+    case STMT_EXISTS:
+        sql.appendf("SELECT count(*) FROM %s WHERE the_key = ?", name());
+        break;
+    case STMT_COUNT:
+        sql.appendf("SELECT count(*) FROM %s", name());
+        break;
+    default:
+        PANIC("unknown prepared statement %d", which);
+    }
+
+    log_debug("prepared_stmt preparing '%s'", sql.c_str());
+
+    sql_ret = SQLAllocHandle(SQL_HANDLE_STMT, db_->m_hdbc, &stmt);
+    if (!SQL_SUCCEEDED(sql_ret) || (stmt == SQL_NULL_HSTMT))
+    {
+        log_err("prepared_stmt failed to allocate Statement handle - ret %d", sql_ret);
+        return SQL_NULL_HSTMT;
+    }
+
+    sql_ret = SQLPrepare(stmt, (SQLCHAR *) sql.c_str(), SQL_NTS);
+    if (!SQL_SUCCEEDED(sql_ret))
+    {
+        log_err("prepared_stmt SQLPrepare error %d", sql_ret);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
+        SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+        return SQL_NULL_HSTMT;
+    }
+
+    prepared_[which] = stmt;
+    return stmt;
+}
+
+//----------------------------------------------------------------------------
+SQLHSTMT
+ODBCDBTable::dynamic_stmt(const char *sql)
+{
+    SQLRETURN sql_ret;
+
+    /*!
+     * To fully free up the hstmt_ it is necessary to both unbind any preexisting
+     * bound output columns (SQL_CLOSE) and any preexisting bound parameters (SQL_RESET_PARAMETERS)
+     * This needs two calls to SQLFreeStmt (nicer if you could combine the options..).
+     * If this is not done and the last usage was a 'put' or 'get' with multiple
+     * parameters you run the risk of seeing random data in the bound parameters
+     * which have potentially recorded addresses which are no longer valid.  If
+     * you get an unexpected 'SQL_NEED_DATA' return from SQLExecute this is a
+     * possible (and *extremely* difficult to diagnose) problem.
+     */
+    sql_ret = SQLFreeStmt(hstmt_, SQL_CLOSE);       //close from any prior use
+    if (!SQL_SUCCEEDED(sql_ret))
+    {
+        log_crit("ERROR:  dynamic_stmt - failed Statement Handle SQL_CLOSE");
+        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+    }
+
+    sql_ret = SQLFreeStmt(hstmt_, SQL_RESET_PARAMS);
+    if (!SQL_SUCCEEDED(sql_ret))
+    {
+        log_crit("ERROR:  dynamic_stmt - failed Statement Handle SQL_RESET_PARAMS");
+        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+    }
+
+    sql_ret = SQLPrepare(hstmt_, (SQLCHAR *) sql, SQL_NTS);
+    if (!SQL_SUCCEEDED(sql_ret))
+    {
+        log_err("dynamic_stmt SQLPrepare error %d", sql_ret);
+        print_error(db_->m_henv, db_->m_hdbc, hstmt_);
+        return SQL_NULL_HSTMT;
+    }
+
+    return hstmt_;
+}
+
+//----------------------------------------------------------------------------
+int
+ODBCDBTable::flush_pending_dels()
+{
+    if (pending_dels_.empty())
+    {
+        return DS_OK;
+    }
+
+    log_debug("flush_pending_dels issuing %zu deletes", pending_dels_.size());
+
+    int ret = DS_OK;
+    size_t first = 0;
+    size_t remaining = pending_dels_.size();
+
+    // full batches use the cached statement and any left over are
+    // deleted with one statement prepared for just that many keys
+    while (remaining >= store_->del_batch_size_ && store_->del_batch_size_ > 1)
+    {
+        SQLHSTMT stmt = prepared_stmt(STMT_DELETE_BATCH);
+        if (stmt == SQL_NULL_HSTMT ||
+            exec_pending_dels(stmt, first, store_->del_batch_size_) != DS_OK)
+        {
+            ret = DS_ERR;
+        }
+        first     += store_->del_batch_size_;
+        remaining -= store_->del_batch_size_;
+    }
+
+    if (remaining == 1)
+    {
+        SQLHSTMT stmt = prepared_stmt(STMT_DELETE);
+        if (stmt == SQL_NULL_HSTMT ||
+            exec_pending_dels(stmt, first, 1) != DS_OK)
+        {
+            ret = DS_ERR;
+        }
+    }
+    else if (remaining > 1)
+    {
+        StringBuffer sql;
+        sql.appendf("DELETE FROM %s WHERE the_key IN (?", name());
+        for (size_t i = 1; i < remaining; ++i) {
+            sql.append(", ?");
+        }
+        sql.append(")");
+
+        SQLHSTMT stmt = dynamic_stmt(sql.c_str());
+        if (stmt == SQL_NULL_HSTMT ||
+            exec_pending_dels(stmt, first, remaining) != DS_OK)
+        {
+            ret = DS_ERR;
+        }
+    }
+
+    pending_dels_.clear();
+
+    if (ret != DS_OK)
+    {
+        log_err("flush_pending_dels error deleting rows from table %s", name());
+    }
+    return ret;
+}
+
+//----------------------------------------------------------------------------
+int
+ODBCDBTable::exec_pending_dels(SQLHSTMT stmt, size_t first, size_t num)
+{
+    SQLRETURN sql_ret;
+    std::vector<SQLLEN> key_lens(num);
+
+    for (size_t i = 0; i < num; ++i)
+    {
+        std::string & key = pending_dels_[first + i];
+        key_lens[i] = key.length();
+
+        sql_ret =
+             SQLBindParameter(stmt, i + 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+                              (key_size_ == 0) ? SQL_VARBINARY : SQL_BINARY,
+                              0, 0, const_cast<char *>(key.data()), 0, &key_lens[i]);
+
+        if (!SQL_SUCCEEDED(sql_ret))
+        {
+            log_err("exec_pending_dels SQLBindParameter error %d", sql_ret);
+            print_error(db_->m_henv, db_->m_hdbc, stmt);
+            return DS_ERR;
+        }
+    }
+
+    sql_ret = SQLExecute(stmt);
+
+    // SQLite does not indicate NO_DATA_FOUND and the rows were checked
+    // when the deletes were queued
+    if (!SQL_SUCCEEDED(sql_ret) && (sql_ret != SQL_NO_DATA_FOUND))
+    {
+        log_err("exec_pending_dels SQLExecute error %d", sql_ret);
+        print_error(db_->m_henv, db_->m_hdbc, stmt);
+        return DS_ERR;
+    }
+
+    return DS_OK;
+}
+
+//----------------------------------------------------------------------------
+bool
+ODBCDBTable::del_pending(const void *key, size_t key_len)
+{
+    std::vector<std::string>::iterator iter;
+    for (iter = pending_dels_.begin(); iter != pending_dels_.end(); ++iter)
+    {
+        if ((iter->length() == key_len) &&
+            (memcmp(iter->data(), key, key_len) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 //----------------------------------------------------------------------------
 int
 ODBCDBTable::print_error(SQLHENV henv, SQLHDBC hdbc, SQLHSTMT hstmt)
@@ -2106,6 +2286,12 @@ ODBCDBIterator::ODBCDBIterator(ODBCDBTable* t):
         t->store_->serialization_lock_.lock("Access by table iterator()");
     }
 
+    // the scan has to see any rows deleted inside the transaction
+    {
+        ScopeLock l(&t->lock_, "Iterator");
+        t->flush_pending_dels();
+    }
+
     log_debug("iterator constructor enter.");
 
     SQLRETURN sql_ret;
@@ -2121,7 +2307,7 @@ ODBCDBIterator::ODBCDBIterator(ODBCDBTable* t):
     //snprintf(my_SQL_str, 500, "SELECT the_key,the_data FROM %s", t->name());
 
     /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+     * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
      */
     sql_ret = SQLFreeStmt(cur_, SQL_CLOSE);
     if (!SQL_SUCCEEDED(sql_ret))
@@ -2187,7 +2373,7 @@ ODBCDBIterator::~ODBCDBIterator()
     valid_ = false;
 
     /*!
-     * See the comment on first 'get' routine about needing both SQLFreeStmt calls.
+     * See the comment in ODBCDBTable::dynamic_stmt about needing both SQLFreeStmt calls.
      */
     sql_ret = SQLFreeStmt(cur_, SQL_CLOSE);
     if (!SQL_SUCCEEDED(sql_ret))
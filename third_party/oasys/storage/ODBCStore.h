@@ -32,6 +32,9 @@
 #include <sys/time.h>
 
 #include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 // includes for standard ODBC headers typically in /usr/include
 #include <sql.h>
@@ -111,6 +114,7 @@ class ODBCDBStore:public DurableStoreImpl
         int get_table_names (StringVector * names);
         std::string get_info () const;
         bool aux_tables_available();
+        bool concurrent_tables() const;
 
         int begin_transaction (void **txid);
         int end_transaction (void *txid, bool be_durable);
@@ -127,6 +131,9 @@ class ODBCDBStore:public DurableStoreImpl
 
         /// @}
 
+        //! Issue the queued deletes for all tables that have some.
+        int flush_pending_dels();
+
         bool init_;					///< Initialized?
         std::string dsn_name_;		///< Data source name (overload purpose of dbname in StorageConfig)
         ODBC_dbenv dbenv_;			///< database environment common to  all tables
@@ -145,6 +152,18 @@ class ODBCDBStore:public DurableStoreImpl
         bool serialize_all_;            // Serialize all access across all tables
         SpinLock serialization_lock_; // For serializing all access to all tables
 
+        /// Number of deletes to queue per table inside a transaction
+        /// before issuing them as a single multi-row DELETE (0 if deletes
+        /// are issued immediately)
+        size_t del_batch_size_;
+
+        /// Largest number of keys allowed in a single multi-row DELETE
+        static const size_t MAX_DEL_BATCH_SIZE = 500;
+
+        /// Tables with queued deletes and the lock protecting the set
+        std::set<ODBCDBTable*> pending_del_tables_;
+        SpinLock pending_del_lock_;
+
     private:
 
 
@@ -361,6 +380,44 @@ class ODBCDBTable:public DurableTableImpl, public Logger
 
         SQLHSTMT hstmt_;
         SQLHSTMT iterator_hstmt_;
+
+        /// Statements for the standard tables that are prepared once on
+        /// their own handles and reused for the life of the table.  The
+        /// SQL for the auxiliary tables depends on the StoreDetail passed
+        /// in so it is still prepared on hstmt_ for each operation.
+        enum prepared_stmt_t {
+            STMT_GET = 0,       ///< SELECT the_data ... WHERE the_key = ?
+            STMT_INSERT,        ///< INSERT INTO ... values(?, ?)
+            STMT_UPDATE,        ///< UPDATE ... SET the_data = ? WHERE the_key = ?
+            STMT_DELETE,        ///< DELETE ... WHERE the_key = ?
+            STMT_DELETE_BATCH,  ///< DELETE ... WHERE the_key IN (?, ..., ?)
+            STMT_EXISTS,        ///< SELECT count(*) ... WHERE the_key = ?
+            STMT_COUNT,         ///< SELECT count(*) FROM ...
+            STMT_MAX
+        };
+        SQLHSTMT prepared_[STMT_MAX];
+
+        /// Keys of rows deleted inside the current transaction that have
+        /// not been removed from the database yet
+        std::vector<std::string> pending_dels_;
+
+        /// Return the handle for a cached statement, preparing it the
+        /// first time it is used.  Returns SQL_NULL_HSTMT on error.
+        SQLHSTMT prepared_stmt(prepared_stmt_t which);
+
+        /// Prepare dynamically generated SQL on hstmt_.  Returns
+        /// SQL_NULL_HSTMT on error.
+        SQLHSTMT dynamic_stmt(const char *sql);
+
+        /// Issue the queued deletes.  Must be called with lock_ held.
+        int flush_pending_dels();
+
+        /// Delete num keys from pending_dels_ starting at first using stmt,
+        /// which must have been prepared with exactly num key parameters.
+        int exec_pending_dels(SQLHSTMT stmt, size_t first, size_t num);
+
+        /// Whether a delete of the key is waiting to be issued.
+        bool del_pending(const void *key, size_t key_len);
         
         //! Only ODBCDBStore can create ODBCDBTables
         ODBCDBTable (const char *logpath,
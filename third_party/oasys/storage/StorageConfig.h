@@ -46,6 +46,12 @@ struct StorageConfig {
     // Filesystem DB Specific options
     int         fs_fd_cache_size_; ///< If > 0, then this # of open
                                    /// fds will be cached
+    int         fs_dir_levels_;    ///< Levels of hashed subdirectories
+                                   /// (256 each) the record files are
+                                   /// spread over, 0 for a flat table
+    bool        fs_batch_sync_;    ///< fsync the files written and their
+                                   /// directories once per durable commit
+    int         fs_scan_threads_;  ///< Threads used to scan the subdirs
 
     // Berkeley DB Specific options
     bool        db_mpool_;      ///< Use DB mpool (default true)
@@ -75,6 +81,11 @@ struct StorageConfig {
     										///< addded once all tables are in place.
     u_int16_t	odbc_mysql_keep_alive_interval_;
     								  	    ///< Keep alive timer interval (MySQL only)
+    int			odbc_del_batch_size_;		///< Deletes queued per table inside a
+    										///< transaction before issuing them as
+    										///< one multi-row DELETE (0 to disable)
+    bool		odbc_sqlite_wal_;			///< Use the SQLite write-ahead log
+    										///< journal mode (SQLite only)
 
     StorageConfig(
         const std::string& cmd,
@@ -96,6 +107,9 @@ struct StorageConfig {
         max_nondurable_transactions_(0),
 
         fs_fd_cache_size_(0),
+        fs_dir_levels_(1),
+        fs_batch_sync_(false),
+        fs_scan_threads_(4),
 
         db_mpool_(true),
         db_log_(true),
@@ -113,7 +127,9 @@ struct StorageConfig {
         odbc_use_aux_tables_(false),
         odbc_schema_pre_creation_(""),
         odbc_schema_post_creation_(""),
-        odbc_mysql_keep_alive_interval_(10)
+        odbc_mysql_keep_alive_interval_(10),
+        odbc_del_batch_size_(32),
+        odbc_sqlite_wal_(true)
 
     {}
 };
@@ -0,0 +1,135 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <stdlib.h>
+
+#include "util/UnitTest.h"
+#include "util/CRC16.h"
+#include "util/Time.h"
+
+using namespace oasys;
+
+#define BENCH_BYTES     (64 * 1024 * 1024)
+#define BENCH_BUF_LEN   (64 * 1024)
+
+/**
+ * The bit at a time crc that BP7_BlockProcessor used to compute.
+ */
+CRC16::CRC_t
+crc16_bitwise(CRC16::CRC_t crc_in, const u_char* buf, size_t length)
+{
+    CRC16::CRC_t crc = ~crc_in;
+    while (length--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0x8408) : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+DECLARE_TEST(KnownValues) {
+    const u_char* check = (const u_char*)"123456789";
+
+    CHECK_EQUAL(CRC16::extend(0, check, 0), 0);
+    CHECK_EQUAL(CRC16::extend(0, check, 9), 0x906e);
+
+    CRC16 crc;
+    crc.update(check, 4);
+    crc.update(check + 4, 5);
+    CHECK_EQUAL(crc.value(), 0x906e);
+
+    crc.reset();
+    CHECK_EQUAL(crc.value(), 0);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Equivalence) {
+    u_char buf[4096 + 8];
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (u_char)(random() & 0xff);
+    }
+
+    // every length up to a few quadwords at every alignment, then
+    // some longer ones
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t len = 0; len < 40; ++len) {
+            CHECK_EQUAL(CRC16::extend(0, buf + offset, len),
+                        crc16_bitwise(0, buf + offset, len));
+        }
+        for (size_t len = 40; len <= 4096; len += 331) {
+            CHECK_EQUAL(CRC16::extend(0, buf + offset, len),
+                        crc16_bitwise(0, buf + offset, len));
+            CHECK_EQUAL(CRC16::extend(0xbeef, buf + offset, len),
+                        crc16_bitwise(0xbeef, buf + offset, len));
+        }
+    }
+
+    // the result can't depend on how the data is split between calls
+    CRC16::CRC_t expected = CRC16::extend(0, buf, 4096);
+    for (size_t split = 0; split <= 4096; split += 61) {
+        CRC16::CRC_t crc = CRC16::extend(0, buf, split);
+        CHECK_EQUAL(CRC16::extend(crc, buf + split, 4096 - split), expected);
+    }
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Throughput) {
+    u_char* buf = (u_char*)malloc(BENCH_BUF_LEN);
+    for (size_t i = 0; i < BENCH_BUF_LEN; ++i) {
+        buf[i] = (u_char)(i * 13);
+    }
+
+    size_t iterations = BENCH_BYTES / BENCH_BUF_LEN;
+    CRC16::CRC_t crc_bitwise = 0, crc = 0;
+    Time start;
+
+    start.get_time();
+    for (size_t n = 0; n < iterations; ++n) {
+        crc_bitwise = crc16_bitwise(crc_bitwise, buf, BENCH_BUF_LEN);
+    }
+    u_int64_t bitwise_us = start.elapsed_us();
+
+    start.get_time();
+    for (size_t n = 0; n < iterations; ++n) {
+        crc = CRC16::extend(crc, buf, BENCH_BUF_LEN);
+    }
+    u_int64_t us = start.elapsed_us();
+
+    CHECK_EQUAL(crc, crc_bitwise);
+
+    log_notice_p("/test", "bitwise %llu MB/s, slicing-by-8 %llu MB/s",
+                 U64FMT(BENCH_BYTES / (bitwise_us ? bitwise_us : 1)),
+                 U64FMT(BENCH_BYTES / (us ? us : 1)));
+
+    free(buf);
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TESTER(CRC16Tester) {
+    ADD_TEST(KnownValues);
+    ADD_TEST(Equivalence);
+    ADD_TEST(Throughput);
+}
+
+DECLARE_TEST_FILE(CRC16Tester, "crc16 test");
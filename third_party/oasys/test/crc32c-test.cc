@@ -0,0 +1,202 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <stdlib.h>
+
+#include "util/UnitTest.h"
+#include "util/CRC32C.h"
+#include "util/Time.h"
+
+using namespace oasys;
+
+#define BENCH_BYTES     (256 * 1024 * 1024)
+#define BENCH_BUF_LEN   (64 * 1024)
+
+/**
+ * Bit at a time crc to check the table and hardware versions against.
+ */
+CRC32C::CRC_t
+crc32c_bitwise(CRC32C::CRC_t crc, const u_char* buf, size_t length)
+{
+    crc = ~crc;
+    while (length--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0x82f63b78) : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+DECLARE_TEST(KnownValues) {
+    const u_char* check = (const u_char*)"123456789";
+
+    CHECK_EQUAL(CRC32C::extend(0, check, 0), 0);
+    CHECK_EQUAL(CRC32C::extend(0, check, 9), 0xe3069283);
+
+    // 32 bytes of zeros (RFC 3720 B.4)
+    u_char zeros[32];
+    memset(zeros, 0, sizeof(zeros));
+    CHECK_EQUAL(CRC32C::extend(0, zeros, sizeof(zeros)), 0x8a9136aa);
+
+    CRC32C crc;
+    crc.update(check, 4);
+    crc.update(check + 4, 5);
+    CHECK_EQUAL(crc.value(), 0xe3069283);
+
+    crc.reset();
+    CHECK_EQUAL(crc.value(), 0);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Unaligned) {
+    u_char buf[1024 + 8];
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (u_char)(i * 7 + 3);
+    }
+
+    // the result can't depend on the alignment of the buffer or on
+    // how the data is split between calls
+    CRC32C::CRC_t expected = CRC32C::extend(0, buf, 1024);
+
+    u_char copy[1024 + 8];
+    for (size_t offset = 1; offset < 8; ++offset) {
+        memcpy(copy + offset, buf, 1024);
+        CHECK_EQUAL(CRC32C::extend(0, copy + offset, 1024), expected);
+    }
+
+    for (size_t split = 0; split <= 1024; split += 61) {
+        CRC32C::CRC_t crc = CRC32C::extend(0, buf, split);
+        crc = CRC32C::extend(crc, buf + split, 1024 - split);
+        CHECK_EQUAL(crc, expected);
+    }
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Combine) {
+    u_char buf[4096];
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (u_char)((i * 31) ^ (i >> 3));
+    }
+
+    CRC32C::CRC_t expected = CRC32C::extend(0, buf, sizeof(buf));
+
+    size_t splits[] = { 0, 1, 7, 8, 9, 100, 2048, 4095, 4096 };
+    for (size_t i = 0; i < sizeof(splits) / sizeof(splits[0]); ++i) {
+        size_t split = splits[i];
+        CRC32C::CRC_t crc1 = CRC32C::extend(0, buf, split);
+        CRC32C::CRC_t crc2 = CRC32C::extend(0, buf + split, sizeof(buf) - split);
+        CHECK_EQUAL(CRC32C::combine(crc1, crc2, sizeof(buf) - split), expected);
+    }
+
+    // three pieces combined out of order of computation
+    CRC32C::CRC_t crc_a = CRC32C::extend(0, buf, 1000);
+    CRC32C::CRC_t crc_b = CRC32C::extend(0, buf + 1000, 1000);
+    CRC32C::CRC_t crc_c = CRC32C::extend(0, buf + 2000, 2096);
+    CRC32C::CRC_t crc_bc = CRC32C::combine(crc_b, crc_c, 2096);
+    CHECK_EQUAL(CRC32C::combine(crc_a, crc_bc, 3096), expected);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Equivalence) {
+    log_notice_p("/test", "crc32c implementation: %s", CRC32C::implementation());
+
+    // lengths around the boundaries of the interleaved blocks of the
+    // hardware version (3 * 256 and 3 * 8192 bytes)
+    size_t lengths[] = { 0, 1, 7, 8, 9, 63, 767, 768, 769, 1543,
+                         24575, 24576, 24577, 49151, 49152, 49160,
+                         100003 };
+    size_t max_len = 100003;
+
+    u_char* buf = (u_char*)malloc(max_len + 8);
+    for (size_t i = 0; i < max_len + 8; ++i) {
+        buf[i] = (u_char)(random() & 0xff);
+    }
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        for (size_t offset = 0; offset < 8; offset += 3) {
+            const u_char* data = buf + offset;
+            CRC32C::CRC_t expected = crc32c_bitwise(0, data, lengths[i]);
+            CHECK_EQUAL(CRC32C::extend_sw(0, data, lengths[i]), expected);
+            CHECK_EQUAL(CRC32C::extend(0, data, lengths[i]), expected);
+
+            // continuing from a nonzero crc
+            CHECK_EQUAL(CRC32C::extend(0x12345678, data, lengths[i]),
+                        crc32c_bitwise(0x12345678, data, lengths[i]));
+        }
+    }
+
+    free(buf);
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Throughput) {
+    u_char* buf = (u_char*)malloc(BENCH_BUF_LEN);
+    for (size_t i = 0; i < BENCH_BUF_LEN; ++i) {
+        buf[i] = (u_char)(i * 13);
+    }
+
+    // the block sizes of a typical small bundle block and a payload
+    size_t block_lens[] = { 64, BENCH_BUF_LEN };
+
+    for (size_t i = 0; i < sizeof(block_lens) / sizeof(block_lens[0]); ++i) {
+        size_t block_len = block_lens[i];
+        size_t iterations = BENCH_BYTES / block_len;
+        CRC32C::CRC_t crc_sw = 0, crc = 0;
+        Time start;
+
+        start.get_time();
+        for (size_t n = 0; n < iterations; ++n) {
+            crc_sw = CRC32C::extend_sw(crc_sw, buf, block_len);
+        }
+        u_int64_t sw_us = start.elapsed_us();
+
+        start.get_time();
+        for (size_t n = 0; n < iterations; ++n) {
+            crc = CRC32C::extend(crc, buf, block_len);
+        }
+        u_int64_t us = start.elapsed_us();
+
+        CHECK_EQUAL(crc, crc_sw);
+
+        log_notice_p("/test", "%zu byte blocks: slicing-by-8 %llu MB/s, %s %llu MB/s",
+                     block_len,
+                     U64FMT(BENCH_BYTES / (sw_us ? sw_us : 1)),
+                     CRC32C::implementation(),
+                     U64FMT(BENCH_BYTES / (us ? us : 1)));
+    }
+
+    free(buf);
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TESTER(CRC32CTester) {
+    ADD_TEST(KnownValues);
+    ADD_TEST(Unaligned);
+    ADD_TEST(Combine);
+    ADD_TEST(Equivalence);
+    ADD_TEST(Throughput);
+}
+
+DECLARE_TEST_FILE(CRC32CTester, "crc32c test");
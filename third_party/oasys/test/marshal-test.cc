@@ -40,6 +40,8 @@
 #include <iostream>
 #include <debug/DebugUtils.h>
 #include <serialize/MarshalSerialize.h>
+#include <util/ScratchBuffer.h>
+#include <util/Time.h>
 #include <util/UnitTest.h>
 
 using namespace std;
@@ -223,11 +225,145 @@ DECLARE_TEST(Compare) {
     return UNIT_TEST_PASSED;
 }
     
+/**
+ * A record with the same field mix as a stored bundle: mostly fixed
+ * width integers and flags, a handful of endpoint id strings and the
+ * received and api blocks.
+ */
+class BundleRecord : public SerializableObject {
+public:
+    BundleRecord() {
+        for (int i = 0; i < NUM_INTS; ++i) {
+            ints_[i] = 0x1000 + i;
+        }
+        for (int i = 0; i < NUM_FLAGS; ++i) {
+            flags_[i] = (i % 3) == 0;
+        }
+        source_    = "ipn:12.1";
+        dest_      = "dtn://destination.example.org/app/demux";
+        custodian_ = "dtn:none";
+        replyto_   = "ipn:12.1";
+        prevhop_   = "ipn:7.0";
+        for (int i = 0; i < NUM_BLOCKS; ++i) {
+            block_types_[i] = i;
+            block_data_[i].assign(20 + i * 10, 'b');
+        }
+    }
+
+    void serialize(SerializeAction* action) {
+        for (int i = 0; i < NUM_INTS; ++i) {
+            action->process("int", &ints_[i]);
+        }
+        for (int i = 0; i < NUM_FLAGS; ++i) {
+            action->process("flag", &flags_[i]);
+        }
+        action->process("source",    &source_);
+        action->process("dest",      &dest_);
+        action->process("custodian", &custodian_);
+        action->process("replyto",   &replyto_);
+        action->process("prevhop",   &prevhop_);
+        for (int i = 0; i < NUM_BLOCKS; ++i) {
+            action->process("block_type", &block_types_[i]);
+            action->process("block_data", &block_data_[i]);
+        }
+    }
+
+    static const int NUM_INTS   = 24;
+    static const int NUM_FLAGS  = 16;
+    static const int NUM_BLOCKS = 4;
+
+    u_int64_t   ints_[NUM_INTS];
+    bool        flags_[NUM_FLAGS];
+    std::string source_, dest_, custodian_, replyto_, prevhop_;
+    u_int32_t   block_types_[NUM_BLOCKS];
+    std::string block_data_[NUM_BLOCKS];
+};
+
+#define BENCH_ITERATIONS 200000
+
+DECLARE_TEST(ThreadBuf) {
+    BundleRecord rec;
+
+    MarshalSize sizer(Serialize::CONTEXT_LOCAL);
+    CHECK(sizer.action(&rec) == 0);
+
+    ScratchBuffer<u_char*, 1024> scratch;
+    u_char* flat = scratch.buf(sizer.size());
+    Marshal two_pass(Serialize::CONTEXT_LOCAL, flat, sizer.size());
+    CHECK(two_pass.action(&rec) == 0);
+
+    // a single pass into the thread buffer gives the same bytes
+    ExpandableBuffer* tbuf = Marshal::thread_buf();
+    Marshal single_pass(Serialize::CONTEXT_LOCAL, tbuf);
+    CHECK(single_pass.action(&rec) == 0);
+    CHECK_EQUAL(tbuf->len(), sizer.size());
+    CHECK(memcmp(tbuf->raw_buf(), flat, sizer.size()) == 0);
+
+    // and the buffer is handed back cleared with the same memory
+    char* raw = tbuf->raw_buf();
+    ExpandableBuffer* tbuf2 = Marshal::thread_buf();
+    CHECK(tbuf2 == tbuf);
+    CHECK_EQUAL(tbuf2->len(), 0);
+    CHECK(tbuf2->raw_buf() == raw);
+
+    // growing an expandable buffer one field at a time still comes
+    // out the same
+    ScratchBuffer<u_char*> small(1);
+    Marshal grow(Serialize::CONTEXT_LOCAL, &small);
+    CHECK(grow.action(&rec) == 0);
+    CHECK_EQUAL(small.len(), sizer.size());
+    CHECK(memcmp(small.buf(), flat, sizer.size()) == 0);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(Throughput) {
+    BundleRecord rec;
+    size_t bytes = 0;
+    Time start;
+
+    // the old way the stores flattened a record: size it, then marshal
+    // it into a freshly sized buffer
+    start.get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+        MarshalSize sizer(Serialize::CONTEXT_LOCAL);
+        sizer.action(&rec);
+
+        ScratchBuffer<u_char*, 1024> scratch;
+        u_char* flat = scratch.buf(sizer.size());
+        Marshal m(Serialize::CONTEXT_LOCAL, flat, sizer.size());
+        m.action(&rec);
+        bytes += sizer.size();
+    }
+    u_int64_t two_pass_us = start.elapsed_us();
+    log_notice_p("/test", "two pass:    %zu bytes in %llu us (%llu MB/s)",
+                 bytes, U64FMT(two_pass_us),
+                 U64FMT(bytes / (two_pass_us ? two_pass_us : 1)));
+
+    // a single pass into the reused thread buffer
+    bytes = 0;
+    start.get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; ++i) {
+        ExpandableBuffer* tbuf = Marshal::thread_buf();
+        Marshal m(Serialize::CONTEXT_LOCAL, tbuf);
+        m.action(&rec);
+        bytes += tbuf->len();
+    }
+    u_int64_t single_pass_us = start.elapsed_us();
+    log_notice_p("/test", "single pass: %zu bytes in %llu us (%llu MB/s)",
+                 bytes, U64FMT(single_pass_us),
+                 U64FMT(bytes / (single_pass_us ? single_pass_us : 1)));
+
+    return UNIT_TEST_PASSED;
+}
+    
 DECLARE_TESTER(MarshalTester) {
     ADD_TEST(Marshal);
     ADD_TEST(Unmarshal);
     ADD_TEST(MarshalSize);
     ADD_TEST(Compare);
+    ADD_TEST(ThreadBuf);
+    ADD_TEST(Throughput);
 }
 
 DECLARE_TEST_FILE(MarshalTester, "marshal unit test");
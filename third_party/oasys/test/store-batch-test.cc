@@ -0,0 +1,312 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+
+#include "util/UnitTest.h"
+#include "util/StringBuffer.h"
+#include "util/Time.h"
+#include "serialize/TypeShims.h"
+#include "storage/DurableStore.h"
+#include "storage/InternalKeyDurableTable.h"
+#include "storage/StorageConfig.h"
+
+using namespace oasys;
+
+//
+// Transaction batching test and benchmark. Records are added, updated,
+// read and deleted in transactions of BATCH_SIZE operations the way the
+// BundleDaemonStorage thread writes them, checking that reads inside a
+// transaction see the deletes made earlier in it (which the ODBC store
+// queues up and issues as multi-row DELETEs), and the throughput of
+// each phase is logged for comparison between the backends.
+//
+// The SQLite backend is only run if OASYS_TEST_SQLITE_DSN names an
+// SQLite data source in the odbc.ini file.
+//
+// The filesystem store is also run with batched syncs and with its
+// records reopened under a different subdirectory layout.
+//
+
+#define NUM_RECORDS     4000
+#define RECORD_LEN      400
+#define BATCH_SIZE      100
+
+const char* g_config_dir = "output/store-batch-test";
+
+class Record : public SerializableObject {
+public:
+    Record(u_int32_t key = 0, size_t len = 0)
+        : key_(key), data_(len, 'x') {}
+    Record(const Builder&) : key_(0) {}
+
+    u_int32_t durable_key() { return key_; }
+
+    virtual void serialize(SerializeAction* a) {
+        a->process("key",  &key_);
+        a->process("data", &data_);
+    }
+
+    u_int32_t key_;
+    std::string data_;
+};
+
+typedef InternalKeyDurableTable<UIntShim, u_int32_t, Record> RecordTable;
+
+// CHECK() is only usable in the body of a test
+#define BATCH_CHECK(x)                                                  \
+    do { if (! (x)) {                                                   \
+        log_err_p("/test", "CHECK FAILED (%s) at %s:%d",                \
+                  #x, __FILE__, __LINE__);                              \
+        return false;                                                   \
+    } } while (0)
+
+/**
+ * Log the throughput of one phase.
+ */
+void
+log_phase(const char* type, const char* phase, const Time& start)
+{
+    u_int64_t elapsed_ms = start.elapsed_ms();
+    log_notice_p("/test", "%s: %-6s %u ops in %" PRIu64 " ms (%" PRIu64 " ops/sec)",
+                 type, phase, NUM_RECORDS, elapsed_ms,
+                 ((u_int64_t) NUM_RECORDS * 1000) / (elapsed_ms ? elapsed_ms : 1));
+}
+
+/**
+ * Run the phases against a new store of the given type.
+ */
+bool
+run_batches(const char* type, const char* dbname, bool fs_batch_sync = false)
+{
+    StringBuffer dir("%s/%s", g_config_dir, type);
+    StringBuffer cmd("mkdir -p %s", dir.c_str());
+    system(cmd.c_str());
+
+    StorageConfig cfg("storage", type, dbname, dir.c_str());
+    cfg.init_          = true;
+    cfg.tidy_          = true;
+    cfg.tidy_wait_     = 0;
+    cfg.auto_commit_   = false;
+    cfg.fs_batch_sync_ = fs_batch_sync;
+
+    DurableStore* store = new DurableStore("/test_storage");
+    BATCH_CHECK(store->create_store(cfg) == 0);
+
+    RecordTable* table = new RecordTable("RecordTable", "/test/table",
+                                         "record", "records");
+    BATCH_CHECK(table->do_init(cfg, store) == 0);
+
+    Time start;
+
+    start.get_time();
+    for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+        if ((i % BATCH_SIZE) == 0) {
+            BATCH_CHECK(store->begin_transaction() == DS_OK);
+        }
+        Record rec(i, RECORD_LEN);
+        BATCH_CHECK(table->add(&rec));
+        if ((i % BATCH_SIZE) == (BATCH_SIZE - 1)) {
+            BATCH_CHECK(store->end_transaction() == DS_OK);
+        }
+    }
+    log_phase(type, "add", start);
+
+    start.get_time();
+    for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+        if ((i % BATCH_SIZE) == 0) {
+            BATCH_CHECK(store->begin_transaction() == DS_OK);
+        }
+        Record rec(i, RECORD_LEN);
+        rec.data_[0] = 'y';
+        BATCH_CHECK(table->update(&rec));
+        if ((i % BATCH_SIZE) == (BATCH_SIZE - 1)) {
+            BATCH_CHECK(store->end_transaction() == DS_OK);
+        }
+    }
+    log_phase(type, "update", start);
+
+    start.get_time();
+    for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+        Record* rec = table->get(i);
+        BATCH_CHECK(rec != NULL);
+        BATCH_CHECK(rec->data_.length() == RECORD_LEN);
+        BATCH_CHECK(rec->data_[0] == 'y');
+        delete rec;
+    }
+    log_phase(type, "get", start);
+
+    // every other record is deleted, and every so often the record
+    // just deleted is looked up again inside the same transaction
+    start.get_time();
+    for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+        if ((i % BATCH_SIZE) == 0) {
+            BATCH_CHECK(store->begin_transaction() == DS_OK);
+        }
+        if ((i % 2) == 0) {
+            BATCH_CHECK(table->del(i));
+            if ((i % 50) == 0) {
+                BATCH_CHECK(table->get(i) == NULL);
+                BATCH_CHECK(!table->del(i));
+            }
+        }
+        if ((i % BATCH_SIZE) == (BATCH_SIZE - 1)) {
+            BATCH_CHECK(store->end_transaction() == DS_OK);
+        }
+    }
+    log_phase(type, "del", start);
+
+    u_int32_t count = 0;
+    RecordTable::iterator* iter = table->new_iterator();
+    while (iter->next() == 0) {
+        BATCH_CHECK((iter->cur_val() % 2) == 1);
+        ++count;
+    }
+    delete iter;
+    BATCH_CHECK(count == NUM_RECORDS / 2);
+
+    delete table;
+    BATCH_CHECK(store->del_table("records") == 0);
+
+    // the store is a singleton so it has to be cleared for the next run
+    DurableStore::reset();
+
+    return true;
+}
+
+/**
+ * Open the filesystem store with the given number of subdirectory
+ * levels, adding records first if add is set, and check that all of
+ * the records can be read back.
+ */
+bool
+open_fs_layout(int levels, bool add)
+{
+    StringBuffer dir("%s/filesysdb-layout", g_config_dir);
+    if (add) {
+        StringBuffer cmd("rm -rf %s; mkdir -p %s", dir.c_str(), dir.c_str());
+        system(cmd.c_str());
+    }
+
+    StorageConfig cfg("storage", "filesysdb", "test", dir.c_str());
+    cfg.init_          = add;
+    cfg.tidy_          = false;
+    cfg.fs_dir_levels_ = levels;
+
+    DurableStore* store = new DurableStore("/test_storage");
+    BATCH_CHECK(store->create_store(cfg) == 0);
+
+    RecordTable* table = new RecordTable("RecordTable", "/test/table",
+                                         "record", "records");
+    BATCH_CHECK(table->do_init(cfg, store) == 0);
+
+    if (add) {
+        for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+            Record rec(i, RECORD_LEN);
+            BATCH_CHECK(table->add(&rec));
+        }
+    }
+
+    for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+        Record* rec = table->get(i);
+        BATCH_CHECK(rec != NULL);
+        BATCH_CHECK(rec->data_.length() == RECORD_LEN);
+        delete rec;
+    }
+
+    u_int32_t count = 0;
+    RecordTable::iterator* iter = table->new_iterator();
+    while (iter->next() == 0) {
+        ++count;
+    }
+    delete iter;
+    BATCH_CHECK(count == NUM_RECORDS);
+
+    // a record is in the subdirectory for its key and nowhere else
+    StringBuffer flat("%s/test/records/00000011-", dir.c_str());
+    struct stat st;
+    BATCH_CHECK((stat(flat.c_str(), &st) == 0) == (levels == 0));
+
+    delete table;
+    DurableStore::reset();
+
+    return true;
+}
+
+DECLARE_TEST(MemoryStoreBatches) {
+    CHECK(run_batches("memorydb", "test"));
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(FileSystemStoreBatches) {
+    CHECK(run_batches("filesysdb", "test"));
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(FileSystemStoreBatchSync) {
+    CHECK(run_batches("filesysdb", "test", true));
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(FileSystemStoreLayout) {
+    CHECK(open_fs_layout(0, true));
+    CHECK(open_fs_layout(2, false));
+    CHECK(open_fs_layout(1, false));
+    CHECK(open_fs_layout(0, false));
+    return UNIT_TEST_PASSED;
+}
+
+#ifdef LIBDB_ENABLED
+DECLARE_TEST(BerkeleyDBStoreBatches) {
+    CHECK(run_batches("berkeleydb", "test"));
+    return UNIT_TEST_PASSED;
+}
+#endif
+
+#ifdef LIBODBC_ENABLED
+DECLARE_TEST(SQLiteStoreBatches) {
+    const char* dsn = getenv("OASYS_TEST_SQLITE_DSN");
+    if (dsn == NULL) {
+        log_notice_p("/test", "OASYS_TEST_SQLITE_DSN not set, skipping odbc-sqlite");
+        return UNIT_TEST_PASSED;
+    }
+    CHECK(run_batches("odbc-sqlite", dsn));
+    return UNIT_TEST_PASSED;
+}
+#endif
+
+DECLARE_TESTER(StoreBatchTester) {
+    ADD_TEST(MemoryStoreBatches);
+    ADD_TEST(FileSystemStoreBatches);
+    ADD_TEST(FileSystemStoreBatchSync);
+    ADD_TEST(FileSystemStoreLayout);
+#ifdef LIBDB_ENABLED
+    ADD_TEST(BerkeleyDBStoreBatches);
+#endif
+#ifdef LIBODBC_ENABLED
+    ADD_TEST(SQLiteStoreBatches);
+#endif
+}
+
+DECLARE_TEST_FILE(StoreBatchTester, "store transaction batch test");
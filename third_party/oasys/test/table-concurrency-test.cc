@@ -0,0 +1,283 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <inttypes.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "util/UnitTest.h"
+#include "util/StringBuffer.h"
+#include "util/Time.h"
+#include "serialize/TypeShims.h"
+#include "storage/DurableStore.h"
+#include "storage/InternalKeyDurableTable.h"
+#include "storage/StorageConfig.h"
+#include "thread/Thread.h"
+
+using namespace oasys;
+
+//
+// Concurrent writer benchmark for the per-table locking done by
+// InternalKeyDurableTable. Each backend is driven by a number of
+// writer threads that either all share one table (which serializes
+// them just like a store-wide lock) or each have a table of their
+// own, and the throughput of the two is logged.
+//
+
+#define NUM_WRITERS     4
+#define NUM_RECORDS     2000
+#define RECORD_LEN      512
+
+const char* g_config_dir = "output/table-concurrency-test";
+
+const char* g_table_names[NUM_WRITERS] = {
+    "table0", "table1", "table2", "table3"
+};
+
+class Record : public SerializableObject {
+public:
+    Record(u_int32_t key = 0, size_t len = 0)
+        : key_(key), data_(len, 'x') {}
+    Record(const Builder&) : key_(0) {}
+
+    u_int32_t durable_key() { return key_; }
+
+    virtual void serialize(SerializeAction* a) {
+        a->process("key",  &key_);
+        a->process("data", &data_);
+    }
+
+    u_int32_t key_;
+    std::string data_;
+};
+
+typedef InternalKeyDurableTable<UIntShim, u_int32_t, Record> RecordTable;
+
+class Writer : public Thread {
+public:
+    Writer(RecordTable* table, u_int32_t first_key)
+        : Thread("Writer", CREATE_JOINABLE),
+          errors_(0), table_(table), first_key_(first_key) {}
+
+    /// keys that are deleted again by the writer
+    static bool deleted(u_int32_t i) { return (i % 8) == 7; }
+
+    u_int32_t errors_;
+
+protected:
+    virtual void run() {
+        // a mix of adds, updates and deletes roughly like the bundle
+        // table sees as bundles are received, forwarded and deleted
+        for (u_int32_t i = 0; i < NUM_RECORDS; ++i) {
+            Record rec(first_key_ + i, RECORD_LEN);
+            if (!table_->add(&rec)) {
+                ++errors_;
+            }
+
+            if ((i % 4) == 3) {
+                rec.data_[0] = 'y';
+                if (!table_->update(&rec)) {
+                    ++errors_;
+                }
+            }
+
+            if (deleted(i)) {
+                if (!table_->del(first_key_ + i)) {
+                    ++errors_;
+                }
+            }
+        }
+    }
+
+    RecordTable* table_;
+    u_int32_t first_key_;
+};
+
+/**
+ * Durably commits the store's transaction every few milliseconds while
+ * the writers run, like the storage thread does, so the FileSystemStore
+ * fd cache is synced while the tables are in use.
+ */
+class Committer : public Thread {
+public:
+    Committer(DurableStore* store)
+        : Thread("Committer", CREATE_JOINABLE), store_(store) {}
+
+protected:
+    virtual void run() {
+        while (! should_stop()) {
+            store_->begin_transaction();
+            usleep(10000);
+            store_->make_transaction_durable();
+            store_->end_transaction();
+        }
+    }
+
+    DurableStore* store_;
+};
+
+// CHECK() is only usable in the body of a test
+#define WRITER_CHECK(x)                                                 \
+    do { if (! (x)) {                                                   \
+        log_err_p("/test", "CHECK FAILED (%s) at %s:%d",                \
+                  #x, __FILE__, __LINE__);                              \
+        return false;                                                   \
+    } } while (0)
+
+/**
+ * Run NUM_WRITERS writers against num_tables tables of a new store
+ * and check that everything they wrote is there.
+ */
+bool
+run_writers(StorageConfig* cfg, int num_tables)
+{
+    DurableStore* store = new DurableStore("/test_storage");
+    WRITER_CHECK(store->create_store(*cfg) == 0);
+
+    std::vector<RecordTable*> tables;
+    for (int i = 0; i < num_tables; ++i) {
+        RecordTable* table = new RecordTable("RecordTable", "/test/table",
+                                             "record", g_table_names[i]);
+        WRITER_CHECK(table->do_init(*cfg, store) == 0);
+        tables.push_back(table);
+    }
+
+    std::vector<Writer*> writers;
+    for (int i = 0; i < NUM_WRITERS; ++i) {
+        writers.push_back(new Writer(tables[i % num_tables], i * NUM_RECORDS));
+    }
+
+    Committer committer(store);
+
+    Time start;
+    start.get_time();
+
+    if (cfg->fs_fd_cache_size_ > 0) {
+        committer.start();
+    }
+    for (int i = 0; i < NUM_WRITERS; ++i) {
+        writers[i]->start();
+    }
+
+    for (int i = 0; i < NUM_WRITERS; ++i) {
+        writers[i]->join();
+    }
+
+    u_int64_t elapsed_ms = start.elapsed_ms();
+
+    if (cfg->fs_fd_cache_size_ > 0) {
+        committer.set_should_stop();
+        committer.join();
+    }
+
+    u_int32_t ops = NUM_WRITERS * (NUM_RECORDS + NUM_RECORDS / 4 + NUM_RECORDS / 8);
+
+    log_notice_p("/test", "%s%s: %d writers, %d table(s): %u ops in %" PRIu64 " ms (%" PRIu64 " ops/sec)",
+                 cfg->type_.c_str(),
+                 (cfg->fs_fd_cache_size_ > 0) ? " (fd cache)" : "",
+                 NUM_WRITERS, num_tables, ops, elapsed_ms,
+                 (ops * 1000) / (elapsed_ms ? elapsed_ms : 1));
+
+    for (int i = 0; i < NUM_WRITERS; ++i) {
+        WRITER_CHECK(writers[i]->errors_ == 0);
+
+        RecordTable* table = tables[i % num_tables];
+        for (u_int32_t key = 0; key < NUM_RECORDS; key += 7) {
+            if (Writer::deleted(key)) {
+                continue;
+            }
+
+            Record* rec = table->get(i * NUM_RECORDS + key);
+            WRITER_CHECK(rec != NULL);
+            WRITER_CHECK(rec->data_.length() == RECORD_LEN);
+            WRITER_CHECK(rec->data_[0] == (((key % 4) == 3) ? 'y' : 'x'));
+            delete rec;
+        }
+
+        delete writers[i];
+    }
+
+    for (int i = 0; i < num_tables; ++i) {
+        delete tables[i];
+        WRITER_CHECK(store->del_table(g_table_names[i]) == 0);
+    }
+
+    // the store is a singleton so it has to be cleared for the next run
+    DurableStore::reset();
+
+    return true;
+}
+
+/**
+ * Compare writers sharing a single table against a table per writer.
+ */
+bool
+compare_writers(const char* type, int fd_cache_size = 0)
+{
+    StringBuffer dir("%s/%s", g_config_dir, type);
+    StringBuffer cmd("mkdir -p %s", dir.c_str());
+    system(cmd.c_str());
+
+    StorageConfig cfg("storage", type, "test", dir.c_str());
+    cfg.init_      = true;
+    cfg.tidy_      = true;
+    cfg.tidy_wait_ = 0;
+    cfg.fs_fd_cache_size_ = fd_cache_size;
+
+    WRITER_CHECK(run_writers(&cfg, 1));
+    WRITER_CHECK(run_writers(&cfg, NUM_WRITERS));
+
+    return true;
+}
+
+DECLARE_TEST(MemoryStoreWriters) {
+    CHECK(compare_writers("memorydb"));
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(FileSystemStoreWriters) {
+    CHECK(compare_writers("filesysdb"));
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(FileSystemStoreCachedWriters) {
+    CHECK(compare_writers("filesysdb", 64));
+    return UNIT_TEST_PASSED;
+}
+
+#ifdef LIBDB_ENABLED
+DECLARE_TEST(BerkeleyDBStoreWriters) {
+    CHECK(compare_writers("berkeleydb"));
+    return UNIT_TEST_PASSED;
+}
+#endif
+
+DECLARE_TESTER(TableConcurrencyTester) {
+    ADD_TEST(MemoryStoreWriters);
+    ADD_TEST(FileSystemStoreWriters);
+    ADD_TEST(FileSystemStoreCachedWriters);
+#ifdef LIBDB_ENABLED
+    ADD_TEST(BerkeleyDBStoreWriters);
+#endif
+}
+
+DECLARE_TEST_FILE(TableConcurrencyTester, "table concurrency test");
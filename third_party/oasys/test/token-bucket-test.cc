@@ -19,6 +19,7 @@
 #endif
 
 #include "util/TokenBucket.h"
+#include "util/TokenBucketLeaky.h"
 #include "util/UnitTest.h"
 
 using namespace oasys;
@@ -180,10 +181,67 @@ DECLARE_TEST(TimeToFill) {
     return UNIT_TEST_PASSED;
 }
 
+DECLARE_TEST(Fractional) {
+    // 1.5 tokens per ms, polled every ms, must not lose the half
+    // token left over from each update
+    TokenBucket t("/test/tokenbucket", 1000000, 1500);
+
+    safe_usleep(0);
+    DO(t.empty());
+    Time start;
+    start.get_time();
+
+    for (int i = 0; i < 2000; ++i) {
+        safe_usleep(1000);
+        t.update();
+    }
+
+    // the polling takes a bit longer than 2 seconds
+    u_int expected = (start.elapsed_us() * 1500) / 1000000;
+    CHECK_GTU(t.tokens(), expected - expected / 100);
+    CHECK_LTU(t.tokens(), expected + 1);
+
+    return UNIT_TEST_PASSED;
+}
+
+DECLARE_TEST(TimeToDrain) {
+    // one token per microsecond
+    TokenBucket t("/test/tokenbucket", 1000, 1000000);
+
+    CHECK_EQUAL(t.time_to_drain_ns(1000), 0);
+    CHECK(t.try_to_drain(1000));
+
+    u_int64_t ns = t.time_to_drain_ns(500);
+    CHECK_LTU(ns, 500001);
+    CHECK_GTU(ns, 400000);
+
+    // and it can go once that time is up
+    safe_usleep(0);
+    safe_usleep(ns / 1000 + 1);
+    CHECK_EQUAL(t.time_to_drain_ns(500), 0);
+    CHECK(t.try_to_drain(500));
+
+    TokenBucketLeaky l("/test/tokenbucket", 0, 1000000);
+    CHECK_EQUAL(l.time_to_drain_ns(1000), 0);
+    CHECK(l.try_to_drain(1000));
+
+    ns = l.time_to_drain_ns(1000);
+    CHECK_LTU(ns, 1000001);
+    CHECK_GTU(ns, 900000);
+
+    safe_usleep(0);
+    safe_usleep(ns / 1000 + 1);
+    CHECK_EQUAL(l.time_to_drain_ns(1000), 0);
+
+    return UNIT_TEST_PASSED;
+}
+
 DECLARE_TESTER(Test) {
     ADD_TEST(Fast);
     ADD_TEST(Slow);
     ADD_TEST(TimeToFill);
+    ADD_TEST(Fractional);
+    ADD_TEST(TimeToDrain);
 }
 
 DECLARE_TEST_FILE(Test, "token bucket test");
@@ -0,0 +1,817 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "../debug/Log.h"
+#include "../io/IO.h"
+#include "../serialize/TypeShims.h"
+#include "../storage/DurableStore.h"
+#include "../storage/InternalKeyDurableTable.h"
+#include "../storage/StorageConfig.h"
+#include "../thread/SpinLock.h"
+#include "../thread/Thread.h"
+#include "../util/App.h"
+#include "../util/StringBuffer.h"
+#include "../util/Time.h"
+
+using namespace oasys;
+
+//
+// Storage backend benchmark. A number of writer threads drive a
+// DurableStore of any configured type with a mix of puts, updates,
+// deletes and gets of records shaped like the bundle records the
+// daemon stores, optionally scanning their table with an iterator and
+// creating, writing and unlinking a payload file alongside each record
+// the way BundlePayload does. Operations are grouped into transactions
+// of a configurable size and the throughput, latency percentiles and
+// bytes written to the storage device per operation are reported.
+//
+
+/**
+ * A record with the same shape as a stored bundle: a handful of
+ * endpoint ids and fixed size fields followed by a variable length
+ * blob standing in for the extension blocks and forwarding log.
+ */
+class BenchRecord : public SerializableObject {
+public:
+    BenchRecord(u_int32_t key = 0)
+        : key_(key), creation_ts_(0), seqno_(0), lifetime_(0),
+          flags_(0), payload_len_(0) {}
+    BenchRecord(const Builder&)
+        : key_(0), creation_ts_(0), seqno_(0), lifetime_(0),
+          flags_(0), payload_len_(0) {}
+
+    u_int32_t durable_key() { return key_; }
+
+    virtual void serialize(SerializeAction* a) {
+        a->process("bundleid",     &key_);
+        a->process("source",       &source_);
+        a->process("dest",         &dest_);
+        a->process("replyto",      &replyto_);
+        a->process("custodian",    &custodian_);
+        a->process("creation_ts",  &creation_ts_);
+        a->process("seqno",        &seqno_);
+        a->process("lifetime",     &lifetime_);
+        a->process("flags",        &flags_);
+        a->process("payload_len",  &payload_len_);
+        a->process("payload_file", &payload_file_);
+        a->process("blocks",       &blocks_);
+    }
+
+    u_int32_t   key_;
+    std::string source_;
+    std::string dest_;
+    std::string replyto_;
+    std::string custodian_;
+    u_int64_t   creation_ts_;
+    u_int64_t   seqno_;
+    u_int64_t   lifetime_;
+    u_int32_t   flags_;
+    u_int64_t   payload_len_;
+    std::string payload_file_;
+    std::string blocks_;
+};
+
+typedef InternalKeyDurableTable<UIntShim, u_int32_t, BenchRecord> BenchTable;
+
+/**
+ * Kinds of operations that are timed.
+ */
+enum op_kind_t {
+    OP_PUT = 0,
+    OP_UPDATE,
+    OP_DEL,
+    OP_GET,
+    OP_SCAN,
+    OP_PAYLOAD_WRITE,
+    OP_PAYLOAD_UNLINK,
+    OP_MAX
+};
+
+static const char* op_names[OP_MAX] = {
+    "put", "update", "del", "get", "scan", "pl_write", "pl_unlink"
+};
+
+/**
+ * Latencies (in microseconds) and bytes handled for one kind of
+ * operation.
+ */
+struct OpStats {
+    OpStats() : bytes_(0), records_(0), errors_(0) {}
+
+    void add(const OpStats& other) {
+        latencies_.insert(latencies_.end(),
+                          other.latencies_.begin(), other.latencies_.end());
+        bytes_   += other.bytes_;
+        records_ += other.records_;
+        errors_  += other.errors_;
+    }
+
+    std::vector<u_int32_t> latencies_;
+    u_int64_t bytes_;
+    u_int64_t records_;     ///< records visited by scans
+    u_int64_t errors_;
+};
+
+class StorageBench;
+
+/**
+ * Thread that runs its share of the operations.
+ */
+class BenchWriter : public Thread {
+public:
+    BenchWriter(StorageBench* bench, int id, BenchTable* table);
+
+    OpStats stats_[OP_MAX];
+
+protected:
+    virtual void run();
+
+    /// Random number in [0..max)
+    u_int32_t rand(u_int32_t max) { return rand_r(&seed_) % max; }
+
+    /// Fill in a record with randomly sized fields
+    void fill_record(BenchRecord* rec, u_int32_t key);
+
+    void do_put();
+    void do_update();
+    void do_del();
+    void do_get();
+    void do_scan();
+
+    bool write_payload(const BenchRecord& rec);
+    void unlink_payload(const BenchRecord& rec);
+
+    StorageBench* bench_;
+    int id_;
+    BenchTable* table_;
+    unsigned int seed_;
+    u_int32_t next_key_;
+
+    /// Keys this writer has put and not yet deleted
+    std::vector<u_int32_t> live_;
+};
+
+/**
+ * The benchmark application.
+ */
+class StorageBench : public App {
+public:
+    StorageBench() : App("StorageBench", "storage-bench") {}
+    void fill_options();
+    int main(int argc, char* argv[]);
+
+    /// @{ Wrap each operation so that it is part of the current
+    /// transaction and the transaction is closed every txn_batch_ ops
+    void begin_op();
+    void end_op();
+    /// @}
+
+    /// Called by each writer once it has preloaded its records, returns
+    /// when all of them have and the clock has been started
+    void start_barrier();
+
+    /// Base of the writers' random seeds, fixed unless one is given so
+    /// that runs are repeatable
+    unsigned int seed_base() const {
+        return random_seed_set_ ? (unsigned int) random_seed_ : 0x5eed;
+    }
+
+    /// Options
+    std::string type_;
+    std::string dbname_;
+    std::string dbdir_;
+    int         writers_;
+    int         tables_;
+    int         ops_;
+    int         preload_;
+    int         put_pct_;
+    int         update_pct_;
+    int         del_pct_;
+    int         scan_every_;
+    int         txn_batch_;
+    int         max_nondurable_;
+    u_int64_t   min_size_;
+    u_int64_t   max_size_;
+    std::string payload_dir_;
+    u_int64_t   payload_size_;
+    u_int64_t   payload_chunk_;
+    bool        payload_sync_;
+
+    DurableStore* store_;
+
+protected:
+    /// Read the number of bytes this process has caused to be written
+    /// to the storage layer, or -1 if that is not available.
+    static int64_t io_write_bytes();
+
+    /// Print the statistics for one kind of operation.
+    void report(op_kind_t kind, OpStats* stats, u_int64_t elapsed_us);
+
+    /// Serializes the operations when transactions are used since all
+    /// the writers share the store's single open transaction
+    SpinLock txn_lock_;
+    int txn_ops_;
+    u_int64_t commits_;
+
+    SpinLock barrier_lock_;
+    int barrier_count_;
+    volatile bool barrier_go_;
+};
+
+//----------------------------------------------------------------------
+BenchWriter::BenchWriter(StorageBench* bench, int id, BenchTable* table)
+    : Thread("BenchWriter", CREATE_JOINABLE),
+      bench_(bench), id_(id), table_(table),
+      seed_(bench->seed_base() + id), next_key_((u_int32_t) id << 24)
+{
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::fill_record(BenchRecord* rec, u_int32_t key)
+{
+    StringBuffer eid("ipn:%u.%u", 100 + rand(1000), 1 + rand(64));
+
+    rec->key_         = key;
+    rec->source_      = eid.c_str();
+    rec->dest_        = "ipn:1.1";
+    rec->replyto_     = "dtn:none";
+    rec->custodian_   = "dtn:none";
+    rec->creation_ts_ = Time::now().in_milliseconds();
+    rec->seqno_       = key;
+    rec->lifetime_    = 86400000;
+    rec->flags_       = rand(0x10000);
+    rec->payload_len_ = bench_->payload_size_;
+
+    if (bench_->payload_dir_.length() != 0) {
+        StringBuffer path("%s/bundle_%u.dat", bench_->payload_dir_.c_str(), key);
+        rec->payload_file_ = path.c_str();
+    }
+
+    // the blob sizes are spread evenly over a log scale between the
+    // min and max so that most records are small but some are large
+    u_int64_t len = bench_->min_size_;
+    if (bench_->max_size_ > bench_->min_size_) {
+        double range = (double) bench_->max_size_ / (double) bench_->min_size_;
+        double frac  = (double) rand(10000) / 10000.0;
+        len = (u_int64_t) (bench_->min_size_ * pow(range, frac));
+    }
+    rec->blocks_.assign(len, 'b');
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::run()
+{
+    int put_limit    = bench_->put_pct_;
+    int update_limit = put_limit + bench_->update_pct_;
+    int del_limit    = update_limit + bench_->del_pct_;
+
+    for (int i = 0; i < bench_->preload_; ++i) {
+        do_put();
+    }
+    for (int i = 0; i < OP_MAX; ++i) {
+        stats_[i] = OpStats();
+    }
+
+    bench_->start_barrier();
+
+    for (int i = 0; i < bench_->ops_; ++i) {
+        int r = (int) rand(100);
+
+        if (live_.empty() || r < put_limit) {
+            do_put();
+        } else if (r < update_limit) {
+            do_update();
+        } else if (r < del_limit) {
+            do_del();
+        } else {
+            do_get();
+        }
+
+        if ((bench_->scan_every_ > 0) && (((i + 1) % bench_->scan_every_) == 0)) {
+            do_scan();
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::do_put()
+{
+    BenchRecord rec;
+    fill_record(&rec, next_key_++);
+
+    if (rec.payload_file_.length() != 0) {
+        write_payload(rec);
+    }
+
+    Time start;
+    start.get_time();
+
+    bench_->begin_op();
+    bool ok = table_->add(&rec);
+    bench_->end_op();
+
+    stats_[OP_PUT].latencies_.push_back(start.elapsed_us());
+    if (ok) {
+        stats_[OP_PUT].bytes_ += rec.blocks_.length();
+        live_.push_back(rec.key_);
+    } else {
+        ++stats_[OP_PUT].errors_;
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::do_update()
+{
+    BenchRecord rec;
+    fill_record(&rec, live_[rand(live_.size())]);
+
+    Time start;
+    start.get_time();
+
+    bench_->begin_op();
+    bool ok = table_->update(&rec);
+    bench_->end_op();
+
+    stats_[OP_UPDATE].latencies_.push_back(start.elapsed_us());
+    if (ok) {
+        stats_[OP_UPDATE].bytes_ += rec.blocks_.length();
+    } else {
+        ++stats_[OP_UPDATE].errors_;
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::do_del()
+{
+    size_t idx = rand(live_.size());
+    u_int32_t key = live_[idx];
+    live_[idx] = live_.back();
+    live_.pop_back();
+
+    Time start;
+    start.get_time();
+
+    bench_->begin_op();
+    bool ok = table_->del(key);
+    bench_->end_op();
+
+    stats_[OP_DEL].latencies_.push_back(start.elapsed_us());
+    if (!ok) {
+        ++stats_[OP_DEL].errors_;
+    }
+
+    if (bench_->payload_dir_.length() != 0) {
+        BenchRecord rec;
+        StringBuffer path("%s/bundle_%u.dat", bench_->payload_dir_.c_str(), key);
+        rec.payload_file_ = path.c_str();
+        unlink_payload(rec);
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::do_get()
+{
+    u_int32_t key = live_[rand(live_.size())];
+
+    Time start;
+    start.get_time();
+
+    bench_->begin_op();
+    BenchRecord* rec = table_->get(key);
+    bench_->end_op();
+
+    stats_[OP_GET].latencies_.push_back(start.elapsed_us());
+    if (rec != NULL) {
+        stats_[OP_GET].bytes_ += rec->blocks_.length();
+        delete rec;
+    } else {
+        ++stats_[OP_GET].errors_;
+    }
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::do_scan()
+{
+    Time start;
+    start.get_time();
+
+    // the scan holds the table (and with transactions the store) for
+    // its whole length just like the daemon does when loading
+    bench_->begin_op();
+    u_int64_t count = 0;
+    BenchTable::iterator* iter = table_->new_iterator();
+    while (iter->next() == 0) {
+        ++count;
+    }
+    delete iter;
+    bench_->end_op();
+
+    stats_[OP_SCAN].latencies_.push_back(start.elapsed_us());
+    stats_[OP_SCAN].records_ += count;
+}
+
+//----------------------------------------------------------------------
+bool
+BenchWriter::write_payload(const BenchRecord& rec)
+{
+    OpStats& stats = stats_[OP_PAYLOAD_WRITE];
+
+    Time start;
+    start.get_time();
+
+    int fd = open(rec.payload_file_.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd < 0) {
+        ++stats.errors_;
+        return false;
+    }
+
+    // written a chunk at a time the way the convergence layers hand
+    // the payload over as it arrives
+    std::string chunk(bench_->payload_chunk_, 'p');
+    u_int64_t remaining = bench_->payload_size_;
+    while (remaining > 0) {
+        size_t len = std::min(remaining, (u_int64_t) chunk.length());
+        if (IO::writeall(fd, chunk.data(), len) != (int) len) {
+            ++stats.errors_;
+            break;
+        }
+        remaining     -= len;
+        stats.bytes_  += len;
+    }
+
+    if (bench_->payload_sync_) {
+        fsync(fd);
+    }
+    close(fd);
+
+    stats.latencies_.push_back(start.elapsed_us());
+    return true;
+}
+
+//----------------------------------------------------------------------
+void
+BenchWriter::unlink_payload(const BenchRecord& rec)
+{
+    Time start;
+    start.get_time();
+
+    if (unlink(rec.payload_file_.c_str()) != 0) {
+        ++stats_[OP_PAYLOAD_UNLINK].errors_;
+    }
+
+    stats_[OP_PAYLOAD_UNLINK].latencies_.push_back(start.elapsed_us());
+}
+
+//----------------------------------------------------------------------
+void
+StorageBench::fill_options()
+{
+    type_           = "berkeleydb";
+    dbname_         = "DTN";
+    dbdir_          = "/tmp/storage-bench";
+    writers_        = 1;
+    tables_         = 1;
+    ops_            = 10000;
+    preload_        = 1000;
+    put_pct_        = 40;
+    update_pct_     = 30;
+    del_pct_        = 25;
+    scan_every_     = 0;
+    txn_batch_      = 32;
+    max_nondurable_ = 0;
+    min_size_       = 256;
+    max_size_       = 8192;
+    payload_dir_    = "";
+    payload_size_   = 65536;
+    payload_chunk_  = 16384;
+    payload_sync_   = true;
+
+    fill_default_options(0);
+
+    opts_.addopt(new StringOpt('t', "type", &type_, "<type>",
+                               "storage type [berkeleydb|filesysdb|memorydb|"
+                               "odbc-sqlite|odbc-mysql]"));
+    opts_.addopt(new StringOpt('n', "dbname", &dbname_, "<name>",
+                               "database name (or ODBC DSN)"));
+    opts_.addopt(new StringOpt('d', "dbdir", &dbdir_, "<dir>",
+                               "database directory (created and tidied)"));
+    opts_.addopt(new IntOpt('w', "writers", &writers_, "<num>",
+                            "number of concurrent writer threads"));
+    opts_.addopt(new IntOpt('T', "tables", &tables_, "<num>",
+                            "number of tables shared round robin by the writers"));
+    opts_.addopt(new IntOpt('c', "ops", &ops_, "<num>",
+                            "operations per writer"));
+    opts_.addopt(new IntOpt('p', "preload", &preload_, "<num>",
+                            "records put by each writer before timing starts"));
+    opts_.addopt(new IntOpt(0, "put-pct", &put_pct_, "<pct>",
+                            "percentage of operations that are puts"));
+    opts_.addopt(new IntOpt(0, "update-pct", &update_pct_, "<pct>",
+                            "percentage of operations that are updates"));
+    opts_.addopt(new IntOpt(0, "del-pct", &del_pct_, "<pct>",
+                            "percentage of operations that are deletes "
+                            "(the rest are gets)"));
+    opts_.addopt(new IntOpt(0, "scan-every", &scan_every_, "<num>",
+                            "scan the table with an iterator every num "
+                            "operations (0 for never)"));
+    opts_.addopt(new IntOpt('b', "txn-batch", &txn_batch_, "<num>",
+                            "operations per transaction (0 for none)"));
+    opts_.addopt(new IntOpt(0, "max-nondurable", &max_nondurable_, "<num>",
+                            "transactions committed without a sync before "
+                            "a durable one"));
+    opts_.addopt(new SizeOpt(0, "min-size", &min_size_, "<bytes>",
+                             "smallest variable part of a record"));
+    opts_.addopt(new SizeOpt(0, "max-size", &max_size_, "<bytes>",
+                             "largest variable part of a record"));
+    opts_.addopt(new StringOpt('P', "payload-dir", &payload_dir_, "<dir>",
+                               "create a payload file per record in dir "
+                               "(none if not set)"));
+    opts_.addopt(new SizeOpt(0, "payload-size", &payload_size_, "<bytes>",
+                             "size of each payload file"));
+    opts_.addopt(new SizeOpt(0, "payload-chunk", &payload_chunk_, "<bytes>",
+                             "size of the writes to the payload files"));
+    opts_.addopt(new BoolOpt(0, "payload-sync", &payload_sync_,
+                             "fsync each payload file once it is written"));
+}
+
+//----------------------------------------------------------------------
+void
+StorageBench::begin_op()
+{
+    if (txn_batch_ <= 0) {
+        return;
+    }
+
+    txn_lock_.lock("StorageBench::begin_op");
+    if (txn_ops_ == 0) {
+        store_->begin_transaction();
+    }
+}
+
+//----------------------------------------------------------------------
+void
+StorageBench::end_op()
+{
+    if (txn_batch_ <= 0) {
+        return;
+    }
+
+    if (++txn_ops_ >= txn_batch_) {
+        store_->end_transaction();
+        txn_ops_ = 0;
+        ++commits_;
+    }
+    txn_lock_.unlock();
+}
+
+//----------------------------------------------------------------------
+void
+StorageBench::start_barrier()
+{
+    barrier_lock_.lock("StorageBench::start_barrier");
+    ++barrier_count_;
+    barrier_lock_.unlock();
+
+    while (!barrier_go_) {
+        usleep(100);
+    }
+}
+
+//----------------------------------------------------------------------
+int64_t
+StorageBench::io_write_bytes()
+{
+    FILE* f = fopen("/proc/self/io", "r");
+    if (f == NULL) {
+        return -1;
+    }
+
+    char line[128];
+    long long val;
+    int64_t ret = -1;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "write_bytes: %lld", &val) == 1) {
+            ret = val;
+            break;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+//----------------------------------------------------------------------
+void
+StorageBench::report(op_kind_t kind, OpStats* stats, u_int64_t elapsed_us)
+{
+    size_t count = stats->latencies_.size();
+    if (count == 0) {
+        return;
+    }
+
+    std::sort(stats->latencies_.begin(), stats->latencies_.end());
+
+    u_int64_t total_us = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total_us += stats->latencies_[i];
+    }
+
+    printf("%-10s %9zu %11.0f %9" PRIu64 " %9u %9u %9u %10.0f %7" PRIu64 "\n",
+           op_names[kind], count,
+           (double) count * 1000000.0 / (elapsed_us ? elapsed_us : 1),
+           total_us / count,
+           stats->latencies_[count / 2],
+           stats->latencies_[std::min(count - 1, (count * 99) / 100)],
+           stats->latencies_[count - 1],
+           (double) stats->bytes_ / count,
+           stats->errors_);
+}
+
+//----------------------------------------------------------------------
+int
+StorageBench::main(int argc, char* argv[])
+{
+    loglevel_ = LOG_WARN;
+    logfile_  = "--"; // stderr
+
+    init_app(argc, argv);
+
+    if ((writers_ < 1) || (tables_ < 1) || (put_pct_ + update_pct_ + del_pct_ > 100)) {
+        fprintf(stderr, "invalid writers, tables or operation mix\n");
+        print_usage_and_exit();
+    }
+    if ((payload_dir_.length() != 0) && (payload_chunk_ == 0)) {
+        fprintf(stderr, "payload-chunk must be non-zero\n");
+        print_usage_and_exit();
+    }
+    if (min_size_ == 0) {
+        min_size_ = 1;
+    }
+
+    StringBuffer cmd("mkdir -p %s", dbdir_.c_str());
+    system(cmd.c_str());
+    if (payload_dir_.length() != 0) {
+        StringBuffer payload_cmd("rm -rf %s && mkdir -p %s",
+                                 payload_dir_.c_str(), payload_dir_.c_str());
+        system(payload_cmd.c_str());
+    }
+
+    StorageConfig cfg("storage", type_, dbname_, dbdir_);
+    cfg.init_      = true;
+    cfg.tidy_      = true;
+    cfg.tidy_wait_ = 0;
+    cfg.auto_commit_ = (txn_batch_ <= 0);
+    cfg.max_nondurable_transactions_ = max_nondurable_;
+
+    store_ = new DurableStore("/storage-bench/store");
+    if (store_->create_store(cfg) != 0) {
+        fprintf(stderr, "error creating %s store in %s\n",
+                type_.c_str(), dbdir_.c_str());
+        return 1;
+    }
+
+    std::vector<BenchTable*> tables;
+    for (int i = 0; i < tables_; ++i) {
+        StringBuffer name("bench%d", i);
+        BenchTable* table = new BenchTable("BenchTable", "/storage-bench/table",
+                                           "record", strdup(name.c_str()));
+        if (table->do_init(cfg, store_) != 0) {
+            fprintf(stderr, "error creating table %s\n", name.c_str());
+            return 1;
+        }
+        tables.push_back(table);
+    }
+
+    txn_ops_ = 0;
+    commits_ = 0;
+    barrier_count_ = 0;
+    barrier_go_    = false;
+
+    std::vector<BenchWriter*> writers;
+    for (int i = 0; i < writers_; ++i) {
+        writers.push_back(new BenchWriter(this, i, tables[i % tables_]));
+    }
+
+    for (int i = 0; i < writers_; ++i) {
+        writers[i]->start();
+    }
+
+    // wait for all the writers to finish preloading
+    while (true) {
+        barrier_lock_.lock("StorageBench::main");
+        bool ready = (barrier_count_ == writers_);
+        barrier_lock_.unlock();
+        if (ready) {
+            break;
+        }
+        usleep(1000);
+    }
+
+    int64_t io_start = io_write_bytes();
+    Time start;
+    start.get_time();
+    barrier_go_ = true;
+
+    for (int i = 0; i < writers_; ++i) {
+        writers[i]->join();
+    }
+
+    // close out any partial transaction so its writes are counted
+    if ((txn_batch_ > 0) && (txn_ops_ != 0)) {
+        store_->make_transaction_durable();
+        store_->end_transaction();
+        txn_ops_ = 0;
+        ++commits_;
+    }
+
+    u_int64_t elapsed_us = start.elapsed_us();
+    int64_t io_end = io_write_bytes();
+
+    OpStats totals[OP_MAX];
+    for (int i = 0; i < writers_; ++i) {
+        for (int kind = 0; kind < OP_MAX; ++kind) {
+            totals[kind].add(writers[i]->stats_[kind]);
+        }
+        delete writers[i];
+    }
+
+    u_int64_t db_ops = totals[OP_PUT].latencies_.size() +
+                       totals[OP_UPDATE].latencies_.size() +
+                       totals[OP_DEL].latencies_.size() +
+                       totals[OP_GET].latencies_.size();
+
+    printf("storage-bench: type %s, %d writer(s), %d table(s), %d ops/writer, "
+           "txn batch %d, records %" PRIu64 "-%" PRIu64 " bytes\n",
+           type_.c_str(), writers_, tables_, ops_, txn_batch_,
+           min_size_, max_size_);
+    printf("%" PRIu64 " operations in %.3f s: %.0f ops/s, %" PRIu64 " commits\n",
+           db_ops, (double) elapsed_us / 1000000.0,
+           (double) db_ops * 1000000.0 / (elapsed_us ? elapsed_us : 1),
+           commits_);
+    if ((io_start >= 0) && (io_end >= 0) && (db_ops > 0)) {
+        printf("%" PRId64 " bytes written to storage: %.0f bytes/op\n",
+               io_end - io_start, (double) (io_end - io_start) / db_ops);
+    } else {
+        printf("bytes written to storage: not available\n");
+    }
+
+    printf("\n%-10s %9s %11s %9s %9s %9s %9s %10s %7s\n",
+           "op", "count", "ops/s", "avg(us)", "p50(us)", "p99(us)", "max(us)",
+           "bytes/op", "errors");
+    for (int kind = 0; kind < OP_MAX; ++kind) {
+        report((op_kind_t) kind, &totals[kind], elapsed_us);
+    }
+    if (totals[OP_SCAN].latencies_.size() != 0) {
+        printf("\n%.0f records per scan\n",
+               (double) totals[OP_SCAN].records_ / totals[OP_SCAN].latencies_.size());
+    }
+
+    for (int i = 0; i < tables_; ++i) {
+        delete tables[i];
+    }
+    DurableStore::reset();
+
+    return 0;
+}
+
+//----------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    StorageBench b;
+    return b.main(argc, argv);
+}
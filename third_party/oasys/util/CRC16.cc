@@ -0,0 +1,105 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <string.h>
+
+#include "CRC16.h"
+
+namespace oasys {
+
+/* CRC-16/X.25 polynomial (0x1021) in reversed bit order. */
+#define CRC16_POLY 0x8408
+
+namespace {
+
+/*
+ * Tables for the slicing-by-8 crc, built the first time they are
+ * needed. t_[k][n] is the crc register for byte n followed by k zero
+ * bytes.
+ */
+struct CRC16Tables {
+    u_int16_t t_[8][256];
+
+    CRC16Tables()
+    {
+        for (u_int32_t n = 0; n < 256; n++) {
+            u_int16_t crc = n;
+            for (int k = 0; k < 8; k++) {
+                crc = (crc & 1) ? ((crc >> 1) ^ CRC16_POLY) : (crc >> 1);
+            }
+            t_[0][n] = crc;
+        }
+
+        for (u_int32_t n = 0; n < 256; n++) {
+            u_int16_t crc = t_[0][n];
+            for (int k = 1; k < 8; k++) {
+                crc = t_[0][crc & 0xff] ^ (crc >> 8);
+                t_[k][n] = crc;
+            }
+        }
+    }
+};
+
+const CRC16Tables&
+crc16_tables()
+{
+    static const CRC16Tables tables;
+    return tables;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+CRC16::CRC_t
+CRC16::extend(CRC_t crci, const u_char* buf, size_t length)
+{
+    const CRC16Tables& tables = crc16_tables();
+    const u_char* next = buf;
+    u_int64_t crc = crci ^ 0xffff;
+    u_int64_t next_qword;
+
+    while (length && ((uintptr_t)next & 7) != 0) {
+        crc = tables.t_[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
+        length--;
+    }
+    while (length >= 8) {
+        memcpy(&next_qword, next, 8);
+        crc ^= next_qword;
+        crc = tables.t_[7][crc & 0xff] ^
+              tables.t_[6][(crc >> 8) & 0xff] ^
+              tables.t_[5][(crc >> 16) & 0xff] ^
+              tables.t_[4][(crc >> 24) & 0xff] ^
+              tables.t_[3][(crc >> 32) & 0xff] ^
+              tables.t_[2][(crc >> 40) & 0xff] ^
+              tables.t_[1][(crc >> 48) & 0xff] ^
+              tables.t_[0][crc >> 56];
+        next += 8;
+        length -= 8;
+    }
+    while (length) {
+        crc = tables.t_[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
+        length--;
+    }
+
+    return (CRC_t)(crc ^ 0xffff);
+}
+
+} // namespace oasys
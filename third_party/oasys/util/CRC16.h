@@ -0,0 +1,61 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _OASYS_CRC16_H_
+#define _OASYS_CRC16_H_
+
+#include <sys/types.h>
+#include "../compat/inttypes.h"
+
+namespace oasys {
+
+/**
+ * CRC-16/X.25 (also known as CRC-16/ISO-HDLC) as used by the BPv7
+ * CRC type 1, computed eight bytes at a time (slicing-by-8).
+ *
+ * Like CRC32C, the static function operates on finished CRC values
+ * so a CRC can be extended with more data at any time.
+ */
+class CRC16 {
+public:
+    typedef u_int16_t CRC_t;
+
+    CRC16() : crc_(0) {}
+
+    /**
+     * Update the crc with the data in the buf
+     */
+    void update(const u_char* buf, size_t length) {
+        crc_ = extend(crc_, buf, length);
+    }
+
+    CRC_t value() const { return crc_; }
+    void reset() { crc_ = 0; }
+
+    /**
+     * @return the CRC of the data covered by crc followed by the
+     * length bytes of buf (start with a crc of 0)
+     */
+    static CRC_t extend(CRC_t crc, const u_char* buf, size_t length);
+
+private:
+    CRC_t crc_;
+};
+
+} // namespace oasys
+
+#endif /* _OASYS_CRC16_H_ */
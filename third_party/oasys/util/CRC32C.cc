@@ -0,0 +1,441 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <oasys-config.h>
+#endif
+
+#include <string.h>
+
+#include "CRC32C.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#  include <nmmintrin.h>
+#  define CRC32C_HW_NAME "sse4.2"
+#  define CRC32C_HW_TARGET __attribute__((target("sse4.2")))
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+#  include <arm_acle.h>
+#  include <sys/auxv.h>
+#  include <asm/hwcap.h>
+#  define CRC32C_HW_NAME "armv8-crc"
+#  if defined(__clang__)
+#    define CRC32C_HW_TARGET __attribute__((target("crc")))
+#  else
+#    define CRC32C_HW_TARGET __attribute__((target("+crc")))
+#  endif
+#endif
+
+namespace oasys {
+
+/* CRC-32C (iSCSI) polynomial in reversed bit order. */
+#define CRC32C_POLY 0x82f63b78
+
+/*
+ * Block sizes for the interleaved hardware crc. Both have to be
+ * powers of two for crc32c_zeros_op().
+ */
+#define CRC32C_LONG  8192
+#define CRC32C_SHORT 256
+
+namespace {
+
+//----------------------------------------------------------------------
+u_int32_t
+gf2_matrix_times(const u_int32_t* mat, u_int32_t vec)
+{
+    u_int32_t sum = 0;
+    while (vec) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+//----------------------------------------------------------------------
+void
+gf2_matrix_square(u_int32_t* square, const u_int32_t* mat)
+{
+    for (int n = 0; n < 32; n++) {
+        square[n] = gf2_matrix_times(mat, mat[n]);
+    }
+}
+
+/*
+ * Tables for a quadword-at-a-time (slicing-by-8) software crc,
+ * built the first time they are needed.
+ */
+struct CRC32CTables {
+    u_int32_t t_[8][256];
+
+    CRC32CTables()
+    {
+        for (u_int32_t n = 0; n < 256; n++) {
+            u_int32_t crc = n;
+            for (int k = 0; k < 8; k++) {
+                crc = (crc & 1) ? ((crc >> 1) ^ CRC32C_POLY) : (crc >> 1);
+            }
+            t_[0][n] = crc;
+        }
+
+        for (u_int32_t n = 0; n < 256; n++) {
+            u_int32_t crc = t_[0][n];
+            for (int k = 1; k < 8; k++) {
+                crc = t_[0][crc & 0xff] ^ (crc >> 8);
+                t_[k][n] = crc;
+            }
+        }
+    }
+};
+
+const CRC32CTables&
+crc32c_tables()
+{
+    static const CRC32CTables tables;
+    return tables;
+}
+
+#ifdef CRC32C_HW_TARGET
+
+//----------------------------------------------------------------------
+/*
+ * Build the operator that applies len zero bytes to a crc register,
+ * len being a power of two.
+ */
+void
+crc32c_zeros_op(u_int32_t* even, size_t len)
+{
+    u_int32_t odd[32];
+
+    // operator for one zero bit in odd
+    odd[0] = CRC32C_POLY;
+    u_int32_t row = 1;
+    for (int n = 1; n < 32; n++) {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    // operator for two zero bits in even, then four zero bits in odd
+    gf2_matrix_square(even, odd);
+    gf2_matrix_square(odd, even);
+
+    // the first square puts the operator for one zero byte in even,
+    // the next the one for two zero bytes in odd, and so on
+    do {
+        gf2_matrix_square(even, odd);
+        len >>= 1;
+        if (len == 0) {
+            return;
+        }
+        gf2_matrix_square(odd, even);
+        len >>= 1;
+    } while (len);
+
+    memcpy(even, odd, sizeof(odd));
+}
+
+/*
+ * Tables to shift a crc register forward over CRC32C_LONG and
+ * CRC32C_SHORT zero bytes a byte at a time, used to combine the
+ * interleaved crcs computed by the hardware version.
+ */
+struct CRC32CShiftTables {
+    u_int32_t long_[4][256];
+    u_int32_t short_[4][256];
+
+    CRC32CShiftTables()
+    {
+        build(long_, CRC32C_LONG);
+        build(short_, CRC32C_SHORT);
+    }
+
+    static void build(u_int32_t zeros[][256], size_t len)
+    {
+        u_int32_t op[32];
+        crc32c_zeros_op(op, len);
+        for (u_int32_t n = 0; n < 256; n++) {
+            zeros[0][n] = gf2_matrix_times(op, n);
+            zeros[1][n] = gf2_matrix_times(op, n << 8);
+            zeros[2][n] = gf2_matrix_times(op, n << 16);
+            zeros[3][n] = gf2_matrix_times(op, n << 24);
+        }
+    }
+};
+
+const CRC32CShiftTables&
+crc32c_shift_tables()
+{
+    static const CRC32CShiftTables tables;
+    return tables;
+}
+
+//----------------------------------------------------------------------
+inline u_int32_t
+crc32c_shift(const u_int32_t zeros[][256], u_int32_t crc)
+{
+    return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+           zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+#if defined(__x86_64__)
+
+inline bool
+hw_supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+
+CRC32C_HW_TARGET __attribute__((always_inline)) inline u_int32_t
+hw_crc_u8(u_int32_t crc, u_char b)
+{
+    return _mm_crc32_u8(crc, b);
+}
+
+CRC32C_HW_TARGET __attribute__((always_inline)) inline u_int32_t
+hw_crc_u64(u_int32_t crc, u_int64_t word)
+{
+    return (u_int32_t)_mm_crc32_u64(crc, word);
+}
+
+#else
+
+inline bool
+hw_supported()
+{
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+}
+
+CRC32C_HW_TARGET __attribute__((always_inline)) inline u_int32_t
+hw_crc_u8(u_int32_t crc, u_char b)
+{
+    return __crc32cb(crc, b);
+}
+
+CRC32C_HW_TARGET __attribute__((always_inline)) inline u_int32_t
+hw_crc_u64(u_int32_t crc, u_int64_t word)
+{
+    return __crc32cd(crc, word);
+}
+
+#endif
+
+//----------------------------------------------------------------------
+/*
+ * Run the crc instruction over three adjacent blocks of block_len
+ * bytes at a time in parallel to hide its latency, then shift the
+ * crcs of the first two forward over the blocks that follow them
+ * and combine the three.
+ */
+CRC32C_HW_TARGET u_int32_t
+crc32c_hw_blocks(u_int32_t crc0, const u_char** nextp, size_t* lengthp,
+                 size_t block_len, const u_int32_t zeros[][256])
+{
+    const u_char* next = *nextp;
+    size_t length = *lengthp;
+    u_int64_t w0, w1, w2;
+
+    while (length >= block_len * 3) {
+        u_int32_t crc1 = 0;
+        u_int32_t crc2 = 0;
+        const u_char* end = next + block_len;
+        do {
+            memcpy(&w0, next, 8);
+            memcpy(&w1, next + block_len, 8);
+            memcpy(&w2, next + (block_len * 2), 8);
+            crc0 = hw_crc_u64(crc0, w0);
+            crc1 = hw_crc_u64(crc1, w1);
+            crc2 = hw_crc_u64(crc2, w2);
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(zeros, crc0) ^ crc1;
+        crc0 = crc32c_shift(zeros, crc0) ^ crc2;
+        next += block_len * 2;
+        length -= block_len * 3;
+    }
+
+    *nextp = next;
+    *lengthp = length;
+    return crc0;
+}
+
+//----------------------------------------------------------------------
+CRC32C_HW_TARGET CRC32C::CRC_t
+crc32c_hw(CRC32C::CRC_t crci, const u_char* buf, size_t length)
+{
+    const CRC32CShiftTables& shift = crc32c_shift_tables();
+    const u_char* next = buf;
+    u_int32_t crc = crci ^ 0xffffffff;
+    u_int64_t word;
+
+    while (length && ((uintptr_t)next & 7) != 0) {
+        crc = hw_crc_u8(crc, *next++);
+        length--;
+    }
+
+    crc = crc32c_hw_blocks(crc, &next, &length, CRC32C_LONG, shift.long_);
+    crc = crc32c_hw_blocks(crc, &next, &length, CRC32C_SHORT, shift.short_);
+
+    while (length >= 8) {
+        memcpy(&word, next, 8);
+        crc = hw_crc_u64(crc, word);
+        next += 8;
+        length -= 8;
+    }
+    while (length) {
+        crc = hw_crc_u8(crc, *next++);
+        length--;
+    }
+
+    return crc ^ 0xffffffff;
+}
+
+#endif // CRC32C_HW_TARGET
+
+/*
+ * The implementation picked for the cpu the first time a crc is
+ * computed.
+ */
+struct CRC32CImpl {
+    typedef CRC32C::CRC_t (*ExtendFn)(CRC32C::CRC_t, const u_char*, size_t);
+
+    ExtendFn    extend_;
+    const char* name_;
+
+    CRC32CImpl()
+        : extend_(CRC32C::extend_sw), name_("slicing-by-8")
+    {
+#ifdef CRC32C_HW_TARGET
+        if (hw_supported()) {
+            crc32c_shift_tables();
+            extend_ = crc32c_hw;
+            name_   = CRC32C_HW_NAME;
+        }
+#endif
+    }
+};
+
+const CRC32CImpl&
+crc32c_impl()
+{
+    static const CRC32CImpl impl;
+    return impl;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+CRC32C::CRC_t
+CRC32C::extend(CRC_t crc, const u_char* buf, size_t length)
+{
+    return crc32c_impl().extend_(crc, buf, length);
+}
+
+//----------------------------------------------------------------------
+const char*
+CRC32C::implementation()
+{
+    return crc32c_impl().name_;
+}
+
+//----------------------------------------------------------------------
+CRC32C::CRC_t
+CRC32C::extend_sw(CRC_t crci, const u_char* buf, size_t length)
+{
+    const CRC32CTables& tables = crc32c_tables();
+    const u_char* next = buf;
+    u_int64_t crc = crci ^ 0xffffffff;
+    u_int64_t next_qword;
+
+    while (length && ((uintptr_t)next & 7) != 0) {
+        crc = tables.t_[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
+        length--;
+    }
+    while (length >= 8) {
+        memcpy(&next_qword, next, 8);
+        crc ^= next_qword;
+        crc = tables.t_[7][crc & 0xff] ^
+              tables.t_[6][(crc >> 8) & 0xff] ^
+              tables.t_[5][(crc >> 16) & 0xff] ^
+              tables.t_[4][(crc >> 24) & 0xff] ^
+              tables.t_[3][(crc >> 32) & 0xff] ^
+              tables.t_[2][(crc >> 40) & 0xff] ^
+              tables.t_[1][(crc >> 48) & 0xff] ^
+              tables.t_[0][crc >> 56];
+        next += 8;
+        length -= 8;
+    }
+    while (length) {
+        crc = tables.t_[0][(crc ^ *next++) & 0xff] ^ (crc >> 8);
+        length--;
+    }
+
+    return (CRC_t)crc ^ 0xffffffff;
+}
+
+//----------------------------------------------------------------------
+CRC32C::CRC_t
+CRC32C::combine(CRC_t crc1, CRC_t crc2, u_int64_t length2)
+{
+    // Same approach as zlib's crc32_combine: apply length2 zero bytes
+    // to crc1 by repeated squaring of the operator matrix for one
+    // zero bit, then fold in crc2.
+    u_int32_t even[32];    // even-power-of-two zeros operator
+    u_int32_t odd[32];     // odd-power-of-two zeros operator
+
+    if (length2 == 0) {
+        return crc1;
+    }
+
+    // operator for one zero bit in odd
+    odd[0] = CRC32C_POLY;
+    u_int32_t row = 1;
+    for (int n = 1; n < 32; n++) {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    // operator for two zero bits in even, then four zero bits in odd
+    gf2_matrix_square(even, odd);
+    gf2_matrix_square(odd, even);
+
+    // apply length2 zeros to crc1 (the first square puts the operator
+    // for one zero byte, eight zero bits, in even)
+    do {
+        gf2_matrix_square(even, odd);
+        if (length2 & 1) {
+            crc1 = gf2_matrix_times(even, crc1);
+        }
+        length2 >>= 1;
+
+        if (length2 == 0) {
+            break;
+        }
+
+        gf2_matrix_square(odd, even);
+        if (length2 & 1) {
+            crc1 = gf2_matrix_times(odd, crc1);
+        }
+        length2 >>= 1;
+    } while (length2 != 0);
+
+    return crc1 ^ crc2;
+}
+
+} // namespace oasys
@@ -0,0 +1,81 @@
+/*
+ *    Copyright 2026 United States Government as represented by NASA
+ *       Marshall Space Flight Center. All Rights Reserved.
+ *
+ *    Released under the NASA Open Source Software Agreement version 1.3;
+ *    You may obtain a copy of the Agreement at:
+ *
+ *        http://ti.arc.nasa.gov/opensource/nosa/
+ *
+ *    The subject software is provided "AS IS" WITHOUT ANY WARRANTY of any kind,
+ *    either expressed, implied or statutory and this agreement does not,
+ *    in any manner, constitute an endorsement by government agency of any
+ *    results, designs or products resulting from use of the subject software.
+ *    See the Agreement for the specific language governing permissions and
+ *    limitations.
+ */
+
+#ifndef _OASYS_CRC32C_H_
+#define _OASYS_CRC32C_H_
+
+#include <sys/types.h>
+#include "../compat/inttypes.h"
+
+namespace oasys {
+
+/**
+ * CRC-32C (Castagnoli) as used by iSCSI and the BPv7 CRC type 2.
+ *
+ * The static functions operate on finished CRC values so a CRC can
+ * be extended with more data at any time and the CRCs of two adjacent
+ * ranges can be combined without the data of either.
+ *
+ * extend() uses the SSE4.2 or ARMv8 crc32c instructions when the cpu
+ * it is running on has them, checked the first time it is called, and
+ * the slicing-by-8 table version otherwise.
+ */
+class CRC32C {
+public:
+    typedef u_int32_t CRC_t;
+
+    CRC32C() : crc_(0) {}
+
+    /**
+     * Update the crc with the data in the buf
+     */
+    void update(const u_char* buf, size_t length) {
+        crc_ = extend(crc_, buf, length);
+    }
+
+    CRC_t value() const { return crc_; }
+    void reset() { crc_ = 0; }
+
+    /**
+     * @return the CRC of the data covered by crc followed by the
+     * length bytes of buf (start with a crc of 0)
+     */
+    static CRC_t extend(CRC_t crc, const u_char* buf, size_t length);
+
+    /**
+     * The table driven version of extend(), whatever the cpu supports.
+     */
+    static CRC_t extend_sw(CRC_t crc, const u_char* buf, size_t length);
+
+    /**
+     * @return the name of the implementation used by extend()
+     */
+    static const char* implementation();
+
+    /**
+     * @return the CRC of two adjacent ranges given the CRC of each
+     * and the length of the second
+     */
+    static CRC_t combine(CRC_t crc1, CRC_t crc2, u_int64_t length2);
+
+private:
+    CRC_t crc_;
+};
+
+} // namespace oasys
+
+#endif /* _OASYS_CRC32C_H_ */
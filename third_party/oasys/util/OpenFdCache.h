@@ -18,6 +18,8 @@
 #define __OPENFDCACHE_H__
 
 #include <map>
+#include <vector>
+#include <unistd.h>
 
 #include "../debug/Logger.h"
 #include "../thread/SpinLock.h"
@@ -183,32 +185,56 @@ public:
      */
     void sync(const _Key& key)
     {
-        ScopeLock l(&lock_, "OpenFdCache::close");
+        int fd;
+        {
+            ScopeLock l(&lock_, "OpenFdCache::sync");
 
-        typename FdMap::iterator i = open_fds_map_.find(key);
+            typename FdMap::iterator i = open_fds_map_.find(key);
 
-        if (i == open_fds_map_.end())
-        {
-        	log_warn("sync failed; Key not found");
-            return;
+            if (i == open_fds_map_.end())
+            {
+                log_warn("sync failed; Key not found");
+                return;
+            }
+
+            fd = ::dup(i->second->fd_);
         }
 
-        fsync(i->second->fd_);
+        // the fsync is done on a dup of the fd so the cache isn't held
+        // locked while it waits on the disk
+        if (fd != -1) {
+            fsync(fd);
+            IO::close(fd);
+        }
     }
 
     /*!
-     * Close and release all of the cached fds.
+     * Sync all of the cached fds.
      */
     void sync_all() {
-        ScopeLock l(&lock_, "OpenFdCache::sync_all");
+        std::vector<int> fds;
+        {
+            ScopeLock l(&lock_, "OpenFdCache::sync_all");
 
-        log_debug("There were %zu open fds upon sync_all.", open_fds_.size());
+            log_debug("There were %zu open fds upon sync_all.", open_fds_.size());
 
-        for (typename FdList::iterator i = open_fds_.begin();
-             i != open_fds_.end(); ++i)
-        {
-            log_debug("Syncing fd=%d", i->fd_);
-            fsync(i->fd_);
+            fds.reserve(open_fds_.size());
+            for (typename FdList::iterator i = open_fds_.begin();
+                 i != open_fds_.end(); ++i)
+            {
+                int fd = ::dup(i->fd_);
+                if (fd != -1) {
+                    fds.push_back(fd);
+                }
+            }
+        }
+
+        // as in sync(), the fsyncs are done on dups of the cached fds
+        // so the files of other tables can be used meanwhile
+        for (size_t i = 0; i < fds.size(); ++i) {
+            log_debug("Syncing fd=%d", fds[i]);
+            fsync(fds[i]);
+            IO::close(fds[i]);
         }
     }
 
@@ -217,22 +243,27 @@ public:
      */
     void close(const _Key& key) 
     {
-        ScopeLock l(&lock_, "OpenFdCache::close");
-        
-        typename FdMap::iterator i = open_fds_map_.find(key);
-
-        if (i == open_fds_map_.end()) 
+        int fd;
         {
-            return;
-        }
+            ScopeLock l(&lock_, "OpenFdCache::close");
 
-        ASSERT(i->second->pin_count_ == 0);
+            typename FdMap::iterator i = open_fds_map_.find(key);
 
-        _CloseFcn::close(i->second->fd_);
-        log_debug("Closed %d size=%u", i->second->fd_, (u_int)open_fds_map_.size());
+            if (i == open_fds_map_.end()) 
+            {
+                return;
+            }
+
+            ASSERT(i->second->pin_count_ == 0);
+
+            fd = i->second->fd_;
+            open_fds_.erase(i->second);
+            open_fds_map_.erase(i);       
+        }
 
-        open_fds_.erase(i->second);
-        open_fds_map_.erase(i);       
+        // nobody can get at the fd once it is out of the cache
+        _CloseFcn::close(fd);
+        log_debug("Closed %d", fd);
     }
     
     /*!
@@ -64,6 +64,17 @@ public:
     _memory_t end() { 
         return reinterpret_cast<_memory_t>(ExpandableBuffer::eb_end());
     }
+
+    //! Free the allocated memory, leaving an empty buffer
+    void free_buf() {
+        if (buf_ != 0) {
+            free(buf_);
+            buf_ = 0;
+        }
+
+        buf_len_ = 0;
+        len_     = 0;
+    }
 };
 
 /*!
@@ -36,6 +36,10 @@
 #  include <oasys-config.h>
 #endif
 
+#include <algorithm>
+#include <math.h>
+#include <time.h>
+
 #include "TokenBucket.h"
 
 namespace oasys {
@@ -51,47 +55,76 @@ TokenBucket::TokenBucket(const char* logpath,
 {
     log_debug("initialized token bucket with depth %llu and rate %llu",
               U64FMT(depth_), U64FMT(rate_));
-    last_update_.get_time();
+    last_update_ns_ = now_ns();
+}
+
+//----------------------------------------------------------------------
+u_int64_t
+TokenBucket::now_ns()
+{
+    // the monotonic clock never jumps backwards
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((u_int64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+//----------------------------------------------------------------------
+u_int64_t
+TokenBucket::ns_for_tokens(u_int64_t n) const
+{
+    return (u_int64_t)ceil(((double)n * 1e9) / rate_);
+}
+
+//----------------------------------------------------------------------
+u_int64_t
+TokenBucket::tokens_for_ns(u_int64_t ns) const
+{
+    return (u_int64_t)floor(((double)ns * rate_) / 1e9);
 }
 
 //----------------------------------------------------------------------
 void
 TokenBucket::update()
 {
-    Time now;
-    now.get_time();
+    u_int64_t now = now_ns();
 
-    // time sometimes jumps backwards!!
-    while (now < last_update_) {
-        now.get_time();
+    if (tokens_ >= (int64_t)depth_) {
+        log_debug("update: bucket already full, nothing to update");
+        last_update_ns_ = now;
+        return;
     }
 
-    if (tokens_ == (int64_t)depth_) {
-        log_debug("update: bucket already full, nothing to update");
-        last_update_ = now;
+    if (rate_ == 0) {
         return;
     }
 
-    u_int32_t elapsed = (now - last_update_).in_microseconds();
-    u_int64_t new_tokens = (rate_ * elapsed) / 1000000;
+    u_int64_t elapsed = now - last_update_ns_;
+    u_int64_t spent   = depth_ - tokens_;
 
-    if (new_tokens != 0) {
-        if ((tokens_ + new_tokens) > depth_) {
-            new_tokens = depth_ - tokens_;
-        }
+    if (elapsed >= ns_for_tokens(spent)) {
+        log_debug("update: filling all %llu spent tokens after %llu nanoseconds",
+                  U64FMT(spent), U64FMT(elapsed));
+        tokens_ = depth_;
+        last_update_ns_ = now;
+        return;
+    }
+
+    u_int64_t new_tokens = tokens_for_ns(elapsed);
 
-        log_debug("update: filling %llu/%lld spent tokens after %u microseconds",
-                  U64FMT(new_tokens), I64FMT(depth_ - tokens_), elapsed);
+    if (new_tokens != 0) {
+        log_debug("update: filling %llu/%llu spent tokens after %llu nanoseconds",
+                  U64FMT(new_tokens), U64FMT(spent), U64FMT(elapsed));
         tokens_ += new_tokens;
-        last_update_ = now;
-        
+
+        // only move ahead by the time the new tokens took to fill so
+        // the remainder counts toward the next one
+        last_update_ns_ += std::min(elapsed, (u_int64_t)floor(((double)new_tokens * 1e9) / rate_));
     } else {
-        // there's a chance that, for a slow rate, that the elapsed
-        // time isn't enough to fill even a single token. in this
-        // case, we leave last_update_ to where it was before,
-        // otherwise we might starve the bucket.
-        log_debug("update: %u microseconds elapsed not enough to fill any tokens (rate: %llu)",
-                  elapsed, U64FMT(rate_));
+        // for a slow rate the elapsed time may not be enough to fill
+        // even a single token, in which case last_update_ns_ stays
+        // where it was so the time isn't lost
+        log_debug("update: %llu nanoseconds elapsed not enough to fill any tokens (rate: %llu)",
+                  U64FMT(elapsed), U64FMT(rate_));
     }
 }
 
@@ -135,8 +168,8 @@ TokenBucket::time_to_level(int64_t n)
         need = n - tokens_;
     }
 
-    Time t(need / rate_,
-           ((need * 1000000) / rate_) % 1000000);
+    u_int64_t ns = ns_for_tokens(need);
+    Time t(ns / 1000000000, (ns % 1000000000) / 1000);
     
     log_debug("time_to_level(%lld): "
               "%lld more tokens will arrive in %u.%u "
@@ -146,6 +179,24 @@ TokenBucket::time_to_level(int64_t n)
     return t;
 }
 
+//----------------------------------------------------------------------
+u_int64_t
+TokenBucket::time_to_drain_ns(u_int64_t length)
+{
+    update();
+
+    if ((rate_ == 0) || ((tokens_ >= 0) && (length <= (u_int64_t)tokens_))) {
+        return 0;
+    }
+
+    // the time since last_update_ns_ already counts toward the tokens
+    // still needed
+    u_int64_t ns      = ns_for_tokens(length - tokens_);
+    u_int64_t partial = now_ns() - last_update_ns_;
+
+    return (ns > partial) ? (ns - partial) : 1;
+}
+
 //----------------------------------------------------------------------
 Time
 TokenBucket::time_to_fill()
@@ -157,8 +208,8 @@ TokenBucket::time_to_fill()
 void
 TokenBucket::empty()
 {
-    tokens_      = 0;
-    last_update_.get_time();
+    tokens_         = 0;
+    last_update_ns_ = now_ns();
 
     log_debug("empty: clearing bucket");
 }
@@ -42,6 +42,12 @@ namespace oasys {
 
 /**
  * A basic token bucket implementation.
+ *
+ * Tokens are accounted against the monotonic clock with nanosecond
+ * arithmetic. The time a fill is credited for advances only by the
+ * time the credited tokens account for, so the fractions of a token
+ * left over from one update carry into the next and the long term
+ * rate is exact however often the bucket is polled.
  */
 class TokenBucket : public Logger {
 
@@ -92,6 +98,17 @@ public:
      */
     virtual Time time_to_level(int64_t n);
 
+    /**
+     * Return the number of nanoseconds until try_to_drain(length)
+     * would succeed, 0 if it would now (or if the rate is 0). This is
+     * the exact departure time for a sender pacing itself against the
+     * bucket. A length beyond the depth never drains.
+     */
+    virtual u_int64_t time_to_drain_ns(u_int64_t length);
+
+    /// Nanoseconds on the monotonic clock
+    static u_int64_t now_ns();
+
     /// @{ Accessors
     virtual u_int64_t depth()  const { return depth_; }
     virtual u_int64_t rate()   const { return rate_; }
@@ -110,10 +127,16 @@ public:
     virtual void empty();
     
 protected:
+    /// Nanoseconds it takes the rate to produce n tokens (rounded up)
+    u_int64_t ns_for_tokens(u_int64_t n) const;
+
+    /// Whole tokens the rate produces in ns nanoseconds
+    u_int64_t tokens_for_ns(u_int64_t ns) const;
+
     u_int64_t depth_;
     u_int64_t rate_;
     int64_t   tokens_;
-    Time      last_update_;
+    u_int64_t last_update_ns_;  ///< time the tokens_ are current as of
 };
 
 } // namespace oasys
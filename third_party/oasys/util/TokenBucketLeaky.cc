@@ -19,6 +19,9 @@
 #  include <oasys-config.h>
 #endif
 
+#include <algorithm>
+#include <math.h>
+
 #include "TokenBucketLeaky.h"
 
 namespace oasys {
@@ -34,48 +37,51 @@ TokenBucketLeaky::TokenBucketLeaky(const char* logpath,
 
     log_debug("initialized token bucket with depth %llu and rate %llu",
               U64FMT(depth_), U64FMT(rate_));
-    last_update_.get_time();
+    last_update_ns_ = now_ns();
 }
 //----------------------------------------------------------------------
 void
 TokenBucketLeaky::update()
 {
-    Time now;
-    now.get_time();
-
-    // time sometimes jumps backwards!!
-    int ctr = 0;
-    while (now < last_update_) {
-        now.get_time();
-        ++ctr;
-    }
+    u_int64_t now = now_ns();
 
-    if (tokens_ == (int64_t)0) {
+    if (tokens_ <= (int64_t)0) {
         log_debug("update: bucket already empty, nothing to update");
-        last_update_ = now;
+        last_update_ns_ = now;
         return;
     }
 
-    u_int32_t elapsed = (now - last_update_).in_microseconds();
-    int64_t new_tokens = (rate_ * elapsed) / 1000000;
+    if (rate_ == 0) {
+        return;
+    }
 
-    if (new_tokens > 0) {
-        if ((int64_t) new_tokens > tokens_) { // will tokens go negative?
-            new_tokens = tokens_;
-        }
+    u_int64_t elapsed = now - last_update_ns_;
 
-        log_debug("update: leaking %lld/%lld spent tokens after %u microseconds",
-                  I64FMT(-new_tokens), I64FMT(tokens_), elapsed);
+    if (elapsed >= ns_for_tokens(tokens_)) {
+        log_debug("update: leaking all %lld tokens after %llu nanoseconds",
+                  I64FMT(tokens_), U64FMT(elapsed));
+        tokens_ = 0;
+        last_update_ns_ = now;
+        return;
+    }
+
+    u_int64_t new_tokens = tokens_for_ns(elapsed);
+
+    if (new_tokens > 0) {
+        log_debug("update: leaking %lld/%lld spent tokens after %llu nanoseconds",
+                  I64FMT(-(int64_t)new_tokens), I64FMT(tokens_), U64FMT(elapsed));
         tokens_ -= new_tokens;
-        last_update_ = now;
-        
+
+        // only move ahead by the time the leaked tokens took so the
+        // remainder counts toward the next one
+        last_update_ns_ += std::min(elapsed, (u_int64_t)floor(((double)new_tokens * 1e9) / rate_));
     } else {
         // there's a chance that, for a slow rate, that the elapsed
-        // time isn't enough to fill even a single token. in this
-        // case, we leave last_update_ to where it was before,
+        // time isn't enough to leak even a single token. in this
+        // case, we leave last_update_ns_ to where it was before,
         // otherwise we might starve the bucket.
-        log_debug("update: %u milliseconds elapsed not enough to fill any tokens",
-                  elapsed);
+        log_debug("update: %llu nanoseconds elapsed not enough to leak any tokens",
+                  U64FMT(elapsed));
     }
 }
 
@@ -115,8 +121,8 @@ TokenBucketLeaky::time_to_level(int64_t n)
         need = n - tokens_;
     }
 
-    Time t(need / rate_,
-           ((need * 1000000) / rate_) % 1000000);
+    u_int64_t ns = ns_for_tokens(need);
+    Time t(ns / 1000000000, (ns % 1000000000) / 1000);
     
     log_debug("time_to_level(%lld): "
               "%lld more tokens will arrive in %u.%u "
@@ -126,6 +132,24 @@ TokenBucketLeaky::time_to_level(int64_t n)
     return t;
 }
 
+//----------------------------------------------------------------------
+u_int64_t
+TokenBucketLeaky::time_to_drain_ns(u_int64_t length)
+{
+    (void) length;
+
+    update();
+
+    if ((rate_ == 0) || (tokens_ <= 0)) {
+        return 0;
+    }
+
+    u_int64_t ns      = ns_for_tokens(tokens_);
+    u_int64_t partial = now_ns() - last_update_ns_;
+
+    return (ns > partial) ? (ns - partial) : 1;
+}
+
 //----------------------------------------------------------------------
 Time
 TokenBucketLeaky::time_to_fill()  // should be drain since we are leaky
@@ -137,8 +161,8 @@ TokenBucketLeaky::time_to_fill()  // should be drain since we are leaky
 void
 TokenBucketLeaky::empty()
 {
-    tokens_      = 0;
-    last_update_.get_time();
+    tokens_         = 0;
+    last_update_ns_ = now_ns();
 
     log_debug("empty: clearing bucket");
 }
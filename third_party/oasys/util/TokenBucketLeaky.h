@@ -77,6 +77,12 @@ public:
      */
     virtual Time time_to_level(int64_t n) override;
 
+    /**
+     * Return the number of nanoseconds until the bucket has leaked
+     * empty and try_to_drain() would succeed, 0 if it would now.
+     */
+    virtual u_int64_t time_to_drain_ns(u_int64_t length) override;
+
     /**
      * Empty the bucket.
      */
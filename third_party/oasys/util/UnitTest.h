@@ -238,10 +238,14 @@ public:
 
         if (in_tcl_) {
             print_tcl_tail();
-        } else {
-            print_results();
+            return 0;
         }
-        return 0;
+
+        // flush now since the log teardown at exit can take stdout with
+        // it, and the exit status tells a makefile if any test failed
+        print_results();
+        fflush(stdout);
+        return (failed_ == 0) ? 0 : 1;
     }
 
     void print_tcl_header() {